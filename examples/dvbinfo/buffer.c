@@ -56,6 +56,7 @@ buffer_t *buffer_new(size_t i_size)
     buffer_t *buffer = (buffer_t*)malloc(sizeof(buffer_t) + i_size);
     if (buffer == NULL) return NULL;
     buffer->i_size = i_size;
+    buffer->i_length = 0;
     buffer->i_date = 0;
     buffer->p_next = NULL;
     buffer->p_data = (uint8_t*)((uint8_t *)buffer + sizeof(buffer_t));
@@ -28,6 +28,7 @@ typedef struct buffer_s buffer_t;
 struct buffer_s
 {
     size_t   i_size;    /* size of buffer data */
+    size_t   i_length;  /* bytes of data read into the buffer */
     mtime_t  i_date;    /* timestamp */
     buffer_t *p_next;   /* pointer to next buffer_t */
     uint8_t  *p_data;   /* actuall buffer data */
@@ -82,6 +82,7 @@ extern int daemon(int, int);
 #endif
 
 #define FIFO_THRESHOLD_SIZE (400 * 1024 * 1024) /* threshold in bytes */
+#define FILE_BLOCK_PACKETS 64 /* TS packets read at once from a file */
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
 #ifdef HAVE_SYS_SOCKET_H
@@ -308,6 +309,7 @@ static void *dvbinfo_capture(void *data)
             continue;
         }
 
+        buffer->i_length = size;
         buffer->i_date = mdate();
 
         /* check fifo size */
@@ -381,14 +383,14 @@ static int dvbinfo_process(dvbinfo_capture_t *capture)
 
         if (param->output)
         {
-            ssize_t size = param->pf_write(param->fd_out, buffer->p_data, buffer->i_size);
+            ssize_t size = param->pf_write(param->fd_out, buffer->p_data, buffer->i_length);
             if (size < 0) /* error writing */
             {
                 libdvbpsi_log(param, DVBINFO_LOG_ERROR,
                               "error (%d) writting to %s", errno, param->output);
                 break;
             }
-            else if ((size_t)size < buffer->i_size) /* short writting disk full? */
+            else if ((size_t)size < buffer->i_length) /* short writting disk full? */
             {
                 libdvbpsi_log(param, DVBINFO_LOG_ERROR,
                               "error writting to %s (disk full?)", param->output);
@@ -396,7 +398,7 @@ static int dvbinfo_process(dvbinfo_capture_t *capture)
             }
         }
 
-        if (!libdvbpsi_process(stream, buffer->p_data, buffer->i_size, buffer->i_date))
+        if (!libdvbpsi_process(stream, buffer->p_data, buffer->i_length, buffer->i_date))
             b_error = true;
 
         /* summary statistics */
@@ -709,7 +711,7 @@ int main(int argc, char **pp_argv)
     else
 #endif
     {
-        capture.size = 188;
+        capture.size = FILE_BLOCK_PACKETS*188;
         libdvbpsi_log(param, DVBINFO_LOG_INFO, "Examining: %s\n",
                       param->input);
     }
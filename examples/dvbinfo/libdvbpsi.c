@@ -50,6 +50,7 @@
 #   include "../../src/demux.h"
 #   include "../../src/psi.h"
 #   include "../../src/descriptor.h"
+#   include "../../src/router.h"
 #   include "../../src/tables/pat.h"
 #   include "../../src/tables/pmt.h"
 #   include "../../src/tables/cat.h"
@@ -71,6 +72,7 @@
 #   include <dvbpsi/demux.h>
 #   include <dvbpsi/psi.h>
 #   include <dvbpsi/descriptor.h>
+#   include <dvbpsi/router.h>
 #   include <dvbpsi/pat.h>
 #   include <dvbpsi/pmt.h>
 #   include <dvbpsi/cat.h>
@@ -269,6 +271,7 @@ struct ts_stream_t
 
     /* pid */
     ts_pid_t    pid[8192];
+    dvbpsi_router_t *router;
 
     enum dvbpsi_msg_level level;
 
@@ -752,6 +755,14 @@ static void handle_PAT(void* p_data, dvbpsi_pat_t* p_pat)
                  free(p_pmt);
                  break;
             }
+            if (!dvbpsi_router_add(p_stream->router, p_program->i_pid, p_pmt->handle))
+            {
+                 fprintf(stderr, "dvbinfo: Failed to route PMT pid 0x%x\n", p_program->i_pid);
+                 dvbpsi_pmt_detach(p_pmt->handle);
+                 dvbpsi_delete(p_pmt->handle);
+                 free(p_pmt);
+                 break;
+            }
 
             /* insert at start of list */
             p_pmt->p_next = p_stream->pmt;
@@ -1707,6 +1718,15 @@ static void handle_atsc_MGT(void *p_data, dvbpsi_atsc_mgt_t *p_mgt)
                  free(p);
                  break;
             }
+            if (!dvbpsi_router_add(p_stream->router, p_table->i_table_type_pid, p->handle))
+            {
+                 fprintf(stderr, "dvbinfo: Failed to route ATSC EIT pid 0x%x\n",
+                         p_table->i_table_type_pid);
+                 dvbpsi_DetachDemux(p->handle);
+                 dvbpsi_delete(p->handle);
+                 free(p);
+                 break;
+            }
 
             /* insert at start of list */
             p->p_next = p_stream->atsc_eit;
@@ -2141,6 +2161,20 @@ ts_stream_t *libdvbpsi_init(int debug, ts_stream_log_cb pf_log, void *cb_data)
         goto error;
     }
 
+    /* PID routing, PMT and ATSC EIT pids are added by the PAT and MGT */
+    stream->router = dvbpsi_router_new();
+    if (stream->router == NULL)
+        goto error;
+    if (!dvbpsi_router_add(stream->router, 0x00, stream->pat.handle) ||  /* PAT */
+        !dvbpsi_router_add(stream->router, 0x01, stream->cat.handle) ||  /* CAT */
+        !dvbpsi_router_add(stream->router, 0x02, stream->tdt.handle) ||  /* Transport Stream Description Table */
+        !dvbpsi_router_add(stream->router, 0x11, stream->sdt.handle) ||  /* SDT/BAT/NIT */
+        !dvbpsi_router_add(stream->router, 0x12, stream->eit.handle) ||  /* EIT */
+        !dvbpsi_router_add(stream->router, 0x13, stream->rst.handle) ||  /* RST */
+        !dvbpsi_router_add(stream->router, 0x14, stream->tdt.handle) ||  /* TDT/TOT */
+        !dvbpsi_router_add(stream->router, 0x1FFB, stream->atsc.handle)) /* ATSC tables */
+        goto error;
+
     /* */
     stream->pat.pid = &stream->pid[0x00];
     stream->cat.pid = &stream->pid[0x01];
@@ -2156,6 +2190,8 @@ ts_stream_t *libdvbpsi_init(int debug, ts_stream_log_cb pf_log, void *cb_data)
     return stream;
 
 error:
+    dvbpsi_router_delete(stream->router);
+
     if (dvbpsi_decoder_present(stream->pat.handle))
         dvbpsi_pat_detach(stream->pat.handle);
     if (dvbpsi_decoder_present(stream->cat.handle))
@@ -2195,6 +2231,8 @@ void libdvbpsi_exit(ts_stream_t *stream)
 {
    summary(stdout, stream);
 
+   dvbpsi_router_delete(stream->router);
+
    if (dvbpsi_decoder_present(stream->pat.handle))
        dvbpsi_pat_detach(stream->pat.handle);
 
@@ -2286,6 +2324,9 @@ bool libdvbpsi_process(ts_stream_t *stream, uint8_t *buf, ssize_t length, mtime_
 {
     mtime_t  i_prev_pcr = 0;  /* 33 bits */
     int      i_old_cc = -1;
+    uint8_t *p_block = NULL;  /* packets in sync, for the router */
+    ssize_t  i_block_end = 0;
+    size_t   i_block = 0;
 
     for (ssize_t i = 0; i < length; i += 188)
     {
@@ -2323,43 +2364,15 @@ bool libdvbpsi_process(ts_stream_t *stream, uint8_t *buf, ssize_t length, mtime_
                            "dvbinfo: %"PRId64" packet %"PRId64" pid %u (0x%x) cc %d\n",
                            date, stream->i_packets, i_pid, i_pid, i_cc);
 
-        if (i_pid == 0x0) /* PAT */
-            dvbpsi_packet_push(stream->pat.handle, p_tmp);
-        else if (i_pid == 0x01) /* CAT */
-            dvbpsi_packet_push(stream->cat.handle, p_tmp);
-        else if (i_pid == 0x02) /* Transport Stream Description Table */
-            dvbpsi_packet_push(stream->tdt.handle, p_tmp);
-#if 0
-        else if (i_pid == 0x03) /* IPMP Control Information Table */
-            dvbpsi_packet_push(stream->ipmp.handle, p_tmp);
-#endif
-        else if (i_pid == 0x11) /* SDT/BAT/NIT */
-            dvbpsi_packet_push(stream->sdt.handle, p_tmp);
-        else if (i_pid == 0x12) /* EIT */
-            dvbpsi_packet_push(stream->eit.handle, p_tmp);
-        else if (i_pid == 0x13) /* RST */
-            dvbpsi_packet_push(stream->rst.handle, p_tmp);
-        else if (i_pid == 0x14) /* TDT/TOT */
-            dvbpsi_packet_push(stream->tdt.handle, p_tmp);
-        else if (i_pid == 0x1FFB) /* ATSC tables */
-            dvbpsi_packet_push(stream->atsc.handle, p_tmp);
-        else
+        /* PSI/SI tables are pushed at once for all the packets in sync,
+         * after the last one has been accounted for */
+        if (i >= i_block_end)
         {
-            ts_pmt_t *p = stream->pmt;
-            while(p)
-            {
-                if (p->pid_pmt->i_pid == i_pid)
-                    dvbpsi_packet_push(p->handle, p_tmp);
-                p = p->p_next;
-            }
-
-            ts_atsc_eit_t *p_atsc_eit = stream->atsc_eit;
-            while (p_atsc_eit)
-            {
-                if (p_atsc_eit->pid->i_pid == i_pid)
-                    dvbpsi_packet_push(p_atsc_eit->handle, p_tmp);
-                p_atsc_eit = p_atsc_eit->p_next;
-            }
+            p_block = p_tmp;
+            i_block = 0;
+            for (i_block_end = i; i_block_end + 188 <= length
+                               && buf[i_block_end] == 0x47; i_block_end += 188)
+                i_block++;
         }
 
         /* Remember PID */
@@ -2526,6 +2539,10 @@ dump_packet:
         {
             ts_dump_packet_details(stdout, stream, &buf[i], i_pid);
         }
+
+        /* PSI/SI tables */
+        if (i + 188 >= i_block_end)
+            dvbpsi_router_push(stream->router, p_block, i_block, 188, NULL);
     }
 
     return true;
@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * bench_demux.c: subtable demux dispatch benchmark
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/demux.h"
+#include "../src/descriptor.h"
+#include "../src/tables/eit.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/demux.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/eit.h>
+#endif
+
+#define LOOKUPS 4000000
+
+/*****************************************************************************
+ * EIT callback, never called
+ *****************************************************************************/
+static void EIT(void *p_data, dvbpsi_eit_t *p_eit)
+{
+  (void)p_data;
+  dvbpsi_eit_delete(p_eit);
+}
+
+/*****************************************************************************
+ * NewSubtable, never called
+ *****************************************************************************/
+static void NewSubtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                        uint16_t i_extension, void *p_data)
+{
+  (void)p_dvbpsi; (void)i_table_id; (void)i_extension; (void)p_data;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Time dvbpsi_demuxGetSubDec() with an increasing number of EIT subtable
+ * decoders (table_id 0x4e to 0x6f times service_id) attached to one demux.
+ * The lookups are spread over all the attached subtables.
+ *****************************************************************************/
+int main(void)
+{
+  static const unsigned int pi_subtables[] = { 16, 256, 1024, 4096, 16384 };
+  unsigned int i, j;
+  int i_errors = 0;
+
+  printf("subtables   ns/lookup\n");
+
+  for(i = 0; i < sizeof(pi_subtables) / sizeof(pi_subtables[0]); i++)
+  {
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, NewSubtable, NULL))
+      return EXIT_FAILURE;
+
+    for(j = 0; j < pi_subtables[i]; j++)
+    {
+      if(!dvbpsi_eit_attach(p_dvbpsi, 0x4e + j % 34, j / 34, EIT, NULL))
+        return EXIT_FAILURE;
+    }
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    uint32_t i_seed = 1;
+    clock_t i_start = clock();
+
+    for(j = 0; j < LOOKUPS; j++)
+    {
+      i_seed = i_seed * 1103515245 + 12345;
+      unsigned int k = (i_seed >> 8) % pi_subtables[i];
+      if(dvbpsi_demuxGetSubDec(p_demux, 0x4e + k % 34, k / 34) == NULL)
+        i_errors++;
+    }
+
+    double f_ns = (double)(clock() - i_start) * 1e9 / CLOCKS_PER_SEC / LOOKUPS;
+    printf("%9u   %9.1f\n", pi_subtables[i], f_ns);
+
+    for(j = 0; j < pi_subtables[i]; j++)
+      dvbpsi_eit_detach(p_dvbpsi, 0x4e + j % 34, j / 34);
+    dvbpsi_DetachDemux(p_dvbpsi);
+    dvbpsi_delete(p_dvbpsi);
+  }
+
+  if(i_errors)
+    printf("%d lookups failed\n", i_errors);
+
+  return i_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
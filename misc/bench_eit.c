@@ -0,0 +1,249 @@
+/*****************************************************************************
+ * bench_eit.c: EIT build and decode benchmark
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/demux.h"
+#include "../src/descriptor.h"
+#include "../src/packetizer.h"
+#include "../src/tables/eit.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/demux.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/eit.h>
+#endif
+
+#define EVENTS      2000
+#define DESCRIPTORS 6
+#define LOOPS       20
+
+static unsigned int i_tables;
+static unsigned int i_events;
+
+/*****************************************************************************
+ * BuildEIT: fill an EIT with EVENTS events of DESCRIPTORS descriptors each
+ *****************************************************************************/
+static dvbpsi_eit_t *BuildEIT(void)
+{
+  uint8_t p_data[32];
+  unsigned int i, j;
+
+  for(i = 0; i < sizeof(p_data); i++)
+    p_data[i] = i;
+
+  dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x50, 1, 0, true, 2, 3, 0, 0x50);
+  if(p_eit == NULL)
+    return NULL;
+
+  for(i = 0; i < EVENTS; i++)
+  {
+    dvbpsi_eit_event_t *p_event;
+    p_event = dvbpsi_eit_event_add(p_eit, i, (uint64_t)i << 24, 0x003000,
+                                   1, false, 0);
+    if(p_event == NULL)
+      break;
+    for(j = 0; j < DESCRIPTORS; j++)
+      dvbpsi_eit_event_descriptor_add(p_event, 0x80 + j, sizeof(p_data), p_data);
+  }
+
+  return p_eit;
+}
+
+/*****************************************************************************
+ * EIT callback
+ *****************************************************************************/
+static void EIT(void *p_data, dvbpsi_eit_t *p_eit)
+{
+  dvbpsi_eit_event_t *p_event = p_eit->p_first_event;
+  (void)p_data;
+
+  i_tables++;
+  for(; p_event != NULL; p_event = p_event->p_next)
+    i_events++;
+  dvbpsi_eit_delete(p_eit);
+}
+
+/*****************************************************************************
+ * NewSubtable
+ *****************************************************************************/
+static void NewSubtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                        uint16_t i_extension, void *p_data)
+{
+  (void)p_data;
+  if(i_table_id == 0x50)
+    dvbpsi_eit_attach(p_dvbpsi, i_table_id, i_extension, EIT, NULL);
+}
+
+/*****************************************************************************
+ * Decode
+ *****************************************************************************/
+static bool Decode(uint8_t *p_ts, unsigned int i_packets, bool b_retain)
+{
+  unsigned int i, j;
+
+  for(i = 0; i < LOOPS; i++)
+  {
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, NewSubtable, NULL))
+      return false;
+    dvbpsi_decoder_retain_sections(p_dvbpsi, b_retain);
+    for(j = 0; j < i_packets; j++)
+      dvbpsi_packet_push(p_dvbpsi, p_ts + 188 * j);
+    dvbpsi_eit_detach(p_dvbpsi, 0x50, 1);
+    dvbpsi_DetachDemux(p_dvbpsi);
+    dvbpsi_delete(p_dvbpsi);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Generate
+ *****************************************************************************
+ * Generate the sections of the table LOOPS times, taking them from a section
+ * pool or not.
+ *****************************************************************************/
+static bool Generate(dvbpsi_eit_t *p_eit, bool b_pool)
+{
+  unsigned int i;
+  dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(p_dvbpsi == NULL)
+    return false;
+  if(b_pool)
+    p_dvbpsi->p_pool = dvbpsi_NewPSISectionPool();
+
+  for(i = 0; i < LOOPS; i++)
+  {
+    dvbpsi_psi_section_t *p_sections = dvbpsi_eit_sections_generate(p_dvbpsi,
+                                                                    p_eit, 0x50);
+    if(p_sections == NULL)
+      return false;
+    dvbpsi_DeletePSISections(p_sections);
+  }
+
+  dvbpsi_DeletePSISectionPool(p_dvbpsi->p_pool);
+  dvbpsi_delete(p_dvbpsi);
+  return true;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Time the construction of an EIT of EVENTS events carrying DESCRIPTORS
+ * descriptors each, the generation of its sections, then the decoding of
+ * the same table pushed as TS packets.
+ *****************************************************************************/
+int main(void)
+{
+  unsigned int i, i_packets;
+  clock_t i_start;
+
+  i_start = clock();
+  for(i = 0; i < LOOPS; i++)
+  {
+    dvbpsi_eit_t *p_eit = BuildEIT();
+    if(p_eit == NULL)
+      return EXIT_FAILURE;
+    dvbpsi_eit_delete(p_eit);
+  }
+  printf("build:  %8.3f ms/table\n",
+         (double)(clock() - i_start) * 1e3 / CLOCKS_PER_SEC / LOOPS);
+
+  dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  dvbpsi_eit_t *p_eit = BuildEIT();
+  if(p_dvbpsi == NULL || p_eit == NULL)
+    return EXIT_FAILURE;
+
+  i_start = clock();
+  if(!Generate(p_eit, false))
+    return EXIT_FAILURE;
+  printf("generate: %6.3f ms/table\n",
+         (double)(clock() - i_start) * 1e3 / CLOCKS_PER_SEC / LOOPS);
+
+  i_start = clock();
+  if(!Generate(p_eit, true))
+    return EXIT_FAILURE;
+  printf("generate: %6.3f ms/table (section pool)\n",
+         (double)(clock() - i_start) * 1e3 / CLOCKS_PER_SEC / LOOPS);
+
+  dvbpsi_psi_section_t *p_sections = dvbpsi_eit_sections_generate(p_dvbpsi,
+                                                                  p_eit, 0x50);
+  dvbpsi_eit_delete(p_eit);
+  dvbpsi_delete(p_dvbpsi);
+  if(p_sections == NULL)
+    return EXIT_FAILURE;
+
+  /* Pack the sections back to back on PID 0x12 */
+  dvbpsi_packetizer_t *p_packetizer = dvbpsi_packetizer_new(true);
+  if(p_packetizer == NULL)
+    return EXIT_FAILURE;
+  i_packets = dvbpsi_packetizer_write(p_packetizer, 0x12, p_sections, NULL, 0);
+  uint8_t *p_ts = malloc(188 * i_packets);
+  if(p_ts == NULL)
+    return EXIT_FAILURE;
+  dvbpsi_packetizer_write(p_packetizer, 0x12, p_sections, p_ts, i_packets);
+  dvbpsi_packetizer_delete(p_packetizer);
+  dvbpsi_DeletePSISections(p_sections);
+
+  i_start = clock();
+  if(!Decode(p_ts, i_packets, false))
+    return EXIT_FAILURE;
+  printf("decode: %8.3f ms/table (%u packets)\n",
+         (double)(clock() - i_start) * 1e3 / CLOCKS_PER_SEC / LOOPS, i_packets);
+
+  i_start = clock();
+  if(!Decode(p_ts, i_packets, true))
+    return EXIT_FAILURE;
+  printf("decode: %8.3f ms/table (retained sections)\n",
+         (double)(clock() - i_start) * 1e3 / CLOCKS_PER_SEC / LOOPS);
+
+  free(p_ts);
+
+  if(i_tables != 2 * LOOPS || i_events != 2 * LOOPS * EVENTS)
+  {
+    printf("decoded %u tables and %u events, expected %u and %u\n",
+           i_tables, i_events, 2 * LOOPS, 2 * LOOPS * EVENTS);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
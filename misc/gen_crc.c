@@ -1,5 +1,5 @@
 /*****************************************************************************
- * gen_crc.c: CRC_32 table generator
+ * gen_crc.c: CRC_32 tables generator
  *----------------------------------------------------------------------------
  * Copyright (c)2001-2010 VideoLAN
  * $Id: gen_crc.c,v 1.2 2002/06/02 23:04:08 bozo Exp $
@@ -35,12 +35,30 @@
 #endif
 
 
+/*****************************************************************************
+ * xn_mod_p
+ *****************************************************************************
+ * x^n modulo the CRC_32 polynomial, used by the folding implementations.
+ *****************************************************************************/
+static uint32_t xn_mod_p(unsigned int n)
+{
+  uint32_t k = 1;
+
+  while(n--)
+    k = (k << 1) ^ ((k & 0x80000000) ? 0x04c11db7 : 0);
+
+  return k;
+}
+
 /*****************************************************************************
  * main
+ *****************************************************************************
+ * Row 0 is the classic byte per byte table, row n gives the CRC_32 of a byte
+ * followed by n zero bytes (slicing-by-16).
  *****************************************************************************/
 int main(void)
 {
-  uint32_t table[256];
+  uint32_t table[16][256];
   uint32_t i, j, k;
 
   for(i = 0; i < 256; i++)
@@ -48,24 +66,40 @@ int main(void)
     k = 0;
     for (j = (i << 24) | 0x800000; j != 0x80000000; j <<= 1)
       k = (k << 1) ^ (((k ^ j) & 0x80000000) ? 0x04c11db7 : 0);
-    table[i] = k;
+    table[0][i] = k;
   }
 
-  printf("static uint32_t table[256] =\n{\n");
-  for(i = 0; i < 64; i++)
+  for(j = 1; j < 16; j++)
+    for(i = 0; i < 256; i++)
+      table[j][i] = (table[j - 1][i] << 8) ^ table[0][table[j - 1][i] >> 24];
+
+  printf("static const uint32_t dvbpsi_crc32_table[16][256] =\n{\n");
+  for(j = 0; j < 16; j++)
   {
-    printf("  0x%08x, 0x%08x, 0x%08x, 0x%08x",
-           table[i << 2 | 0],
-           table[i << 2 | 1],
-           table[i << 2 | 2],
-           table[i << 2 | 3]);
-    if(i < 63)
-      printf(",\n");
+    printf("  {\n");
+    for(i = 0; i < 64; i++)
+    {
+      printf("    0x%08x, 0x%08x, 0x%08x, 0x%08x",
+             table[j][i << 2 | 0],
+             table[j][i << 2 | 1],
+             table[j][i << 2 | 2],
+             table[j][i << 2 | 3]);
+      if(i < 63)
+        printf(",\n");
+      else
+        printf("\n");
+    }
+    if(j < 15)
+      printf("  },\n");
     else
-      printf("\n");
+      printf("  }\n");
   }
-  printf("};\n");
+  printf("};\n\n");
+
+  printf("#define DVBPSI_CRC32_X128 0x%08x\n", xn_mod_p(128));
+  printf("#define DVBPSI_CRC32_X192 0x%08x\n", xn_mod_p(192));
+  printf("#define DVBPSI_CRC32_X512 0x%08x\n", xn_mod_p(512));
+  printf("#define DVBPSI_CRC32_X576 0x%08x\n", xn_mod_p(576));
 
   return 0;
 }
-
@@ -28,6 +28,7 @@
 #include "config.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 
 #if defined(HAVE_INTTYPES_H)
@@ -40,68 +41,31 @@
 #ifdef DVBPSI_DIST
 #include "../src/dvbpsi.h"
 #include "../src/psi.h"
+#include "../src/packetizer.h"
 #include "../src/tables/pat.h"
 #else
 #include <dvbpsi/dvbpsi.h>
 #include <dvbpsi/psi.h>
+#include <dvbpsi/packetizer.h>
 #include <dvbpsi/pat.h>
 #endif
 
 /*****************************************************************************
  * writePSI
  *****************************************************************************/
-static void writePSI(uint8_t* p_packet, dvbpsi_psi_section_t* p_section)
+static void writePSI(dvbpsi_packetizer_t* p_packetizer, uint16_t i_pid,
+                     dvbpsi_psi_section_t* p_section)
 {
-  p_packet[0] = 0x47;
-
-  while(p_section)
-  {
-    size_t i_bytes_written = 0;
-    uint8_t* p_pos_in_ts;
-    uint8_t* p_byte = p_section->p_data;
-    uint8_t* p_end =   p_section->p_payload_end
-                     + (p_section->b_syntax_indicator ? 4 : 0);
-
-    p_packet[1] |= 0x40;
-    p_packet[3] = (p_packet[3] & 0x0f) | 0x10;
-
-    p_packet[4] = 0x00; /* pointer_field */
-    p_pos_in_ts = p_packet + 5;
-
-    while((p_pos_in_ts < p_packet + 188) && (p_byte < p_end))
-      *(p_pos_in_ts++) = *(p_byte++);
-    while(p_pos_in_ts < p_packet + 188)
-      *(p_pos_in_ts++) = 0xff;
-    i_bytes_written = fwrite(p_packet, 1, 188, stdout);
-    if(i_bytes_written == 0)
-    {
-      fprintf(stderr,"eof detected ... aborting\n");
-      return;
-    }
-    p_packet[3] = (p_packet[3] + 1) & 0x0f;
-
-    while(p_byte < p_end)
-    {
-      p_packet[1] &= 0xbf;
-      p_packet[3] = (p_packet[3] & 0x0f) | 0x10;
-
-      p_pos_in_ts = p_packet + 4;
-
-      while((p_pos_in_ts < p_packet + 188) && (p_byte < p_end))
-        *(p_pos_in_ts++) = *(p_byte++);
-      while(p_pos_in_ts < p_packet + 188)
-        *(p_pos_in_ts++) = 0xff;
-      i_bytes_written = fwrite(p_packet, 1, 188, stdout);
-      if(i_bytes_written == 0)
-      {
-        fprintf(stderr,"eof detected ... aborting\n");
-        return;
-      }
-      p_packet[3] = (p_packet[3] + 1) & 0x0f;
-    }
-
-    p_section = p_section->p_next;
-  }
+  size_t i_packets = dvbpsi_packetizer_write(p_packetizer, i_pid, p_section,
+                                             NULL, 0);
+  uint8_t* p_packets = malloc(188 * i_packets);
+  if(p_packets == NULL)
+    return;
+
+  dvbpsi_packetizer_write(p_packetizer, i_pid, p_section, p_packets, i_packets);
+  if(fwrite(p_packets, 188, i_packets, stdout) != i_packets)
+    fprintf(stderr,"eof detected ... aborting\n");
+  free(p_packets);
 }
 
 static void message(dvbpsi_t *handle, const dvbpsi_msg_level_t level, const char* msg)
@@ -122,7 +86,6 @@ static void message(dvbpsi_t *handle, const dvbpsi_msg_level_t level, const char
  *****************************************************************************/
 int main(int i_argc, char* pa_argv[])
 {
-  uint8_t packet[188];
   dvbpsi_pat_t pat;
   dvbpsi_psi_section_t* p_section1, * p_section2;
   dvbpsi_psi_section_t* p_section3, * p_section4;
@@ -161,16 +124,18 @@ int main(int i_argc, char* pa_argv[])
   p_section6 = dvbpsi_pat_sections_generate(p_dvbpsi, &pat, 16);
 
   /* TS packets generation */
-  packet[0] = 0x47;
-  packet[1] = packet[2] = 0x00;
-  packet[3] = 0x00;
-
-  writePSI(packet, p_section1);
-  writePSI(packet, p_section2);
-  writePSI(packet, p_section3);
-  writePSI(packet, p_section4);
-  writePSI(packet, p_section5);
-  writePSI(packet, p_section6);
+  dvbpsi_packetizer_t* p_packetizer = dvbpsi_packetizer_new(false);
+  if (p_packetizer == NULL)
+      return 1;
+
+  writePSI(p_packetizer, 0x00, p_section1);
+  writePSI(p_packetizer, 0x00, p_section2);
+  writePSI(p_packetizer, 0x00, p_section3);
+  writePSI(p_packetizer, 0x00, p_section4);
+  writePSI(p_packetizer, 0x00, p_section5);
+  writePSI(p_packetizer, 0x00, p_section6);
+
+  dvbpsi_packetizer_delete(p_packetizer);
 
   dvbpsi_DeletePSISections(p_section1);
   dvbpsi_DeletePSISections(p_section2);
@@ -0,0 +1,206 @@
+/*****************************************************************************
+ * test_carousel.c: PSI/SI carousel self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/carousel.h"
+#include "../src/tables/pat.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/carousel.h>
+#include <dvbpsi/pat.h>
+#endif
+
+/* 188 * 8 * 10 bit/s: one packet every 100 ms */
+#define TEN_PACKETS_PER_SECOND 15040
+
+/*****************************************************************************
+ * PAT: sections of a PAT with i_programs programs
+ *****************************************************************************/
+static dvbpsi_psi_section_t *PAT(uint16_t i_ts_id, uint8_t i_version,
+                                 unsigned int i_programs)
+{
+  dvbpsi_pat_t *p_pat = dvbpsi_pat_new(i_ts_id, i_version, true);
+  unsigned int i;
+
+  if(p_pat == NULL)
+    return NULL;
+  for(i = 0; i < i_programs; i++)
+    dvbpsi_pat_program_add(p_pat, i + 1, 0x100 + i);
+
+  dvbpsi_psi_section_t *p_sections = dvbpsi_pat_sections_generate(NULL, p_pat,
+                                                                  253);
+  dvbpsi_pat_delete(p_pat);
+  return p_sections;
+}
+
+/*****************************************************************************
+ * Set: add a PAT to the carousel
+ *****************************************************************************/
+static bool Set(dvbpsi_carousel_t *p_carousel, uint16_t i_pid, uint16_t i_ts_id,
+                uint8_t i_version, unsigned int i_programs, uint64_t i_interval)
+{
+  dvbpsi_psi_section_t *p_sections = PAT(i_ts_id, i_version, i_programs);
+  if(p_sections == NULL)
+    return false;
+
+  bool b_ok = dvbpsi_carousel_set(p_carousel, i_pid, 0x00, i_ts_id, i_interval,
+                                  p_sections);
+  dvbpsi_DeletePSISections(p_sections);
+  return b_ok;
+}
+
+/*****************************************************************************
+ * Run: call dvbpsi_carousel_send() every 10 ms from i_start to i_end
+ * excluded, count the packets of each PID
+ *****************************************************************************/
+static unsigned int Run(dvbpsi_carousel_t *p_carousel, uint64_t i_start,
+                        uint64_t i_end, unsigned int *pi_count)
+{
+  uint8_t p_buffer[188 * 16];
+  unsigned int i_total = 0;
+  uint64_t i_time;
+  size_t i, i_packets;
+
+  for(i_time = i_start; i_time < i_end; i_time += 10000)
+  {
+    i_packets = dvbpsi_carousel_send(p_carousel, i_time, p_buffer, 16);
+    for(i = 0; i < i_packets; i++)
+    {
+      uint16_t i_pid = ((p_buffer[188 * i + 1] & 0x1f) << 8)
+                     | p_buffer[188 * i + 2];
+      if(pi_count != NULL)
+        pi_count[i_pid]++;
+    }
+    i_total += i_packets;
+  }
+  return i_total;
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, unsigned int i_value,
+                 unsigned int i_expected)
+{
+  if(i_value == i_expected)
+    return 0;
+  printf("%-32s: %u instead of %u\n", psz_test, i_value, i_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Check the repetition of tables with different intervals, the bitrate
+ * bound of a PID, the swap to a new version of a table being sent, the
+ * rejection of a zero interval and the handling of a clock going
+ * backwards.
+ *****************************************************************************/
+int main(void)
+{
+  static unsigned int pi_count[8192];
+  uint8_t p_buffer[188 * 16];
+  int i_failed = 0;
+  size_t i;
+
+  /* Repetition intervals */
+  dvbpsi_carousel_t *p_carousel = dvbpsi_carousel_new(true);
+  if(p_carousel == NULL
+   || !Set(p_carousel, 0x00, 1, 0, 4, 100000)
+   || !Set(p_carousel, 0x10, 2, 0, 4, 250000))
+    return EXIT_FAILURE;
+  i_failed += Check("interval: zero",
+                    Set(p_carousel, 0x11, 3, 0, 4, 0), 0);
+  i_failed += Check("interval: next", dvbpsi_carousel_next(p_carousel), 0);
+  Run(p_carousel, 0, 1000000, pi_count);
+  i_failed += Check("interval: 100 ms", pi_count[0x00], 10);
+  i_failed += Check("interval: 250 ms", pi_count[0x10], 4);
+  i_failed += Check("interval: zero not sent", pi_count[0x11], 0);
+  i_failed += Check("interval: next",
+                    dvbpsi_carousel_next(p_carousel), 1000000);
+
+  /* Clock going backwards: the tables keep being sent */
+  memset(pi_count, 0, sizeof(pi_count));
+  Run(p_carousel, 5000, 505000, pi_count);
+  i_failed += Check("backwards: 100 ms", pi_count[0x00], 5);
+  i_failed += Check("backwards: 250 ms", pi_count[0x10], 2);
+  dvbpsi_carousel_delete(p_carousel);
+
+  /* Bitrate bound of a table of several packets */
+  p_carousel = dvbpsi_carousel_new(true);
+  if(p_carousel == NULL || !Set(p_carousel, 0x00, 1, 0, 1000, 1000000)
+   || !dvbpsi_carousel_rate(p_carousel, 0x00, TEN_PACKETS_PER_SECOND, 1))
+    return EXIT_FAILURE;
+  i_failed += Check("rate: burst",
+                    dvbpsi_carousel_send(p_carousel, 0, p_buffer, 16), 1);
+  i_failed += Check("rate: next", dvbpsi_carousel_next(p_carousel), 100000);
+  i_failed += Check("rate: too early",
+                    dvbpsi_carousel_send(p_carousel, 99000, p_buffer, 16), 0);
+  i_failed += Check("rate: one second",
+                    Run(p_carousel, 100000, 1000000, NULL), 9);
+  dvbpsi_carousel_delete(p_carousel);
+
+  /* New version of a table being sent */
+  p_carousel = dvbpsi_carousel_new(true);
+  if(p_carousel == NULL || !Set(p_carousel, 0x00, 1, 0, 200, 1000000))
+    return EXIT_FAILURE;
+  size_t i_first = dvbpsi_carousel_send(p_carousel, 0, p_buffer, 2);
+  if(!Set(p_carousel, 0x00, 1, 1, 200, 1000000))
+    return EXIT_FAILURE;
+  size_t i_second = dvbpsi_carousel_send(p_carousel, 0, p_buffer, 16);
+  size_t i_old = 0;
+  while(i_old < i_second && !(p_buffer[188 * i_old + 1] & 0x40))
+    i_old++;
+  i_failed += Check("version: old one finished", i_first + i_old, 5);
+  i_failed += Check("version: new one follows", i_second - i_old, 5);
+  if(i_old < i_second)
+    i_failed += Check("version: new version",
+                      (p_buffer[188 * i_old + 10] >> 1) & 0x1f, 1);
+  for(i = 1; i < i_second; i++)
+    i_failed += Check("version: continuity counter",
+                      p_buffer[188 * i + 3] & 0x0f,
+                      (p_buffer[188 * (i - 1) + 3] + 1) & 0x0f);
+  dvbpsi_carousel_delete(p_carousel);
+
+  printf("%-32s: %s\n", "carousel", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
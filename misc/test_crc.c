@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * test_crc.c: CRC_32 implementations self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#endif
+
+#define TEST_SIZE 4200 /* more than the largest section */
+
+static const char *ppsz_impl[] =
+{
+  "auto", "table", "slicing-by-8", "slicing-by-16", "carry-less multiplication"
+};
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Cross-check every available CRC_32 implementation against the byte per
+ * byte table for all lengths and alignments, then against a known vector.
+ * Then check the CRC_32 updates of zero bytes and of patched sections.
+ *****************************************************************************/
+int main(void)
+{
+  static uint8_t p_data[TEST_SIZE + 16];
+  /* A PAT section without its CRC_32, which is 0xe8f95e7d */
+  static const uint8_t p_pat[] = { 0x00, 0xb0, 0x0d, 0x00, 0x01, 0xc1,
+                                   0x00, 0x00, 0x00, 0x01, 0xe1, 0x00 };
+  uint32_t i_seed = 0x12345678;
+  int i_errors = 0;
+  int i, i_impl;
+
+  for(i = 0; i < TEST_SIZE + 16; i++)
+  {
+    i_seed = i_seed * 1103515245 + 12345;
+    p_data[i] = i_seed >> 24;
+  }
+
+  printf("dispatcher uses: %s\n", ppsz_impl[dvbpsi_crc32_get_impl()]);
+
+  for(i_impl = DVBPSI_CRC32_AUTO; i_impl <= DVBPSI_CRC32_CLMUL; i_impl++)
+  {
+    uint32_t i_ref, i_crc;
+    size_t i_size, i_offset;
+    int i_failed = 0;
+
+    i_crc = 0xffffffff;
+    if(!dvbpsi_crc32_impl(i_impl, &i_crc, p_data, 0))
+    {
+      printf("%-26s: not available\n", ppsz_impl[i_impl]);
+      continue;
+    }
+
+    for(i_offset = 0; i_offset < 16; i_offset++)
+    {
+      for(i_size = 0; i_size <= TEST_SIZE; i_size++)
+      {
+        i_ref = i_crc = 0xffffffff ^ (uint32_t)(i_size * 0x9e3779b9);
+        dvbpsi_crc32_impl(DVBPSI_CRC32_TABLE, &i_ref, p_data + i_offset, i_size);
+        dvbpsi_crc32_impl(i_impl, &i_crc, p_data + i_offset, i_size);
+        if(i_crc != i_ref)
+        {
+          if(i_failed++ == 0)
+            printf("%-26s: size %u offset %u: 0x%08x instead of 0x%08x\n",
+                   ppsz_impl[i_impl], (unsigned)i_size, (unsigned)i_offset,
+                   i_crc, i_ref);
+        }
+      }
+    }
+
+    i_crc = 0xffffffff;
+    dvbpsi_crc32_impl(i_impl, &i_crc, p_pat, sizeof(p_pat));
+    if(i_crc != 0xe8f95e7d)
+    {
+      printf("%-26s: PAT CRC_32 0x%08x instead of 0xe8f95e7d\n",
+             ppsz_impl[i_impl], i_crc);
+      i_failed++;
+    }
+
+    printf("%-26s: %s\n", ppsz_impl[i_impl], i_failed ? "FAILED" : "ok");
+    i_errors += i_failed;
+  }
+
+  int i_failed = 0;
+
+  /* CRC_32 of zero bytes against the real thing */
+  for(i = 0; i <= TEST_SIZE; i += 7)
+  {
+    static const uint8_t p_zero[TEST_SIZE + 1];
+    uint32_t i_ref = 0x9e3779b9;
+    dvbpsi_crc32_impl(DVBPSI_CRC32_TABLE, &i_ref, p_zero, i);
+    if(dvbpsi_crc32_shift(0x9e3779b9, i) != i_ref)
+    {
+      printf("%-26s: %d zero bytes: 0x%08x instead of 0x%08x\n", "shift",
+             i, dvbpsi_crc32_shift(0x9e3779b9, i), i_ref);
+      i_failed++;
+      break;
+    }
+  }
+
+  /* Patching a section keeps its CRC_32 valid */
+  dvbpsi_psi_section_t *p_section = dvbpsi_NewPSISection(TEST_SIZE);
+  if(p_section == NULL)
+    return EXIT_FAILURE;
+  memcpy(p_section->p_data, p_data, 4000);
+  p_section->p_data[0] = 0x02;
+  p_section->b_syntax_indicator = true;
+  p_section->p_payload_end = p_section->p_data + 4000;
+  dvbpsi_CalculateCRC32(p_section);
+  for(i = 0; i < 1000; i++)
+  {
+    size_t i_offset = (i * 37) % 3990, i_size = 1 + i % 10;
+    uint8_t p_bytes[10];
+    for(size_t j = 0; j < i_size; j++)
+      p_bytes[j] = i * j;
+    if(!dvbpsi_PatchPSISection(p_section, i_offset, p_bytes, i_size)
+     || !dvbpsi_ValidPSISection(p_section))
+    {
+      printf("%-26s: offset %u size %u: bad CRC_32\n", "patch",
+             (unsigned)i_offset, (unsigned)i_size);
+      i_failed++;
+      break;
+    }
+  }
+  if(dvbpsi_PatchPSISection(p_section, 3999, p_data, 2))
+  {
+    printf("%-26s: CRC_32 field overwritten\n", "patch");
+    i_failed++;
+  }
+  dvbpsi_DeletePSISections(p_section);
+  printf("%-26s: %s\n", "shift and patch", i_failed ? "FAILED" : "ok");
+  i_errors += i_failed;
+
+  return i_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
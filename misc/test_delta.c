@@ -0,0 +1,227 @@
+/*****************************************************************************
+ * test_delta.c: table delta self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/tables/sdt.h"
+#include "../src/tables/eit.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/sdt.h>
+#include <dvbpsi/eit.h>
+#endif
+
+/*****************************************************************************
+ * SDT: sections of a SDT holding the services of pi_services, split into
+ * two sections after i_split services when i_split is not 0
+ *****************************************************************************/
+static dvbpsi_psi_section_t *SDT(uint16_t i_network_id, const uint16_t *pi_services,
+                                 int i_services, uint16_t i_modified, int i_split)
+{
+  dvbpsi_psi_section_t *p_sections = NULL, **pp_last = &p_sections;
+  int i_first = 0;
+
+  while(i_first < i_services)
+  {
+    int i_end = (i_split > i_first && i_split < i_services) ? i_split : i_services;
+    dvbpsi_sdt_t *p_sdt = dvbpsi_sdt_new(0x42, 1, 0, true, i_network_id);
+    int i;
+
+    if(p_sdt == NULL)
+      return NULL;
+    for(i = i_first; i < i_end; i++)
+    {
+      uint8_t p_data[4] = { 0x01, 0, 'T', 'V' };
+      dvbpsi_sdt_service_t *p_service;
+      p_service = dvbpsi_sdt_service_add(p_sdt, pi_services[i], false, true,
+                                         4, false);
+      if(pi_services[i] == i_modified)
+        p_data[2] = 'X';
+      if(p_service == NULL
+       || !dvbpsi_sdt_service_descriptor_add(p_service, 0x48, 4, p_data))
+        return NULL;
+    }
+
+    *pp_last = dvbpsi_sdt_sections_generate(NULL, p_sdt);
+    dvbpsi_sdt_delete(p_sdt);
+    if(*pp_last == NULL)
+      return NULL;
+    while(*pp_last)
+      pp_last = &(*pp_last)->p_next;
+    i_first = i_end;
+  }
+  return p_sections;
+}
+
+/*****************************************************************************
+ * EIT: sections of an EIT of 10 events, split into two sections of a same
+ * segment when b_split is true
+ *****************************************************************************/
+static dvbpsi_psi_section_t *EIT(bool b_split)
+{
+  dvbpsi_psi_section_t *p_sections = NULL, **pp_last = &p_sections;
+  int i_first = 0;
+
+  while(i_first < 10)
+  {
+    int i_end = b_split && i_first == 0 ? 5 : 10;
+    dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x50, 1, 0, true, 1, 2, 0, 0x50);
+    int i;
+
+    if(p_eit == NULL)
+      return NULL;
+    for(i = i_first; i < i_end; i++)
+    {
+      if(!dvbpsi_eit_event_add(p_eit, i, (uint64_t)i << 24, 0x003000, 1,
+                               false, 0))
+        return NULL;
+    }
+
+    *pp_last = dvbpsi_eit_sections_generate(NULL, p_eit, 0x50);
+    dvbpsi_eit_delete(p_eit);
+    if(*pp_last == NULL)
+      return NULL;
+    /* segment_last_section_number */
+    if(b_split)
+      (*pp_last)->p_payload_start[4] = 1;
+    while(*pp_last)
+      pp_last = &(*pp_last)->p_next;
+    i_first = i_end;
+  }
+  return p_sections;
+}
+
+/*****************************************************************************
+ * Delta: changes between the previous sections given to the decoder and
+ * these ones, as "added/removed/modified/table" or "none"
+ *****************************************************************************/
+static const char *Delta(dvbpsi_decoder_t *p_decoder, dvbpsi_arena_t *p_arena,
+                         dvbpsi_psi_section_t *p_sections)
+{
+  static char psz_delta[64];
+
+  if(p_sections == NULL)
+    return "error";
+
+  dvbpsi_delta_t *p_delta = dvbpsi_decoder_psi_sections_delta(p_decoder, p_arena,
+                                                              p_sections);
+  dvbpsi_DeletePSISections(p_sections);
+  if(p_delta == NULL)
+    return "none";
+
+  sprintf(psz_delta, "%d/%d/%d/%d", p_delta->i_added, p_delta->i_removed,
+          p_delta->i_modified, p_delta->b_table_changed);
+  return psz_delta;
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, const char *psz_value,
+                 const char *psz_expected)
+{
+  if(!strcmp(psz_value, psz_expected))
+    return 0;
+  printf("%-32s: %s instead of %s\n", psz_test, psz_value, psz_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Compare successive versions of a SDT: added, removed and modified
+ * services, a changed table field, and the same services spread over more
+ * sections, which is no change. Then the same split for an EIT, and
+ * sections too short to hold the fields of the table.
+ *****************************************************************************/
+int main(void)
+{
+  static const uint16_t pi_v0[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+  static const uint16_t pi_v1[] = { 1, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+  dvbpsi_arena_t *p_arena = dvbpsi_NewArena();
+  dvbpsi_decoder_t *p_decoder = dvbpsi_decoder_new(NULL, 0, true,
+                                                   sizeof(dvbpsi_decoder_t));
+  int i_failed = 0;
+
+  if(p_arena == NULL || p_decoder == NULL)
+    return EXIT_FAILURE;
+
+  i_failed += Check("sdt: first version",
+                    Delta(p_decoder, p_arena, SDT(1, pi_v0, 10, 0, 0)), "none");
+  i_failed += Check("sdt: services",
+                    Delta(p_decoder, p_arena, SDT(1, pi_v1, 10, 3, 0)), "1/1/1/0");
+  i_failed += Check("sdt: more sections",
+                    Delta(p_decoder, p_arena, SDT(1, pi_v1, 10, 3, 4)), "0/0/0/0");
+  i_failed += Check("sdt: other split",
+                    Delta(p_decoder, p_arena, SDT(1, pi_v1, 10, 3, 7)), "0/0/0/0");
+  i_failed += Check("sdt: network id",
+                    Delta(p_decoder, p_arena, SDT(2, pi_v1, 10, 3, 7)), "0/0/0/1");
+  i_failed += Check("sdt: back to one section",
+                    Delta(p_decoder, p_arena, SDT(2, pi_v1, 10, 0, 0)), "0/0/1/0");
+
+  /* Sections too short for the fields of a SDT */
+  dvbpsi_psi_section_t *p_short = dvbpsi_NewPSISection(9);
+  if(p_short == NULL)
+    return EXIT_FAILURE;
+  p_short->i_table_id = 0x42;
+  p_short->p_payload_start = p_short->p_data + 8;
+  p_short->p_payload_end = p_short->p_data + 9;
+  i_failed += Check("sdt: short section",
+                    Delta(p_decoder, p_arena, p_short), "0/10/0/1");
+  dvbpsi_decoder_delete(p_decoder);
+
+  p_decoder = dvbpsi_decoder_new(NULL, 0, true, sizeof(dvbpsi_decoder_t));
+  if(p_decoder == NULL)
+    return EXIT_FAILURE;
+  i_failed += Check("eit: first version",
+                    Delta(p_decoder, p_arena, EIT(false)), "none");
+  i_failed += Check("eit: two sections",
+                    Delta(p_decoder, p_arena, EIT(true)), "0/0/0/0");
+  i_failed += Check("eit: one section",
+                    Delta(p_decoder, p_arena, EIT(false)), "0/0/0/0");
+  dvbpsi_decoder_delete(p_decoder);
+  dvbpsi_DeleteArena(p_arena);
+
+  printf("%-32s: %s\n", "table delta", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,389 @@
+/*****************************************************************************
+ * test_demux.c: subtable demux self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/demux.h"
+#include "../src/descriptor.h"
+#include "../src/packetizer.h"
+#include "../src/tables/eit.h"
+#include "../src/tables/sdt.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/demux.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/eit.h>
+#include <dvbpsi/sdt.h>
+#endif
+
+#define SERVICES 20
+#define EVENTS   30
+
+typedef struct
+{
+  uint8_t *p_ts;
+  size_t   i_packets;
+} ts_t;
+
+static unsigned int i_tables;
+static unsigned int i_declined;
+static unsigned int i_events;
+static uint32_t     i_sum;
+
+/*****************************************************************************
+ * BuildTS: the EIT schedule 0x50 and 0x51 of SERVICES services on PID 0x12
+ *****************************************************************************/
+static bool BuildTS(dvbpsi_packetizer_t *p_packetizer, uint8_t i_version,
+                    ts_t *p_ts)
+{
+  uint8_t p_data[8] = { 'e', 'v', 'e', 'n', 't', 0, 0, 0 };
+  unsigned int i, j;
+
+  p_ts->p_ts = NULL;
+  p_ts->i_packets = 0;
+
+  for(i = 0; i < 2 * SERVICES; i++)
+  {
+    uint8_t i_table_id = 0x50 + i / SERVICES;
+    uint16_t i_service = 1 + i % SERVICES;
+    dvbpsi_eit_t *p_eit = dvbpsi_eit_new(i_table_id, i_service, i_version,
+                                         true, 1, 2, 0, 0x51);
+    if(p_eit == NULL)
+      return false;
+    for(j = 0; j < EVENTS; j++)
+    {
+      dvbpsi_eit_event_t *p_event;
+      p_event = dvbpsi_eit_event_add(p_eit, j, (uint64_t)j << 24, 0x003000,
+                                     1, false, 0);
+      if(p_event == NULL)
+        return false;
+      p_data[5] = i;
+      p_data[6] = j;
+      p_data[7] = i_version;
+      dvbpsi_eit_event_descriptor_add(p_event, 0x80, sizeof(p_data), p_data);
+    }
+
+    dvbpsi_psi_section_t *p_sections = dvbpsi_eit_sections_generate(NULL,
+                                                          p_eit, i_table_id);
+    dvbpsi_eit_delete(p_eit);
+    if(p_sections == NULL)
+      return false;
+
+    size_t i_packets = dvbpsi_packetizer_write(p_packetizer, 0x12, p_sections,
+                                               NULL, 0);
+    uint8_t *p_ts_new = realloc(p_ts->p_ts, 188 * (p_ts->i_packets + i_packets));
+    if(p_ts_new == NULL)
+      return false;
+    p_ts->p_ts = p_ts_new;
+    dvbpsi_packetizer_write(p_packetizer, 0x12, p_sections,
+                            p_ts->p_ts + 188 * p_ts->i_packets, i_packets);
+    p_ts->i_packets += i_packets;
+    dvbpsi_DeletePSISections(p_sections);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * EIT callback: count the tables and events, sum up what they hold
+ *****************************************************************************/
+static void EIT(void *p_data, dvbpsi_eit_t *p_eit)
+{
+  dvbpsi_eit_event_t *p_event;
+  (void)p_data;
+
+  i_tables++;
+  for(p_event = p_eit->p_first_event; p_event != NULL; p_event = p_event->p_next)
+  {
+    i_events++;
+    if(p_event->p_first_descriptor)
+      i_sum += p_event->p_first_descriptor->p_data[5] * 65536
+             + p_event->p_first_descriptor->p_data[6] * 256
+             + p_event->p_first_descriptor->p_data[7];
+  }
+  i_sum += (uint32_t)p_eit->i_table_id << 24 ^ p_eit->i_extension << 8
+         ^ p_eit->i_version;
+  dvbpsi_eit_delete(p_eit);
+}
+
+/*****************************************************************************
+ * SDT callback, never called on PID 0x12
+ *****************************************************************************/
+static void SDT(void *p_data, dvbpsi_sdt_t *p_sdt)
+{
+  (void)p_data;
+  dvbpsi_sdt_delete(p_sdt);
+}
+
+/*****************************************************************************
+ * NewSubtable: attach an EIT decoder to every EIT subtable
+ *****************************************************************************/
+static void NewSubtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                        uint16_t i_extension, void *p_data)
+{
+  (void)p_data;
+  if(i_table_id >= 0x4e && i_table_id <= 0x6f)
+    dvbpsi_eit_attach(p_dvbpsi, i_table_id, i_extension, EIT, NULL);
+}
+
+/*****************************************************************************
+ * Decline: attach nothing, count the calls
+ *****************************************************************************/
+static void Decline(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                    uint16_t i_extension, void *p_data)
+{
+  (void)p_dvbpsi;
+  (void)i_table_id;
+  (void)i_extension;
+  (void)p_data;
+  i_declined++;
+}
+
+/*****************************************************************************
+ * Push: push whole streams, return the number of tables they delivered
+ *****************************************************************************/
+static unsigned int Push(dvbpsi_t *p_dvbpsi, const ts_t *p_ts, int i_ts)
+{
+  unsigned int i_before = i_tables;
+  int i;
+
+  for(i = 0; i < i_ts; i++)
+    dvbpsi_packets_push(p_dvbpsi, p_ts[i].p_ts, p_ts[i].i_packets, 188, NULL);
+  return i_tables - i_before;
+}
+
+/*****************************************************************************
+ * PushEIT: push the EIT schedule 0x50 of a service, of one section holding an
+ * event whose descriptor has i_size bytes set to i_tag, return the number of
+ * tables it delivered
+ *****************************************************************************/
+static unsigned int PushEIT(dvbpsi_t *p_dvbpsi, dvbpsi_packetizer_t *p_packetizer,
+                            uint16_t i_service, uint8_t i_tag, size_t i_size,
+                            dvbpsi_push_stats_t *p_stats)
+{
+  unsigned int i_before = i_tables;
+  uint8_t p_data[255], p_ts[188 * 4];
+
+  memset(p_data, i_tag, sizeof(p_data));
+  dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x50, i_service, 0, true, 1, 2, 0, 0x50);
+  if(p_eit == NULL)
+    return 0;
+  dvbpsi_eit_event_t *p_event = dvbpsi_eit_event_add(p_eit, 1, 0, 0x003000, 1,
+                                                     false, 0);
+  if(p_event == NULL
+   || !dvbpsi_eit_event_descriptor_add(p_event, 0x80, i_size, p_data))
+  {
+    dvbpsi_eit_delete(p_eit);
+    return 0;
+  }
+
+  dvbpsi_psi_section_t *p_sections = dvbpsi_eit_sections_generate(NULL, p_eit, 0x50);
+  dvbpsi_eit_delete(p_eit);
+  size_t i_packets = dvbpsi_packetizer_write(p_packetizer, 0x12, p_sections,
+                                             p_ts, 4);
+  dvbpsi_DeletePSISections(p_sections);
+
+  dvbpsi_push_stats_t stats;
+  dvbpsi_packets_push(p_dvbpsi, p_ts, i_packets, 188, &stats);
+  p_stats->i_repeats += stats.i_repeats;
+  p_stats->i_changed += stats.i_changed;
+  return i_tables - i_before;
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, unsigned int i_value,
+                 unsigned int i_expected)
+{
+  if(i_value == i_expected)
+    return 0;
+  printf("%-32s: %u instead of %u\n", psz_test, i_value, i_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Decode the same EIT schedule twice in version 0, then in version 1, with
+ * one subtable decoder per subtable and with one family decoder, and
+ * compare the tables delivered. Then check that the declined subtables are
+ * only remembered on request, that a family gets the subtables the new
+ * subtable callback declined before it was attached, and that two families
+ * cannot share a table id. Finally check that the section cache drops the
+ * repeats of each subtable and lets a subtable changed without a version
+ * update be decoded again, with both kinds of decoders.
+ *****************************************************************************/
+int main(void)
+{
+  dvbpsi_packetizer_t *p_packetizer = dvbpsi_packetizer_new(true);
+  ts_t p_ts[3];
+  int i_failed = 0;
+  int i;
+
+  if(p_packetizer == NULL
+   || !BuildTS(p_packetizer, 0, &p_ts[0])
+   || !BuildTS(p_packetizer, 0, &p_ts[1])
+   || !BuildTS(p_packetizer, 1, &p_ts[2]))
+    return EXIT_FAILURE;
+  dvbpsi_packetizer_delete(p_packetizer);
+
+  /* One subtable decoder per subtable */
+  dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, NewSubtable, NULL))
+    return EXIT_FAILURE;
+  i_failed += Check("subtables: version 0", Push(p_dvbpsi, &p_ts[0], 1),
+                    2 * SERVICES);
+  i_failed += Check("subtables: repetition", Push(p_dvbpsi, &p_ts[1], 1), 0);
+  i_failed += Check("subtables: version 1", Push(p_dvbpsi, &p_ts[2], 1),
+                    2 * SERVICES);
+  dvbpsi_DetachDemux(p_dvbpsi);
+  dvbpsi_delete(p_dvbpsi);
+
+  unsigned int i_subtables_events = i_events;
+  uint32_t i_subtables_sum = i_sum;
+  i_tables = i_events = i_sum = 0;
+
+  /* One family decoder */
+  p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, Decline, NULL)
+   || !dvbpsi_eit_family_attach(p_dvbpsi, 0x4e, 0x6f, EIT, NULL))
+    return EXIT_FAILURE;
+  i_failed += Check("family: version 0", Push(p_dvbpsi, &p_ts[0], 1),
+                    2 * SERVICES);
+  i_failed += Check("family: repetition", Push(p_dvbpsi, &p_ts[1], 1), 0);
+  i_failed += Check("family: version 1", Push(p_dvbpsi, &p_ts[2], 1),
+                    2 * SERVICES);
+  i_failed += Check("family: events", i_events, i_subtables_events);
+  i_failed += Check("family: content", i_sum == i_subtables_sum, 1);
+
+  /* Families cannot overlap */
+  i_failed += Check("family: overlap",
+                    dvbpsi_sdt_family_attach(p_dvbpsi, 0x42, 0x4e, SDT, NULL), 0);
+  i_failed += Check("family: no overlap",
+                    dvbpsi_sdt_family_attach(p_dvbpsi, 0x42, 0x46, SDT, NULL), 1);
+  dvbpsi_sdt_family_detach(p_dvbpsi, 0x42);
+  dvbpsi_eit_family_detach(p_dvbpsi, 0x50);
+  dvbpsi_DetachDemux(p_dvbpsi);
+  dvbpsi_delete(p_dvbpsi);
+
+  /* Declined subtables are asked again by default */
+  p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, Decline, NULL))
+    return EXIT_FAILURE;
+  i_declined = 0;
+  Push(p_dvbpsi, &p_ts[0], 2);
+  i_failed += Check("declined: asked again", i_declined >= 4 * SERVICES, 1);
+  dvbpsi_DetachDemux(p_dvbpsi);
+  dvbpsi_delete(p_dvbpsi);
+
+  /* A family attached after the new subtable callback declined its
+     subtables */
+  p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(p_dvbpsi == NULL || !dvbpsi_AttachDemux(p_dvbpsi, Decline, NULL))
+    return EXIT_FAILURE;
+  dvbpsi_demux_remember_declined(p_dvbpsi, true);
+  i_declined = 0;
+  i_failed += Check("declined: no decoder", Push(p_dvbpsi, &p_ts[0], 1), 0);
+  i_failed += Check("declined: asked once", i_declined, 2 * SERVICES);
+  if(!dvbpsi_eit_family_attach(p_dvbpsi, 0x4e, 0x6f, EIT, NULL))
+    return EXIT_FAILURE;
+  i_failed += Check("declined: family", Push(p_dvbpsi, &p_ts[1], 2),
+                    4 * SERVICES);
+  dvbpsi_DetachDemux(p_dvbpsi);
+  dvbpsi_delete(p_dvbpsi);
+
+  for(i = 0; i < 3; i++)
+    free(p_ts[i].p_ts);
+
+  /* Section cache, with sections in one and in several packets */
+  for(i = 0; i < 4; i++)
+  {
+    bool b_family = i & 1;
+    size_t i_size = i & 2 ? 250 : 8;
+    dvbpsi_push_stats_t stats;
+    char psz_test[32];
+
+    p_packetizer = dvbpsi_packetizer_new(false);
+    p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    if(p_packetizer == NULL || p_dvbpsi == NULL
+     || !dvbpsi_AttachDemux(p_dvbpsi, b_family ? Decline : NewSubtable, NULL)
+     || (b_family && !dvbpsi_eit_family_attach(p_dvbpsi, 0x4e, 0x6f, EIT, NULL))
+     || !dvbpsi_decoder_section_cache(p_dvbpsi, true))
+      return EXIT_FAILURE;
+    memset(&stats, 0, sizeof(stats));
+    i_tables = 0;
+
+    /* Two subtables whose sections have the same number */
+    PushEIT(p_dvbpsi, p_packetizer, 1, 'a', i_size, &stats);
+    PushEIT(p_dvbpsi, p_packetizer, 2, 'a', i_size, &stats);
+    sprintf(psz_test, "cache %d: tables", i);
+    i_failed += Check(psz_test, i_tables, 2);
+
+    /* The first repetition is recorded, the next ones are dropped */
+    PushEIT(p_dvbpsi, p_packetizer, 1, 'a', i_size, &stats);
+    PushEIT(p_dvbpsi, p_packetizer, 2, 'a', i_size, &stats);
+    PushEIT(p_dvbpsi, p_packetizer, 1, 'a', i_size, &stats);
+    PushEIT(p_dvbpsi, p_packetizer, 2, 'a', i_size, &stats);
+    sprintf(psz_test, "cache %d: repeats", i);
+    i_failed += Check(psz_test, stats.i_repeats, 2);
+
+    /* A change without a version update is delivered once */
+    sprintf(psz_test, "cache %d: changed", i);
+    i_failed += Check(psz_test,
+                      PushEIT(p_dvbpsi, p_packetizer, 1, 'b', i_size, &stats), 1);
+    i_failed += Check(psz_test, stats.i_changed, 1);
+    sprintf(psz_test, "cache %d: changed repetition", i);
+    i_failed += Check(psz_test,
+                      PushEIT(p_dvbpsi, p_packetizer, 1, 'b', i_size, &stats)
+                    + PushEIT(p_dvbpsi, p_packetizer, 1, 'b', i_size, &stats)
+                    + PushEIT(p_dvbpsi, p_packetizer, 2, 'a', i_size, &stats), 0);
+
+    if(b_family)
+      dvbpsi_eit_family_detach(p_dvbpsi, 0x50);
+    dvbpsi_DetachDemux(p_dvbpsi);
+    dvbpsi_delete(p_dvbpsi);
+    dvbpsi_packetizer_delete(p_packetizer);
+  }
+
+  printf("%-32s: %s\n", "subtable and family decoders", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+/*****************************************************************************
+ * test_eit.c: EIT section and segment delivery self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/demux.h"
+#include "../src/descriptor.h"
+#include "../src/packetizer.h"
+#include "../src/tables/eit.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/demux.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/eit.h>
+#endif
+
+/* The subtables have two segments, sections 0 and 1, then 8 and 9 */
+#define LAST_SECTION 9
+
+/* What the callbacks got */
+typedef struct
+{
+  unsigned int i_tables;
+  unsigned int i_events;
+  uint16_t     i_event_ids;   /* one bit per event_id */
+  unsigned int i_complete;
+  uint8_t      i_version;     /* of the last complete subtable */
+} delivered_t;
+
+static delivered_t delivered;
+
+/*****************************************************************************
+ * EIT callback: count the tables and events
+ *****************************************************************************/
+static void EIT(void *p_data, dvbpsi_eit_t *p_eit)
+{
+  delivered_t *p_delivered = (delivered_t *)p_data;
+  dvbpsi_eit_event_t *p_event;
+
+  p_delivered->i_tables++;
+  for(p_event = p_eit->p_first_event; p_event != NULL; p_event = p_event->p_next)
+  {
+    p_delivered->i_events++;
+    p_delivered->i_event_ids |= 1 << p_event->i_event_id;
+  }
+  dvbpsi_eit_delete(p_eit);
+}
+
+/*****************************************************************************
+ * Complete callback: count the subtables whose events were all delivered
+ *****************************************************************************/
+static void Complete(void *p_data, uint8_t i_table_id, uint16_t i_extension,
+                     uint8_t i_version)
+{
+  delivered_t *p_delivered = (delivered_t *)p_data;
+  (void)i_table_id;
+  (void)i_extension;
+
+  p_delivered->i_complete++;
+  p_delivered->i_version = i_version;
+}
+
+/*****************************************************************************
+ * NewSubtable: attach an EIT decoder to every EIT subtable, its extension
+ * gives the delivery mode
+ *****************************************************************************/
+static void NewSubtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                        uint16_t i_extension, void *p_data)
+{
+  (void)p_data;
+  if(i_table_id == 0x50
+   && dvbpsi_eit_attach(p_dvbpsi, i_table_id, i_extension, EIT, &delivered))
+    dvbpsi_eit_delivery(p_dvbpsi, i_table_id, i_extension,
+                        (dvbpsi_eit_delivery_t)i_extension, Complete);
+}
+
+/*****************************************************************************
+ * Push: push the sections of an EIT schedule 0x50 whose numbers are listed
+ * in psz_numbers, each holding the event whose event_id is its number
+ *****************************************************************************/
+static void Push(dvbpsi_t *p_dvbpsi, dvbpsi_packetizer_t *p_packetizer,
+                 dvbpsi_eit_delivery_t i_delivery, uint8_t i_version,
+                 const char *psz_numbers)
+{
+  uint8_t p_ts[188 * 2];
+
+  for(; *psz_numbers; psz_numbers++)
+  {
+    uint8_t i_number = *psz_numbers - '0';
+    uint8_t i_segment_last = i_number < 8 ? 1 : LAST_SECTION;
+    dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x50, i_delivery, i_version, true,
+                                         1, 2, i_segment_last, 0x50);
+    if(p_eit == NULL)
+      return;
+    if(dvbpsi_eit_event_add(p_eit, i_number, (uint64_t)i_number << 24,
+                            0x003000, 1, false, 0) == NULL)
+    {
+      dvbpsi_eit_delete(p_eit);
+      return;
+    }
+
+    dvbpsi_psi_section_t *p_section = dvbpsi_eit_sections_generate(NULL, p_eit, 0x50);
+    dvbpsi_eit_delete(p_eit);
+    if(p_section == NULL)
+      return;
+
+    /* Renumber the section into its segment */
+    p_section->i_number = i_number;
+    p_section->i_last_number = LAST_SECTION;
+    p_section->p_data[12] = i_segment_last;
+    dvbpsi_BuildPSISection(NULL, p_section);
+
+    size_t i_packets = dvbpsi_packetizer_write(p_packetizer, 0x12, p_section,
+                                               p_ts, 2);
+    dvbpsi_DeletePSISections(p_section);
+    dvbpsi_packets_push(p_dvbpsi, p_ts, i_packets, 188, NULL);
+  }
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, unsigned int i_value,
+                 unsigned int i_expected)
+{
+  if(i_value == i_expected)
+    return 0;
+  printf("%-32s: %u instead of %u\n", psz_test, i_value, i_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Deliver an EIT subtable of two segments section by section, then segment
+ * by segment with a segment whose sections arrive out of order, and with a
+ * section lost in the first segment. Check that each section is delivered
+ * once per version, that a segment is delivered once all its sections are
+ * received, and that the subtable is only complete once every segment was
+ * delivered, the lost section coming with the next repetition.
+ *****************************************************************************/
+int main(void)
+{
+  dvbpsi_packetizer_t *p_packetizer = dvbpsi_packetizer_new(false);
+  dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  int i_failed = 0;
+
+  if(p_packetizer == NULL || p_dvbpsi == NULL
+   || !dvbpsi_AttachDemux(p_dvbpsi, NewSubtable, NULL))
+    return EXIT_FAILURE;
+
+  /* Section by section */
+  memset(&delivered, 0, sizeof(delivered));
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SECTION, 0, "0819");
+  i_failed += Check("section: tables", delivered.i_tables, 4);
+  i_failed += Check("section: events", delivered.i_events, 4);
+  i_failed += Check("section: event ids", delivered.i_event_ids, 0x303);
+  i_failed += Check("section: complete", delivered.i_complete, 1);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SECTION, 0, "0189");
+  i_failed += Check("section: repetition", delivered.i_tables, 4);
+  i_failed += Check("section: complete once", delivered.i_complete, 1);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SECTION, 1, "0189");
+  i_failed += Check("section: new version", delivered.i_tables, 8);
+  i_failed += Check("section: new version complete", delivered.i_complete, 2);
+  i_failed += Check("section: version", delivered.i_version, 1);
+
+  /* Segment by segment, the second one out of order */
+  memset(&delivered, 0, sizeof(delivered));
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "09");
+  i_failed += Check("segment: incomplete", delivered.i_tables, 0);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "8");
+  i_failed += Check("segment: out of order", delivered.i_tables, 1);
+  i_failed += Check("segment: out of order events", delivered.i_events, 2);
+  i_failed += Check("segment: out of order ids", delivered.i_event_ids, 0x300);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "1");
+  i_failed += Check("segment: tables", delivered.i_tables, 2);
+  i_failed += Check("segment: event ids", delivered.i_event_ids, 0x303);
+  i_failed += Check("segment: not complete yet", delivered.i_complete, 0);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "0189");
+  i_failed += Check("segment: repetition", delivered.i_tables, 2);
+  i_failed += Check("segment: complete", delivered.i_complete, 1);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "0189");
+  i_failed += Check("segment: complete once", delivered.i_complete, 1);
+
+  /* Section 1 is lost, its segment keeps the version open */
+  dvbpsi_eit_detach(p_dvbpsi, 0x50, DVBPSI_EIT_DELIVER_SEGMENT);
+  memset(&delivered, 0, sizeof(delivered));
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "089");
+  i_failed += Check("lost: tables", delivered.i_tables, 1);
+  i_failed += Check("lost: event ids", delivered.i_event_ids, 0x300);
+  i_failed += Check("lost: not complete", delivered.i_complete, 0);
+  Push(p_dvbpsi, p_packetizer, DVBPSI_EIT_DELIVER_SEGMENT, 0, "0189");
+  i_failed += Check("lost: next repetition", delivered.i_tables, 2);
+  i_failed += Check("lost: events", delivered.i_events, 4);
+  i_failed += Check("lost: event ids", delivered.i_event_ids, 0x303);
+  i_failed += Check("lost: complete", delivered.i_complete, 1);
+
+  dvbpsi_DetachDemux(p_dvbpsi);
+  dvbpsi_delete(p_dvbpsi);
+  dvbpsi_packetizer_delete(p_packetizer);
+
+  printf("%-32s: %s\n", "EIT delivery", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
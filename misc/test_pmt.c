@@ -0,0 +1,204 @@
+/*****************************************************************************
+ * test_pmt.c: shared PID PMT decoder self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/packetizer.h"
+#include "../src/tables/pmt.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/pmt.h>
+#endif
+
+#define PMT_PID  0x100
+#define PROGRAMS 2
+
+/* PMTs delivered to a callback, per program */
+typedef struct
+{
+  unsigned int p_tables[PROGRAMS + 1];
+  unsigned int i_version;   /* of the last PMT */
+} tables_t;
+
+static tables_t all, one;
+
+/*****************************************************************************
+ * PMT callback: count the tables of each program
+ *****************************************************************************/
+static void PMT(void *p_data, dvbpsi_pmt_t *p_pmt)
+{
+  tables_t *p_tables = (tables_t *)p_data;
+
+  if(p_pmt->i_program_number <= PROGRAMS)
+    p_tables->p_tables[p_pmt->i_program_number]++;
+  p_tables->i_version = p_pmt->i_version;
+  dvbpsi_pmt_delete(p_pmt);
+}
+
+/*****************************************************************************
+ * Push: push the PMT of programs 1 to PROGRAMS on PMT_PID, in version
+ * i_version. The packetizer keeps the continuity counter going, unless
+ * b_skip drops a packet first.
+ *****************************************************************************/
+static bool Push(dvbpsi_t *p_dvbpsi, dvbpsi_packetizer_t *p_packetizer,
+                 uint8_t i_version, bool b_skip)
+{
+  uint8_t p_ts[188 * 4];
+
+  for(uint16_t i_program = 1; i_program <= PROGRAMS; i_program++)
+  {
+    dvbpsi_pmt_t *p_pmt = dvbpsi_pmt_new(i_program, i_version, true,
+                                         0x100 + 0x10 * i_program);
+    if(p_pmt == NULL
+     || !dvbpsi_pmt_es_add(p_pmt, 0x02, 0x101 + 0x10 * i_program)
+     || !dvbpsi_pmt_es_add(p_pmt, 0x04, 0x102 + 0x10 * i_program))
+    {
+      dvbpsi_pmt_delete(p_pmt);
+      return false;
+    }
+
+    dvbpsi_psi_section_t *p_sections = dvbpsi_pmt_sections_generate(NULL, p_pmt);
+    dvbpsi_pmt_delete(p_pmt);
+    if(p_sections == NULL)
+      return false;
+
+    if(b_skip && i_program == 1)
+      dvbpsi_packetizer_write(p_packetizer, PMT_PID, p_sections, p_ts, 4);
+    size_t i_packets = dvbpsi_packetizer_write(p_packetizer, PMT_PID,
+                                               p_sections, p_ts, 4);
+    dvbpsi_DeletePSISections(p_sections);
+    dvbpsi_packets_push(p_dvbpsi, p_ts, i_packets, 188, NULL);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, unsigned int i_value,
+                 unsigned int i_expected)
+{
+  if(i_value == i_expected)
+    return 0;
+  printf("%-32s: %u instead of %u\n", psz_test, i_value, i_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Decode the PMTs of two programs carried on one PID with a single decoder.
+ * Check that both are delivered to the all programs callback, that a
+ * program taken over by its own callback is only delivered to it from its
+ * next version on and goes back to the all programs callback once its
+ * decoder is removed, and that a TS discontinuity makes every program be
+ * delivered again. Then check that without an all programs callback only
+ * the programs attached are decoded, and that detaching the decoder releases
+ * the handle with its programs.
+ *****************************************************************************/
+int main(void)
+{
+  dvbpsi_packetizer_t *p_packetizer = dvbpsi_packetizer_new(false);
+  dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  int i_failed = 0;
+
+  if(p_packetizer == NULL || p_dvbpsi == NULL
+   || !dvbpsi_pmt_programs_attach(p_dvbpsi, PMT, &all))
+    return EXIT_FAILURE;
+
+  /* Every program goes to the all programs callback */
+  Push(p_dvbpsi, p_packetizer, 0, false);
+  Push(p_dvbpsi, p_packetizer, 0, false);
+  i_failed += Check("all: program 1", all.p_tables[1], 1);
+  i_failed += Check("all: program 2", all.p_tables[2], 1);
+
+  /* Program 1 is taken over, its current version is not delivered again */
+  i_failed += Check("take over",
+                    dvbpsi_pmt_program_attach(p_dvbpsi, 1, PMT, &one), 1);
+  i_failed += Check("take over twice",
+                    dvbpsi_pmt_program_attach(p_dvbpsi, 1, PMT, &one), 0);
+  Push(p_dvbpsi, p_packetizer, 0, false);
+  i_failed += Check("take over: same version", one.p_tables[1], 0);
+  Push(p_dvbpsi, p_packetizer, 1, false);
+  i_failed += Check("take over: new version", one.p_tables[1], 1);
+  i_failed += Check("take over: version", one.i_version, 1);
+  i_failed += Check("take over: all program 1", all.p_tables[1], 1);
+  i_failed += Check("take over: all program 2", all.p_tables[2], 2);
+
+  /* A discontinuity found by the section of program 1 reaches program 2 */
+  Push(p_dvbpsi, p_packetizer, 1, true);
+  i_failed += Check("discontinuity: program 1", one.p_tables[1], 2);
+  i_failed += Check("discontinuity: program 2", all.p_tables[2], 3);
+  Push(p_dvbpsi, p_packetizer, 1, false);
+  i_failed += Check("discontinuity: repetition",
+                    one.p_tables[1] + all.p_tables[2], 5);
+
+  /* Program 1 goes back to the all programs callback */
+  dvbpsi_pmt_program_detach(p_dvbpsi, 1);
+  Push(p_dvbpsi, p_packetizer, 1, false);
+  i_failed += Check("detach: all program 1", all.p_tables[1], 2);
+  i_failed += Check("detach: one program 1", one.p_tables[1], 2);
+  i_failed += Check("detach: all program 2", all.p_tables[2], 3);
+
+  dvbpsi_pmt_programs_detach(p_dvbpsi);
+  i_failed += Check("programs detach", p_dvbpsi->p_decoder == NULL, 1);
+
+  /* Without an all programs callback, only program 2 is decoded */
+  memset(&all, 0, sizeof(all));
+  memset(&one, 0, sizeof(one));
+  if(!dvbpsi_pmt_programs_attach(p_dvbpsi, NULL, NULL)
+   || !dvbpsi_pmt_program_attach(p_dvbpsi, 2, PMT, &one))
+    return EXIT_FAILURE;
+  Push(p_dvbpsi, p_packetizer, 2, false);
+  i_failed += Check("programs: program 1", one.p_tables[1], 0);
+  i_failed += Check("programs: program 2", one.p_tables[2], 1);
+  dvbpsi_pmt_programs_detach(p_dvbpsi);
+  i_failed += Check("programs detach", p_dvbpsi->p_decoder == NULL, 1);
+
+  dvbpsi_delete(p_dvbpsi);
+  dvbpsi_packetizer_delete(p_packetizer);
+
+  printf("%-32s: %s\n", "shared PID PMT decoder", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
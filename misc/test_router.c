@@ -0,0 +1,298 @@
+/*****************************************************************************
+ * test_router.c: PID router self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/packetizer.h"
+#include "../src/router.h"
+#include "../src/tables/pat.h"
+#include "../src/tables/pmt.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/router.h>
+#include <dvbpsi/pat.h>
+#include <dvbpsi/pmt.h>
+#endif
+
+#define PMT_PID  0x100
+#define DATA_PID 0x200
+#define GROWN    8
+
+typedef struct
+{
+  dvbpsi_router_t *p_router;
+  dvbpsi_t        *p_pat;
+  dvbpsi_t        *p_pmt;
+  unsigned int     i_pat;
+  unsigned int     i_pmt;
+  unsigned int     i_self;
+  unsigned int     i_grow;
+  unsigned int     p_grown[GROWN];
+} test_t;
+
+static test_t test;
+
+/*****************************************************************************
+ * Write: append the packets of a list of sections to a block
+ *****************************************************************************/
+static bool Write(dvbpsi_packetizer_t *p_packetizer, uint16_t i_pid,
+                  dvbpsi_psi_section_t *p_sections, uint8_t **pp_ts,
+                  size_t *pi_packets)
+{
+  if(p_sections == NULL)
+    return false;
+
+  size_t i_packets = dvbpsi_packetizer_write(p_packetizer, i_pid, p_sections,
+                                             NULL, 0);
+  uint8_t *p_ts = realloc(*pp_ts, 188 * (*pi_packets + i_packets));
+  if(p_ts == NULL)
+  {
+    dvbpsi_DeletePSISections(p_sections);
+    return false;
+  }
+  dvbpsi_packetizer_write(p_packetizer, i_pid, p_sections,
+                          p_ts + 188 * *pi_packets, i_packets);
+  dvbpsi_DeletePSISections(p_sections);
+  *pp_ts = p_ts;
+  *pi_packets += i_packets;
+  return true;
+}
+
+/*****************************************************************************
+ * BuildTS: a block holding a PAT, the PMT it points to, three packets on
+ * DATA_PID, a packet without sync byte and a PAT of another version
+ *****************************************************************************/
+static bool BuildTS(uint8_t **pp_ts, size_t *pi_packets)
+{
+  dvbpsi_packetizer_t *p_packetizer = dvbpsi_packetizer_new(false);
+  dvbpsi_pat_t *p_pat = dvbpsi_pat_new(1, 0, true);
+  dvbpsi_pmt_t *p_pmt = dvbpsi_pmt_new(1, 0, true, 0x101);
+  bool b_ok = p_packetizer && p_pat && p_pmt
+           && dvbpsi_pat_program_add(p_pat, 1, PMT_PID)
+           && dvbpsi_pmt_es_add(p_pmt, 0x02, 0x101);
+
+  *pp_ts = NULL;
+  *pi_packets = 0;
+
+  b_ok = b_ok
+      && Write(p_packetizer, 0, dvbpsi_pat_sections_generate(NULL, p_pat, 253),
+               pp_ts, pi_packets)
+      && Write(p_packetizer, PMT_PID, dvbpsi_pmt_sections_generate(NULL, p_pmt),
+               pp_ts, pi_packets);
+
+  uint8_t *p_ts = b_ok ? realloc(*pp_ts, 188 * (*pi_packets + 4)) : NULL;
+  if(p_ts)
+  {
+    for(int i = 0; i < 4; i++)
+    {
+      uint8_t *p_packet = p_ts + 188 * (*pi_packets + i);
+      memset(p_packet, 0xff, 188);
+      p_packet[0] = i < 3 ? 0x47 : 0;
+      p_packet[1] = DATA_PID >> 8;
+      p_packet[2] = DATA_PID & 0xff;
+      p_packet[3] = 0x10 | i;
+    }
+    *pp_ts = p_ts;
+    *pi_packets += 4;
+  }
+  b_ok = p_ts != NULL;
+
+  if(b_ok)
+  {
+    p_pat->i_version = 1;
+    b_ok = Write(p_packetizer, 0, dvbpsi_pat_sections_generate(NULL, p_pat, 253),
+                 pp_ts, pi_packets);
+  }
+
+  dvbpsi_pmt_delete(p_pmt);
+  dvbpsi_pat_delete(p_pat);
+  dvbpsi_packetizer_delete(p_packetizer);
+  return b_ok;
+}
+
+/*****************************************************************************
+ * PMT callback: count the tables
+ *****************************************************************************/
+static void PMT(void *p_data, dvbpsi_pmt_t *p_pmt)
+{
+  test_t *p_test = (test_t *)p_data;
+  p_test->i_pmt++;
+  dvbpsi_pmt_delete(p_pmt);
+}
+
+/*****************************************************************************
+ * PAT callback: route the PMT PID to the PMT handle, in the middle of the
+ * block, and stop routing the PAT PID to the handle being called
+ *****************************************************************************/
+static void PAT(void *p_data, dvbpsi_pat_t *p_pat)
+{
+  test_t *p_test = (test_t *)p_data;
+  dvbpsi_pat_program_t *p_program;
+
+  p_test->i_pat++;
+  for(p_program = p_pat->p_first_program; p_program != NULL;
+      p_program = p_program->p_next)
+  {
+    if(p_program->i_number != 0)
+      dvbpsi_router_add(p_test->p_router, p_program->i_pid, p_test->p_pmt);
+  }
+  dvbpsi_router_remove(p_test->p_router, 0, p_test->p_pat);
+  dvbpsi_pat_delete(p_pat);
+}
+
+/*****************************************************************************
+ * Grown callback: count the packets of each callback added by Grow
+ *****************************************************************************/
+static void Grown(void *p_data, uint8_t *p_packet)
+{
+  (void)p_packet;
+  (*(unsigned int *)p_data)++;
+}
+
+/*****************************************************************************
+ * Self callback: stop routing DATA_PID to itself on its first packet
+ *****************************************************************************/
+static void Self(void *p_data, uint8_t *p_packet)
+{
+  test_t *p_test = (test_t *)p_data;
+  (void)p_packet;
+  p_test->i_self++;
+  dvbpsi_router_remove_callback(p_test->p_router, DATA_PID, Self, p_test);
+}
+
+/*****************************************************************************
+ * Grow callback: on its first packet, add enough callbacks to DATA_PID for
+ * its targets to be reallocated while they are being dispatched
+ *****************************************************************************/
+static void Grow(void *p_data, uint8_t *p_packet)
+{
+  test_t *p_test = (test_t *)p_data;
+  (void)p_packet;
+  if(p_test->i_grow++ == 0)
+  {
+    for(int i = 0; i < GROWN; i++)
+      dvbpsi_router_add_callback(p_test->p_router, DATA_PID, Grown,
+                                 &p_test->p_grown[i]);
+  }
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, unsigned int i_value,
+                 unsigned int i_expected)
+{
+  if(i_value == i_expected)
+    return 0;
+  printf("%-32s: %u instead of %u\n", psz_test, i_value, i_expected);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Push a block holding a PAT and its PMT through a router whose PAT
+ * callback routes the PMT PID and stops routing the PAT PID, and check that
+ * the PMT later in the same block is decoded and the second PAT is not.
+ * Then check that a callback removing itself and a callback adding targets
+ * to the PID being dispatched only change the targets of the next packets,
+ * and that the removed targets can be added again after the push.
+ *****************************************************************************/
+int main(void)
+{
+  dvbpsi_push_stats_t stats;
+  uint8_t *p_ts;
+  size_t i_packets;
+  int i_failed = 0;
+
+  if(!BuildTS(&p_ts, &i_packets))
+    return EXIT_FAILURE;
+
+  test.p_router = dvbpsi_router_new();
+  test.p_pat = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  test.p_pmt = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+  if(test.p_router == NULL || test.p_pat == NULL || test.p_pmt == NULL
+   || !dvbpsi_pat_attach(test.p_pat, PAT, &test)
+   || !dvbpsi_pmt_attach(test.p_pmt, 1, PMT, &test)
+   || !dvbpsi_router_add(test.p_router, 0, test.p_pat)
+   || !dvbpsi_router_add_callback(test.p_router, DATA_PID, Self, &test)
+   || !dvbpsi_router_add_callback(test.p_router, DATA_PID, Grow, &test))
+    return EXIT_FAILURE;
+
+  i_failed += Check("router: sync error",
+                    dvbpsi_router_push(test.p_router, p_ts, i_packets, 0, &stats), 0);
+  i_failed += Check("router: packets", stats.i_packets, i_packets);
+  i_failed += Check("router: ts errors", stats.i_ts_errors, 1);
+  i_failed += Check("router: sections", stats.i_sections, 2);
+  i_failed += Check("router: pat", test.i_pat, 1);
+  i_failed += Check("router: pmt added in the block", test.i_pmt, 1);
+  i_failed += Check("router: self removed", test.i_self, 1);
+  i_failed += Check("router: grow", test.i_grow, 3);
+  for(int i = 0; i < GROWN; i++)
+    i_failed += Check("router: grown", test.p_grown[i], 2);
+
+  /* The removed targets are gone, and can be added again */
+  dvbpsi_router_push(test.p_router, p_ts, i_packets, 188, &stats);
+  i_failed += Check("router: pat removed", test.i_pat, 1);
+  i_failed += Check("router: self removed again", test.i_self, 1);
+  i_failed += Check("router: pmt repetition", test.i_pmt, 1);
+  i_failed += Check("router: add again",
+                    dvbpsi_router_add_callback(test.p_router, DATA_PID, Self,
+                                               &test), 1);
+  i_failed += Check("router: add twice",
+                    dvbpsi_router_add_callback(test.p_router, DATA_PID, Self,
+                                               &test), 0);
+  dvbpsi_router_push(test.p_router, p_ts, i_packets, 188, &stats);
+  i_failed += Check("router: self added again", test.i_self, 2);
+
+  dvbpsi_router_delete(test.p_router);
+  dvbpsi_pmt_detach(test.p_pmt);
+  dvbpsi_pat_detach(test.p_pat);
+  dvbpsi_delete(test.p_pmt);
+  dvbpsi_delete(test.p_pat);
+  free(p_ts);
+
+  printf("%-32s: %s\n", "router", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
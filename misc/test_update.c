@@ -0,0 +1,213 @@
+/*****************************************************************************
+ * test_update.c: section cache self-test
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/tables/eit.h"
+#include "../src/tables/sdt.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/eit.h>
+#include <dvbpsi/sdt.h>
+#endif
+
+#define EVENTS 200
+
+/*****************************************************************************
+ * Same: whether two lists of sections hold the same bytes
+ *****************************************************************************/
+static bool Same(dvbpsi_psi_section_t *p_a, dvbpsi_psi_section_t *p_b)
+{
+  bool b_same = true;
+
+  while(p_a && p_b && b_same)
+  {
+    size_t i_size = p_a->p_payload_end - p_a->p_data + 4;
+    b_same = i_size == (size_t)(p_b->p_payload_end - p_b->p_data + 4)
+          && !memcmp(p_a->p_data, p_b->p_data, i_size);
+    p_a = p_a->p_next;
+    p_b = p_b->p_next;
+  }
+  return b_same && p_a == NULL && p_b == NULL;
+}
+
+/*****************************************************************************
+ * SameAsGenerated: whether the updated sections of an EIT are those its
+ * generator gives
+ *****************************************************************************/
+static bool SameAsGenerated(dvbpsi_psi_section_t *p_updated, dvbpsi_eit_t *p_eit)
+{
+  dvbpsi_psi_section_t *p_generated = dvbpsi_eit_sections_generate(NULL, p_eit,
+                                                                   0x50);
+  bool b_same = Same(p_updated, p_generated);
+  dvbpsi_DeletePSISections(p_generated);
+  return b_same;
+}
+
+/*****************************************************************************
+ * Carries: whether sections with valid CRC_32 carry the events of the EIT
+ *****************************************************************************/
+static bool Carries(dvbpsi_psi_section_t *p_section, dvbpsi_eit_t *p_eit)
+{
+  dvbpsi_eit_event_t *p_event = p_eit->p_first_event;
+  dvbpsi_descriptor_cursor_t cursor;
+
+  for(; p_section != NULL; p_section = p_section->p_next)
+  {
+    if(!dvbpsi_ValidPSISection(p_section)
+     || p_section->i_version != p_eit->i_version
+     || !dvbpsi_descriptor_cursor_init(&cursor, p_section))
+      return false;
+    while(dvbpsi_descriptor_cursor_next_entry(&cursor) != NULL)
+    {
+      if(p_event == NULL
+       || dvbpsi_descriptor_cursor_entry_id(&cursor) != p_event->i_event_id)
+        return false;
+      p_event = p_event->p_next;
+    }
+  }
+  return p_event == NULL;
+}
+
+/*****************************************************************************
+ * Check
+ *****************************************************************************/
+static int Check(const char *psz_test, bool b_ok)
+{
+  if(b_ok)
+    return 0;
+  printf("%-32s: FAILED\n", psz_test);
+  return 1;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************
+ * Compare the sections of dvbpsi_xxx_sections_update() with those of
+ * dvbpsi_xxx_sections_generate(): for a new table, after an event is edited
+ * in place and after a service is removed. Then remove an event of the
+ * first section of a large EIT and check that the other sections are kept.
+ *****************************************************************************/
+int main(void)
+{
+  uint8_t p_data[32];
+  int i_failed = 0;
+  int i;
+
+  memset(p_data, 'e', sizeof(p_data));
+
+  /* EIT of several sections */
+  dvbpsi_psi_section_cache_t *p_cache = dvbpsi_NewPSISectionCache();
+  dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x50, 1, 3, true, 1, 2, 0, 0x50);
+  if(p_cache == NULL || p_eit == NULL)
+    return EXIT_FAILURE;
+  for(i = 0; i < EVENTS; i++)
+  {
+    dvbpsi_eit_event_t *p_event = dvbpsi_eit_event_add(p_eit, i, (uint64_t)i << 24,
+                                                       0x003000, 1, false, 0);
+    if(p_event == NULL
+     || !dvbpsi_eit_event_descriptor_add(p_event, 0x80, sizeof(p_data), p_data))
+      return EXIT_FAILURE;
+  }
+
+  dvbpsi_psi_section_t *p_sections = dvbpsi_eit_sections_update(NULL, p_cache,
+                                                                p_eit, 0x50);
+  i_failed += Check("eit: new table", p_sections && p_sections->p_next
+                                   && p_eit->i_version == 3
+                                   && SameAsGenerated(p_sections, p_eit));
+
+  p_sections = dvbpsi_eit_sections_update(NULL, p_cache, p_eit, 0x50);
+  i_failed += Check("eit: no change", p_eit->i_version == 3
+                                   && SameAsGenerated(p_sections, p_eit));
+
+  dvbpsi_eit_event_t *p_edited = p_eit->p_first_event;
+  for(i = 0; i < EVENTS / 2; i++)
+    p_edited = p_edited->p_next;
+  p_edited->i_duration = 0x011500;
+  dvbpsi_PSISectionCacheChanged(p_cache, p_edited);
+  p_sections = dvbpsi_eit_sections_update(NULL, p_cache, p_eit, 0x50);
+  i_failed += Check("eit: edited event", p_eit->i_version == 4
+                                       && SameAsGenerated(p_sections, p_eit));
+
+  /* Remove the second event, the sections after the first one are kept */
+  dvbpsi_psi_section_t *p_second = p_sections->p_next;
+  p_eit->p_first_event->p_next = p_eit->p_first_event->p_next->p_next;
+  p_sections = dvbpsi_eit_sections_update(NULL, p_cache, p_eit, 0x50);
+  i_failed += Check("eit: removed event", p_sections
+                                        && p_sections->p_next == p_second
+                                        && p_eit->i_version == 5
+                                        && Carries(p_sections, p_eit));
+  dvbpsi_eit_delete(p_eit);
+  dvbpsi_DeletePSISectionCache(p_cache);
+
+  /* SDT of one section */
+  p_cache = dvbpsi_NewPSISectionCache();
+  dvbpsi_sdt_t *p_sdt = dvbpsi_sdt_new(0x42, 1, 0, true, 2);
+  if(p_cache == NULL || p_sdt == NULL)
+    return EXIT_FAILURE;
+  for(i = 0; i < 10; i++)
+  {
+    dvbpsi_sdt_service_t *p_service = dvbpsi_sdt_service_add(p_sdt, i + 1, false,
+                                                             true, 4, false);
+    if(p_service == NULL
+     || !dvbpsi_sdt_service_descriptor_add(p_service, 0x48, sizeof(p_data), p_data))
+      return EXIT_FAILURE;
+  }
+
+  p_sections = dvbpsi_sdt_sections_update(NULL, p_cache, p_sdt);
+  dvbpsi_psi_section_t *p_generated = dvbpsi_sdt_sections_generate(NULL, p_sdt);
+  i_failed += Check("sdt: new table", p_sections && Same(p_sections, p_generated));
+  dvbpsi_DeletePSISections(p_generated);
+
+  p_sdt->p_first_service->p_next = p_sdt->p_first_service->p_next->p_next;
+  p_sections = dvbpsi_sdt_sections_update(NULL, p_cache, p_sdt);
+  p_generated = dvbpsi_sdt_sections_generate(NULL, p_sdt);
+  i_failed += Check("sdt: removed service", p_sdt->i_version == 1 && p_sections
+                                          && Same(p_sections, p_generated));
+  dvbpsi_DeletePSISections(p_generated);
+  dvbpsi_sdt_delete(p_sdt);
+  dvbpsi_DeletePSISectionCache(p_cache);
+
+  printf("%-32s: %s\n", "section cache", i_failed ? "FAILED" : "ok");
+  return i_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
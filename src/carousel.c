@@ -0,0 +1,500 @@
+/*****************************************************************************
+ * carousel.c: PSI/SI carousel
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "packetizer.h"
+#include "carousel.h"
+
+/* Tokens are counted in bit.microseconds, a packet costs 188 * 8 bits */
+#define DVBPSI_CAROUSEL_PACKET_COST ((uint64_t)188 * 8 * 1000000)
+
+/*****************************************************************************
+ * dvbpsi_carousel_table_t
+ *****************************************************************************/
+typedef struct dvbpsi_carousel_table_s
+{
+    uint8_t     i_table_id;
+    uint16_t    i_extension;
+
+    uint64_t    i_interval;     /* repetition interval */
+    uint64_t    i_next;         /* next deadline */
+
+    uint8_t    *p_packets;      /* packets of the current version */
+    size_t      i_packets;
+    uint8_t    *p_pending;      /* next version, waiting for the current one
+                                   to be sent completely */
+    size_t      i_pending;
+
+    struct dvbpsi_carousel_table_s *p_next;
+} dvbpsi_carousel_table_t;
+
+/*****************************************************************************
+ * dvbpsi_carousel_pid_t
+ *****************************************************************************/
+typedef struct dvbpsi_carousel_pid_s
+{
+    uint16_t    i_pid;
+    uint8_t     i_cc;           /* next continuity_counter */
+
+    uint64_t    i_bitrate;      /* bit/s, 0 when unbounded */
+    uint64_t    i_depth;        /* capacity of the bucket */
+    uint64_t    i_credit;       /* tokens in the bucket */
+    uint64_t    i_time;         /* time of the last update of the bucket */
+
+    dvbpsi_carousel_table_t *p_current; /* table being sent, or NULL */
+    size_t      i_sent;         /* packets of p_current already sent */
+    uint64_t    i_deadline;     /* deadline of p_current */
+
+    dvbpsi_carousel_table_t *p_first_table;
+
+    struct dvbpsi_carousel_pid_s *p_next;
+} dvbpsi_carousel_pid_t;
+
+/*****************************************************************************
+ * dvbpsi_carousel_s
+ *****************************************************************************/
+struct dvbpsi_carousel_s
+{
+    dvbpsi_packetizer_t   *p_packetizer;
+    dvbpsi_carousel_pid_t *p_first_pid;
+
+    uint64_t    i_time;         /* time of the last dvbpsi_carousel_send() */
+};
+
+/*****************************************************************************
+ * dvbpsi_carousel_new
+ *****************************************************************************/
+dvbpsi_carousel_t *dvbpsi_carousel_new(const bool b_pack)
+{
+    dvbpsi_carousel_t *p_carousel
+                = (dvbpsi_carousel_t *)calloc(1, sizeof(dvbpsi_carousel_t));
+    if (p_carousel == NULL)
+        return NULL;
+
+    p_carousel->p_packetizer = dvbpsi_packetizer_new(b_pack);
+    if (p_carousel->p_packetizer == NULL)
+    {
+        free(p_carousel);
+        return NULL;
+    }
+    return p_carousel;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_delete
+ *****************************************************************************/
+void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel)
+{
+    if (p_carousel == NULL)
+        return;
+
+    dvbpsi_carousel_pid_t *p_pid = p_carousel->p_first_pid;
+    while (p_pid != NULL)
+    {
+        dvbpsi_carousel_table_t *p_table = p_pid->p_first_table;
+        while (p_table != NULL)
+        {
+            dvbpsi_carousel_table_t *p_next = p_table->p_next;
+            free(p_table->p_packets);
+            free(p_table->p_pending);
+            free(p_table);
+            p_table = p_next;
+        }
+
+        dvbpsi_carousel_pid_t *p_next = p_pid->p_next;
+        free(p_pid);
+        p_pid = p_next;
+    }
+
+    dvbpsi_packetizer_delete(p_carousel->p_packetizer);
+    free(p_carousel);
+}
+
+/*****************************************************************************
+ * dvbpsi_CarouselPid
+ *****************************************************************************
+ * Find the state of a PID, creating it if needed.
+ *****************************************************************************/
+static dvbpsi_carousel_pid_t *dvbpsi_CarouselPid(dvbpsi_carousel_t *p_carousel,
+                                                 const uint16_t i_pid, bool b_create)
+{
+    dvbpsi_carousel_pid_t *p_pid = p_carousel->p_first_pid;
+    for (; p_pid != NULL; p_pid = p_pid->p_next)
+    {
+        if (p_pid->i_pid == i_pid)
+            return p_pid;
+    }
+
+    if (!b_create)
+        return NULL;
+
+    p_pid = (dvbpsi_carousel_pid_t *)calloc(1, sizeof(dvbpsi_carousel_pid_t));
+    if (p_pid == NULL)
+        return NULL;
+
+    p_pid->i_pid = i_pid;
+    p_pid->p_next = p_carousel->p_first_pid;
+    p_carousel->p_first_pid = p_pid;
+    return p_pid;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_set
+ *****************************************************************************/
+bool dvbpsi_carousel_set(dvbpsi_carousel_t *p_carousel,
+                         const uint16_t i_pid, const uint8_t i_table_id,
+                         const uint16_t i_extension, const uint64_t i_interval,
+                         dvbpsi_psi_section_t *p_sections)
+{
+    assert(p_carousel);
+    assert(i_pid < 8192);
+
+    /* A table without interval would fill every buffer */
+    if (i_interval == 0)
+        return false;
+
+    size_t i_packets = dvbpsi_packetizer_write(p_carousel->p_packetizer, i_pid,
+                                               p_sections, NULL, 0);
+    if (i_packets == 0)
+        return false;
+
+    dvbpsi_carousel_pid_t *p_pid = dvbpsi_CarouselPid(p_carousel, i_pid, true);
+    if (p_pid == NULL)
+        return false;
+
+    uint8_t *p_packets = (uint8_t *)malloc(188 * i_packets);
+    if (p_packets == NULL)
+        return false;
+    dvbpsi_packetizer_write(p_carousel->p_packetizer, i_pid, p_sections,
+                            p_packets, i_packets);
+
+    dvbpsi_carousel_table_t *p_table = p_pid->p_first_table;
+    while (p_table != NULL && (p_table->i_table_id != i_table_id
+                               || p_table->i_extension != i_extension))
+        p_table = p_table->p_next;
+
+    if (p_table == NULL)
+    {
+        p_table = (dvbpsi_carousel_table_t *)calloc(1, sizeof(dvbpsi_carousel_table_t));
+        if (p_table == NULL)
+        {
+            free(p_packets);
+            return false;
+        }
+        p_table->i_table_id = i_table_id;
+        p_table->i_extension = i_extension;
+        p_table->p_next = p_pid->p_first_table;
+        p_pid->p_first_table = p_table;
+    }
+
+    if (p_pid->p_current == p_table)
+    {
+        free(p_table->p_pending);
+        p_table->p_pending = p_packets;
+        p_table->i_pending = i_packets;
+    }
+    else
+    {
+        free(p_table->p_packets);
+        p_table->p_packets = p_packets;
+        p_table->i_packets = i_packets;
+    }
+
+    p_table->i_interval = i_interval;
+    p_table->i_next = 0;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_remove
+ *****************************************************************************/
+void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                            const uint16_t i_pid, const uint8_t i_table_id,
+                            const uint16_t i_extension)
+{
+    assert(p_carousel);
+
+    dvbpsi_carousel_pid_t *p_pid = dvbpsi_CarouselPid(p_carousel, i_pid, false);
+    if (p_pid == NULL)
+        return;
+
+    dvbpsi_carousel_table_t **pp_table = &p_pid->p_first_table;
+    while (*pp_table != NULL)
+    {
+        dvbpsi_carousel_table_t *p_table = *pp_table;
+        if (p_table->i_table_id == i_table_id
+         && p_table->i_extension == i_extension)
+        {
+            *pp_table = p_table->p_next;
+            if (p_pid->p_current == p_table)
+                p_pid->p_current = NULL;
+            free(p_table->p_packets);
+            free(p_table->p_pending);
+            free(p_table);
+            return;
+        }
+        pp_table = &p_table->p_next;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_rate
+ *****************************************************************************/
+bool dvbpsi_carousel_rate(dvbpsi_carousel_t *p_carousel, const uint16_t i_pid,
+                          const uint32_t i_bitrate, const uint32_t i_burst)
+{
+    assert(p_carousel);
+    assert(i_pid < 8192);
+
+    dvbpsi_carousel_pid_t *p_pid = dvbpsi_CarouselPid(p_carousel, i_pid, true);
+    if (p_pid == NULL)
+        return false;
+
+    p_pid->i_bitrate = i_bitrate;
+    p_pid->i_depth = (i_burst > 0 ? i_burst : 1) * DVBPSI_CAROUSEL_PACKET_COST;
+    p_pid->i_credit = p_pid->i_depth;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_CarouselCredit
+ *****************************************************************************
+ * Fill the bucket of a PID with the tokens earned since its last update.
+ *****************************************************************************/
+static void dvbpsi_CarouselCredit(dvbpsi_carousel_pid_t *p_pid, const uint64_t i_time)
+{
+    if (p_pid->i_bitrate == 0)
+        return;
+
+    if (i_time > p_pid->i_time)
+    {
+        uint64_t i_room = p_pid->i_depth - p_pid->i_credit;
+        uint64_t i_elapsed = i_time - p_pid->i_time;
+        if (i_elapsed > i_room / p_pid->i_bitrate)
+            p_pid->i_credit = p_pid->i_depth;
+        else
+            p_pid->i_credit += i_elapsed * p_pid->i_bitrate;
+    }
+    p_pid->i_time = i_time;
+}
+
+/*****************************************************************************
+ * dvbpsi_CarouselRebaseTime
+ *****************************************************************************
+ * Deadline on the new time base, keeping its distance to the previous time.
+ * A deadline already past is due at once.
+ *****************************************************************************/
+static inline uint64_t dvbpsi_CarouselRebaseTime(const uint64_t i_deadline,
+                                                 const uint64_t i_old,
+                                                 const uint64_t i_time)
+{
+    return i_deadline > i_old ? i_time + (i_deadline - i_old) : i_time;
+}
+
+/*****************************************************************************
+ * dvbpsi_CarouselRebase
+ *****************************************************************************
+ * Move all the deadlines to a clock that went backwards, for instance a
+ * wrapping PCR.
+ *****************************************************************************/
+static void dvbpsi_CarouselRebase(dvbpsi_carousel_t *p_carousel, const uint64_t i_time)
+{
+    const uint64_t i_old = p_carousel->i_time;
+
+    dvbpsi_carousel_pid_t *p_pid = p_carousel->p_first_pid;
+    for (; p_pid != NULL; p_pid = p_pid->p_next)
+    {
+        p_pid->i_deadline = dvbpsi_CarouselRebaseTime(p_pid->i_deadline, i_old, i_time);
+        /* The bucket keeps its tokens and fills up again from now on */
+        p_pid->i_time = i_time;
+
+        dvbpsi_carousel_table_t *p_table = p_pid->p_first_table;
+        for (; p_table != NULL; p_table = p_table->p_next)
+            p_table->i_next = dvbpsi_CarouselRebaseTime(p_table->i_next, i_old, i_time);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_CarouselDue
+ *****************************************************************************
+ * Table of the PID with the earliest deadline, or NULL if the PID has none
+ * due at i_time.
+ *****************************************************************************/
+static dvbpsi_carousel_table_t *dvbpsi_CarouselDue(dvbpsi_carousel_pid_t *p_pid,
+                                                   const uint64_t i_time)
+{
+    dvbpsi_carousel_table_t *p_due = NULL;
+    dvbpsi_carousel_table_t *p_table = p_pid->p_first_table;
+    for (; p_table != NULL; p_table = p_table->p_next)
+    {
+        if (p_table->i_next <= i_time
+         && (p_due == NULL || p_table->i_next < p_due->i_next))
+            p_due = p_table;
+    }
+    return p_due;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_send
+ *****************************************************************************/
+size_t dvbpsi_carousel_send(dvbpsi_carousel_t *p_carousel, const uint64_t i_time,
+                            uint8_t *p_buffer, const size_t i_packets)
+{
+    assert(p_carousel);
+
+    if (i_time < p_carousel->i_time)
+        dvbpsi_CarouselRebase(p_carousel, i_time);
+    p_carousel->i_time = i_time;
+
+    dvbpsi_carousel_pid_t *p_pid = p_carousel->p_first_pid;
+    for (; p_pid != NULL; p_pid = p_pid->p_next)
+        dvbpsi_CarouselCredit(p_pid, i_time);
+
+    size_t i_written = 0;
+    while (i_written < i_packets)
+    {
+        /* Pick the PID whose next packet has the earliest deadline */
+        dvbpsi_carousel_pid_t *p_best = NULL;
+        dvbpsi_carousel_table_t *p_best_table = NULL;
+        uint64_t i_best = 0;
+
+        for (p_pid = p_carousel->p_first_pid; p_pid != NULL; p_pid = p_pid->p_next)
+        {
+            if (p_pid->i_bitrate != 0
+             && p_pid->i_credit < DVBPSI_CAROUSEL_PACKET_COST)
+                continue;
+
+            dvbpsi_carousel_table_t *p_table = p_pid->p_current;
+            uint64_t i_deadline = p_pid->i_deadline;
+            if (p_table == NULL)
+            {
+                p_table = dvbpsi_CarouselDue(p_pid, i_time);
+                if (p_table == NULL)
+                    continue;
+                i_deadline = p_table->i_next;
+            }
+
+            if (p_best == NULL || i_deadline < i_best)
+            {
+                p_best = p_pid;
+                p_best_table = p_table;
+                i_best = i_deadline;
+            }
+        }
+
+        if (p_best == NULL)
+            break;
+
+        /* Start a new round of the table */
+        if (p_best->p_current == NULL)
+        {
+            uint64_t i_next = p_best_table->i_next + p_best_table->i_interval;
+            p_best->p_current = p_best_table;
+            p_best->i_sent = 0;
+            p_best->i_deadline = p_best_table->i_next;
+            p_best_table->i_next = i_next > i_time ? i_next
+                                                   : i_time + p_best_table->i_interval;
+        }
+
+        uint8_t *p_packet = p_buffer + 188 * i_written++;
+        memcpy(p_packet, p_best_table->p_packets + 188 * p_best->i_sent, 188);
+        p_packet[3] = (p_packet[3] & 0xf0) | p_best->i_cc;
+        p_best->i_cc = (p_best->i_cc + 1) & 0x0f;
+        if (p_best->i_bitrate != 0)
+            p_best->i_credit -= DVBPSI_CAROUSEL_PACKET_COST;
+
+        if (++p_best->i_sent == p_best_table->i_packets)
+        {
+            p_best->p_current = NULL;
+            if (p_best_table->p_pending != NULL)
+            {
+                free(p_best_table->p_packets);
+                p_best_table->p_packets = p_best_table->p_pending;
+                p_best_table->i_packets = p_best_table->i_pending;
+                p_best_table->p_pending = NULL;
+            }
+        }
+    }
+
+    return i_written;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_next
+ *****************************************************************************/
+uint64_t dvbpsi_carousel_next(dvbpsi_carousel_t *p_carousel)
+{
+    assert(p_carousel);
+
+    uint64_t i_next = DVBPSI_CAROUSEL_NEVER;
+    dvbpsi_carousel_pid_t *p_pid = p_carousel->p_first_pid;
+    for (; p_pid != NULL; p_pid = p_pid->p_next)
+    {
+        uint64_t i_time = DVBPSI_CAROUSEL_NEVER;
+        if (p_pid->p_current != NULL)
+            i_time = 0;
+        else
+        {
+            dvbpsi_carousel_table_t *p_table = p_pid->p_first_table;
+            for (; p_table != NULL; p_table = p_table->p_next)
+            {
+                if (p_table->i_next < i_time)
+                    i_time = p_table->i_next;
+            }
+        }
+        if (i_time == DVBPSI_CAROUSEL_NEVER)
+            continue;
+
+        /* Wait for the bucket to hold a packet */
+        if (p_pid->i_bitrate != 0
+         && p_pid->i_credit < DVBPSI_CAROUSEL_PACKET_COST)
+        {
+            uint64_t i_missing = DVBPSI_CAROUSEL_PACKET_COST - p_pid->i_credit;
+            uint64_t i_ready = p_pid->i_time
+                             + (i_missing + p_pid->i_bitrate - 1) / p_pid->i_bitrate;
+            if (i_ready > i_time)
+                i_time = i_ready;
+        }
+
+        if (i_time < i_next)
+            i_next = i_time;
+    }
+
+    return i_next;
+}
@@ -0,0 +1,203 @@
+/*****************************************************************************
+ * carousel.h
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <carousel.h>
+ * \brief PSI/SI carousel.
+ *
+ * Repeated transmission of generated tables as TS packets, each table at
+ * its own repetition interval (ETSI TR 101 211 section 4.4), with the
+ * bitrate of every PID bounded by a token bucket.
+ */
+
+#ifndef _DVBPSI_CAROUSEL_H_
+#define _DVBPSI_CAROUSEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * DVBPSI_CAROUSEL_NEVER
+ *****************************************************************************/
+/*!
+ * \def DVBPSI_CAROUSEL_NEVER
+ * \brief Time returned by dvbpsi_carousel_next() when there is nothing to
+ * send.
+ */
+#define DVBPSI_CAROUSEL_NEVER ((uint64_t)-1)
+
+/*****************************************************************************
+ * dvbpsi_carousel_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_carousel_s dvbpsi_carousel_t
+ * \brief Opaque PSI/SI carousel.
+ *
+ * A carousel holds the TS packets of the current version of every table
+ * it carries. Times are given in microseconds, for instance on the
+ * wall-clock or as the PCR divided by 27. A time earlier than the one of
+ * the previous dvbpsi_carousel_send() call, as when the PCR wraps, is taken
+ * as a new time base: the pending deadlines are moved to it, keeping their
+ * distance to the previous time. dvbpsi_carousel_next() answers on the
+ * time base of the last dvbpsi_carousel_send() call.
+ *
+ * The packets of a table are sent one after the other, and a table that
+ * has started is finished before another one starts on the same PID.
+ * Among the PIDs allowed to send, the table that has waited longest past
+ * its deadline goes first.
+ */
+typedef struct dvbpsi_carousel_s dvbpsi_carousel_t;
+
+/*****************************************************************************
+ * dvbpsi_carousel_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_carousel_t *dvbpsi_carousel_new(const bool b_pack)
+ * \brief Creation of a new carousel.
+ * \param b_pack true to pack the sections of a table into as few packets
+ * as possible, see dvbpsi_packetizer_new()
+ * \return a pointer to the carousel or NULL on error.
+ */
+dvbpsi_carousel_t *dvbpsi_carousel_new(const bool b_pack);
+
+/*****************************************************************************
+ * dvbpsi_carousel_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel)
+ * \brief Destruction of a carousel and of all the tables it holds.
+ * \param p_carousel pointer to the carousel
+ * \return nothing.
+ */
+void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel);
+
+/*****************************************************************************
+ * dvbpsi_carousel_set
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_carousel_set(dvbpsi_carousel_t *p_carousel,
+                                const uint16_t i_pid, const uint8_t i_table_id,
+                                const uint16_t i_extension,
+                                const uint64_t i_interval,
+                                dvbpsi_psi_section_t *p_sections)
+ * \brief Add a table to the carousel or replace its current version.
+ * \param p_carousel pointer to the carousel
+ * \param i_pid PID carrying the table
+ * \param i_table_id table_id of the table
+ * \param i_extension table_id_extension of the table, 0 if it has none
+ * \param i_interval repetition interval in microseconds, at least 1
+ * \param p_sections sections of the table, as returned by the
+ * dvbpsi_xxx_sections_generate() functions
+ * \return true on success, false on error or if i_interval is 0.
+ *
+ * The sections are packetized at once and may be deleted by the caller
+ * when this function returns. The new version is due immediately; if the
+ * previous version is being sent, it is finished first.
+ */
+bool dvbpsi_carousel_set(dvbpsi_carousel_t *p_carousel,
+                         const uint16_t i_pid, const uint8_t i_table_id,
+                         const uint16_t i_extension, const uint64_t i_interval,
+                         dvbpsi_psi_section_t *p_sections);
+
+/*****************************************************************************
+ * dvbpsi_carousel_remove
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                                   const uint16_t i_pid,
+                                   const uint8_t i_table_id,
+                                   const uint16_t i_extension)
+ * \brief Remove a table from the carousel.
+ * \param p_carousel pointer to the carousel
+ * \param i_pid PID carrying the table
+ * \param i_table_id table_id of the table
+ * \param i_extension table_id_extension of the table
+ * \return nothing.
+ *
+ * A table being sent is dropped in the middle, receivers discard its
+ * incomplete section.
+ */
+void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                            const uint16_t i_pid, const uint8_t i_table_id,
+                            const uint16_t i_extension);
+
+/*****************************************************************************
+ * dvbpsi_carousel_rate
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_carousel_rate(dvbpsi_carousel_t *p_carousel,
+                                 const uint16_t i_pid,
+                                 const uint32_t i_bitrate,
+                                 const uint32_t i_burst)
+ * \brief Bound the bitrate of a PID.
+ * \param p_carousel pointer to the carousel
+ * \param i_pid PID to bound
+ * \param i_bitrate long term bitrate of the PID in bit/s, 0 for no bound
+ * \param i_burst number of packets the PID may send back to back after
+ * being idle, at least 1
+ * \return true on success, false on error.
+ *
+ * The PID earns the right to send one packet every 1504 / i_bitrate
+ * seconds, and saves up to i_burst of them.
+ */
+bool dvbpsi_carousel_rate(dvbpsi_carousel_t *p_carousel, const uint16_t i_pid,
+                          const uint32_t i_bitrate, const uint32_t i_burst);
+
+/*****************************************************************************
+ * dvbpsi_carousel_send
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_carousel_send(dvbpsi_carousel_t *p_carousel,
+                                   const uint64_t i_time,
+                                   uint8_t *p_buffer, const size_t i_packets)
+ * \brief Write the packets due at a given time.
+ * \param p_carousel pointer to the carousel
+ * \param i_time current time in microseconds
+ * \param p_buffer buffer receiving the 188 byte packets
+ * \param i_packets number of packets the buffer can hold
+ * \return the number of packets written.
+ *
+ * Packets that do not fit in the buffer, or that the bitrate of their PID
+ * does not allow yet, are sent by a later call.
+ */
+size_t dvbpsi_carousel_send(dvbpsi_carousel_t *p_carousel, const uint64_t i_time,
+                            uint8_t *p_buffer, const size_t i_packets);
+
+/*****************************************************************************
+ * dvbpsi_carousel_next
+ *****************************************************************************/
+/*!
+ * \fn uint64_t dvbpsi_carousel_next(dvbpsi_carousel_t *p_carousel)
+ * \brief Time of the next packet.
+ * \param p_carousel pointer to the carousel
+ * \return the earliest time in microseconds at which dvbpsi_carousel_send()
+ * has a packet to write, or DVBPSI_CAROUSEL_NEVER if the carousel is empty.
+ */
+uint64_t dvbpsi_carousel_next(dvbpsi_carousel_t *p_carousel);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of carousel.h"
+#endif
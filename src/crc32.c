@@ -0,0 +1,1513 @@
+/*****************************************************************************
+ * crc32.c: CRC_32 computation
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2012 VideoLAN
+ * $Id$
+ *
+ * Authors: Arnaud de Bossoreille de Ribou <bozo@via.ecp.fr>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#   define DVBPSI_CRC32_HAVE_PCLMUL
+#   include <cpuid.h>
+#   include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#   define DVBPSI_CRC32_HAVE_PMULL
+#   include <arm_neon.h>
+#endif
+
+#include "dvbpsi.h"
+#include "psi.h"
+
+/*****************************************************************************
+ * dvbpsi_crc32_table
+ *****************************************************************************
+ * These tables are used to compute a PSI CRC byte per byte or several bytes
+ * at a time instead of bit per bit. They've been generated by 'gen_crc' in
+ * the 'misc' directory. dvbpsi_crc32_table[0] is the byte per byte table:
+ *
+ *   uint32_t table[256];
+ *   uint32_t i, j, k;
+ *
+ *   for(i = 0; i < 256; i++)
+ *   {
+ *     k = 0;
+ *     for (j = (i << 24) | 0x800000; j != 0x80000000; j <<= 1)
+ *       k = (k << 1) ^ (((k ^ j) & 0x80000000) ? 0x04c11db7 : 0);
+ *     table[i] = k;
+ *   }
+ *
+ * A CRC is computed like this:
+ *
+ *   initialization
+ *   --------------
+ *   uint32_t i_crc = 0xffffffff;
+ *
+ *   for each data byte do
+ *   ---------------------
+ *   i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[0][(i_crc >> 24) ^ (data_byte)];
+ *
+ * dvbpsi_crc32_table[n] is the CRC_32 of a byte followed by n zero bytes,
+ * which lets the slicing-by-8 and slicing-by-16 loops handle 8 or 16 bytes
+ * with independent lookups. The DVBPSI_CRC32_X* constants are x^n modulo
+ * the polynomial and are used to fold 128 bit blocks with carry-less
+ * multiplications.
+ *****************************************************************************/
+static const uint32_t dvbpsi_crc32_table[16][256] =
+{
+  {
+    0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9,
+    0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005,
+    0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
+    0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd,
+    0x4c11db70, 0x48d0c6c7, 0x4593e01e, 0x4152fda9,
+    0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
+    0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011,
+    0x791d4014, 0x7ddc5da3, 0x709f7b7a, 0x745e66cd,
+    0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
+    0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5,
+    0xbe2b5b58, 0xbaea46ef, 0xb7a96036, 0xb3687d81,
+    0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
+    0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49,
+    0xc7361b4c, 0xc3f706fb, 0xceb42022, 0xca753d95,
+    0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
+    0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d,
+    0x34867077, 0x30476dc0, 0x3d044b19, 0x39c556ae,
+    0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
+    0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16,
+    0x018aeb13, 0x054bf6a4, 0x0808d07d, 0x0cc9cdca,
+    0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
+    0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02,
+    0x5e9f46bf, 0x5a5e5b08, 0x571d7dd1, 0x53dc6066,
+    0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
+    0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e,
+    0xbfa1b04b, 0xbb60adfc, 0xb6238b25, 0xb2e29692,
+    0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
+    0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a,
+    0xe0b41de7, 0xe4750050, 0xe9362689, 0xedf73b3e,
+    0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
+    0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686,
+    0xd5b88683, 0xd1799b34, 0xdc3abded, 0xd8fba05a,
+    0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
+    0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb,
+    0x4f040d56, 0x4bc510e1, 0x46863638, 0x42472b8f,
+    0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
+    0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47,
+    0x36194d42, 0x32d850f5, 0x3f9b762c, 0x3b5a6b9b,
+    0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
+    0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623,
+    0xf12f560e, 0xf5ee4bb9, 0xf8ad6d60, 0xfc6c70d7,
+    0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
+    0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f,
+    0xc423cd6a, 0xc0e2d0dd, 0xcda1f604, 0xc960ebb3,
+    0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
+    0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b,
+    0x9b3660c6, 0x9ff77d71, 0x92b45ba8, 0x9675461f,
+    0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
+    0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640,
+    0x4e8ee645, 0x4a4ffbf2, 0x470cdd2b, 0x43cdc09c,
+    0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
+    0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24,
+    0x119b4be9, 0x155a565e, 0x18197087, 0x1cd86d30,
+    0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
+    0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088,
+    0x2497d08d, 0x2056cd3a, 0x2d15ebe3, 0x29d4f654,
+    0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
+    0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c,
+    0xe3a1cbc1, 0xe760d676, 0xea23f0af, 0xeee2ed18,
+    0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
+    0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0,
+    0x9abc8bd5, 0x9e7d9662, 0x933eb0bb, 0x97ffad0c,
+    0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
+    0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
+  },
+  {
+    0x00000000, 0xd219c1dc, 0xa0f29e0f, 0x72eb5fd3,
+    0x452421a9, 0x973de075, 0xe5d6bfa6, 0x37cf7e7a,
+    0x8a484352, 0x5851828e, 0x2abadd5d, 0xf8a31c81,
+    0xcf6c62fb, 0x1d75a327, 0x6f9efcf4, 0xbd873d28,
+    0x10519b13, 0xc2485acf, 0xb0a3051c, 0x62bac4c0,
+    0x5575baba, 0x876c7b66, 0xf58724b5, 0x279ee569,
+    0x9a19d841, 0x4800199d, 0x3aeb464e, 0xe8f28792,
+    0xdf3df9e8, 0x0d243834, 0x7fcf67e7, 0xadd6a63b,
+    0x20a33626, 0xf2baf7fa, 0x8051a829, 0x524869f5,
+    0x6587178f, 0xb79ed653, 0xc5758980, 0x176c485c,
+    0xaaeb7574, 0x78f2b4a8, 0x0a19eb7b, 0xd8002aa7,
+    0xefcf54dd, 0x3dd69501, 0x4f3dcad2, 0x9d240b0e,
+    0x30f2ad35, 0xe2eb6ce9, 0x9000333a, 0x4219f2e6,
+    0x75d68c9c, 0xa7cf4d40, 0xd5241293, 0x073dd34f,
+    0xbabaee67, 0x68a32fbb, 0x1a487068, 0xc851b1b4,
+    0xff9ecfce, 0x2d870e12, 0x5f6c51c1, 0x8d75901d,
+    0x41466c4c, 0x935fad90, 0xe1b4f243, 0x33ad339f,
+    0x04624de5, 0xd67b8c39, 0xa490d3ea, 0x76891236,
+    0xcb0e2f1e, 0x1917eec2, 0x6bfcb111, 0xb9e570cd,
+    0x8e2a0eb7, 0x5c33cf6b, 0x2ed890b8, 0xfcc15164,
+    0x5117f75f, 0x830e3683, 0xf1e56950, 0x23fca88c,
+    0x1433d6f6, 0xc62a172a, 0xb4c148f9, 0x66d88925,
+    0xdb5fb40d, 0x094675d1, 0x7bad2a02, 0xa9b4ebde,
+    0x9e7b95a4, 0x4c625478, 0x3e890bab, 0xec90ca77,
+    0x61e55a6a, 0xb3fc9bb6, 0xc117c465, 0x130e05b9,
+    0x24c17bc3, 0xf6d8ba1f, 0x8433e5cc, 0x562a2410,
+    0xebad1938, 0x39b4d8e4, 0x4b5f8737, 0x994646eb,
+    0xae893891, 0x7c90f94d, 0x0e7ba69e, 0xdc626742,
+    0x71b4c179, 0xa3ad00a5, 0xd1465f76, 0x035f9eaa,
+    0x3490e0d0, 0xe689210c, 0x94627edf, 0x467bbf03,
+    0xfbfc822b, 0x29e543f7, 0x5b0e1c24, 0x8917ddf8,
+    0xbed8a382, 0x6cc1625e, 0x1e2a3d8d, 0xcc33fc51,
+    0x828cd898, 0x50951944, 0x227e4697, 0xf067874b,
+    0xc7a8f931, 0x15b138ed, 0x675a673e, 0xb543a6e2,
+    0x08c49bca, 0xdadd5a16, 0xa83605c5, 0x7a2fc419,
+    0x4de0ba63, 0x9ff97bbf, 0xed12246c, 0x3f0be5b0,
+    0x92dd438b, 0x40c48257, 0x322fdd84, 0xe0361c58,
+    0xd7f96222, 0x05e0a3fe, 0x770bfc2d, 0xa5123df1,
+    0x189500d9, 0xca8cc105, 0xb8679ed6, 0x6a7e5f0a,
+    0x5db12170, 0x8fa8e0ac, 0xfd43bf7f, 0x2f5a7ea3,
+    0xa22feebe, 0x70362f62, 0x02dd70b1, 0xd0c4b16d,
+    0xe70bcf17, 0x35120ecb, 0x47f95118, 0x95e090c4,
+    0x2867adec, 0xfa7e6c30, 0x889533e3, 0x5a8cf23f,
+    0x6d438c45, 0xbf5a4d99, 0xcdb1124a, 0x1fa8d396,
+    0xb27e75ad, 0x6067b471, 0x128ceba2, 0xc0952a7e,
+    0xf75a5404, 0x254395d8, 0x57a8ca0b, 0x85b10bd7,
+    0x383636ff, 0xea2ff723, 0x98c4a8f0, 0x4add692c,
+    0x7d121756, 0xaf0bd68a, 0xdde08959, 0x0ff94885,
+    0xc3cab4d4, 0x11d37508, 0x63382adb, 0xb121eb07,
+    0x86ee957d, 0x54f754a1, 0x261c0b72, 0xf405caae,
+    0x4982f786, 0x9b9b365a, 0xe9706989, 0x3b69a855,
+    0x0ca6d62f, 0xdebf17f3, 0xac544820, 0x7e4d89fc,
+    0xd39b2fc7, 0x0182ee1b, 0x7369b1c8, 0xa1707014,
+    0x96bf0e6e, 0x44a6cfb2, 0x364d9061, 0xe45451bd,
+    0x59d36c95, 0x8bcaad49, 0xf921f29a, 0x2b383346,
+    0x1cf74d3c, 0xceee8ce0, 0xbc05d333, 0x6e1c12ef,
+    0xe36982f2, 0x3170432e, 0x439b1cfd, 0x9182dd21,
+    0xa64da35b, 0x74546287, 0x06bf3d54, 0xd4a6fc88,
+    0x6921c1a0, 0xbb38007c, 0xc9d35faf, 0x1bca9e73,
+    0x2c05e009, 0xfe1c21d5, 0x8cf77e06, 0x5eeebfda,
+    0xf33819e1, 0x2121d83d, 0x53ca87ee, 0x81d34632,
+    0xb61c3848, 0x6405f994, 0x16eea647, 0xc4f7679b,
+    0x79705ab3, 0xab699b6f, 0xd982c4bc, 0x0b9b0560,
+    0x3c547b1a, 0xee4dbac6, 0x9ca6e515, 0x4ebf24c9
+  },
+  {
+    0x00000000, 0x01d8ac87, 0x03b1590e, 0x0269f589,
+    0x0762b21c, 0x06ba1e9b, 0x04d3eb12, 0x050b4795,
+    0x0ec56438, 0x0f1dc8bf, 0x0d743d36, 0x0cac91b1,
+    0x09a7d624, 0x087f7aa3, 0x0a168f2a, 0x0bce23ad,
+    0x1d8ac870, 0x1c5264f7, 0x1e3b917e, 0x1fe33df9,
+    0x1ae87a6c, 0x1b30d6eb, 0x19592362, 0x18818fe5,
+    0x134fac48, 0x129700cf, 0x10fef546, 0x112659c1,
+    0x142d1e54, 0x15f5b2d3, 0x179c475a, 0x1644ebdd,
+    0x3b1590e0, 0x3acd3c67, 0x38a4c9ee, 0x397c6569,
+    0x3c7722fc, 0x3daf8e7b, 0x3fc67bf2, 0x3e1ed775,
+    0x35d0f4d8, 0x3408585f, 0x3661add6, 0x37b90151,
+    0x32b246c4, 0x336aea43, 0x31031fca, 0x30dbb34d,
+    0x269f5890, 0x2747f417, 0x252e019e, 0x24f6ad19,
+    0x21fdea8c, 0x2025460b, 0x224cb382, 0x23941f05,
+    0x285a3ca8, 0x2982902f, 0x2beb65a6, 0x2a33c921,
+    0x2f388eb4, 0x2ee02233, 0x2c89d7ba, 0x2d517b3d,
+    0x762b21c0, 0x77f38d47, 0x759a78ce, 0x7442d449,
+    0x714993dc, 0x70913f5b, 0x72f8cad2, 0x73206655,
+    0x78ee45f8, 0x7936e97f, 0x7b5f1cf6, 0x7a87b071,
+    0x7f8cf7e4, 0x7e545b63, 0x7c3daeea, 0x7de5026d,
+    0x6ba1e9b0, 0x6a794537, 0x6810b0be, 0x69c81c39,
+    0x6cc35bac, 0x6d1bf72b, 0x6f7202a2, 0x6eaaae25,
+    0x65648d88, 0x64bc210f, 0x66d5d486, 0x670d7801,
+    0x62063f94, 0x63de9313, 0x61b7669a, 0x606fca1d,
+    0x4d3eb120, 0x4ce61da7, 0x4e8fe82e, 0x4f5744a9,
+    0x4a5c033c, 0x4b84afbb, 0x49ed5a32, 0x4835f6b5,
+    0x43fbd518, 0x4223799f, 0x404a8c16, 0x41922091,
+    0x44996704, 0x4541cb83, 0x47283e0a, 0x46f0928d,
+    0x50b47950, 0x516cd5d7, 0x5305205e, 0x52dd8cd9,
+    0x57d6cb4c, 0x560e67cb, 0x54679242, 0x55bf3ec5,
+    0x5e711d68, 0x5fa9b1ef, 0x5dc04466, 0x5c18e8e1,
+    0x5913af74, 0x58cb03f3, 0x5aa2f67a, 0x5b7a5afd,
+    0xec564380, 0xed8eef07, 0xefe71a8e, 0xee3fb609,
+    0xeb34f19c, 0xeaec5d1b, 0xe885a892, 0xe95d0415,
+    0xe29327b8, 0xe34b8b3f, 0xe1227eb6, 0xe0fad231,
+    0xe5f195a4, 0xe4293923, 0xe640ccaa, 0xe798602d,
+    0xf1dc8bf0, 0xf0042777, 0xf26dd2fe, 0xf3b57e79,
+    0xf6be39ec, 0xf766956b, 0xf50f60e2, 0xf4d7cc65,
+    0xff19efc8, 0xfec1434f, 0xfca8b6c6, 0xfd701a41,
+    0xf87b5dd4, 0xf9a3f153, 0xfbca04da, 0xfa12a85d,
+    0xd743d360, 0xd69b7fe7, 0xd4f28a6e, 0xd52a26e9,
+    0xd021617c, 0xd1f9cdfb, 0xd3903872, 0xd24894f5,
+    0xd986b758, 0xd85e1bdf, 0xda37ee56, 0xdbef42d1,
+    0xdee40544, 0xdf3ca9c3, 0xdd555c4a, 0xdc8df0cd,
+    0xcac91b10, 0xcb11b797, 0xc978421e, 0xc8a0ee99,
+    0xcdaba90c, 0xcc73058b, 0xce1af002, 0xcfc25c85,
+    0xc40c7f28, 0xc5d4d3af, 0xc7bd2626, 0xc6658aa1,
+    0xc36ecd34, 0xc2b661b3, 0xc0df943a, 0xc10738bd,
+    0x9a7d6240, 0x9ba5cec7, 0x99cc3b4e, 0x981497c9,
+    0x9d1fd05c, 0x9cc77cdb, 0x9eae8952, 0x9f7625d5,
+    0x94b80678, 0x9560aaff, 0x97095f76, 0x96d1f3f1,
+    0x93dab464, 0x920218e3, 0x906bed6a, 0x91b341ed,
+    0x87f7aa30, 0x862f06b7, 0x8446f33e, 0x859e5fb9,
+    0x8095182c, 0x814db4ab, 0x83244122, 0x82fceda5,
+    0x8932ce08, 0x88ea628f, 0x8a839706, 0x8b5b3b81,
+    0x8e507c14, 0x8f88d093, 0x8de1251a, 0x8c39899d,
+    0xa168f2a0, 0xa0b05e27, 0xa2d9abae, 0xa3010729,
+    0xa60a40bc, 0xa7d2ec3b, 0xa5bb19b2, 0xa463b535,
+    0xafad9698, 0xae753a1f, 0xac1ccf96, 0xadc46311,
+    0xa8cf2484, 0xa9178803, 0xab7e7d8a, 0xaaa6d10d,
+    0xbce23ad0, 0xbd3a9657, 0xbf5363de, 0xbe8bcf59,
+    0xbb8088cc, 0xba58244b, 0xb831d1c2, 0xb9e97d45,
+    0xb2275ee8, 0xb3fff26f, 0xb19607e6, 0xb04eab61,
+    0xb545ecf4, 0xb49d4073, 0xb6f4b5fa, 0xb72c197d
+  },
+  {
+    0x00000000, 0xdc6d9ab7, 0xbc1a28d9, 0x6077b26e,
+    0x7cf54c05, 0xa098d6b2, 0xc0ef64dc, 0x1c82fe6b,
+    0xf9ea980a, 0x258702bd, 0x45f0b0d3, 0x999d2a64,
+    0x851fd40f, 0x59724eb8, 0x3905fcd6, 0xe5686661,
+    0xf7142da3, 0x2b79b714, 0x4b0e057a, 0x97639fcd,
+    0x8be161a6, 0x578cfb11, 0x37fb497f, 0xeb96d3c8,
+    0x0efeb5a9, 0xd2932f1e, 0xb2e49d70, 0x6e8907c7,
+    0x720bf9ac, 0xae66631b, 0xce11d175, 0x127c4bc2,
+    0xeae946f1, 0x3684dc46, 0x56f36e28, 0x8a9ef49f,
+    0x961c0af4, 0x4a719043, 0x2a06222d, 0xf66bb89a,
+    0x1303defb, 0xcf6e444c, 0xaf19f622, 0x73746c95,
+    0x6ff692fe, 0xb39b0849, 0xd3ecba27, 0x0f812090,
+    0x1dfd6b52, 0xc190f1e5, 0xa1e7438b, 0x7d8ad93c,
+    0x61082757, 0xbd65bde0, 0xdd120f8e, 0x017f9539,
+    0xe417f358, 0x387a69ef, 0x580ddb81, 0x84604136,
+    0x98e2bf5d, 0x448f25ea, 0x24f89784, 0xf8950d33,
+    0xd1139055, 0x0d7e0ae2, 0x6d09b88c, 0xb164223b,
+    0xade6dc50, 0x718b46e7, 0x11fcf489, 0xcd916e3e,
+    0x28f9085f, 0xf49492e8, 0x94e32086, 0x488eba31,
+    0x540c445a, 0x8861deed, 0xe8166c83, 0x347bf634,
+    0x2607bdf6, 0xfa6a2741, 0x9a1d952f, 0x46700f98,
+    0x5af2f1f3, 0x869f6b44, 0xe6e8d92a, 0x3a85439d,
+    0xdfed25fc, 0x0380bf4b, 0x63f70d25, 0xbf9a9792,
+    0xa31869f9, 0x7f75f34e, 0x1f024120, 0xc36fdb97,
+    0x3bfad6a4, 0xe7974c13, 0x87e0fe7d, 0x5b8d64ca,
+    0x470f9aa1, 0x9b620016, 0xfb15b278, 0x277828cf,
+    0xc2104eae, 0x1e7dd419, 0x7e0a6677, 0xa267fcc0,
+    0xbee502ab, 0x6288981c, 0x02ff2a72, 0xde92b0c5,
+    0xcceefb07, 0x108361b0, 0x70f4d3de, 0xac994969,
+    0xb01bb702, 0x6c762db5, 0x0c019fdb, 0xd06c056c,
+    0x3504630d, 0xe969f9ba, 0x891e4bd4, 0x5573d163,
+    0x49f12f08, 0x959cb5bf, 0xf5eb07d1, 0x29869d66,
+    0xa6e63d1d, 0x7a8ba7aa, 0x1afc15c4, 0xc6918f73,
+    0xda137118, 0x067eebaf, 0x660959c1, 0xba64c376,
+    0x5f0ca517, 0x83613fa0, 0xe3168dce, 0x3f7b1779,
+    0x23f9e912, 0xff9473a5, 0x9fe3c1cb, 0x438e5b7c,
+    0x51f210be, 0x8d9f8a09, 0xede83867, 0x3185a2d0,
+    0x2d075cbb, 0xf16ac60c, 0x911d7462, 0x4d70eed5,
+    0xa81888b4, 0x74751203, 0x1402a06d, 0xc86f3ada,
+    0xd4edc4b1, 0x08805e06, 0x68f7ec68, 0xb49a76df,
+    0x4c0f7bec, 0x9062e15b, 0xf0155335, 0x2c78c982,
+    0x30fa37e9, 0xec97ad5e, 0x8ce01f30, 0x508d8587,
+    0xb5e5e3e6, 0x69887951, 0x09ffcb3f, 0xd5925188,
+    0xc910afe3, 0x157d3554, 0x750a873a, 0xa9671d8d,
+    0xbb1b564f, 0x6776ccf8, 0x07017e96, 0xdb6ce421,
+    0xc7ee1a4a, 0x1b8380fd, 0x7bf43293, 0xa799a824,
+    0x42f1ce45, 0x9e9c54f2, 0xfeebe69c, 0x22867c2b,
+    0x3e048240, 0xe26918f7, 0x821eaa99, 0x5e73302e,
+    0x77f5ad48, 0xab9837ff, 0xcbef8591, 0x17821f26,
+    0x0b00e14d, 0xd76d7bfa, 0xb71ac994, 0x6b775323,
+    0x8e1f3542, 0x5272aff5, 0x32051d9b, 0xee68872c,
+    0xf2ea7947, 0x2e87e3f0, 0x4ef0519e, 0x929dcb29,
+    0x80e180eb, 0x5c8c1a5c, 0x3cfba832, 0xe0963285,
+    0xfc14ccee, 0x20795659, 0x400ee437, 0x9c637e80,
+    0x790b18e1, 0xa5668256, 0xc5113038, 0x197caa8f,
+    0x05fe54e4, 0xd993ce53, 0xb9e47c3d, 0x6589e68a,
+    0x9d1cebb9, 0x4171710e, 0x2106c360, 0xfd6b59d7,
+    0xe1e9a7bc, 0x3d843d0b, 0x5df38f65, 0x819e15d2,
+    0x64f673b3, 0xb89be904, 0xd8ec5b6a, 0x0481c1dd,
+    0x18033fb6, 0xc46ea501, 0xa419176f, 0x78748dd8,
+    0x6a08c61a, 0xb6655cad, 0xd612eec3, 0x0a7f7474,
+    0x16fd8a1f, 0xca9010a8, 0xaae7a2c6, 0x768a3871,
+    0x93e25e10, 0x4f8fc4a7, 0x2ff876c9, 0xf395ec7e,
+    0xef171215, 0x337a88a2, 0x530d3acc, 0x8f60a07b
+  },
+  {
+    0x00000000, 0x490d678d, 0x921acf1a, 0xdb17a897,
+    0x20f48383, 0x69f9e40e, 0xb2ee4c99, 0xfbe32b14,
+    0x41e90706, 0x08e4608b, 0xd3f3c81c, 0x9afeaf91,
+    0x611d8485, 0x2810e308, 0xf3074b9f, 0xba0a2c12,
+    0x83d20e0c, 0xcadf6981, 0x11c8c116, 0x58c5a69b,
+    0xa3268d8f, 0xea2bea02, 0x313c4295, 0x78312518,
+    0xc23b090a, 0x8b366e87, 0x5021c610, 0x192ca19d,
+    0xe2cf8a89, 0xabc2ed04, 0x70d54593, 0x39d8221e,
+    0x036501af, 0x4a686622, 0x917fceb5, 0xd872a938,
+    0x2391822c, 0x6a9ce5a1, 0xb18b4d36, 0xf8862abb,
+    0x428c06a9, 0x0b816124, 0xd096c9b3, 0x999bae3e,
+    0x6278852a, 0x2b75e2a7, 0xf0624a30, 0xb96f2dbd,
+    0x80b70fa3, 0xc9ba682e, 0x12adc0b9, 0x5ba0a734,
+    0xa0438c20, 0xe94eebad, 0x3259433a, 0x7b5424b7,
+    0xc15e08a5, 0x88536f28, 0x5344c7bf, 0x1a49a032,
+    0xe1aa8b26, 0xa8a7ecab, 0x73b0443c, 0x3abd23b1,
+    0x06ca035e, 0x4fc764d3, 0x94d0cc44, 0xddddabc9,
+    0x263e80dd, 0x6f33e750, 0xb4244fc7, 0xfd29284a,
+    0x47230458, 0x0e2e63d5, 0xd539cb42, 0x9c34accf,
+    0x67d787db, 0x2edae056, 0xf5cd48c1, 0xbcc02f4c,
+    0x85180d52, 0xcc156adf, 0x1702c248, 0x5e0fa5c5,
+    0xa5ec8ed1, 0xece1e95c, 0x37f641cb, 0x7efb2646,
+    0xc4f10a54, 0x8dfc6dd9, 0x56ebc54e, 0x1fe6a2c3,
+    0xe40589d7, 0xad08ee5a, 0x761f46cd, 0x3f122140,
+    0x05af02f1, 0x4ca2657c, 0x97b5cdeb, 0xdeb8aa66,
+    0x255b8172, 0x6c56e6ff, 0xb7414e68, 0xfe4c29e5,
+    0x444605f7, 0x0d4b627a, 0xd65ccaed, 0x9f51ad60,
+    0x64b28674, 0x2dbfe1f9, 0xf6a8496e, 0xbfa52ee3,
+    0x867d0cfd, 0xcf706b70, 0x1467c3e7, 0x5d6aa46a,
+    0xa6898f7e, 0xef84e8f3, 0x34934064, 0x7d9e27e9,
+    0xc7940bfb, 0x8e996c76, 0x558ec4e1, 0x1c83a36c,
+    0xe7608878, 0xae6deff5, 0x757a4762, 0x3c7720ef,
+    0x0d9406bc, 0x44996131, 0x9f8ec9a6, 0xd683ae2b,
+    0x2d60853f, 0x646de2b2, 0xbf7a4a25, 0xf6772da8,
+    0x4c7d01ba, 0x05706637, 0xde67cea0, 0x976aa92d,
+    0x6c898239, 0x2584e5b4, 0xfe934d23, 0xb79e2aae,
+    0x8e4608b0, 0xc74b6f3d, 0x1c5cc7aa, 0x5551a027,
+    0xaeb28b33, 0xe7bfecbe, 0x3ca84429, 0x75a523a4,
+    0xcfaf0fb6, 0x86a2683b, 0x5db5c0ac, 0x14b8a721,
+    0xef5b8c35, 0xa656ebb8, 0x7d41432f, 0x344c24a2,
+    0x0ef10713, 0x47fc609e, 0x9cebc809, 0xd5e6af84,
+    0x2e058490, 0x6708e31d, 0xbc1f4b8a, 0xf5122c07,
+    0x4f180015, 0x06156798, 0xdd02cf0f, 0x940fa882,
+    0x6fec8396, 0x26e1e41b, 0xfdf64c8c, 0xb4fb2b01,
+    0x8d23091f, 0xc42e6e92, 0x1f39c605, 0x5634a188,
+    0xadd78a9c, 0xe4daed11, 0x3fcd4586, 0x76c0220b,
+    0xccca0e19, 0x85c76994, 0x5ed0c103, 0x17dda68e,
+    0xec3e8d9a, 0xa533ea17, 0x7e244280, 0x3729250d,
+    0x0b5e05e2, 0x4253626f, 0x9944caf8, 0xd049ad75,
+    0x2baa8661, 0x62a7e1ec, 0xb9b0497b, 0xf0bd2ef6,
+    0x4ab702e4, 0x03ba6569, 0xd8adcdfe, 0x91a0aa73,
+    0x6a438167, 0x234ee6ea, 0xf8594e7d, 0xb15429f0,
+    0x888c0bee, 0xc1816c63, 0x1a96c4f4, 0x539ba379,
+    0xa878886d, 0xe175efe0, 0x3a624777, 0x736f20fa,
+    0xc9650ce8, 0x80686b65, 0x5b7fc3f2, 0x1272a47f,
+    0xe9918f6b, 0xa09ce8e6, 0x7b8b4071, 0x328627fc,
+    0x083b044d, 0x413663c0, 0x9a21cb57, 0xd32cacda,
+    0x28cf87ce, 0x61c2e043, 0xbad548d4, 0xf3d82f59,
+    0x49d2034b, 0x00df64c6, 0xdbc8cc51, 0x92c5abdc,
+    0x692680c8, 0x202be745, 0xfb3c4fd2, 0xb231285f,
+    0x8be90a41, 0xc2e46dcc, 0x19f3c55b, 0x50fea2d6,
+    0xab1d89c2, 0xe210ee4f, 0x390746d8, 0x700a2155,
+    0xca000d47, 0x830d6aca, 0x581ac25d, 0x1117a5d0,
+    0xeaf48ec4, 0xa3f9e949, 0x78ee41de, 0x31e32653
+  },
+  {
+    0x00000000, 0x1b280d78, 0x36501af0, 0x2d781788,
+    0x6ca035e0, 0x77883898, 0x5af02f10, 0x41d82268,
+    0xd9406bc0, 0xc26866b8, 0xef107130, 0xf4387c48,
+    0xb5e05e20, 0xaec85358, 0x83b044d0, 0x989849a8,
+    0xb641ca37, 0xad69c74f, 0x8011d0c7, 0x9b39ddbf,
+    0xdae1ffd7, 0xc1c9f2af, 0xecb1e527, 0xf799e85f,
+    0x6f01a1f7, 0x7429ac8f, 0x5951bb07, 0x4279b67f,
+    0x03a19417, 0x1889996f, 0x35f18ee7, 0x2ed9839f,
+    0x684289d9, 0x736a84a1, 0x5e129329, 0x453a9e51,
+    0x04e2bc39, 0x1fcab141, 0x32b2a6c9, 0x299aabb1,
+    0xb102e219, 0xaa2aef61, 0x8752f8e9, 0x9c7af591,
+    0xdda2d7f9, 0xc68ada81, 0xebf2cd09, 0xf0dac071,
+    0xde0343ee, 0xc52b4e96, 0xe853591e, 0xf37b5466,
+    0xb2a3760e, 0xa98b7b76, 0x84f36cfe, 0x9fdb6186,
+    0x0743282e, 0x1c6b2556, 0x311332de, 0x2a3b3fa6,
+    0x6be31dce, 0x70cb10b6, 0x5db3073e, 0x469b0a46,
+    0xd08513b2, 0xcbad1eca, 0xe6d50942, 0xfdfd043a,
+    0xbc252652, 0xa70d2b2a, 0x8a753ca2, 0x915d31da,
+    0x09c57872, 0x12ed750a, 0x3f956282, 0x24bd6ffa,
+    0x65654d92, 0x7e4d40ea, 0x53355762, 0x481d5a1a,
+    0x66c4d985, 0x7decd4fd, 0x5094c375, 0x4bbcce0d,
+    0x0a64ec65, 0x114ce11d, 0x3c34f695, 0x271cfbed,
+    0xbf84b245, 0xa4acbf3d, 0x89d4a8b5, 0x92fca5cd,
+    0xd32487a5, 0xc80c8add, 0xe5749d55, 0xfe5c902d,
+    0xb8c79a6b, 0xa3ef9713, 0x8e97809b, 0x95bf8de3,
+    0xd467af8b, 0xcf4fa2f3, 0xe237b57b, 0xf91fb803,
+    0x6187f1ab, 0x7aaffcd3, 0x57d7eb5b, 0x4cffe623,
+    0x0d27c44b, 0x160fc933, 0x3b77debb, 0x205fd3c3,
+    0x0e86505c, 0x15ae5d24, 0x38d64aac, 0x23fe47d4,
+    0x622665bc, 0x790e68c4, 0x54767f4c, 0x4f5e7234,
+    0xd7c63b9c, 0xccee36e4, 0xe196216c, 0xfabe2c14,
+    0xbb660e7c, 0xa04e0304, 0x8d36148c, 0x961e19f4,
+    0xa5cb3ad3, 0xbee337ab, 0x939b2023, 0x88b32d5b,
+    0xc96b0f33, 0xd243024b, 0xff3b15c3, 0xe41318bb,
+    0x7c8b5113, 0x67a35c6b, 0x4adb4be3, 0x51f3469b,
+    0x102b64f3, 0x0b03698b, 0x267b7e03, 0x3d53737b,
+    0x138af0e4, 0x08a2fd9c, 0x25daea14, 0x3ef2e76c,
+    0x7f2ac504, 0x6402c87c, 0x497adff4, 0x5252d28c,
+    0xcaca9b24, 0xd1e2965c, 0xfc9a81d4, 0xe7b28cac,
+    0xa66aaec4, 0xbd42a3bc, 0x903ab434, 0x8b12b94c,
+    0xcd89b30a, 0xd6a1be72, 0xfbd9a9fa, 0xe0f1a482,
+    0xa12986ea, 0xba018b92, 0x97799c1a, 0x8c519162,
+    0x14c9d8ca, 0x0fe1d5b2, 0x2299c23a, 0x39b1cf42,
+    0x7869ed2a, 0x6341e052, 0x4e39f7da, 0x5511faa2,
+    0x7bc8793d, 0x60e07445, 0x4d9863cd, 0x56b06eb5,
+    0x17684cdd, 0x0c4041a5, 0x2138562d, 0x3a105b55,
+    0xa28812fd, 0xb9a01f85, 0x94d8080d, 0x8ff00575,
+    0xce28271d, 0xd5002a65, 0xf8783ded, 0xe3503095,
+    0x754e2961, 0x6e662419, 0x431e3391, 0x58363ee9,
+    0x19ee1c81, 0x02c611f9, 0x2fbe0671, 0x34960b09,
+    0xac0e42a1, 0xb7264fd9, 0x9a5e5851, 0x81765529,
+    0xc0ae7741, 0xdb867a39, 0xf6fe6db1, 0xedd660c9,
+    0xc30fe356, 0xd827ee2e, 0xf55ff9a6, 0xee77f4de,
+    0xafafd6b6, 0xb487dbce, 0x99ffcc46, 0x82d7c13e,
+    0x1a4f8896, 0x016785ee, 0x2c1f9266, 0x37379f1e,
+    0x76efbd76, 0x6dc7b00e, 0x40bfa786, 0x5b97aafe,
+    0x1d0ca0b8, 0x0624adc0, 0x2b5cba48, 0x3074b730,
+    0x71ac9558, 0x6a849820, 0x47fc8fa8, 0x5cd482d0,
+    0xc44ccb78, 0xdf64c600, 0xf21cd188, 0xe934dcf0,
+    0xa8ecfe98, 0xb3c4f3e0, 0x9ebce468, 0x8594e910,
+    0xab4d6a8f, 0xb06567f7, 0x9d1d707f, 0x86357d07,
+    0xc7ed5f6f, 0xdcc55217, 0xf1bd459f, 0xea9548e7,
+    0x720d014f, 0x69250c37, 0x445d1bbf, 0x5f7516c7,
+    0x1ead34af, 0x058539d7, 0x28fd2e5f, 0x33d52327
+  },
+  {
+    0x00000000, 0x4f576811, 0x9eaed022, 0xd1f9b833,
+    0x399cbdf3, 0x76cbd5e2, 0xa7326dd1, 0xe86505c0,
+    0x73397be6, 0x3c6e13f7, 0xed97abc4, 0xa2c0c3d5,
+    0x4aa5c615, 0x05f2ae04, 0xd40b1637, 0x9b5c7e26,
+    0xe672f7cc, 0xa9259fdd, 0x78dc27ee, 0x378b4fff,
+    0xdfee4a3f, 0x90b9222e, 0x41409a1d, 0x0e17f20c,
+    0x954b8c2a, 0xda1ce43b, 0x0be55c08, 0x44b23419,
+    0xacd731d9, 0xe38059c8, 0x3279e1fb, 0x7d2e89ea,
+    0xc824f22f, 0x87739a3e, 0x568a220d, 0x19dd4a1c,
+    0xf1b84fdc, 0xbeef27cd, 0x6f169ffe, 0x2041f7ef,
+    0xbb1d89c9, 0xf44ae1d8, 0x25b359eb, 0x6ae431fa,
+    0x8281343a, 0xcdd65c2b, 0x1c2fe418, 0x53788c09,
+    0x2e5605e3, 0x61016df2, 0xb0f8d5c1, 0xffafbdd0,
+    0x17cab810, 0x589dd001, 0x89646832, 0xc6330023,
+    0x5d6f7e05, 0x12381614, 0xc3c1ae27, 0x8c96c636,
+    0x64f3c3f6, 0x2ba4abe7, 0xfa5d13d4, 0xb50a7bc5,
+    0x9488f9e9, 0xdbdf91f8, 0x0a2629cb, 0x457141da,
+    0xad14441a, 0xe2432c0b, 0x33ba9438, 0x7cedfc29,
+    0xe7b1820f, 0xa8e6ea1e, 0x791f522d, 0x36483a3c,
+    0xde2d3ffc, 0x917a57ed, 0x4083efde, 0x0fd487cf,
+    0x72fa0e25, 0x3dad6634, 0xec54de07, 0xa303b616,
+    0x4b66b3d6, 0x0431dbc7, 0xd5c863f4, 0x9a9f0be5,
+    0x01c375c3, 0x4e941dd2, 0x9f6da5e1, 0xd03acdf0,
+    0x385fc830, 0x7708a021, 0xa6f11812, 0xe9a67003,
+    0x5cac0bc6, 0x13fb63d7, 0xc202dbe4, 0x8d55b3f5,
+    0x6530b635, 0x2a67de24, 0xfb9e6617, 0xb4c90e06,
+    0x2f957020, 0x60c21831, 0xb13ba002, 0xfe6cc813,
+    0x1609cdd3, 0x595ea5c2, 0x88a71df1, 0xc7f075e0,
+    0xbadefc0a, 0xf589941b, 0x24702c28, 0x6b274439,
+    0x834241f9, 0xcc1529e8, 0x1dec91db, 0x52bbf9ca,
+    0xc9e787ec, 0x86b0effd, 0x574957ce, 0x181e3fdf,
+    0xf07b3a1f, 0xbf2c520e, 0x6ed5ea3d, 0x2182822c,
+    0x2dd0ee65, 0x62878674, 0xb37e3e47, 0xfc295656,
+    0x144c5396, 0x5b1b3b87, 0x8ae283b4, 0xc5b5eba5,
+    0x5ee99583, 0x11befd92, 0xc04745a1, 0x8f102db0,
+    0x67752870, 0x28224061, 0xf9dbf852, 0xb68c9043,
+    0xcba219a9, 0x84f571b8, 0x550cc98b, 0x1a5ba19a,
+    0xf23ea45a, 0xbd69cc4b, 0x6c907478, 0x23c71c69,
+    0xb89b624f, 0xf7cc0a5e, 0x2635b26d, 0x6962da7c,
+    0x8107dfbc, 0xce50b7ad, 0x1fa90f9e, 0x50fe678f,
+    0xe5f41c4a, 0xaaa3745b, 0x7b5acc68, 0x340da479,
+    0xdc68a1b9, 0x933fc9a8, 0x42c6719b, 0x0d91198a,
+    0x96cd67ac, 0xd99a0fbd, 0x0863b78e, 0x4734df9f,
+    0xaf51da5f, 0xe006b24e, 0x31ff0a7d, 0x7ea8626c,
+    0x0386eb86, 0x4cd18397, 0x9d283ba4, 0xd27f53b5,
+    0x3a1a5675, 0x754d3e64, 0xa4b48657, 0xebe3ee46,
+    0x70bf9060, 0x3fe8f871, 0xee114042, 0xa1462853,
+    0x49232d93, 0x06744582, 0xd78dfdb1, 0x98da95a0,
+    0xb958178c, 0xf60f7f9d, 0x27f6c7ae, 0x68a1afbf,
+    0x80c4aa7f, 0xcf93c26e, 0x1e6a7a5d, 0x513d124c,
+    0xca616c6a, 0x8536047b, 0x54cfbc48, 0x1b98d459,
+    0xf3fdd199, 0xbcaab988, 0x6d5301bb, 0x220469aa,
+    0x5f2ae040, 0x107d8851, 0xc1843062, 0x8ed35873,
+    0x66b65db3, 0x29e135a2, 0xf8188d91, 0xb74fe580,
+    0x2c139ba6, 0x6344f3b7, 0xb2bd4b84, 0xfdea2395,
+    0x158f2655, 0x5ad84e44, 0x8b21f677, 0xc4769e66,
+    0x717ce5a3, 0x3e2b8db2, 0xefd23581, 0xa0855d90,
+    0x48e05850, 0x07b73041, 0xd64e8872, 0x9919e063,
+    0x02459e45, 0x4d12f654, 0x9ceb4e67, 0xd3bc2676,
+    0x3bd923b6, 0x748e4ba7, 0xa577f394, 0xea209b85,
+    0x970e126f, 0xd8597a7e, 0x09a0c24d, 0x46f7aa5c,
+    0xae92af9c, 0xe1c5c78d, 0x303c7fbe, 0x7f6b17af,
+    0xe4376989, 0xab600198, 0x7a99b9ab, 0x35ced1ba,
+    0xddabd47a, 0x92fcbc6b, 0x43050458, 0x0c526c49
+  },
+  {
+    0x00000000, 0x5ba1dcca, 0xb743b994, 0xece2655e,
+    0x6a466e9f, 0x31e7b255, 0xdd05d70b, 0x86a40bc1,
+    0xd48cdd3e, 0x8f2d01f4, 0x63cf64aa, 0x386eb860,
+    0xbecab3a1, 0xe56b6f6b, 0x09890a35, 0x5228d6ff,
+    0xadd8a7cb, 0xf6797b01, 0x1a9b1e5f, 0x413ac295,
+    0xc79ec954, 0x9c3f159e, 0x70dd70c0, 0x2b7cac0a,
+    0x79547af5, 0x22f5a63f, 0xce17c361, 0x95b61fab,
+    0x1312146a, 0x48b3c8a0, 0xa451adfe, 0xfff07134,
+    0x5f705221, 0x04d18eeb, 0xe833ebb5, 0xb392377f,
+    0x35363cbe, 0x6e97e074, 0x8275852a, 0xd9d459e0,
+    0x8bfc8f1f, 0xd05d53d5, 0x3cbf368b, 0x671eea41,
+    0xe1bae180, 0xba1b3d4a, 0x56f95814, 0x0d5884de,
+    0xf2a8f5ea, 0xa9092920, 0x45eb4c7e, 0x1e4a90b4,
+    0x98ee9b75, 0xc34f47bf, 0x2fad22e1, 0x740cfe2b,
+    0x262428d4, 0x7d85f41e, 0x91679140, 0xcac64d8a,
+    0x4c62464b, 0x17c39a81, 0xfb21ffdf, 0xa0802315,
+    0xbee0a442, 0xe5417888, 0x09a31dd6, 0x5202c11c,
+    0xd4a6cadd, 0x8f071617, 0x63e57349, 0x3844af83,
+    0x6a6c797c, 0x31cda5b6, 0xdd2fc0e8, 0x868e1c22,
+    0x002a17e3, 0x5b8bcb29, 0xb769ae77, 0xecc872bd,
+    0x13380389, 0x4899df43, 0xa47bba1d, 0xffda66d7,
+    0x797e6d16, 0x22dfb1dc, 0xce3dd482, 0x959c0848,
+    0xc7b4deb7, 0x9c15027d, 0x70f76723, 0x2b56bbe9,
+    0xadf2b028, 0xf6536ce2, 0x1ab109bc, 0x4110d576,
+    0xe190f663, 0xba312aa9, 0x56d34ff7, 0x0d72933d,
+    0x8bd698fc, 0xd0774436, 0x3c952168, 0x6734fda2,
+    0x351c2b5d, 0x6ebdf797, 0x825f92c9, 0xd9fe4e03,
+    0x5f5a45c2, 0x04fb9908, 0xe819fc56, 0xb3b8209c,
+    0x4c4851a8, 0x17e98d62, 0xfb0be83c, 0xa0aa34f6,
+    0x260e3f37, 0x7dafe3fd, 0x914d86a3, 0xcaec5a69,
+    0x98c48c96, 0xc365505c, 0x2f873502, 0x7426e9c8,
+    0xf282e209, 0xa9233ec3, 0x45c15b9d, 0x1e608757,
+    0x79005533, 0x22a189f9, 0xce43eca7, 0x95e2306d,
+    0x13463bac, 0x48e7e766, 0xa4058238, 0xffa45ef2,
+    0xad8c880d, 0xf62d54c7, 0x1acf3199, 0x416eed53,
+    0xc7cae692, 0x9c6b3a58, 0x70895f06, 0x2b2883cc,
+    0xd4d8f2f8, 0x8f792e32, 0x639b4b6c, 0x383a97a6,
+    0xbe9e9c67, 0xe53f40ad, 0x09dd25f3, 0x527cf939,
+    0x00542fc6, 0x5bf5f30c, 0xb7179652, 0xecb64a98,
+    0x6a124159, 0x31b39d93, 0xdd51f8cd, 0x86f02407,
+    0x26700712, 0x7dd1dbd8, 0x9133be86, 0xca92624c,
+    0x4c36698d, 0x1797b547, 0xfb75d019, 0xa0d40cd3,
+    0xf2fcda2c, 0xa95d06e6, 0x45bf63b8, 0x1e1ebf72,
+    0x98bab4b3, 0xc31b6879, 0x2ff90d27, 0x7458d1ed,
+    0x8ba8a0d9, 0xd0097c13, 0x3ceb194d, 0x674ac587,
+    0xe1eece46, 0xba4f128c, 0x56ad77d2, 0x0d0cab18,
+    0x5f247de7, 0x0485a12d, 0xe867c473, 0xb3c618b9,
+    0x35621378, 0x6ec3cfb2, 0x8221aaec, 0xd9807626,
+    0xc7e0f171, 0x9c412dbb, 0x70a348e5, 0x2b02942f,
+    0xada69fee, 0xf6074324, 0x1ae5267a, 0x4144fab0,
+    0x136c2c4f, 0x48cdf085, 0xa42f95db, 0xff8e4911,
+    0x792a42d0, 0x228b9e1a, 0xce69fb44, 0x95c8278e,
+    0x6a3856ba, 0x31998a70, 0xdd7bef2e, 0x86da33e4,
+    0x007e3825, 0x5bdfe4ef, 0xb73d81b1, 0xec9c5d7b,
+    0xbeb48b84, 0xe515574e, 0x09f73210, 0x5256eeda,
+    0xd4f2e51b, 0x8f5339d1, 0x63b15c8f, 0x38108045,
+    0x9890a350, 0xc3317f9a, 0x2fd31ac4, 0x7472c60e,
+    0xf2d6cdcf, 0xa9771105, 0x4595745b, 0x1e34a891,
+    0x4c1c7e6e, 0x17bda2a4, 0xfb5fc7fa, 0xa0fe1b30,
+    0x265a10f1, 0x7dfbcc3b, 0x9119a965, 0xcab875af,
+    0x3548049b, 0x6ee9d851, 0x820bbd0f, 0xd9aa61c5,
+    0x5f0e6a04, 0x04afb6ce, 0xe84dd390, 0xb3ec0f5a,
+    0xe1c4d9a5, 0xba65056f, 0x56876031, 0x0d26bcfb,
+    0x8b82b73a, 0xd0236bf0, 0x3cc10eae, 0x6760d264
+  },
+  {
+    0x00000000, 0xf200aa66, 0xe0c0497b, 0x12c0e31d,
+    0xc5418f41, 0x37412527, 0x2581c63a, 0xd7816c5c,
+    0x8e420335, 0x7c42a953, 0x6e824a4e, 0x9c82e028,
+    0x4b038c74, 0xb9032612, 0xabc3c50f, 0x59c36f69,
+    0x18451bdd, 0xea45b1bb, 0xf88552a6, 0x0a85f8c0,
+    0xdd04949c, 0x2f043efa, 0x3dc4dde7, 0xcfc47781,
+    0x960718e8, 0x6407b28e, 0x76c75193, 0x84c7fbf5,
+    0x534697a9, 0xa1463dcf, 0xb386ded2, 0x418674b4,
+    0x308a37ba, 0xc28a9ddc, 0xd04a7ec1, 0x224ad4a7,
+    0xf5cbb8fb, 0x07cb129d, 0x150bf180, 0xe70b5be6,
+    0xbec8348f, 0x4cc89ee9, 0x5e087df4, 0xac08d792,
+    0x7b89bbce, 0x898911a8, 0x9b49f2b5, 0x694958d3,
+    0x28cf2c67, 0xdacf8601, 0xc80f651c, 0x3a0fcf7a,
+    0xed8ea326, 0x1f8e0940, 0x0d4eea5d, 0xff4e403b,
+    0xa68d2f52, 0x548d8534, 0x464d6629, 0xb44dcc4f,
+    0x63cca013, 0x91cc0a75, 0x830ce968, 0x710c430e,
+    0x61146f74, 0x9314c512, 0x81d4260f, 0x73d48c69,
+    0xa455e035, 0x56554a53, 0x4495a94e, 0xb6950328,
+    0xef566c41, 0x1d56c627, 0x0f96253a, 0xfd968f5c,
+    0x2a17e300, 0xd8174966, 0xcad7aa7b, 0x38d7001d,
+    0x795174a9, 0x8b51decf, 0x99913dd2, 0x6b9197b4,
+    0xbc10fbe8, 0x4e10518e, 0x5cd0b293, 0xaed018f5,
+    0xf713779c, 0x0513ddfa, 0x17d33ee7, 0xe5d39481,
+    0x3252f8dd, 0xc05252bb, 0xd292b1a6, 0x20921bc0,
+    0x519e58ce, 0xa39ef2a8, 0xb15e11b5, 0x435ebbd3,
+    0x94dfd78f, 0x66df7de9, 0x741f9ef4, 0x861f3492,
+    0xdfdc5bfb, 0x2ddcf19d, 0x3f1c1280, 0xcd1cb8e6,
+    0x1a9dd4ba, 0xe89d7edc, 0xfa5d9dc1, 0x085d37a7,
+    0x49db4313, 0xbbdbe975, 0xa91b0a68, 0x5b1ba00e,
+    0x8c9acc52, 0x7e9a6634, 0x6c5a8529, 0x9e5a2f4f,
+    0xc7994026, 0x3599ea40, 0x2759095d, 0xd559a33b,
+    0x02d8cf67, 0xf0d86501, 0xe218861c, 0x10182c7a,
+    0xc228dee8, 0x3028748e, 0x22e89793, 0xd0e83df5,
+    0x076951a9, 0xf569fbcf, 0xe7a918d2, 0x15a9b2b4,
+    0x4c6adddd, 0xbe6a77bb, 0xacaa94a6, 0x5eaa3ec0,
+    0x892b529c, 0x7b2bf8fa, 0x69eb1be7, 0x9bebb181,
+    0xda6dc535, 0x286d6f53, 0x3aad8c4e, 0xc8ad2628,
+    0x1f2c4a74, 0xed2ce012, 0xffec030f, 0x0deca969,
+    0x542fc600, 0xa62f6c66, 0xb4ef8f7b, 0x46ef251d,
+    0x916e4941, 0x636ee327, 0x71ae003a, 0x83aeaa5c,
+    0xf2a2e952, 0x00a24334, 0x1262a029, 0xe0620a4f,
+    0x37e36613, 0xc5e3cc75, 0xd7232f68, 0x2523850e,
+    0x7ce0ea67, 0x8ee04001, 0x9c20a31c, 0x6e20097a,
+    0xb9a16526, 0x4ba1cf40, 0x59612c5d, 0xab61863b,
+    0xeae7f28f, 0x18e758e9, 0x0a27bbf4, 0xf8271192,
+    0x2fa67dce, 0xdda6d7a8, 0xcf6634b5, 0x3d669ed3,
+    0x64a5f1ba, 0x96a55bdc, 0x8465b8c1, 0x766512a7,
+    0xa1e47efb, 0x53e4d49d, 0x41243780, 0xb3249de6,
+    0xa33cb19c, 0x513c1bfa, 0x43fcf8e7, 0xb1fc5281,
+    0x667d3edd, 0x947d94bb, 0x86bd77a6, 0x74bdddc0,
+    0x2d7eb2a9, 0xdf7e18cf, 0xcdbefbd2, 0x3fbe51b4,
+    0xe83f3de8, 0x1a3f978e, 0x08ff7493, 0xfaffdef5,
+    0xbb79aa41, 0x49790027, 0x5bb9e33a, 0xa9b9495c,
+    0x7e382500, 0x8c388f66, 0x9ef86c7b, 0x6cf8c61d,
+    0x353ba974, 0xc73b0312, 0xd5fbe00f, 0x27fb4a69,
+    0xf07a2635, 0x027a8c53, 0x10ba6f4e, 0xe2bac528,
+    0x93b68626, 0x61b62c40, 0x7376cf5d, 0x8176653b,
+    0x56f70967, 0xa4f7a301, 0xb637401c, 0x4437ea7a,
+    0x1df48513, 0xeff42f75, 0xfd34cc68, 0x0f34660e,
+    0xd8b50a52, 0x2ab5a034, 0x38754329, 0xca75e94f,
+    0x8bf39dfb, 0x79f3379d, 0x6b33d480, 0x99337ee6,
+    0x4eb212ba, 0xbcb2b8dc, 0xae725bc1, 0x5c72f1a7,
+    0x05b19ece, 0xf7b134a8, 0xe571d7b5, 0x17717dd3,
+    0xc0f0118f, 0x32f0bbe9, 0x203058f4, 0xd230f292
+  },
+  {
+    0x00000000, 0x8090a067, 0x05e05d79, 0x8570fd1e,
+    0x0bc0baf2, 0x8b501a95, 0x0e20e78b, 0x8eb047ec,
+    0x178175e4, 0x9711d583, 0x1261289d, 0x92f188fa,
+    0x1c41cf16, 0x9cd16f71, 0x19a1926f, 0x99313208,
+    0x2f02ebc8, 0xaf924baf, 0x2ae2b6b1, 0xaa7216d6,
+    0x24c2513a, 0xa452f15d, 0x21220c43, 0xa1b2ac24,
+    0x38839e2c, 0xb8133e4b, 0x3d63c355, 0xbdf36332,
+    0x334324de, 0xb3d384b9, 0x36a379a7, 0xb633d9c0,
+    0x5e05d790, 0xde9577f7, 0x5be58ae9, 0xdb752a8e,
+    0x55c56d62, 0xd555cd05, 0x5025301b, 0xd0b5907c,
+    0x4984a274, 0xc9140213, 0x4c64ff0d, 0xccf45f6a,
+    0x42441886, 0xc2d4b8e1, 0x47a445ff, 0xc734e598,
+    0x71073c58, 0xf1979c3f, 0x74e76121, 0xf477c146,
+    0x7ac786aa, 0xfa5726cd, 0x7f27dbd3, 0xffb77bb4,
+    0x668649bc, 0xe616e9db, 0x636614c5, 0xe3f6b4a2,
+    0x6d46f34e, 0xedd65329, 0x68a6ae37, 0xe8360e50,
+    0xbc0baf20, 0x3c9b0f47, 0xb9ebf259, 0x397b523e,
+    0xb7cb15d2, 0x375bb5b5, 0xb22b48ab, 0x32bbe8cc,
+    0xab8adac4, 0x2b1a7aa3, 0xae6a87bd, 0x2efa27da,
+    0xa04a6036, 0x20dac051, 0xa5aa3d4f, 0x253a9d28,
+    0x930944e8, 0x1399e48f, 0x96e91991, 0x1679b9f6,
+    0x98c9fe1a, 0x18595e7d, 0x9d29a363, 0x1db90304,
+    0x8488310c, 0x0418916b, 0x81686c75, 0x01f8cc12,
+    0x8f488bfe, 0x0fd82b99, 0x8aa8d687, 0x0a3876e0,
+    0xe20e78b0, 0x629ed8d7, 0xe7ee25c9, 0x677e85ae,
+    0xe9cec242, 0x695e6225, 0xec2e9f3b, 0x6cbe3f5c,
+    0xf58f0d54, 0x751fad33, 0xf06f502d, 0x70fff04a,
+    0xfe4fb7a6, 0x7edf17c1, 0xfbafeadf, 0x7b3f4ab8,
+    0xcd0c9378, 0x4d9c331f, 0xc8ecce01, 0x487c6e66,
+    0xc6cc298a, 0x465c89ed, 0xc32c74f3, 0x43bcd494,
+    0xda8de69c, 0x5a1d46fb, 0xdf6dbbe5, 0x5ffd1b82,
+    0xd14d5c6e, 0x51ddfc09, 0xd4ad0117, 0x543da170,
+    0x7cd643f7, 0xfc46e390, 0x79361e8e, 0xf9a6bee9,
+    0x7716f905, 0xf7865962, 0x72f6a47c, 0xf266041b,
+    0x6b573613, 0xebc79674, 0x6eb76b6a, 0xee27cb0d,
+    0x60978ce1, 0xe0072c86, 0x6577d198, 0xe5e771ff,
+    0x53d4a83f, 0xd3440858, 0x5634f546, 0xd6a45521,
+    0x581412cd, 0xd884b2aa, 0x5df44fb4, 0xdd64efd3,
+    0x4455dddb, 0xc4c57dbc, 0x41b580a2, 0xc12520c5,
+    0x4f956729, 0xcf05c74e, 0x4a753a50, 0xcae59a37,
+    0x22d39467, 0xa2433400, 0x2733c91e, 0xa7a36979,
+    0x29132e95, 0xa9838ef2, 0x2cf373ec, 0xac63d38b,
+    0x3552e183, 0xb5c241e4, 0x30b2bcfa, 0xb0221c9d,
+    0x3e925b71, 0xbe02fb16, 0x3b720608, 0xbbe2a66f,
+    0x0dd17faf, 0x8d41dfc8, 0x083122d6, 0x88a182b1,
+    0x0611c55d, 0x8681653a, 0x03f19824, 0x83613843,
+    0x1a500a4b, 0x9ac0aa2c, 0x1fb05732, 0x9f20f755,
+    0x1190b0b9, 0x910010de, 0x1470edc0, 0x94e04da7,
+    0xc0ddecd7, 0x404d4cb0, 0xc53db1ae, 0x45ad11c9,
+    0xcb1d5625, 0x4b8df642, 0xcefd0b5c, 0x4e6dab3b,
+    0xd75c9933, 0x57cc3954, 0xd2bcc44a, 0x522c642d,
+    0xdc9c23c1, 0x5c0c83a6, 0xd97c7eb8, 0x59ecdedf,
+    0xefdf071f, 0x6f4fa778, 0xea3f5a66, 0x6aaffa01,
+    0xe41fbded, 0x648f1d8a, 0xe1ffe094, 0x616f40f3,
+    0xf85e72fb, 0x78ced29c, 0xfdbe2f82, 0x7d2e8fe5,
+    0xf39ec809, 0x730e686e, 0xf67e9570, 0x76ee3517,
+    0x9ed83b47, 0x1e489b20, 0x9b38663e, 0x1ba8c659,
+    0x951881b5, 0x158821d2, 0x90f8dccc, 0x10687cab,
+    0x89594ea3, 0x09c9eec4, 0x8cb913da, 0x0c29b3bd,
+    0x8299f451, 0x02095436, 0x8779a928, 0x07e9094f,
+    0xb1dad08f, 0x314a70e8, 0xb43a8df6, 0x34aa2d91,
+    0xba1a6a7d, 0x3a8aca1a, 0xbffa3704, 0x3f6a9763,
+    0xa65ba56b, 0x26cb050c, 0xa3bbf812, 0x232b5875,
+    0xad9b1f99, 0x2d0bbffe, 0xa87b42e0, 0x28ebe287
+  },
+  {
+    0x00000000, 0xf9ac87ee, 0xf798126b, 0x0e349585,
+    0xebf13961, 0x125dbe8f, 0x1c692b0a, 0xe5c5ace4,
+    0xd3236f75, 0x2a8fe89b, 0x24bb7d1e, 0xdd17faf0,
+    0x38d25614, 0xc17ed1fa, 0xcf4a447f, 0x36e6c391,
+    0xa287c35d, 0x5b2b44b3, 0x551fd136, 0xacb356d8,
+    0x4976fa3c, 0xb0da7dd2, 0xbeeee857, 0x47426fb9,
+    0x71a4ac28, 0x88082bc6, 0x863cbe43, 0x7f9039ad,
+    0x9a559549, 0x63f912a7, 0x6dcd8722, 0x946100cc,
+    0x41ce9b0d, 0xb8621ce3, 0xb6568966, 0x4ffa0e88,
+    0xaa3fa26c, 0x53932582, 0x5da7b007, 0xa40b37e9,
+    0x92edf478, 0x6b417396, 0x6575e613, 0x9cd961fd,
+    0x791ccd19, 0x80b04af7, 0x8e84df72, 0x7728589c,
+    0xe3495850, 0x1ae5dfbe, 0x14d14a3b, 0xed7dcdd5,
+    0x08b86131, 0xf114e6df, 0xff20735a, 0x068cf4b4,
+    0x306a3725, 0xc9c6b0cb, 0xc7f2254e, 0x3e5ea2a0,
+    0xdb9b0e44, 0x223789aa, 0x2c031c2f, 0xd5af9bc1,
+    0x839d361a, 0x7a31b1f4, 0x74052471, 0x8da9a39f,
+    0x686c0f7b, 0x91c08895, 0x9ff41d10, 0x66589afe,
+    0x50be596f, 0xa912de81, 0xa7264b04, 0x5e8accea,
+    0xbb4f600e, 0x42e3e7e0, 0x4cd77265, 0xb57bf58b,
+    0x211af547, 0xd8b672a9, 0xd682e72c, 0x2f2e60c2,
+    0xcaebcc26, 0x33474bc8, 0x3d73de4d, 0xc4df59a3,
+    0xf2399a32, 0x0b951ddc, 0x05a18859, 0xfc0d0fb7,
+    0x19c8a353, 0xe06424bd, 0xee50b138, 0x17fc36d6,
+    0xc253ad17, 0x3bff2af9, 0x35cbbf7c, 0xcc673892,
+    0x29a29476, 0xd00e1398, 0xde3a861d, 0x279601f3,
+    0x1170c262, 0xe8dc458c, 0xe6e8d009, 0x1f4457e7,
+    0xfa81fb03, 0x032d7ced, 0x0d19e968, 0xf4b56e86,
+    0x60d46e4a, 0x9978e9a4, 0x974c7c21, 0x6ee0fbcf,
+    0x8b25572b, 0x7289d0c5, 0x7cbd4540, 0x8511c2ae,
+    0xb3f7013f, 0x4a5b86d1, 0x446f1354, 0xbdc394ba,
+    0x5806385e, 0xa1aabfb0, 0xaf9e2a35, 0x5632addb,
+    0x03fb7183, 0xfa57f66d, 0xf46363e8, 0x0dcfe406,
+    0xe80a48e2, 0x11a6cf0c, 0x1f925a89, 0xe63edd67,
+    0xd0d81ef6, 0x29749918, 0x27400c9d, 0xdeec8b73,
+    0x3b292797, 0xc285a079, 0xccb135fc, 0x351db212,
+    0xa17cb2de, 0x58d03530, 0x56e4a0b5, 0xaf48275b,
+    0x4a8d8bbf, 0xb3210c51, 0xbd1599d4, 0x44b91e3a,
+    0x725fddab, 0x8bf35a45, 0x85c7cfc0, 0x7c6b482e,
+    0x99aee4ca, 0x60026324, 0x6e36f6a1, 0x979a714f,
+    0x4235ea8e, 0xbb996d60, 0xb5adf8e5, 0x4c017f0b,
+    0xa9c4d3ef, 0x50685401, 0x5e5cc184, 0xa7f0466a,
+    0x911685fb, 0x68ba0215, 0x668e9790, 0x9f22107e,
+    0x7ae7bc9a, 0x834b3b74, 0x8d7faef1, 0x74d3291f,
+    0xe0b229d3, 0x191eae3d, 0x172a3bb8, 0xee86bc56,
+    0x0b4310b2, 0xf2ef975c, 0xfcdb02d9, 0x05778537,
+    0x339146a6, 0xca3dc148, 0xc40954cd, 0x3da5d323,
+    0xd8607fc7, 0x21ccf829, 0x2ff86dac, 0xd654ea42,
+    0x80664799, 0x79cac077, 0x77fe55f2, 0x8e52d21c,
+    0x6b977ef8, 0x923bf916, 0x9c0f6c93, 0x65a3eb7d,
+    0x534528ec, 0xaae9af02, 0xa4dd3a87, 0x5d71bd69,
+    0xb8b4118d, 0x41189663, 0x4f2c03e6, 0xb6808408,
+    0x22e184c4, 0xdb4d032a, 0xd57996af, 0x2cd51141,
+    0xc910bda5, 0x30bc3a4b, 0x3e88afce, 0xc7242820,
+    0xf1c2ebb1, 0x086e6c5f, 0x065af9da, 0xfff67e34,
+    0x1a33d2d0, 0xe39f553e, 0xedabc0bb, 0x14074755,
+    0xc1a8dc94, 0x38045b7a, 0x3630ceff, 0xcf9c4911,
+    0x2a59e5f5, 0xd3f5621b, 0xddc1f79e, 0x246d7070,
+    0x128bb3e1, 0xeb27340f, 0xe513a18a, 0x1cbf2664,
+    0xf97a8a80, 0x00d60d6e, 0x0ee298eb, 0xf74e1f05,
+    0x632f1fc9, 0x9a839827, 0x94b70da2, 0x6d1b8a4c,
+    0x88de26a8, 0x7172a146, 0x7f4634c3, 0x86eab32d,
+    0xb00c70bc, 0x49a0f752, 0x479462d7, 0xbe38e539,
+    0x5bfd49dd, 0xa251ce33, 0xac655bb6, 0x55c9dc58
+  },
+  {
+    0x00000000, 0x07f6e306, 0x0fedc60c, 0x081b250a,
+    0x1fdb8c18, 0x182d6f1e, 0x10364a14, 0x17c0a912,
+    0x3fb71830, 0x3841fb36, 0x305ade3c, 0x37ac3d3a,
+    0x206c9428, 0x279a772e, 0x2f815224, 0x2877b122,
+    0x7f6e3060, 0x7898d366, 0x7083f66c, 0x7775156a,
+    0x60b5bc78, 0x67435f7e, 0x6f587a74, 0x68ae9972,
+    0x40d92850, 0x472fcb56, 0x4f34ee5c, 0x48c20d5a,
+    0x5f02a448, 0x58f4474e, 0x50ef6244, 0x57198142,
+    0xfedc60c0, 0xf92a83c6, 0xf131a6cc, 0xf6c745ca,
+    0xe107ecd8, 0xe6f10fde, 0xeeea2ad4, 0xe91cc9d2,
+    0xc16b78f0, 0xc69d9bf6, 0xce86befc, 0xc9705dfa,
+    0xdeb0f4e8, 0xd94617ee, 0xd15d32e4, 0xd6abd1e2,
+    0x81b250a0, 0x8644b3a6, 0x8e5f96ac, 0x89a975aa,
+    0x9e69dcb8, 0x999f3fbe, 0x91841ab4, 0x9672f9b2,
+    0xbe054890, 0xb9f3ab96, 0xb1e88e9c, 0xb61e6d9a,
+    0xa1dec488, 0xa628278e, 0xae330284, 0xa9c5e182,
+    0xf979dc37, 0xfe8f3f31, 0xf6941a3b, 0xf162f93d,
+    0xe6a2502f, 0xe154b329, 0xe94f9623, 0xeeb97525,
+    0xc6cec407, 0xc1382701, 0xc923020b, 0xced5e10d,
+    0xd915481f, 0xdee3ab19, 0xd6f88e13, 0xd10e6d15,
+    0x8617ec57, 0x81e10f51, 0x89fa2a5b, 0x8e0cc95d,
+    0x99cc604f, 0x9e3a8349, 0x9621a643, 0x91d74545,
+    0xb9a0f467, 0xbe561761, 0xb64d326b, 0xb1bbd16d,
+    0xa67b787f, 0xa18d9b79, 0xa996be73, 0xae605d75,
+    0x07a5bcf7, 0x00535ff1, 0x08487afb, 0x0fbe99fd,
+    0x187e30ef, 0x1f88d3e9, 0x1793f6e3, 0x106515e5,
+    0x3812a4c7, 0x3fe447c1, 0x37ff62cb, 0x300981cd,
+    0x27c928df, 0x203fcbd9, 0x2824eed3, 0x2fd20dd5,
+    0x78cb8c97, 0x7f3d6f91, 0x77264a9b, 0x70d0a99d,
+    0x6710008f, 0x60e6e389, 0x68fdc683, 0x6f0b2585,
+    0x477c94a7, 0x408a77a1, 0x489152ab, 0x4f67b1ad,
+    0x58a718bf, 0x5f51fbb9, 0x574adeb3, 0x50bc3db5,
+    0xf632a5d9, 0xf1c446df, 0xf9df63d5, 0xfe2980d3,
+    0xe9e929c1, 0xee1fcac7, 0xe604efcd, 0xe1f20ccb,
+    0xc985bde9, 0xce735eef, 0xc6687be5, 0xc19e98e3,
+    0xd65e31f1, 0xd1a8d2f7, 0xd9b3f7fd, 0xde4514fb,
+    0x895c95b9, 0x8eaa76bf, 0x86b153b5, 0x8147b0b3,
+    0x968719a1, 0x9171faa7, 0x996adfad, 0x9e9c3cab,
+    0xb6eb8d89, 0xb11d6e8f, 0xb9064b85, 0xbef0a883,
+    0xa9300191, 0xaec6e297, 0xa6ddc79d, 0xa12b249b,
+    0x08eec519, 0x0f18261f, 0x07030315, 0x00f5e013,
+    0x17354901, 0x10c3aa07, 0x18d88f0d, 0x1f2e6c0b,
+    0x3759dd29, 0x30af3e2f, 0x38b41b25, 0x3f42f823,
+    0x28825131, 0x2f74b237, 0x276f973d, 0x2099743b,
+    0x7780f579, 0x7076167f, 0x786d3375, 0x7f9bd073,
+    0x685b7961, 0x6fad9a67, 0x67b6bf6d, 0x60405c6b,
+    0x4837ed49, 0x4fc10e4f, 0x47da2b45, 0x402cc843,
+    0x57ec6151, 0x501a8257, 0x5801a75d, 0x5ff7445b,
+    0x0f4b79ee, 0x08bd9ae8, 0x00a6bfe2, 0x07505ce4,
+    0x1090f5f6, 0x176616f0, 0x1f7d33fa, 0x188bd0fc,
+    0x30fc61de, 0x370a82d8, 0x3f11a7d2, 0x38e744d4,
+    0x2f27edc6, 0x28d10ec0, 0x20ca2bca, 0x273cc8cc,
+    0x7025498e, 0x77d3aa88, 0x7fc88f82, 0x783e6c84,
+    0x6ffec596, 0x68082690, 0x6013039a, 0x67e5e09c,
+    0x4f9251be, 0x4864b2b8, 0x407f97b2, 0x478974b4,
+    0x5049dda6, 0x57bf3ea0, 0x5fa41baa, 0x5852f8ac,
+    0xf197192e, 0xf661fa28, 0xfe7adf22, 0xf98c3c24,
+    0xee4c9536, 0xe9ba7630, 0xe1a1533a, 0xe657b03c,
+    0xce20011e, 0xc9d6e218, 0xc1cdc712, 0xc63b2414,
+    0xd1fb8d06, 0xd60d6e00, 0xde164b0a, 0xd9e0a80c,
+    0x8ef9294e, 0x890fca48, 0x8114ef42, 0x86e20c44,
+    0x9122a556, 0x96d44650, 0x9ecf635a, 0x9939805c,
+    0xb14e317e, 0xb6b8d278, 0xbea3f772, 0xb9551474,
+    0xae95bd66, 0xa9635e60, 0xa1787b6a, 0xa68e986c
+  },
+  {
+    0x00000000, 0xe8a45605, 0xd589b1bd, 0x3d2de7b8,
+    0xafd27ecd, 0x477628c8, 0x7a5bcf70, 0x92ff9975,
+    0x5b65e02d, 0xb3c1b628, 0x8eec5190, 0x66480795,
+    0xf4b79ee0, 0x1c13c8e5, 0x213e2f5d, 0xc99a7958,
+    0xb6cbc05a, 0x5e6f965f, 0x634271e7, 0x8be627e2,
+    0x1919be97, 0xf1bde892, 0xcc900f2a, 0x2434592f,
+    0xedae2077, 0x050a7672, 0x382791ca, 0xd083c7cf,
+    0x427c5eba, 0xaad808bf, 0x97f5ef07, 0x7f51b902,
+    0x69569d03, 0x81f2cb06, 0xbcdf2cbe, 0x547b7abb,
+    0xc684e3ce, 0x2e20b5cb, 0x130d5273, 0xfba90476,
+    0x32337d2e, 0xda972b2b, 0xe7bacc93, 0x0f1e9a96,
+    0x9de103e3, 0x754555e6, 0x4868b25e, 0xa0cce45b,
+    0xdf9d5d59, 0x37390b5c, 0x0a14ece4, 0xe2b0bae1,
+    0x704f2394, 0x98eb7591, 0xa5c69229, 0x4d62c42c,
+    0x84f8bd74, 0x6c5ceb71, 0x51710cc9, 0xb9d55acc,
+    0x2b2ac3b9, 0xc38e95bc, 0xfea37204, 0x16072401,
+    0xd2ad3a06, 0x3a096c03, 0x07248bbb, 0xef80ddbe,
+    0x7d7f44cb, 0x95db12ce, 0xa8f6f576, 0x4052a373,
+    0x89c8da2b, 0x616c8c2e, 0x5c416b96, 0xb4e53d93,
+    0x261aa4e6, 0xcebef2e3, 0xf393155b, 0x1b37435e,
+    0x6466fa5c, 0x8cc2ac59, 0xb1ef4be1, 0x594b1de4,
+    0xcbb48491, 0x2310d294, 0x1e3d352c, 0xf6996329,
+    0x3f031a71, 0xd7a74c74, 0xea8aabcc, 0x022efdc9,
+    0x90d164bc, 0x787532b9, 0x4558d501, 0xadfc8304,
+    0xbbfba705, 0x535ff100, 0x6e7216b8, 0x86d640bd,
+    0x1429d9c8, 0xfc8d8fcd, 0xc1a06875, 0x29043e70,
+    0xe09e4728, 0x083a112d, 0x3517f695, 0xddb3a090,
+    0x4f4c39e5, 0xa7e86fe0, 0x9ac58858, 0x7261de5d,
+    0x0d30675f, 0xe594315a, 0xd8b9d6e2, 0x301d80e7,
+    0xa2e21992, 0x4a464f97, 0x776ba82f, 0x9fcffe2a,
+    0x56558772, 0xbef1d177, 0x83dc36cf, 0x6b7860ca,
+    0xf987f9bf, 0x1123afba, 0x2c0e4802, 0xc4aa1e07,
+    0xa19b69bb, 0x493f3fbe, 0x7412d806, 0x9cb68e03,
+    0x0e491776, 0xe6ed4173, 0xdbc0a6cb, 0x3364f0ce,
+    0xfafe8996, 0x125adf93, 0x2f77382b, 0xc7d36e2e,
+    0x552cf75b, 0xbd88a15e, 0x80a546e6, 0x680110e3,
+    0x1750a9e1, 0xfff4ffe4, 0xc2d9185c, 0x2a7d4e59,
+    0xb882d72c, 0x50268129, 0x6d0b6691, 0x85af3094,
+    0x4c3549cc, 0xa4911fc9, 0x99bcf871, 0x7118ae74,
+    0xe3e73701, 0x0b436104, 0x366e86bc, 0xdecad0b9,
+    0xc8cdf4b8, 0x2069a2bd, 0x1d444505, 0xf5e01300,
+    0x671f8a75, 0x8fbbdc70, 0xb2963bc8, 0x5a326dcd,
+    0x93a81495, 0x7b0c4290, 0x4621a528, 0xae85f32d,
+    0x3c7a6a58, 0xd4de3c5d, 0xe9f3dbe5, 0x01578de0,
+    0x7e0634e2, 0x96a262e7, 0xab8f855f, 0x432bd35a,
+    0xd1d44a2f, 0x39701c2a, 0x045dfb92, 0xecf9ad97,
+    0x2563d4cf, 0xcdc782ca, 0xf0ea6572, 0x184e3377,
+    0x8ab1aa02, 0x6215fc07, 0x5f381bbf, 0xb79c4dba,
+    0x733653bd, 0x9b9205b8, 0xa6bfe200, 0x4e1bb405,
+    0xdce42d70, 0x34407b75, 0x096d9ccd, 0xe1c9cac8,
+    0x2853b390, 0xc0f7e595, 0xfdda022d, 0x157e5428,
+    0x8781cd5d, 0x6f259b58, 0x52087ce0, 0xbaac2ae5,
+    0xc5fd93e7, 0x2d59c5e2, 0x1074225a, 0xf8d0745f,
+    0x6a2fed2a, 0x828bbb2f, 0xbfa65c97, 0x57020a92,
+    0x9e9873ca, 0x763c25cf, 0x4b11c277, 0xa3b59472,
+    0x314a0d07, 0xd9ee5b02, 0xe4c3bcba, 0x0c67eabf,
+    0x1a60cebe, 0xf2c498bb, 0xcfe97f03, 0x274d2906,
+    0xb5b2b073, 0x5d16e676, 0x603b01ce, 0x889f57cb,
+    0x41052e93, 0xa9a17896, 0x948c9f2e, 0x7c28c92b,
+    0xeed7505e, 0x0673065b, 0x3b5ee1e3, 0xd3fab7e6,
+    0xacab0ee4, 0x440f58e1, 0x7922bf59, 0x9186e95c,
+    0x03797029, 0xebdd262c, 0xd6f0c194, 0x3e549791,
+    0xf7ceeec9, 0x1f6ab8cc, 0x22475f74, 0xcae30971,
+    0x581c9004, 0xb0b8c601, 0x8d9521b9, 0x653177bc
+  },
+  {
+    0x00000000, 0x47f7cec1, 0x8fef9d82, 0xc8185343,
+    0x1b1e26b3, 0x5ce9e872, 0x94f1bb31, 0xd30675f0,
+    0x363c4d66, 0x71cb83a7, 0xb9d3d0e4, 0xfe241e25,
+    0x2d226bd5, 0x6ad5a514, 0xa2cdf657, 0xe53a3896,
+    0x6c789acc, 0x2b8f540d, 0xe397074e, 0xa460c98f,
+    0x7766bc7f, 0x309172be, 0xf88921fd, 0xbf7eef3c,
+    0x5a44d7aa, 0x1db3196b, 0xd5ab4a28, 0x925c84e9,
+    0x415af119, 0x06ad3fd8, 0xceb56c9b, 0x8942a25a,
+    0xd8f13598, 0x9f06fb59, 0x571ea81a, 0x10e966db,
+    0xc3ef132b, 0x8418ddea, 0x4c008ea9, 0x0bf74068,
+    0xeecd78fe, 0xa93ab63f, 0x6122e57c, 0x26d52bbd,
+    0xf5d35e4d, 0xb224908c, 0x7a3cc3cf, 0x3dcb0d0e,
+    0xb489af54, 0xf37e6195, 0x3b6632d6, 0x7c91fc17,
+    0xaf9789e7, 0xe8604726, 0x20781465, 0x678fdaa4,
+    0x82b5e232, 0xc5422cf3, 0x0d5a7fb0, 0x4aadb171,
+    0x99abc481, 0xde5c0a40, 0x16445903, 0x51b397c2,
+    0xb5237687, 0xf2d4b846, 0x3acceb05, 0x7d3b25c4,
+    0xae3d5034, 0xe9ca9ef5, 0x21d2cdb6, 0x66250377,
+    0x831f3be1, 0xc4e8f520, 0x0cf0a663, 0x4b0768a2,
+    0x98011d52, 0xdff6d393, 0x17ee80d0, 0x50194e11,
+    0xd95bec4b, 0x9eac228a, 0x56b471c9, 0x1143bf08,
+    0xc245caf8, 0x85b20439, 0x4daa577a, 0x0a5d99bb,
+    0xef67a12d, 0xa8906fec, 0x60883caf, 0x277ff26e,
+    0xf479879e, 0xb38e495f, 0x7b961a1c, 0x3c61d4dd,
+    0x6dd2431f, 0x2a258dde, 0xe23dde9d, 0xa5ca105c,
+    0x76cc65ac, 0x313bab6d, 0xf923f82e, 0xbed436ef,
+    0x5bee0e79, 0x1c19c0b8, 0xd40193fb, 0x93f65d3a,
+    0x40f028ca, 0x0707e60b, 0xcf1fb548, 0x88e87b89,
+    0x01aad9d3, 0x465d1712, 0x8e454451, 0xc9b28a90,
+    0x1ab4ff60, 0x5d4331a1, 0x955b62e2, 0xd2acac23,
+    0x379694b5, 0x70615a74, 0xb8790937, 0xff8ec7f6,
+    0x2c88b206, 0x6b7f7cc7, 0xa3672f84, 0xe490e145,
+    0x6e87f0b9, 0x29703e78, 0xe1686d3b, 0xa69fa3fa,
+    0x7599d60a, 0x326e18cb, 0xfa764b88, 0xbd818549,
+    0x58bbbddf, 0x1f4c731e, 0xd754205d, 0x90a3ee9c,
+    0x43a59b6c, 0x045255ad, 0xcc4a06ee, 0x8bbdc82f,
+    0x02ff6a75, 0x4508a4b4, 0x8d10f7f7, 0xcae73936,
+    0x19e14cc6, 0x5e168207, 0x960ed144, 0xd1f91f85,
+    0x34c32713, 0x7334e9d2, 0xbb2cba91, 0xfcdb7450,
+    0x2fdd01a0, 0x682acf61, 0xa0329c22, 0xe7c552e3,
+    0xb676c521, 0xf1810be0, 0x399958a3, 0x7e6e9662,
+    0xad68e392, 0xea9f2d53, 0x22877e10, 0x6570b0d1,
+    0x804a8847, 0xc7bd4686, 0x0fa515c5, 0x4852db04,
+    0x9b54aef4, 0xdca36035, 0x14bb3376, 0x534cfdb7,
+    0xda0e5fed, 0x9df9912c, 0x55e1c26f, 0x12160cae,
+    0xc110795e, 0x86e7b79f, 0x4effe4dc, 0x09082a1d,
+    0xec32128b, 0xabc5dc4a, 0x63dd8f09, 0x242a41c8,
+    0xf72c3438, 0xb0dbfaf9, 0x78c3a9ba, 0x3f34677b,
+    0xdba4863e, 0x9c5348ff, 0x544b1bbc, 0x13bcd57d,
+    0xc0baa08d, 0x874d6e4c, 0x4f553d0f, 0x08a2f3ce,
+    0xed98cb58, 0xaa6f0599, 0x627756da, 0x2580981b,
+    0xf686edeb, 0xb171232a, 0x79697069, 0x3e9ebea8,
+    0xb7dc1cf2, 0xf02bd233, 0x38338170, 0x7fc44fb1,
+    0xacc23a41, 0xeb35f480, 0x232da7c3, 0x64da6902,
+    0x81e05194, 0xc6179f55, 0x0e0fcc16, 0x49f802d7,
+    0x9afe7727, 0xdd09b9e6, 0x1511eaa5, 0x52e62464,
+    0x0355b3a6, 0x44a27d67, 0x8cba2e24, 0xcb4de0e5,
+    0x184b9515, 0x5fbc5bd4, 0x97a40897, 0xd053c656,
+    0x3569fec0, 0x729e3001, 0xba866342, 0xfd71ad83,
+    0x2e77d873, 0x698016b2, 0xa19845f1, 0xe66f8b30,
+    0x6f2d296a, 0x28dae7ab, 0xe0c2b4e8, 0xa7357a29,
+    0x74330fd9, 0x33c4c118, 0xfbdc925b, 0xbc2b5c9a,
+    0x5911640c, 0x1ee6aacd, 0xd6fef98e, 0x9109374f,
+    0x420f42bf, 0x05f88c7e, 0xcde0df3d, 0x8a1711fc
+  },
+  {
+    0x00000000, 0xdd0fe172, 0xbededf53, 0x63d13e21,
+    0x797ca311, 0xa4734263, 0xc7a27c42, 0x1aad9d30,
+    0xf2f94622, 0x2ff6a750, 0x4c279971, 0x91287803,
+    0x8b85e533, 0x568a0441, 0x355b3a60, 0xe854db12,
+    0xe13391f3, 0x3c3c7081, 0x5fed4ea0, 0x82e2afd2,
+    0x984f32e2, 0x4540d390, 0x2691edb1, 0xfb9e0cc3,
+    0x13cad7d1, 0xcec536a3, 0xad140882, 0x701be9f0,
+    0x6ab674c0, 0xb7b995b2, 0xd468ab93, 0x09674ae1,
+    0xc6a63e51, 0x1ba9df23, 0x7878e102, 0xa5770070,
+    0xbfda9d40, 0x62d57c32, 0x01044213, 0xdc0ba361,
+    0x345f7873, 0xe9509901, 0x8a81a720, 0x578e4652,
+    0x4d23db62, 0x902c3a10, 0xf3fd0431, 0x2ef2e543,
+    0x2795afa2, 0xfa9a4ed0, 0x994b70f1, 0x44449183,
+    0x5ee90cb3, 0x83e6edc1, 0xe037d3e0, 0x3d383292,
+    0xd56ce980, 0x086308f2, 0x6bb236d3, 0xb6bdd7a1,
+    0xac104a91, 0x711fabe3, 0x12ce95c2, 0xcfc174b0,
+    0x898d6115, 0x54828067, 0x3753be46, 0xea5c5f34,
+    0xf0f1c204, 0x2dfe2376, 0x4e2f1d57, 0x9320fc25,
+    0x7b742737, 0xa67bc645, 0xc5aaf864, 0x18a51916,
+    0x02088426, 0xdf076554, 0xbcd65b75, 0x61d9ba07,
+    0x68bef0e6, 0xb5b11194, 0xd6602fb5, 0x0b6fcec7,
+    0x11c253f7, 0xcccdb285, 0xaf1c8ca4, 0x72136dd6,
+    0x9a47b6c4, 0x474857b6, 0x24996997, 0xf99688e5,
+    0xe33b15d5, 0x3e34f4a7, 0x5de5ca86, 0x80ea2bf4,
+    0x4f2b5f44, 0x9224be36, 0xf1f58017, 0x2cfa6165,
+    0x3657fc55, 0xeb581d27, 0x88892306, 0x5586c274,
+    0xbdd21966, 0x60ddf814, 0x030cc635, 0xde032747,
+    0xc4aeba77, 0x19a15b05, 0x7a706524, 0xa77f8456,
+    0xae18ceb7, 0x73172fc5, 0x10c611e4, 0xcdc9f096,
+    0xd7646da6, 0x0a6b8cd4, 0x69bab2f5, 0xb4b55387,
+    0x5ce18895, 0x81ee69e7, 0xe23f57c6, 0x3f30b6b4,
+    0x259d2b84, 0xf892caf6, 0x9b43f4d7, 0x464c15a5,
+    0x17dbdf9d, 0xcad43eef, 0xa90500ce, 0x740ae1bc,
+    0x6ea77c8c, 0xb3a89dfe, 0xd079a3df, 0x0d7642ad,
+    0xe52299bf, 0x382d78cd, 0x5bfc46ec, 0x86f3a79e,
+    0x9c5e3aae, 0x4151dbdc, 0x2280e5fd, 0xff8f048f,
+    0xf6e84e6e, 0x2be7af1c, 0x4836913d, 0x9539704f,
+    0x8f94ed7f, 0x529b0c0d, 0x314a322c, 0xec45d35e,
+    0x0411084c, 0xd91ee93e, 0xbacfd71f, 0x67c0366d,
+    0x7d6dab5d, 0xa0624a2f, 0xc3b3740e, 0x1ebc957c,
+    0xd17de1cc, 0x0c7200be, 0x6fa33e9f, 0xb2acdfed,
+    0xa80142dd, 0x750ea3af, 0x16df9d8e, 0xcbd07cfc,
+    0x2384a7ee, 0xfe8b469c, 0x9d5a78bd, 0x405599cf,
+    0x5af804ff, 0x87f7e58d, 0xe426dbac, 0x39293ade,
+    0x304e703f, 0xed41914d, 0x8e90af6c, 0x539f4e1e,
+    0x4932d32e, 0x943d325c, 0xf7ec0c7d, 0x2ae3ed0f,
+    0xc2b7361d, 0x1fb8d76f, 0x7c69e94e, 0xa166083c,
+    0xbbcb950c, 0x66c4747e, 0x05154a5f, 0xd81aab2d,
+    0x9e56be88, 0x43595ffa, 0x208861db, 0xfd8780a9,
+    0xe72a1d99, 0x3a25fceb, 0x59f4c2ca, 0x84fb23b8,
+    0x6caff8aa, 0xb1a019d8, 0xd27127f9, 0x0f7ec68b,
+    0x15d35bbb, 0xc8dcbac9, 0xab0d84e8, 0x7602659a,
+    0x7f652f7b, 0xa26ace09, 0xc1bbf028, 0x1cb4115a,
+    0x06198c6a, 0xdb166d18, 0xb8c75339, 0x65c8b24b,
+    0x8d9c6959, 0x5093882b, 0x3342b60a, 0xee4d5778,
+    0xf4e0ca48, 0x29ef2b3a, 0x4a3e151b, 0x9731f469,
+    0x58f080d9, 0x85ff61ab, 0xe62e5f8a, 0x3b21bef8,
+    0x218c23c8, 0xfc83c2ba, 0x9f52fc9b, 0x425d1de9,
+    0xaa09c6fb, 0x77062789, 0x14d719a8, 0xc9d8f8da,
+    0xd37565ea, 0x0e7a8498, 0x6dabbab9, 0xb0a45bcb,
+    0xb9c3112a, 0x64ccf058, 0x071dce79, 0xda122f0b,
+    0xc0bfb23b, 0x1db05349, 0x7e616d68, 0xa36e8c1a,
+    0x4b3a5708, 0x9635b67a, 0xf5e4885b, 0x28eb6929,
+    0x3246f419, 0xef49156b, 0x8c982b4a, 0x5197ca38
+  },
+  {
+    0x00000000, 0x2fb7bf3a, 0x5f6f7e74, 0x70d8c14e,
+    0xbedefce8, 0x916943d2, 0xe1b1829c, 0xce063da6,
+    0x797ce467, 0x56cb5b5d, 0x26139a13, 0x09a42529,
+    0xc7a2188f, 0xe815a7b5, 0x98cd66fb, 0xb77ad9c1,
+    0xf2f9c8ce, 0xdd4e77f4, 0xad96b6ba, 0x82210980,
+    0x4c273426, 0x63908b1c, 0x13484a52, 0x3cfff568,
+    0x8b852ca9, 0xa4329393, 0xd4ea52dd, 0xfb5dede7,
+    0x355bd041, 0x1aec6f7b, 0x6a34ae35, 0x4583110f,
+    0xe1328c2b, 0xce853311, 0xbe5df25f, 0x91ea4d65,
+    0x5fec70c3, 0x705bcff9, 0x00830eb7, 0x2f34b18d,
+    0x984e684c, 0xb7f9d776, 0xc7211638, 0xe896a902,
+    0x269094a4, 0x09272b9e, 0x79ffead0, 0x564855ea,
+    0x13cb44e5, 0x3c7cfbdf, 0x4ca43a91, 0x631385ab,
+    0xad15b80d, 0x82a20737, 0xf27ac679, 0xddcd7943,
+    0x6ab7a082, 0x45001fb8, 0x35d8def6, 0x1a6f61cc,
+    0xd4695c6a, 0xfbdee350, 0x8b06221e, 0xa4b19d24,
+    0xc6a405e1, 0xe913badb, 0x99cb7b95, 0xb67cc4af,
+    0x787af909, 0x57cd4633, 0x2715877d, 0x08a23847,
+    0xbfd8e186, 0x906f5ebc, 0xe0b79ff2, 0xcf0020c8,
+    0x01061d6e, 0x2eb1a254, 0x5e69631a, 0x71dedc20,
+    0x345dcd2f, 0x1bea7215, 0x6b32b35b, 0x44850c61,
+    0x8a8331c7, 0xa5348efd, 0xd5ec4fb3, 0xfa5bf089,
+    0x4d212948, 0x62969672, 0x124e573c, 0x3df9e806,
+    0xf3ffd5a0, 0xdc486a9a, 0xac90abd4, 0x832714ee,
+    0x279689ca, 0x082136f0, 0x78f9f7be, 0x574e4884,
+    0x99487522, 0xb6ffca18, 0xc6270b56, 0xe990b46c,
+    0x5eea6dad, 0x715dd297, 0x018513d9, 0x2e32ace3,
+    0xe0349145, 0xcf832e7f, 0xbf5bef31, 0x90ec500b,
+    0xd56f4104, 0xfad8fe3e, 0x8a003f70, 0xa5b7804a,
+    0x6bb1bdec, 0x440602d6, 0x34dec398, 0x1b697ca2,
+    0xac13a563, 0x83a41a59, 0xf37cdb17, 0xdccb642d,
+    0x12cd598b, 0x3d7ae6b1, 0x4da227ff, 0x621598c5,
+    0x89891675, 0xa63ea94f, 0xd6e66801, 0xf951d73b,
+    0x3757ea9d, 0x18e055a7, 0x683894e9, 0x478f2bd3,
+    0xf0f5f212, 0xdf424d28, 0xaf9a8c66, 0x802d335c,
+    0x4e2b0efa, 0x619cb1c0, 0x1144708e, 0x3ef3cfb4,
+    0x7b70debb, 0x54c76181, 0x241fa0cf, 0x0ba81ff5,
+    0xc5ae2253, 0xea199d69, 0x9ac15c27, 0xb576e31d,
+    0x020c3adc, 0x2dbb85e6, 0x5d6344a8, 0x72d4fb92,
+    0xbcd2c634, 0x9365790e, 0xe3bdb840, 0xcc0a077a,
+    0x68bb9a5e, 0x470c2564, 0x37d4e42a, 0x18635b10,
+    0xd66566b6, 0xf9d2d98c, 0x890a18c2, 0xa6bda7f8,
+    0x11c77e39, 0x3e70c103, 0x4ea8004d, 0x611fbf77,
+    0xaf1982d1, 0x80ae3deb, 0xf076fca5, 0xdfc1439f,
+    0x9a425290, 0xb5f5edaa, 0xc52d2ce4, 0xea9a93de,
+    0x249cae78, 0x0b2b1142, 0x7bf3d00c, 0x54446f36,
+    0xe33eb6f7, 0xcc8909cd, 0xbc51c883, 0x93e677b9,
+    0x5de04a1f, 0x7257f525, 0x028f346b, 0x2d388b51,
+    0x4f2d1394, 0x609aacae, 0x10426de0, 0x3ff5d2da,
+    0xf1f3ef7c, 0xde445046, 0xae9c9108, 0x812b2e32,
+    0x3651f7f3, 0x19e648c9, 0x693e8987, 0x468936bd,
+    0x888f0b1b, 0xa738b421, 0xd7e0756f, 0xf857ca55,
+    0xbdd4db5a, 0x92636460, 0xe2bba52e, 0xcd0c1a14,
+    0x030a27b2, 0x2cbd9888, 0x5c6559c6, 0x73d2e6fc,
+    0xc4a83f3d, 0xeb1f8007, 0x9bc74149, 0xb470fe73,
+    0x7a76c3d5, 0x55c17cef, 0x2519bda1, 0x0aae029b,
+    0xae1f9fbf, 0x81a82085, 0xf170e1cb, 0xdec75ef1,
+    0x10c16357, 0x3f76dc6d, 0x4fae1d23, 0x6019a219,
+    0xd7637bd8, 0xf8d4c4e2, 0x880c05ac, 0xa7bbba96,
+    0x69bd8730, 0x460a380a, 0x36d2f944, 0x1965467e,
+    0x5ce65771, 0x7351e84b, 0x03892905, 0x2c3e963f,
+    0xe238ab99, 0xcd8f14a3, 0xbd57d5ed, 0x92e06ad7,
+    0x259ab316, 0x0a2d0c2c, 0x7af5cd62, 0x55427258,
+    0x9b444ffe, 0xb4f3f0c4, 0xc42b318a, 0xeb9c8eb0
+  }
+};
+
+#define DVBPSI_CRC32_X128 0xe8a45605
+#define DVBPSI_CRC32_X192 0xc5b9cd4c
+#define DVBPSI_CRC32_X512 0xe6228b11
+#define DVBPSI_CRC32_X576 0x8833794c
+
+/*****************************************************************************
+ * dvbpsi_crc32_bytes
+ *****************************************************************************
+ * Byte per byte table lookup, the reference implementation.
+ *****************************************************************************/
+static uint32_t dvbpsi_crc32_bytes(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    while (i_size--)
+        i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[0][(i_crc >> 24) ^ *p_data++];
+
+    return i_crc;
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_slice8
+ *****************************************************************************
+ * Slicing-by-8: the CRC is xored in the first 4 bytes and the 8 bytes are
+ * looked up independently.
+ *****************************************************************************/
+static uint32_t dvbpsi_crc32_slice8(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    while (i_size >= 8)
+    {
+        uint32_t a = i_crc ^ (  (uint32_t)p_data[0] << 24 | (uint32_t)p_data[1] << 16
+                              | (uint32_t)p_data[2] << 8  | (uint32_t)p_data[3]);
+        i_crc =   dvbpsi_crc32_table[7][a >> 24]
+                ^ dvbpsi_crc32_table[6][(a >> 16) & 0xff]
+                ^ dvbpsi_crc32_table[5][(a >> 8) & 0xff]
+                ^ dvbpsi_crc32_table[4][a & 0xff]
+                ^ dvbpsi_crc32_table[3][p_data[4]]
+                ^ dvbpsi_crc32_table[2][p_data[5]]
+                ^ dvbpsi_crc32_table[1][p_data[6]]
+                ^ dvbpsi_crc32_table[0][p_data[7]];
+        p_data += 8;
+        i_size -= 8;
+    }
+
+    return dvbpsi_crc32_bytes(i_crc, p_data, i_size);
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_slice16
+ *****************************************************************************
+ * Slicing-by-16, same as slicing-by-8 with 16 bytes per iteration.
+ *****************************************************************************/
+static uint32_t dvbpsi_crc32_slice16(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    while (i_size >= 16)
+    {
+        uint32_t a = i_crc ^ (  (uint32_t)p_data[0] << 24 | (uint32_t)p_data[1] << 16
+                              | (uint32_t)p_data[2] << 8  | (uint32_t)p_data[3]);
+        i_crc =   dvbpsi_crc32_table[15][a >> 24]
+                ^ dvbpsi_crc32_table[14][(a >> 16) & 0xff]
+                ^ dvbpsi_crc32_table[13][(a >> 8) & 0xff]
+                ^ dvbpsi_crc32_table[12][a & 0xff]
+                ^ dvbpsi_crc32_table[11][p_data[4]]
+                ^ dvbpsi_crc32_table[10][p_data[5]]
+                ^ dvbpsi_crc32_table[9][p_data[6]]
+                ^ dvbpsi_crc32_table[8][p_data[7]]
+                ^ dvbpsi_crc32_table[7][p_data[8]]
+                ^ dvbpsi_crc32_table[6][p_data[9]]
+                ^ dvbpsi_crc32_table[5][p_data[10]]
+                ^ dvbpsi_crc32_table[4][p_data[11]]
+                ^ dvbpsi_crc32_table[3][p_data[12]]
+                ^ dvbpsi_crc32_table[2][p_data[13]]
+                ^ dvbpsi_crc32_table[1][p_data[14]]
+                ^ dvbpsi_crc32_table[0][p_data[15]];
+        p_data += 16;
+        i_size -= 16;
+    }
+
+    return dvbpsi_crc32_slice8(i_crc, p_data, i_size);
+}
+
+/*****************************************************************************
+ * Carry-less multiplication folding
+ *****************************************************************************
+ * The data is loaded in 128 bit blocks with the first byte as the most
+ * significant one, so that bit n of a block is the coefficient of x^n. The
+ * CRC is xored in the first 32 bits. An accumulator A followed by a block B
+ * is then A.x^128 + B, and with A = H.x^64 + L:
+ *
+ *   A.x^128 + B = H.(x^192 mod P) + L.(x^128 mod P) + B   (mod P)
+ *
+ * which fits again in 128 bits. Four accumulators are folded in parallel
+ * 512 bits ahead. The last accumulator is congruent to the data seen so far
+ * and is fed to slicing-by-16 together with the remaining bytes, which
+ * computes the final A.x^32 mod P.
+ *****************************************************************************/
+#define DVBPSI_CRC32_FOLD_MIN 64 /* shorter buffers are not worth it */
+
+#if defined(DVBPSI_CRC32_HAVE_PCLMUL)
+
+#define DVBPSI_CRC32_TARGET __attribute__((target("pclmul,ssse3")))
+
+DVBPSI_CRC32_TARGET
+static inline __m128i dvbpsi_crc32_load(const uint8_t *p_data)
+{
+    const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p_data), swap);
+}
+
+DVBPSI_CRC32_TARGET
+static inline __m128i dvbpsi_crc32_fold(__m128i a, const __m128i k, const __m128i b)
+{
+    /* k holds x^(n+64) mod P in its high half and x^n mod P in its low half */
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x11),
+                                       _mm_clmulepi64_si128(a, k, 0x00)), b);
+}
+
+DVBPSI_CRC32_TARGET
+static uint32_t dvbpsi_crc32_clmul(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    if (i_size < DVBPSI_CRC32_FOLD_MIN)
+        return dvbpsi_crc32_slice16(i_crc, p_data, i_size);
+
+    const __m128i k512 = _mm_set_epi64x(DVBPSI_CRC32_X576, DVBPSI_CRC32_X512);
+    const __m128i k128 = _mm_set_epi64x(DVBPSI_CRC32_X192, DVBPSI_CRC32_X128);
+
+    __m128i a0 = _mm_xor_si128(dvbpsi_crc32_load(p_data),
+                               _mm_set_epi32((int)i_crc, 0, 0, 0));
+    __m128i a1 = dvbpsi_crc32_load(p_data + 16);
+    __m128i a2 = dvbpsi_crc32_load(p_data + 32);
+    __m128i a3 = dvbpsi_crc32_load(p_data + 48);
+    p_data += 64;
+    i_size -= 64;
+
+    while (i_size >= 64)
+    {
+        a0 = dvbpsi_crc32_fold(a0, k512, dvbpsi_crc32_load(p_data));
+        a1 = dvbpsi_crc32_fold(a1, k512, dvbpsi_crc32_load(p_data + 16));
+        a2 = dvbpsi_crc32_fold(a2, k512, dvbpsi_crc32_load(p_data + 32));
+        a3 = dvbpsi_crc32_fold(a3, k512, dvbpsi_crc32_load(p_data + 48));
+        p_data += 64;
+        i_size -= 64;
+    }
+
+    a0 = dvbpsi_crc32_fold(a0, k128, a1);
+    a0 = dvbpsi_crc32_fold(a0, k128, a2);
+    a0 = dvbpsi_crc32_fold(a0, k128, a3);
+
+    while (i_size >= 16)
+    {
+        a0 = dvbpsi_crc32_fold(a0, k128, dvbpsi_crc32_load(p_data));
+        p_data += 16;
+        i_size -= 16;
+    }
+
+    /* Back to memory order */
+    uint8_t p_last[16];
+    const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+    _mm_storeu_si128((__m128i *)p_last, _mm_shuffle_epi8(a0, swap));
+
+    i_crc = dvbpsi_crc32_slice16(0, p_last, 16);
+    return dvbpsi_crc32_slice16(i_crc, p_data, i_size);
+}
+
+static bool dvbpsi_crc32_clmul_supported(void)
+{
+    /* cpuid is slow, notably in virtual machines, ask only once */
+    static int i_supported = -1;
+    unsigned int eax, ebx, ecx, edx;
+
+    if (i_supported < 0)
+    {
+        /* PCLMULQDQ and SSSE3 */
+        i_supported = __get_cpuid(1, &eax, &ebx, &ecx, &edx)
+                      && (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+    }
+    return i_supported;
+}
+
+#elif defined(DVBPSI_CRC32_HAVE_PMULL)
+
+static inline uint64x2_t dvbpsi_crc32_load(const uint8_t *p_data)
+{
+    uint8x16_t v = vrev64q_u8(vld1q_u8(p_data));
+    return vreinterpretq_u64_u8(vextq_u8(v, v, 8));
+}
+
+static inline uint64x2_t dvbpsi_crc32_fold(uint64x2_t a, const poly64_t k_hi,
+                                           const poly64_t k_lo, const uint64x2_t b)
+{
+    uint64x2_t h = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 1), k_hi));
+    uint64x2_t l = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(a, 0), k_lo));
+    return veorq_u64(veorq_u64(h, l), b);
+}
+
+static uint32_t dvbpsi_crc32_clmul(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    if (i_size < DVBPSI_CRC32_FOLD_MIN)
+        return dvbpsi_crc32_slice16(i_crc, p_data, i_size);
+
+    const uint64_t p_crc[2] = { 0, (uint64_t)i_crc << 32 };
+    uint64x2_t a0 = veorq_u64(dvbpsi_crc32_load(p_data), vld1q_u64(p_crc));
+    uint64x2_t a1 = dvbpsi_crc32_load(p_data + 16);
+    uint64x2_t a2 = dvbpsi_crc32_load(p_data + 32);
+    uint64x2_t a3 = dvbpsi_crc32_load(p_data + 48);
+    p_data += 64;
+    i_size -= 64;
+
+    while (i_size >= 64)
+    {
+        a0 = dvbpsi_crc32_fold(a0, DVBPSI_CRC32_X576, DVBPSI_CRC32_X512,
+                               dvbpsi_crc32_load(p_data));
+        a1 = dvbpsi_crc32_fold(a1, DVBPSI_CRC32_X576, DVBPSI_CRC32_X512,
+                               dvbpsi_crc32_load(p_data + 16));
+        a2 = dvbpsi_crc32_fold(a2, DVBPSI_CRC32_X576, DVBPSI_CRC32_X512,
+                               dvbpsi_crc32_load(p_data + 32));
+        a3 = dvbpsi_crc32_fold(a3, DVBPSI_CRC32_X576, DVBPSI_CRC32_X512,
+                               dvbpsi_crc32_load(p_data + 48));
+        p_data += 64;
+        i_size -= 64;
+    }
+
+    a0 = dvbpsi_crc32_fold(a0, DVBPSI_CRC32_X192, DVBPSI_CRC32_X128, a1);
+    a0 = dvbpsi_crc32_fold(a0, DVBPSI_CRC32_X192, DVBPSI_CRC32_X128, a2);
+    a0 = dvbpsi_crc32_fold(a0, DVBPSI_CRC32_X192, DVBPSI_CRC32_X128, a3);
+
+    while (i_size >= 16)
+    {
+        a0 = dvbpsi_crc32_fold(a0, DVBPSI_CRC32_X192, DVBPSI_CRC32_X128,
+                               dvbpsi_crc32_load(p_data));
+        p_data += 16;
+        i_size -= 16;
+    }
+
+    /* Back to memory order */
+    uint8_t p_last[16];
+    uint8x16_t v = vrev64q_u8(vreinterpretq_u8_u64(a0));
+    vst1q_u8(p_last, vextq_u8(v, v, 8));
+
+    i_crc = dvbpsi_crc32_slice16(0, p_last, 16);
+    return dvbpsi_crc32_slice16(i_crc, p_data, i_size);
+}
+
+static bool dvbpsi_crc32_clmul_supported(void)
+{
+    /* Only built when the compiler targets the crypto extension */
+    return true;
+}
+
+#endif
+
+/*****************************************************************************
+ * Runtime dispatch
+ *****************************************************************************
+ * The first call picks the fastest implementation for this CPU. Picking it
+ * twice from concurrent first calls is harmless.
+ *****************************************************************************/
+typedef uint32_t (* dvbpsi_crc32_func_t)(uint32_t i_crc, const uint8_t *p_data,
+                                         size_t i_size);
+
+static dvbpsi_crc32_impl_t dvbpsi_crc32_best(void)
+{
+#if defined(DVBPSI_CRC32_HAVE_PCLMUL) || defined(DVBPSI_CRC32_HAVE_PMULL)
+    if (dvbpsi_crc32_clmul_supported())
+        return DVBPSI_CRC32_CLMUL;
+#endif
+    return DVBPSI_CRC32_SLICE16;
+}
+
+static dvbpsi_crc32_func_t dvbpsi_crc32_func(const dvbpsi_crc32_impl_t i_impl)
+{
+    switch (i_impl)
+    {
+        case DVBPSI_CRC32_AUTO:
+            return dvbpsi_crc32_func(dvbpsi_crc32_best());
+        case DVBPSI_CRC32_TABLE:
+            return dvbpsi_crc32_bytes;
+        case DVBPSI_CRC32_SLICE8:
+            return dvbpsi_crc32_slice8;
+        case DVBPSI_CRC32_SLICE16:
+            return dvbpsi_crc32_slice16;
+        case DVBPSI_CRC32_CLMUL:
+#if defined(DVBPSI_CRC32_HAVE_PCLMUL) || defined(DVBPSI_CRC32_HAVE_PMULL)
+            if (dvbpsi_crc32_clmul_supported())
+                return dvbpsi_crc32_clmul;
+#endif
+            return NULL;
+    }
+    return NULL;
+}
+
+static uint32_t dvbpsi_crc32_dispatch(uint32_t i_crc, const uint8_t *p_data,
+                                      size_t i_size);
+
+static dvbpsi_crc32_func_t pf_crc32 = dvbpsi_crc32_dispatch;
+
+static uint32_t dvbpsi_crc32_dispatch(uint32_t i_crc, const uint8_t *p_data,
+                                      size_t i_size)
+{
+    pf_crc32 = dvbpsi_crc32_func(DVBPSI_CRC32_AUTO);
+    return pf_crc32(i_crc, p_data, i_size);
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32
+ *****************************************************************************/
+uint32_t dvbpsi_crc32(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+{
+    return pf_crc32(i_crc, p_data, i_size);
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_multiply
+ *****************************************************************************
+ * Product of two polynomials modulo the CRC_32 polynomial, MSB first.
+ *****************************************************************************/
+static uint32_t dvbpsi_crc32_multiply(uint32_t a, uint32_t b)
+{
+    uint32_t i_product = 0;
+
+    for (int i = 31; i >= 0; i--)
+    {
+        i_product = (i_product << 1) ^ ((i_product & 0x80000000) ? 0x04c11db7 : 0);
+        if ((b >> i) & 1)
+            i_product ^= a;
+    }
+    return i_product;
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_shift
+ *****************************************************************************
+ * Feeding i_size zero bytes multiplies the CRC by x^(8 * i_size), which is
+ * computed by squaring.
+ *****************************************************************************/
+uint32_t dvbpsi_crc32_shift(uint32_t i_crc, size_t i_size)
+{
+    uint32_t i_power = 0x100; /* x^8 */
+
+    for (; i_size != 0 && i_crc != 0; i_size >>= 1)
+    {
+        if (i_size & 1)
+            i_crc = dvbpsi_crc32_multiply(i_crc, i_power);
+        i_power = dvbpsi_crc32_multiply(i_power, i_power);
+    }
+    return i_crc;
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_impl
+ *****************************************************************************/
+bool dvbpsi_crc32_impl(const dvbpsi_crc32_impl_t i_impl, uint32_t *p_crc,
+                       const uint8_t *p_data, size_t i_size)
+{
+    dvbpsi_crc32_func_t pf_func = dvbpsi_crc32_func(i_impl);
+    if (pf_func == NULL)
+        return false;
+
+    *p_crc = pf_func(*p_crc, p_data, i_size);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_crc32_get_impl
+ *****************************************************************************/
+dvbpsi_crc32_impl_t dvbpsi_crc32_get_impl(void)
+{
+    return dvbpsi_crc32_best();
+}
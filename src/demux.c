@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #if defined(HAVE_INTTYPES_H)
 #include <inttypes.h>
@@ -44,6 +45,70 @@
 #include "psi.h"
 #include "demux.h"
 
+static dvbpsi_demux_subtable_t *dvbpsi_DemuxFamilyFind(const dvbpsi_demux_family_t *p_family,
+                                                      const uint32_t i_id);
+
+/*****************************************************************************
+ * dvbpsi_DemuxRoute
+ *****************************************************************************
+ * Subtable decoder receiving the sections of a subtable. A family receives
+ * them itself unless the subtable is being decoded.
+ *****************************************************************************/
+static dvbpsi_decoder_t *dvbpsi_DemuxRoute(dvbpsi_decoder_t *p_decoder,
+                                           const uint8_t i_table_id,
+                                           const uint16_t i_extension)
+{
+    dvbpsi_demux_subdec_t *p_subdec;
+    p_subdec = dvbpsi_demuxGetSubDec((dvbpsi_demux_t *)p_decoder, i_table_id, i_extension);
+    if (p_subdec)
+        return p_subdec->p_decoder;
+
+    dvbpsi_demux_family_t *p_family;
+    p_family = dvbpsi_demuxGetFamily((dvbpsi_demux_t *)p_decoder, i_table_id);
+    if (p_family == NULL)
+        return NULL;
+
+    const dvbpsi_demux_subtable_t *p_subtable;
+    p_subtable = dvbpsi_DemuxFamilyFind(p_family, (uint32_t)i_table_id << 16 | i_extension);
+    if (p_subtable && p_subtable->p_decoder)
+        return p_subtable->p_decoder;
+
+    return DVBPSI_DECODER(p_family);
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxDiscard
+ *****************************************************************************
+ * Subtables declined by the new subtable callback
+ *****************************************************************************/
+static bool dvbpsi_DemuxDiscard(dvbpsi_decoder_t *p_decoder,
+                                const uint8_t i_table_id,
+                                const uint16_t i_extension)
+{
+    const uint8_t *p_declined = ((dvbpsi_demux_t *)p_decoder)->p_declined[i_table_id];
+
+    return p_declined && (p_declined[i_extension >> 3] & (1 << (i_extension & 7)));
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxDecline
+ *****************************************************************************
+ * Remember a subtable declined by the new subtable callback. On error the
+ * callback will be called again for the next section.
+ *****************************************************************************/
+static void dvbpsi_DemuxDecline(dvbpsi_demux_t *p_demux, const uint8_t i_table_id,
+                                const uint16_t i_extension)
+{
+    if (p_demux->p_declined[i_table_id] == NULL)
+    {
+        p_demux->p_declined[i_table_id] = calloc(1, 65536 / 8);
+        if (p_demux->p_declined[i_table_id] == NULL)
+            return;
+    }
+
+    p_demux->p_declined[i_table_id][i_extension >> 3] |= 1 << (i_extension & 7);
+}
+
 /*****************************************************************************
  * dvbpsi_AttachDemux
  *****************************************************************************
@@ -64,13 +129,112 @@ bool dvbpsi_AttachDemux(dvbpsi_t *            p_dvbpsi,
 
     /* Subtables demux configuration */
     p_demux->p_first_subdec = NULL;
+    p_demux->p_first_family = NULL;
+    p_demux->pp_subdec_hash = NULL;
+    p_demux->i_subdec_hash_size = 0;
+    p_demux->i_subdec_count = 0;
     p_demux->pf_new_callback = pf_new_cb;
     p_demux->p_new_cb_data = p_new_cb_data;
+    p_demux->b_remember_declined = false;
+    for (int i = 0; i < 256; i++)
+        p_demux->p_declined[i] = NULL;
+    p_demux->pf_route = dvbpsi_DemuxRoute;
+    p_demux->pf_discard = dvbpsi_DemuxDiscard;
 
     p_dvbpsi->p_decoder = DVBPSI_DECODER(p_demux);
     return true;
 }
 
+/*****************************************************************************
+ * dvbpsi_DemuxHash
+ *****************************************************************************
+ * Hash bucket of a subtable id
+ *****************************************************************************/
+static inline unsigned int dvbpsi_DemuxHash(const uint32_t i_id, const unsigned int i_size)
+{
+    uint32_t i_hash = i_id * 0x9e3779b1;
+    return (i_hash ^ (i_hash >> 15)) & (i_size - 1);
+}
+
+/* Subtable id of the free entries of a family, above any real id */
+#define DVBPSI_DEMUX_NO_SUBTABLE 0xffffffff
+
+/*****************************************************************************
+ * dvbpsi_DemuxRehash
+ *****************************************************************************
+ * Resize the hash table of the subtable decoders. On error the current table
+ * is kept, which only makes the lookups slower.
+ *****************************************************************************/
+static void dvbpsi_DemuxRehash(dvbpsi_demux_t *p_demux, const unsigned int i_size)
+{
+    dvbpsi_demux_subdec_t **pp_hash = calloc(i_size, sizeof(dvbpsi_demux_subdec_t *));
+    if (pp_hash == NULL)
+        return;
+
+    dvbpsi_demux_subdec_t *p_subdec = p_demux->p_first_subdec;
+    while (p_subdec)
+    {
+        unsigned int i_bucket = dvbpsi_DemuxHash(p_subdec->i_id, i_size);
+        p_subdec->p_hash_next = pp_hash[i_bucket];
+        pp_hash[i_bucket] = p_subdec;
+        p_subdec = p_subdec->p_next;
+    }
+
+    free(p_demux->pp_subdec_hash);
+    p_demux->pp_subdec_hash = pp_hash;
+    p_demux->i_subdec_hash_size = i_size;
+}
+
+/*****************************************************************************
+ * dvbpsi_demux_remember_declined
+ *****************************************************************************
+ * Enable or disable the memory of the declined subtables
+ *****************************************************************************/
+void dvbpsi_demux_remember_declined(dvbpsi_t *p_dvbpsi, bool b_remember)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    p_demux->b_remember_declined = b_remember;
+    if (!b_remember)
+        dvbpsi_demux_clear_all_declined(p_dvbpsi);
+}
+
+/*****************************************************************************
+ * dvbpsi_demux_clear_declined
+ *****************************************************************************
+ * Forget a declined subtable
+ *****************************************************************************/
+void dvbpsi_demux_clear_declined(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                 uint16_t i_extension)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    if (p_demux->p_declined[i_table_id])
+        p_demux->p_declined[i_table_id][i_extension >> 3] &= ~(1 << (i_extension & 7));
+}
+
+/*****************************************************************************
+ * dvbpsi_demux_clear_all_declined
+ *****************************************************************************
+ * Forget all the declined subtables
+ *****************************************************************************/
+void dvbpsi_demux_clear_all_declined(dvbpsi_t *p_dvbpsi)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    for (int i = 0; i < 256; i++)
+    {
+        free(p_demux->p_declined[i]);
+        p_demux->p_declined[i] = NULL;
+    }
+}
+
 /*****************************************************************************
  * dvbpsi_demuxGetSubDec
  *****************************************************************************
@@ -81,6 +245,18 @@ dvbpsi_demux_subdec_t * dvbpsi_demuxGetSubDec(dvbpsi_demux_t * p_demux,
                                               uint16_t i_extension)
 {
     uint32_t i_id = (uint32_t)i_table_id << 16 |(uint32_t)i_extension;
+
+    if (p_demux->pp_subdec_hash)
+    {
+        dvbpsi_demux_subdec_t * p_subdec;
+        p_subdec = p_demux->pp_subdec_hash[dvbpsi_DemuxHash(i_id, p_demux->i_subdec_hash_size)];
+        while (p_subdec && p_subdec->i_id != i_id)
+            p_subdec = p_subdec->p_hash_next;
+
+        return p_subdec;
+    }
+
+    /* No hash table (out of memory) */
     dvbpsi_demux_subdec_t * p_subdec = p_demux->p_first_subdec;
 
     while (p_subdec)
@@ -94,6 +270,385 @@ dvbpsi_demux_subdec_t * dvbpsi_demuxGetSubDec(dvbpsi_demux_t * p_demux,
     return p_subdec;
 }
 
+/*****************************************************************************
+ * dvbpsi_DemuxFamilyFind
+ *****************************************************************************
+ * State of a subtable of a family, NULL if the family has not seen it. The
+ * states are hashed on the subtable id with linear probing.
+ *****************************************************************************/
+static dvbpsi_demux_subtable_t *dvbpsi_DemuxFamilyFind(const dvbpsi_demux_family_t *p_family,
+                                                      const uint32_t i_id)
+{
+    if (p_family->i_subtables_size == 0)
+        return NULL;
+
+    unsigned int i_mask = p_family->i_subtables_size - 1;
+    unsigned int i = dvbpsi_DemuxHash(i_id, p_family->i_subtables_size);
+    for (;; i = (i + 1) & i_mask)
+    {
+        if (p_family->p_subtables[i].i_id == i_id)
+            return &p_family->p_subtables[i];
+        if (p_family->p_subtables[i].i_id == DVBPSI_DEMUX_NO_SUBTABLE)
+            return NULL;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxFamilyInsert
+ *****************************************************************************
+ * Free state for a subtable id, the table must have room for it.
+ *****************************************************************************/
+static dvbpsi_demux_subtable_t *dvbpsi_DemuxFamilyInsert(dvbpsi_demux_family_t *p_family,
+                                                        const uint32_t i_id)
+{
+    unsigned int i_mask = p_family->i_subtables_size - 1;
+    unsigned int i = dvbpsi_DemuxHash(i_id, p_family->i_subtables_size);
+    while (p_family->p_subtables[i].i_id != DVBPSI_DEMUX_NO_SUBTABLE)
+        i = (i + 1) & i_mask;
+
+    p_family->p_subtables[i].i_id = i_id;
+    p_family->i_subtables++;
+    return &p_family->p_subtables[i];
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxFamilySubtable
+ *****************************************************************************
+ * State of a subtable of a family, added if it is new. The table is kept at
+ * most half full. NULL on error.
+ *****************************************************************************/
+static dvbpsi_demux_subtable_t *dvbpsi_DemuxFamilySubtable(dvbpsi_demux_family_t *p_family,
+                                                          const uint32_t i_id)
+{
+    dvbpsi_demux_subtable_t *p_subtable = dvbpsi_DemuxFamilyFind(p_family, i_id);
+    if (p_subtable)
+        return p_subtable;
+
+    if (2 * (p_family->i_subtables + 1) > p_family->i_subtables_size)
+    {
+        unsigned int i_old_size = p_family->i_subtables_size;
+        unsigned int i_size = i_old_size ? 2 * i_old_size : 16;
+        dvbpsi_demux_subtable_t *p_old = p_family->p_subtables;
+
+        p_family->p_subtables = malloc(i_size * sizeof(dvbpsi_demux_subtable_t));
+        if (p_family->p_subtables == NULL)
+        {
+            p_family->p_subtables = p_old;
+            return NULL;
+        }
+        for (unsigned int i = 0; i < i_size; i++)
+            p_family->p_subtables[i].i_id = DVBPSI_DEMUX_NO_SUBTABLE;
+        p_family->i_subtables_size = i_size;
+        p_family->i_subtables = 0;
+
+        for (unsigned int i = 0; i < i_old_size; i++)
+            if (p_old[i].i_id != DVBPSI_DEMUX_NO_SUBTABLE)
+                *dvbpsi_DemuxFamilyInsert(p_family, p_old[i].i_id) = p_old[i];
+        free(p_old);
+    }
+
+    p_subtable = dvbpsi_DemuxFamilyInsert(p_family, i_id);
+    p_subtable->i_version = 0;
+    p_subtable->b_current_next = false;
+    p_subtable->b_valid = false;
+    p_subtable->p_decoder = NULL;
+    return p_subtable;
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxFamilyPeek
+ *****************************************************************************
+ * Tell if a section belongs to a subtable of the family already decoded,
+ * given its header.
+ *****************************************************************************/
+static bool dvbpsi_DemuxFamilyPeek(dvbpsi_decoder_t *p_decoder, const uint8_t *p_header)
+{
+    dvbpsi_demux_family_t *p_family = (dvbpsi_demux_family_t *)p_decoder;
+    uint32_t i_id = (uint32_t)p_header[0] << 16 | (uint32_t)p_header[3] << 8 | p_header[4];
+
+    const dvbpsi_demux_subtable_t *p_subtable = dvbpsi_DemuxFamilyFind(p_family, i_id);
+    if (p_subtable == NULL)
+        return false;
+
+    if (p_subtable->p_decoder)
+        return p_subtable->p_decoder->pf_peek
+            && p_subtable->p_decoder->pf_peek(p_subtable->p_decoder, p_header);
+
+    return (p_subtable->b_valid)
+        && (p_subtable->i_version == ((p_header[5] & 0x3e) >> 1))
+        && (p_subtable->b_current_next == ((p_header[5] & 0x01) != 0));
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxFamilyChanged
+ *****************************************************************************
+ * A decoded subtable of the family changed without a version update, decode
+ * it again.
+ *****************************************************************************/
+static void dvbpsi_DemuxFamilyChanged(dvbpsi_decoder_t *p_decoder, const uint8_t i_table_id,
+                                      const uint16_t i_extension)
+{
+    dvbpsi_demux_family_t *p_family = (dvbpsi_demux_family_t *)p_decoder;
+
+    dvbpsi_demux_subtable_t *p_subtable;
+    p_subtable = dvbpsi_DemuxFamilyFind(p_family, (uint32_t)i_table_id << 16 | i_extension);
+    if (p_subtable == NULL)
+        return;
+
+    p_subtable->b_valid = false;
+    if (p_subtable->p_decoder)
+        p_subtable->p_decoder->b_current_valid = false;
+}
+
+/*****************************************************************************
+ * dvbpsi_DemuxFamilyGather
+ *****************************************************************************
+ * Sends a PSI section to the decoder of its subtable, created if the
+ * subtable is not decoded yet.
+ *****************************************************************************/
+static void dvbpsi_DemuxFamilyGather(dvbpsi_t *p_dvbpsi, dvbpsi_demux_family_t *p_family,
+                                     dvbpsi_psi_section_t *p_section)
+{
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    const uint8_t i_table_id = p_section->i_table_id;
+    const uint16_t i_extension = p_section->i_extension;
+    const uint8_t i_version = p_section->i_version;
+    const bool b_current_next = p_section->b_current_next;
+
+    dvbpsi_demux_subtable_t *p_subtable;
+    p_subtable = dvbpsi_DemuxFamilySubtable(p_family,
+                                            (uint32_t)i_table_id << 16 | i_extension);
+    if (p_subtable == NULL)
+    {
+        dvbpsi_decoder_section_cache_forget(DVBPSI_DECODER(p_family), i_table_id,
+                                            i_extension);
+        dvbpsi_DeletePSISections(p_section);
+        return;
+    }
+
+    if (p_subtable->p_decoder == NULL)
+    {
+        /* Don't decode since this version is already decoded */
+        if (!p_demux->b_discontinuity
+         && p_subtable->b_valid
+         && p_subtable->i_version == i_version
+         && p_subtable->b_current_next == b_current_next)
+        {
+            dvbpsi_DeletePSISections(p_section);
+            return;
+        }
+
+        /* From now on the decoder of the subtable gets its sections, the
+           repeats it needs must not be dropped */
+        dvbpsi_decoder_section_cache_forget(DVBPSI_DECODER(p_family), i_table_id,
+                                            i_extension);
+        p_subtable->p_decoder = p_family->pf_new(p_family, i_table_id, i_extension);
+        if (p_subtable->p_decoder == NULL)
+        {
+            dvbpsi_error(p_dvbpsi, "demux", "failed creating the decoder of "
+                         "(table_id == 0x%02x, extension == 0x%04x)",
+                         i_table_id, i_extension);
+            dvbpsi_DeletePSISections(p_section);
+            return;
+        }
+    }
+
+    dvbpsi_decoder_t *p_decoder = p_subtable->p_decoder;
+    p_family->pf_subtable_gather(p_dvbpsi, p_decoder, p_section);
+
+    /* Once the table is delivered only its version is kept. The section
+       completing it carried that version. */
+    if (p_decoder->b_current_valid && p_decoder->p_sections == NULL
+     && !p_demux->b_delta)
+    {
+        p_subtable->i_version = i_version;
+        p_subtable->b_current_next = b_current_next;
+        p_subtable->b_valid = true;
+        p_subtable->p_decoder = NULL;
+        p_family->pf_delete(p_decoder);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_NewDemuxFamily
+ *****************************************************************************
+ * Allocate a new family of subtables
+ *****************************************************************************/
+dvbpsi_demux_family_t *dvbpsi_NewDemuxFamily(const uint8_t i_first_table_id,
+                                             const uint8_t i_last_table_id,
+                                             dvbpsi_demux_gather_cb_t pf_gather,
+                                             dvbpsi_demux_family_new_cb_t pf_new,
+                                             dvbpsi_demux_family_delete_cb_t pf_delete,
+                                             const size_t i_size)
+{
+    assert(pf_gather);
+    assert(pf_new);
+    assert(pf_delete);
+    assert(i_size >= sizeof(dvbpsi_demux_family_t));
+
+    dvbpsi_demux_family_t *p_family;
+    p_family = (dvbpsi_demux_family_t *)dvbpsi_decoder_new(NULL, 0, true, i_size);
+    if (p_family == NULL)
+        return NULL;
+
+    p_family->i_first_table_id = i_first_table_id;
+    p_family->i_last_table_id = i_last_table_id;
+    p_family->pf_subtable_gather = pf_gather;
+    p_family->pf_new = pf_new;
+    p_family->pf_delete = pf_delete;
+    p_family->pf_table_callback = NULL;
+    p_family->p_cb_data = NULL;
+    p_family->p_subtables = NULL;
+    p_family->i_subtables = 0;
+    p_family->i_subtables_size = 0;
+    p_family->p_next = NULL;
+    p_family->pf_peek = dvbpsi_DemuxFamilyPeek;
+    p_family->pf_changed = dvbpsi_DemuxFamilyChanged;
+
+    return p_family;
+}
+
+/*****************************************************************************
+ * dvbpsi_DeleteDemuxFamily
+ *****************************************************************************
+ * Free a family of subtables
+ *****************************************************************************/
+void dvbpsi_DeleteDemuxFamily(dvbpsi_demux_family_t *p_family)
+{
+    assert(p_family);
+
+    for (unsigned int i = 0; i < p_family->i_subtables_size; i++)
+        if (p_family->p_subtables[i].i_id != DVBPSI_DEMUX_NO_SUBTABLE
+         && p_family->p_subtables[i].p_decoder)
+            p_family->pf_delete(p_family->p_subtables[i].p_decoder);
+    free(p_family->p_subtables);
+    dvbpsi_decoder_delete(DVBPSI_DECODER(p_family));
+}
+
+/*****************************************************************************
+ * dvbpsi_demuxGetFamily
+ *****************************************************************************
+ * Finds the family of a table id
+ *****************************************************************************/
+dvbpsi_demux_family_t *dvbpsi_demuxGetFamily(dvbpsi_demux_t *p_demux,
+                                             uint8_t i_table_id)
+{
+    dvbpsi_demux_family_t *p_family = p_demux->p_first_family;
+    while (p_family && (i_table_id < p_family->i_first_table_id
+                     || i_table_id > p_family->i_last_table_id))
+        p_family = p_family->p_next;
+
+    return p_family;
+}
+
+/*****************************************************************************
+ * dvbpsi_AttachDemuxFamily
+ *****************************************************************************/
+bool dvbpsi_AttachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family)
+{
+    assert(p_demux);
+    assert(p_family);
+
+    for (dvbpsi_demux_family_t *p = p_demux->p_first_family; p; p = p->p_next)
+        if (p_family->i_first_table_id <= p->i_last_table_id
+         && p->i_first_table_id <= p_family->i_last_table_id)
+            return false;
+
+    p_family->p_next = p_demux->p_first_family;
+    p_demux->p_first_family = p_family;
+
+    /* The family now takes the subtables the new subtable callback declined */
+    for (int i = p_family->i_first_table_id; i <= p_family->i_last_table_id; i++)
+    {
+        free(p_demux->p_declined[i]);
+        p_demux->p_declined[i] = NULL;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_DetachDemuxFamily
+ *****************************************************************************/
+void dvbpsi_DetachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family)
+{
+    assert(p_demux);
+    assert(p_family);
+
+    dvbpsi_demux_family_t **pp_prev = &p_demux->p_first_family;
+    while (*pp_prev != p_family)
+    {
+        assert(*pp_prev);
+        pp_prev = &(*pp_prev)->p_next;
+    }
+    *pp_prev = p_family->p_next;
+}
+
+/*****************************************************************************
+ * dvbpsi_AddDemuxFamily
+ *****************************************************************************
+ * Create a family and attach it to the demux of a handle.
+ *****************************************************************************/
+bool dvbpsi_AddDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                           const uint8_t i_first_table_id,
+                           const uint8_t i_last_table_id,
+                           dvbpsi_demux_gather_cb_t pf_gather,
+                           dvbpsi_demux_family_new_cb_t pf_new,
+                           dvbpsi_demux_family_delete_cb_t pf_delete,
+                           dvbpsi_demux_family_table_cb_t pf_callback,
+                           void *p_cb_data)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *) p_dvbpsi->p_decoder;
+
+    dvbpsi_demux_family_t *p_family;
+    p_family = dvbpsi_NewDemuxFamily(i_first_table_id, i_last_table_id, pf_gather,
+                                     pf_new, pf_delete, sizeof(dvbpsi_demux_family_t));
+    if (p_family == NULL)
+        return false;
+
+    p_family->pf_table_callback = pf_callback;
+    p_family->p_cb_data = p_cb_data;
+
+    if (!dvbpsi_AttachDemuxFamily(p_demux, p_family))
+    {
+        dvbpsi_error(p_dvbpsi, psz_decoder,
+                     "Already a decoder for a table_id in [0x%02x, 0x%02x]",
+                     i_first_table_id, i_last_table_id);
+        dvbpsi_DeleteDemuxFamily(p_family);
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_RemoveDemuxFamily
+ *****************************************************************************
+ * Detach and destroy the family of a table id.
+ *****************************************************************************/
+void dvbpsi_RemoveDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                              const uint8_t i_table_id,
+                              dvbpsi_demux_family_new_cb_t pf_new)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *) p_dvbpsi->p_decoder;
+
+    dvbpsi_demux_family_t *p_family = dvbpsi_demuxGetFamily(p_demux, i_table_id);
+    if (p_family == NULL || p_family->pf_new != pf_new)
+    {
+        dvbpsi_error(p_dvbpsi, psz_decoder,
+                     "No such family decoder (table_id == 0x%02x)", i_table_id);
+        return;
+    }
+
+    dvbpsi_DetachDemuxFamily(p_demux, p_family);
+    dvbpsi_DeleteDemuxFamily(p_family);
+}
+
 /*****************************************************************************
  * dvbpsi_Demux
  *****************************************************************************
@@ -108,6 +663,18 @@ void dvbpsi_Demux(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
     dvbpsi_demux_subdec_t * p_subdec = dvbpsi_demuxGetSubDec(p_demux, p_section->i_table_id,
                                                              p_section->i_extension);
     if (p_subdec == NULL)
+    {
+        dvbpsi_demux_family_t *p_family = dvbpsi_demuxGetFamily(p_demux, p_section->i_table_id);
+        if (p_family)
+        {
+            dvbpsi_DemuxFamilyGather(p_dvbpsi, p_family, p_section);
+            return;
+        }
+    }
+
+    if (p_subdec == NULL
+     && !dvbpsi_DemuxDiscard(DVBPSI_DECODER(p_demux), p_section->i_table_id,
+                             p_section->i_extension))
     {
         /* Tell the application we found a new subtable, so that it may attach a
          * subtable decoder */
@@ -117,6 +684,8 @@ void dvbpsi_Demux(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
         /* Check if a new subtable decoder is available */
         p_subdec = dvbpsi_demuxGetSubDec(p_demux, p_section->i_table_id,
                                          p_section->i_extension);
+        if (p_subdec == NULL && p_demux->b_remember_declined)
+            dvbpsi_DemuxDecline(p_demux, p_section->i_table_id, p_section->i_extension);
     }
 
     if (p_subdec)
@@ -149,6 +718,16 @@ void dvbpsi_DetachDemux(dvbpsi_t *p_dvbpsi)
         else free(p_subdec_temp);
     }
 
+    while (p_demux->p_first_family)
+    {
+        dvbpsi_demux_family_t *p_family = p_demux->p_first_family;
+        p_demux->p_first_family = p_family->p_next;
+        dvbpsi_DeleteDemuxFamily(p_family);
+    }
+
+    free(p_demux->pp_subdec_hash);
+    for (int i = 0; i < 256; i++)
+        free(p_demux->p_declined[i]);
     dvbpsi_decoder_delete(p_dvbpsi->p_decoder);
     p_dvbpsi->p_decoder = NULL;
 }
@@ -212,6 +791,25 @@ void dvbpsi_AttachDemuxSubDecoder(dvbpsi_demux_t *p_demux, dvbpsi_demux_subdec_t
 
     p_subdec->p_next = p_demux->p_first_subdec;
     p_demux->p_first_subdec = p_subdec;
+    p_demux->i_subdec_count++;
+
+    /* The subtable is no longer declined */
+    uint8_t *p_declined = p_demux->p_declined[(p_subdec->i_id >> 16) & 0xff];
+    if (p_declined)
+        p_declined[(p_subdec->i_id >> 3) & 0x1fff] &= ~(1 << (p_subdec->i_id & 7));
+
+    /* Keep at most one subtable decoder per bucket on average, a new
+       table holds all subtable decoders of the list already */
+    unsigned int i_size = p_demux->i_subdec_hash_size;
+    if (p_demux->i_subdec_count > i_size)
+        dvbpsi_DemuxRehash(p_demux, i_size ? 2 * i_size : 16);
+
+    if (p_demux->pp_subdec_hash && p_demux->i_subdec_hash_size == i_size)
+    {
+        unsigned int i_bucket = dvbpsi_DemuxHash(p_subdec->i_id, i_size);
+        p_subdec->p_hash_next = p_demux->pp_subdec_hash[i_bucket];
+        p_demux->pp_subdec_hash[i_bucket] = p_subdec;
+    }
 }
 
 /*****************************************************************************
@@ -233,4 +831,15 @@ void dvbpsi_DetachDemuxSubDecoder(dvbpsi_demux_t *p_demux, dvbpsi_demux_subdec_t
         pp_prev_subdec = &(*pp_prev_subdec)->p_next;
 
     *pp_prev_subdec = p_subdec->p_next;
+    p_demux->i_subdec_count--;
+
+    if (p_demux->pp_subdec_hash)
+    {
+        pp_prev_subdec = &p_demux->pp_subdec_hash[dvbpsi_DemuxHash(p_subdec->i_id,
+                                                      p_demux->i_subdec_hash_size)];
+        while (*pp_prev_subdec != p_subdec)
+            pp_prev_subdec = &(*pp_prev_subdec)->p_hash_next;
+
+        *pp_prev_subdec = p_subdec->p_hash_next;
+    }
 }
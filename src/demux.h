@@ -97,9 +97,109 @@ typedef struct dvbpsi_demux_subdec_s
   dvbpsi_demux_detach_cb_t      pf_detach; /*!< detach subdec callback */
 
   struct dvbpsi_demux_subdec_s *p_next;    /*!< next subdec */
+  struct dvbpsi_demux_subdec_s *p_hash_next; /*!< next subdec in the same
+                                                  hash bucket */
 } dvbpsi_demux_subdec_t;
 
 
+/*****************************************************************************
+ * dvbpsi_demux_subtable_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_demux_subtable_s
+ * \brief State of one subtable of a family
+ * This structure tells which version of the subtable was decoded. A full
+ * decoder only exists while the subtable is being received.
+ */
+/*!
+ * \typedef struct dvbpsi_demux_subtable_s dvbpsi_demux_subtable_t
+ * \brief dvbpsi_demux_subtable_t type definition.
+ */
+typedef struct dvbpsi_demux_subtable_s
+{
+  uint32_t                      i_id;           /*!< subtable id */
+  uint8_t                       i_version;      /*!< version_number of the
+                                                     decoded table */
+  bool                          b_current_next; /*!< current_next_indicator of
+                                                     the decoded table */
+  bool                          b_valid;        /*!< a table was decoded */
+  dvbpsi_decoder_t             *p_decoder;      /*!< decoder of the table being
+                                                     received, or NULL */
+} dvbpsi_demux_subtable_t;
+
+/*!
+ * \typedef struct dvbpsi_demux_family_s dvbpsi_demux_family_t
+ * \brief dvbpsi_demux_family_t type definition.
+ */
+typedef struct dvbpsi_demux_family_s dvbpsi_demux_family_t;
+
+/*!
+ * \typedef dvbpsi_decoder_t *(*dvbpsi_demux_family_new_cb_t)(dvbpsi_demux_family_t *p_family,
+                                                               uint8_t i_table_id,
+                                                               uint16_t i_extension);
+ * \brief Callback creating the decoder of a subtable of a family.
+ */
+typedef dvbpsi_decoder_t *(*dvbpsi_demux_family_new_cb_t) (dvbpsi_demux_family_t *p_family, /*!< pointer to family */
+                                                           uint8_t  i_table_id,  /*!< table id of the subtable */
+                                                           uint16_t i_extension);/*!< table extension of the subtable */
+
+/*!
+ * \typedef void (*dvbpsi_demux_family_table_cb_t)(void *p_cb_data, void *p_table);
+ * \brief Table callback of a family. The table decoder stores its own
+ * callback type (dvbpsi_eit_callback, ...) cast to this one and casts it back
+ * before calling it.
+ */
+typedef void (*dvbpsi_demux_family_table_cb_t) (void *p_cb_data, /*!< pointer to callback data */
+                                                void *p_table);  /*!< pointer to the table */
+
+/*!
+ * \typedef void (*dvbpsi_demux_family_delete_cb_t)(dvbpsi_decoder_t *p_decoder);
+ * \brief Callback destroying the decoder of a subtable of a family.
+ */
+typedef void (*dvbpsi_demux_family_delete_cb_t) (dvbpsi_decoder_t *p_decoder); /*!< pointer to decoder */
+
+/*****************************************************************************
+ * dvbpsi_demux_family_s
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_demux_family_s
+ * \brief Subtable decoder of a range of table ids and any extension
+ * This structure receives the sections of every subtable whose table id is
+ * in the range and which has no subtable decoder of its own. A table decoder
+ * extends it the way it extends dvbpsi_decoder_t.
+ */
+struct dvbpsi_demux_family_s
+{
+    DVBPSI_DECODER_COMMON
+
+    uint8_t                          i_first_table_id; /*!< First table id */
+    uint8_t                          i_last_table_id;  /*!< Last table id */
+
+    dvbpsi_demux_gather_cb_t         pf_subtable_gather; /*!< gather callback
+                                                            of the subtable
+                                                            decoders */
+    dvbpsi_demux_family_new_cb_t     pf_new;    /*!< creation of a subtable
+                                                   decoder */
+    dvbpsi_demux_family_delete_cb_t  pf_delete; /*!< destruction of a subtable
+                                                   decoder */
+
+    dvbpsi_demux_family_table_cb_t   pf_table_callback; /*!< table callback
+                                                           given to the
+                                                           subtable decoders */
+    void *                           p_cb_data; /*!< data given to the table
+                                                   callback */
+
+    dvbpsi_demux_subtable_t *        p_subtables;       /*!< Subtables hashed
+                                                           on their id */
+    unsigned int                     i_subtables;       /*!< Number of
+                                                           subtables */
+    unsigned int                     i_subtables_size;  /*!< Entries of
+                                                           p_subtables, a
+                                                           power of 2 */
+
+    dvbpsi_demux_family_t *          p_next;    /*!< next family */
+};
+
 /*****************************************************************************
  * dvbpsi_demux_s
  *****************************************************************************/
@@ -122,10 +222,31 @@ struct dvbpsi_demux_s
 
     dvbpsi_demux_subdec_t *   p_first_subdec;     /*!< First subtable decoder */
 
+    /* Subtable decoders lookup, only updated through
+       dvbpsi_AttachDemuxSubDecoder() and dvbpsi_DetachDemuxSubDecoder() */
+    dvbpsi_demux_subdec_t **  pp_subdec_hash;     /*!< Subtable decoders hashed
+                                                     on their id */
+    unsigned int              i_subdec_hash_size; /*!< Number of buckets, a
+                                                     power of 2 */
+    unsigned int              i_subdec_count;     /*!< Number of subtable
+                                                     decoders */
+
+    /* Subtable decoders of a range of table ids */
+    dvbpsi_demux_family_t *   p_first_family;     /*!< First family */
+
     /* New subtable callback */
     dvbpsi_demux_new_cb_t     pf_new_callback;    /*!< New subtable callback */
     void *                    p_new_cb_data;      /*!< Data provided to the
                                                      previous callback */
+
+    /* Subtables for which no subtable decoder was attached by the new
+       subtable callback, see dvbpsi_demux_remember_declined() */
+    bool                      b_remember_declined; /*!< Declined subtables
+                                                      are remembered */
+    uint8_t *                 p_declined[256];    /*!< Bitmaps of the declined
+                                                     extensions of each table
+                                                     id, NULL if there is
+                                                     none */
 };
 
 /*****************************************************************************
@@ -154,6 +275,55 @@ bool dvbpsi_AttachDemux(dvbpsi_t *            p_dvbpsi,
  */
 void dvbpsi_DetachDemux(dvbpsi_t *p_dvbpsi);
 
+/*****************************************************************************
+ * dvbpsi_demux_remember_declined
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_demux_remember_declined(dvbpsi_t *p_dvbpsi, bool b_remember)
+ * \brief Enables or disables the memory of the declined subtables.
+ *
+ * By default the new subtable callback is called again for each section of
+ * a subtable it did not attach a subtable decoder to. Once enabled, the
+ * demux remembers that the subtable was declined and drops its following
+ * sections without calling the callback again nor checking their CRC_32,
+ * until dvbpsi_demux_clear_declined() is called or a subtable decoder or a
+ * family is attached to it. Disabling it forgets all the declined subtables.
+ * \param p_dvbpsi pointer to dvbpsi_t handle with an attached demux
+ * \param b_remember true to remember the declined subtables
+ * \return nothing
+ */
+void dvbpsi_demux_remember_declined(dvbpsi_t *p_dvbpsi, bool b_remember);
+
+/*****************************************************************************
+ * dvbpsi_demux_clear_declined
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_demux_clear_declined(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                        uint16_t i_extension)
+ * \brief Forgets that a subtable was declined.
+ *
+ * Makes the demux call the new subtable callback again on the next section
+ * of the subtable, see dvbpsi_demux_remember_declined().
+ * \param p_dvbpsi pointer to dvbpsi_t handle with an attached demux
+ * \param i_table_id table id of the subtable
+ * \param i_extension table id extension of the subtable
+ * \return nothing
+ */
+void dvbpsi_demux_clear_declined(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                 uint16_t i_extension);
+
+/*****************************************************************************
+ * dvbpsi_demux_clear_all_declined
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_demux_clear_all_declined(dvbpsi_t *p_dvbpsi)
+ * \brief Forgets all the declined subtables, see
+ * @see dvbpsi_demux_clear_declined.
+ * \param p_dvbpsi pointer to dvbpsi_t handle with an attached demux
+ * \return nothing
+ */
+void dvbpsi_demux_clear_all_declined(dvbpsi_t *p_dvbpsi);
+
 /*****************************************************************************
  * dvbpsi_demuxGetSubDec
  *****************************************************************************/
@@ -165,6 +335,8 @@ void dvbpsi_DetachDemux(dvbpsi_t *p_dvbpsi);
  * \param i_extension Table ID extension of the wanted subtable.
  * \return a pointer to the found subdecoder, or NULL.
  *
+ * The subtable decoders are hashed on their ID, so the cost of the lookup
+ * does not depend on the number of subtable decoders.
  */
 dvbpsi_demux_subdec_t * dvbpsi_demuxGetSubDec(dvbpsi_demux_t * p_demux,
                                               uint8_t          i_table_id,
@@ -241,6 +413,142 @@ void dvbpsi_AttachDemuxSubDecoder(dvbpsi_demux_t *p_demux, dvbpsi_demux_subdec_t
  */
 void dvbpsi_DetachDemuxSubDecoder(dvbpsi_demux_t *p_demux, dvbpsi_demux_subdec_t *p_subdec);
 
+/*****************************************************************************
+ * dvbpsi_NewDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_demux_family_t *dvbpsi_NewDemuxFamily(const uint8_t i_first_table_id,
+                                                  const uint8_t i_last_table_id,
+                                                  dvbpsi_demux_gather_cb_t pf_gather,
+                                                  dvbpsi_demux_family_new_cb_t pf_new,
+                                                  dvbpsi_demux_family_delete_cb_t pf_delete,
+                                                  const size_t i_size)
+ * \brief Allocates a new family of subtables and initializes it.
+ * \param i_first_table_id first table id of the family
+ * \param i_last_table_id last table id of the family
+ * \param pf_gather gather function of the subtable decoders
+ * \param pf_new creation of the decoder of a subtable being received
+ * \param pf_delete destruction of the decoder of a subtable
+ * \param i_size size of the structure extending dvbpsi_demux_family_t
+ * \return pointer to the family, or NULL on error.
+ *
+ * Once a table is delivered, its decoder is destroyed and only its version
+ * is kept, unless the demux delivers deltas which need the previous table.
+ */
+dvbpsi_demux_family_t *dvbpsi_NewDemuxFamily(const uint8_t i_first_table_id,
+                                             const uint8_t i_last_table_id,
+                                             dvbpsi_demux_gather_cb_t pf_gather,
+                                             dvbpsi_demux_family_new_cb_t pf_new,
+                                             dvbpsi_demux_family_delete_cb_t pf_delete,
+                                             const size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_DeleteDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DeleteDemuxFamily(dvbpsi_demux_family_t *p_family)
+ * \brief Releases a family and the decoders of its subtables.
+ * \param p_family pointer to the family
+ * \return nothing.
+ */
+void dvbpsi_DeleteDemuxFamily(dvbpsi_demux_family_t *p_family);
+
+/*****************************************************************************
+ * dvbpsi_demuxGetFamily
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_demux_family_t *dvbpsi_demuxGetFamily(dvbpsi_demux_t *p_demux, uint8_t i_table_id)
+ * \brief Looks for the family of a table id.
+ * \param p_demux Pointer to the demux structure.
+ * \param i_table_id Table ID of the wanted family.
+ * \return a pointer to the found family, or NULL.
+ */
+dvbpsi_demux_family_t *dvbpsi_demuxGetFamily(dvbpsi_demux_t *p_demux,
+                                             uint8_t i_table_id);
+
+/*****************************************************************************
+ * dvbpsi_AttachDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_AttachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family)
+ * \brief Attach a family to the given demux handle.
+ * \param p_demux pointer to dvbpsi_demux_t
+ * \param p_family pointer to dvbpsi_demux_family_t
+ * \return true on success, false if a table id of the family already
+ * belongs to another one.
+ *
+ * The subtables of the family declined by the new subtable callback are
+ * forgotten, their sections go to the family from then on.
+ */
+bool dvbpsi_AttachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family);
+
+/*****************************************************************************
+ * dvbpsi_DetachDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DetachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family)
+ * \brief Detach a family from the given demux handle.
+ * \param p_demux pointer to dvbpsi_demux_t
+ * \param p_family pointer to dvbpsi_demux_family_t
+ * \return nothing
+ */
+void dvbpsi_DetachDemuxFamily(dvbpsi_demux_t *p_demux, dvbpsi_demux_family_t *p_family);
+
+/*****************************************************************************
+ * dvbpsi_AddDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_AddDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                                  const uint8_t i_first_table_id,
+                                  const uint8_t i_last_table_id,
+                                  dvbpsi_demux_gather_cb_t pf_gather,
+                                  dvbpsi_demux_family_new_cb_t pf_new,
+                                  dvbpsi_demux_family_delete_cb_t pf_delete,
+                                  dvbpsi_demux_family_table_cb_t pf_callback,
+                                  void *p_cb_data)
+ * \brief Create a family and attach it to the demux of a handle, the
+ * common part of the dvbpsi_xxx_family_attach() functions.
+ * \param p_dvbpsi pointer to dvbpsi_t handle with an attached demux
+ * \param psz_decoder name of the table decoder, for the error messages
+ * \param i_first_table_id first table id of the family
+ * \param i_last_table_id last table id of the family
+ * \param pf_gather gather callback of the subtable decoders
+ * \param pf_new creation of a subtable decoder
+ * \param pf_delete destruction of a subtable decoder
+ * \param pf_callback table callback, see dvbpsi_demux_family_table_cb_t
+ * \param p_cb_data data given to the table callback
+ * \return true on success, false on error or if another family already
+ * covers one of the table ids.
+ */
+bool dvbpsi_AddDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                           const uint8_t i_first_table_id,
+                           const uint8_t i_last_table_id,
+                           dvbpsi_demux_gather_cb_t pf_gather,
+                           dvbpsi_demux_family_new_cb_t pf_new,
+                           dvbpsi_demux_family_delete_cb_t pf_delete,
+                           dvbpsi_demux_family_table_cb_t pf_callback,
+                           void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_RemoveDemuxFamily
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_RemoveDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                                     const uint8_t i_table_id,
+                                     dvbpsi_demux_family_new_cb_t pf_new)
+ * \brief Detach and destroy the family of a table id, the common part of
+ * the dvbpsi_xxx_family_detach() functions.
+ * \param p_dvbpsi pointer to dvbpsi_t handle with an attached demux
+ * \param psz_decoder name of the table decoder, for the error messages
+ * \param i_table_id any table id of the family
+ * \param pf_new creation callback the family was added with, so that a
+ * decoder does not remove the family of another table
+ * \return nothing.
+ */
+void dvbpsi_RemoveDemuxFamily(dvbpsi_t *p_dvbpsi, const char *psz_decoder,
+                              const uint8_t i_table_id,
+                              dvbpsi_demux_family_new_cb_t pf_new);
+
 #ifdef __cplusplus
 };
 #endif
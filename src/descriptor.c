@@ -39,6 +39,7 @@
 #include <assert.h>
 
 #include "dvbpsi.h"
+#include "psi.h"
 #include "descriptor.h"
 
 /*****************************************************************************
@@ -132,6 +133,31 @@ dvbpsi_descriptor_t *dvbpsi_AddDescriptor(dvbpsi_descriptor_t *p_list,
     return p_list;
 }
 
+/*****************************************************************************
+ * dvbpsi_AppendDescriptor
+ *****************************************************************************
+ * Add 'p_descriptor' at the end of the list '*pp_first' whose last descriptor
+ * is '*pp_last'
+ *****************************************************************************/
+void dvbpsi_AppendDescriptor(dvbpsi_descriptor_t **pp_first,
+                             dvbpsi_descriptor_t **pp_last,
+                             dvbpsi_descriptor_t *p_descriptor)
+{
+    assert(p_descriptor);
+
+    if (*pp_first == NULL)
+        *pp_first = p_descriptor;
+    else
+    {
+        /* Descriptors may have been linked by hand after the last one */
+        dvbpsi_descriptor_t *p_last = *pp_last ? *pp_last : *pp_first;
+        while (p_last->p_next != NULL)
+            p_last = p_last->p_next;
+        p_last->p_next = p_descriptor;
+    }
+    *pp_last = p_descriptor;
+}
+
 /*****************************************************************************
  * dvbpsi_DeleteDescriptors
  *****************************************************************************
@@ -154,6 +180,408 @@ void dvbpsi_DeleteDescriptors(dvbpsi_descriptor_t* p_descriptor)
     }
 }
 
+/*****************************************************************************
+ * dvbpsi_arena_s
+ *****************************************************************************
+ * An arena is a list of chunks, the current one first. Blocks are carved
+ * from the current chunk by bumping 'i_used'. Chunks grow geometrically from
+ * DVBPSI_ARENA_MIN_CHUNK to DVBPSI_ARENA_MAX_CHUNK bytes, a block that does
+ * not fit in such a chunk gets a chunk of its own. The arena structure is
+ * allocated together with its first chunk.
+ *****************************************************************************/
+#define DVBPSI_ARENA_MIN_CHUNK  512
+#define DVBPSI_ARENA_MAX_CHUNK  65536
+#define DVBPSI_ARENA_ALIGN      (2 * sizeof(void *))
+
+typedef struct dvbpsi_arena_chunk_s
+{
+    struct dvbpsi_arena_chunk_s *p_next;
+    size_t                       i_size;    /* size of the data area */
+    size_t                       i_used;    /* bytes carved from it */
+    uint8_t                     *p_data;    /* aligned data area */
+} dvbpsi_arena_chunk_t;
+
+struct dvbpsi_arena_s
+{
+    dvbpsi_arena_chunk_t *p_chunk;          /* current chunk */
+    dvbpsi_arena_chunk_t  first;            /* chunk allocated with the arena */
+    size_t                i_next_size;      /* size of the next chunk */
+};
+
+static inline size_t dvbpsi_ArenaAlign(size_t i_size)
+{
+    return (i_size + DVBPSI_ARENA_ALIGN - 1) & ~(DVBPSI_ARENA_ALIGN - 1);
+}
+
+/*****************************************************************************
+ * dvbpsi_NewArena
+ *****************************************************************************
+ * Creation of an arena with a first chunk of DVBPSI_ARENA_MIN_CHUNK bytes.
+ *****************************************************************************/
+dvbpsi_arena_t *dvbpsi_NewArena(void)
+{
+    size_t i_header = dvbpsi_ArenaAlign(sizeof(dvbpsi_arena_t));
+    uint8_t *p_block = (uint8_t *)malloc(i_header + DVBPSI_ARENA_MIN_CHUNK);
+    if (p_block == NULL)
+        return NULL;
+
+    dvbpsi_arena_t *p_arena = (dvbpsi_arena_t *)p_block;
+    p_arena->first.p_next = NULL;
+    p_arena->first.i_size = DVBPSI_ARENA_MIN_CHUNK;
+    p_arena->first.i_used = 0;
+    p_arena->first.p_data = p_block + i_header;
+    p_arena->p_chunk = &p_arena->first;
+    p_arena->i_next_size = 2 * DVBPSI_ARENA_MIN_CHUNK;
+    return p_arena;
+}
+
+/*****************************************************************************
+ * dvbpsi_ArenaAlloc
+ *****************************************************************************
+ * Carve a zeroed block from the current chunk, start a new chunk when it
+ * is full.
+ *****************************************************************************/
+void *dvbpsi_ArenaAlloc(dvbpsi_arena_t *p_arena, size_t i_size)
+{
+    if (p_arena == NULL)
+        return calloc(1, i_size);
+
+    i_size = dvbpsi_ArenaAlign(i_size);
+
+    dvbpsi_arena_chunk_t *p_chunk = p_arena->p_chunk;
+    if (p_chunk->i_size - p_chunk->i_used < i_size)
+    {
+        size_t i_chunk = p_arena->i_next_size;
+        if (i_chunk < i_size)
+            i_chunk = i_size;
+        else if (i_chunk < DVBPSI_ARENA_MAX_CHUNK)
+            p_arena->i_next_size *= 2;
+
+        size_t i_header = dvbpsi_ArenaAlign(sizeof(dvbpsi_arena_chunk_t));
+        uint8_t *p_block = (uint8_t *)malloc(i_header + i_chunk);
+        if (p_block == NULL)
+            return NULL;
+
+        p_chunk = (dvbpsi_arena_chunk_t *)p_block;
+        p_chunk->p_next = p_arena->p_chunk;
+        p_chunk->i_size = i_chunk;
+        p_chunk->i_used = 0;
+        p_chunk->p_data = p_block + i_header;
+        p_arena->p_chunk = p_chunk;
+    }
+
+    void *p_block = p_chunk->p_data + p_chunk->i_used;
+    p_chunk->i_used += i_size;
+    memset(p_block, 0, i_size);
+    return p_block;
+}
+
+/*****************************************************************************
+ * dvbpsi_ResetArena
+ *****************************************************************************
+ * Keep the current chunk, which is the largest one, and free the others.
+ *****************************************************************************/
+void dvbpsi_ResetArena(dvbpsi_arena_t *p_arena)
+{
+    if (p_arena == NULL)
+        return;
+
+    dvbpsi_arena_chunk_t *p_keep = p_arena->p_chunk;
+    dvbpsi_arena_chunk_t *p_chunk = p_keep->p_next;
+    while (p_chunk != NULL)
+    {
+        dvbpsi_arena_chunk_t *p_next = p_chunk->p_next;
+        if (p_chunk != &p_arena->first)
+            free(p_chunk);
+        p_chunk = p_next;
+    }
+
+    p_keep->i_used = 0;
+    if (p_keep != &p_arena->first)
+    {
+        /* The first chunk is part of the arena, keep it in the list */
+        p_arena->first.i_used = 0;
+        p_arena->first.p_next = NULL;
+        p_keep->p_next = &p_arena->first;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_DeleteArena
+ *****************************************************************************
+ * Free all the chunks, then the arena with its first chunk.
+ *****************************************************************************/
+void dvbpsi_DeleteArena(dvbpsi_arena_t *p_arena)
+{
+    if (p_arena == NULL)
+        return;
+
+    dvbpsi_arena_chunk_t *p_chunk = p_arena->p_chunk;
+    while (p_chunk != NULL)
+    {
+        dvbpsi_arena_chunk_t *p_next = p_chunk->p_next;
+        if (p_chunk != &p_arena->first)
+            free(p_chunk);
+        p_chunk = p_next;
+    }
+    free(p_arena);
+}
+
+/*****************************************************************************
+ * dvbpsi_NewArenaDescriptor
+ *****************************************************************************
+ * Creation of a new dvbpsi_descriptor_t structure followed by its payload
+ * in the arena.
+ *****************************************************************************/
+dvbpsi_descriptor_t *dvbpsi_NewArenaDescriptor(dvbpsi_arena_t *p_arena,
+                                               uint8_t i_tag, uint8_t i_length,
+                                               uint8_t *p_data)
+{
+    if (p_arena == NULL)
+        return dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+
+    dvbpsi_descriptor_t *p_descriptor = (dvbpsi_descriptor_t *)
+                dvbpsi_ArenaAlloc(p_arena, sizeof(dvbpsi_descriptor_t) + i_length);
+    if (p_descriptor == NULL)
+        return NULL;
+
+    p_descriptor->i_tag = i_tag;
+    p_descriptor->i_length = i_length;
+    p_descriptor->p_data = (uint8_t *)(p_descriptor + 1);
+    if (p_data)
+        memcpy(p_descriptor->p_data, p_data, i_length);
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DeleteArenaDescriptors
+ *****************************************************************************
+ * Free the decoded descriptors, the rest belongs to the arena.
+ *****************************************************************************/
+void dvbpsi_DeleteArenaDescriptors(dvbpsi_arena_t *p_arena,
+                                   dvbpsi_descriptor_t *p_descriptor)
+{
+    if (p_arena == NULL)
+    {
+        dvbpsi_DeleteDescriptors(p_descriptor);
+        return;
+    }
+
+    for (; p_descriptor != NULL; p_descriptor = p_descriptor->p_next)
+    {
+        free(p_descriptor->p_decoded);
+        p_descriptor->p_decoded = NULL;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_AppendDescriptorViews
+ *****************************************************************************
+ * Append the descriptors of the loop 'p_data' to a list, as one array of
+ * descriptors whose payload is left in the loop.
+ *****************************************************************************/
+bool dvbpsi_AppendDescriptorViews(dvbpsi_arena_t *p_arena,
+                                  dvbpsi_descriptor_t **pp_first,
+                                  dvbpsi_descriptor_t **pp_last,
+                                  uint8_t *p_data, int i_length)
+{
+    if (p_arena == NULL)
+        return false;
+
+    /* Count the descriptors fitting in the loop, a truncated one ends it */
+    int i_count = 0;
+    for (int i = 0; i + 2 <= i_length && i + 2 + p_data[i + 1] <= i_length;
+         i += 2 + p_data[i + 1])
+        i_count++;
+
+    if (i_count == 0)
+        return true;
+
+    dvbpsi_descriptor_t *p_array = (dvbpsi_descriptor_t *)
+                dvbpsi_ArenaAlloc(p_arena, i_count * sizeof(dvbpsi_descriptor_t));
+    if (p_array == NULL)
+        return false;
+
+    for (int i = 0, k = 0; k < i_count; k++)
+    {
+        p_array[k].i_tag = p_data[i];
+        p_array[k].i_length = p_data[i + 1];
+        p_array[k].p_data = p_data + i + 2;
+        p_array[k].p_next = (k + 1 < i_count) ? &p_array[k + 1] : NULL;
+        i += 2 + p_data[i + 1];
+    }
+
+    dvbpsi_AppendDescriptor(pp_first, pp_last, p_array);
+    *pp_last = &p_array[i_count - 1];
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_init
+ *****************************************************************************
+ * Locate the loop of the table and the entries in the section. The length
+ * of an entry's descriptor loop is always in the last 12 bits of its header.
+ *****************************************************************************/
+bool dvbpsi_descriptor_cursor_init(dvbpsi_descriptor_cursor_t *p_cursor,
+                                   dvbpsi_psi_section_t *p_section)
+{
+    uint8_t *p_byte = p_section->p_payload_start;
+    uint8_t *p_end = p_section->p_payload_end;
+    uint8_t *p_loop_end;
+
+    p_cursor->i_table_id = p_section->i_table_id;
+    p_cursor->i_entry_size = 0;
+    p_cursor->p_next_entry = p_end;
+    p_cursor->p_entries_end = p_end;
+
+    switch (p_section->i_table_id)
+    {
+        case 0x01: /* CAT */
+            p_loop_end = p_end;
+            break;
+        case 0x02: /* PMT */
+            p_loop_end = p_end;
+            if (p_byte + 4 > p_end)
+            {
+                p_byte = p_end;
+                break;
+            }
+            /* program_info_length */
+            p_loop_end = p_byte + 4 + (((uint16_t)(p_byte[2] & 0x0f) << 8) | p_byte[3]);
+            p_byte += 4;
+            if (p_loop_end > p_end)
+                p_loop_end = p_end;
+            p_cursor->i_entry_size = 5;
+            p_cursor->p_next_entry = p_loop_end;
+            break;
+        case 0x40: /* NIT */
+        case 0x41:
+        case 0x4a: /* BAT */
+            p_loop_end = p_end;
+            if (p_byte + 2 > p_end)
+            {
+                p_byte = p_end;
+                break;
+            }
+            /* network_descriptors_length or bouquet_descriptors_length */
+            p_loop_end = p_byte + 2 + (((uint16_t)(p_byte[0] & 0x0f) << 8) | p_byte[1]);
+            p_byte += 2;
+            if (p_loop_end + 2 > p_end)
+            {
+                p_loop_end = p_end;
+                break;
+            }
+            /* transport_stream_loop_length */
+            p_cursor->i_entry_size = 6;
+            p_cursor->p_next_entry = p_loop_end + 2;
+            p_cursor->p_entries_end = p_loop_end + 2
+                    + (((uint16_t)(p_loop_end[0] & 0x0f) << 8) | p_loop_end[1]);
+            if (p_cursor->p_entries_end > p_end)
+                p_cursor->p_entries_end = p_end;
+            break;
+        case 0x42: /* SDT */
+        case 0x46:
+            p_byte = p_loop_end = p_byte + 3 > p_end ? p_end : p_byte + 3;
+            p_cursor->i_entry_size = 5;
+            p_cursor->p_next_entry = p_byte;
+            break;
+        default:
+            if (p_section->i_table_id < 0x4e || p_section->i_table_id > 0x6f)
+                return false;
+            /* EIT */
+            p_byte = p_loop_end = p_byte + 6 > p_end ? p_end : p_byte + 6;
+            p_cursor->i_entry_size = 12;
+            p_cursor->p_next_entry = p_byte;
+            break;
+    }
+
+    p_cursor->p_entry = NULL;
+    p_cursor->p_next = p_byte;
+    p_cursor->p_loop_end = p_loop_end;
+    memset(&p_cursor->descriptor, 0, sizeof(dvbpsi_descriptor_t));
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_init_loop
+ *****************************************************************************/
+void dvbpsi_descriptor_cursor_init_loop(dvbpsi_descriptor_cursor_t *p_cursor,
+                                        uint8_t *p_data, int i_length)
+{
+    p_cursor->i_table_id = 0xff;
+    p_cursor->i_entry_size = 0;
+    p_cursor->p_entry = NULL;
+    p_cursor->p_next = p_data;
+    p_cursor->p_loop_end = p_data + i_length;
+    p_cursor->p_next_entry = NULL;
+    p_cursor->p_entries_end = NULL;
+    memset(&p_cursor->descriptor, 0, sizeof(dvbpsi_descriptor_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_next_entry
+ *****************************************************************************/
+uint8_t *dvbpsi_descriptor_cursor_next_entry(dvbpsi_descriptor_cursor_t *p_cursor)
+{
+    const int i_size = p_cursor->i_entry_size;
+    if (i_size == 0 || p_cursor->p_next_entry + i_size > p_cursor->p_entries_end)
+    {
+        p_cursor->p_next = p_cursor->p_loop_end;
+        return NULL;
+    }
+
+    uint8_t *p_entry = p_cursor->p_next_entry;
+    uint16_t i_length = ((uint16_t)(p_entry[i_size - 2] & 0x0f) << 8)
+                        | p_entry[i_size - 1];
+    p_cursor->p_entry = p_entry;
+    p_cursor->p_next = p_entry + i_size;
+    p_cursor->p_next_entry = p_entry + i_size + i_length;
+    p_cursor->p_loop_end = p_cursor->p_next_entry;
+    if (p_cursor->p_loop_end > p_cursor->p_entries_end)
+        p_cursor->p_loop_end = p_cursor->p_entries_end;
+    return p_entry;
+}
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_next
+ *****************************************************************************
+ * Next descriptor of the current loop, or first one of the next entries.
+ *****************************************************************************/
+dvbpsi_descriptor_t *dvbpsi_descriptor_cursor_next(dvbpsi_descriptor_cursor_t *p_cursor)
+{
+    do
+    {
+        uint8_t *p_byte = p_cursor->p_next;
+        if (p_byte + 2 <= p_cursor->p_loop_end
+         && p_byte + 2 + p_byte[1] <= p_cursor->p_loop_end)
+        {
+            p_cursor->descriptor.i_tag = p_byte[0];
+            p_cursor->descriptor.i_length = p_byte[1];
+            p_cursor->descriptor.p_data = p_byte + 2;
+            p_cursor->descriptor.p_decoded = NULL;
+            p_cursor->p_next = p_byte + 2 + p_byte[1];
+            return &p_cursor->descriptor;
+        }
+    } while (dvbpsi_descriptor_cursor_next_entry(p_cursor) != NULL);
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_entry_id
+ *****************************************************************************/
+int dvbpsi_descriptor_cursor_entry_id(const dvbpsi_descriptor_cursor_t *p_cursor)
+{
+    const uint8_t *p_entry = p_cursor->p_entry;
+
+    if (p_entry == NULL)
+        return -1;
+    if (p_cursor->i_table_id == 0x02)
+        return ((uint16_t)(p_entry[1] & 0x1f) << 8) | p_entry[2];
+    return ((uint16_t)p_entry[0] << 8) | p_entry[1];
+}
+
 /*****************************************************************************
  * dvbpsi_DuplicateDecodedDescriptor
  *****************************************************************************
@@ -115,6 +115,8 @@ dvbpsi_descriptor_t* dvbpsi_NewDescriptor(uint8_t i_tag, uint8_t i_length,
  * descriptor, if present.
  * \param p_descriptor pointer to the first descriptor structure
  * \return nothing.
+ *
+ * Not for the descriptors of a table with an arena, see dvbpsi_arena_t.
  */
 void dvbpsi_DeleteDescriptors(dvbpsi_descriptor_t* p_descriptor);
 
@@ -132,6 +134,24 @@ void dvbpsi_DeleteDescriptors(dvbpsi_descriptor_t* p_descriptor);
 dvbpsi_descriptor_t *dvbpsi_AddDescriptor(dvbpsi_descriptor_t *p_list,
                                           dvbpsi_descriptor_t *p_descriptor);
 
+/*****************************************************************************
+ * dvbpsi_AppendDescriptor
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_AppendDescriptor(dvbpsi_descriptor_t **pp_first,
+                                    dvbpsi_descriptor_t **pp_last,
+                                    dvbpsi_descriptor_t *p_descriptor);
+ * \brief Add a descriptor to the end of descriptor list in constant time.
+ * \param pp_first pointer to the first descriptor of the list.
+ * \param pp_last pointer to the last descriptor of the list, which is updated.
+ * It may point to NULL, then the end of the list is looked for.
+ * \param p_descriptor the descriptor to add to the list
+ * \return nothing.
+ */
+void dvbpsi_AppendDescriptor(dvbpsi_descriptor_t **pp_first,
+                             dvbpsi_descriptor_t **pp_last,
+                             dvbpsi_descriptor_t *p_descriptor);
+
 /*****************************************************************************
  * dvbpsi_CanDecodeAsDescriptor
  *****************************************************************************/
@@ -167,6 +187,242 @@ bool dvbpsi_IsDescriptorDecoded(dvbpsi_descriptor_t *p_descriptor);
  */
 void *dvbpsi_DuplicateDecodedDescriptor(void *p_decoded, ssize_t i_size);
 
+/*****************************************************************************
+ * dvbpsi_NewArena
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_arena_t *dvbpsi_NewArena(void)
+ * \brief Creation of a new, empty, memory arena.
+ * \return a pointer to the new arena or NULL on error.
+ */
+dvbpsi_arena_t *dvbpsi_NewArena(void);
+
+/*****************************************************************************
+ * dvbpsi_ArenaAlloc
+ *****************************************************************************/
+/*!
+ * \fn void *dvbpsi_ArenaAlloc(dvbpsi_arena_t *p_arena, size_t i_size)
+ * \brief Allocate a zeroed block of memory from an arena.
+ * \param p_arena pointer to the arena, can be NULL
+ * \param i_size size of the block in bytes
+ * \return a pointer to the block or NULL on error.
+ *
+ * The block stays valid until the arena is reset or deleted. Without an
+ * arena the block comes from calloc() and must be given to free().
+ */
+void *dvbpsi_ArenaAlloc(dvbpsi_arena_t *p_arena, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_ResetArena
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_ResetArena(dvbpsi_arena_t *p_arena)
+ * \brief Release every block allocated from an arena at once.
+ * \param p_arena pointer to the arena, can be NULL
+ * \return nothing.
+ *
+ * The memory of the largest chunk is kept for the next allocations.
+ */
+void dvbpsi_ResetArena(dvbpsi_arena_t *p_arena);
+
+/*****************************************************************************
+ * dvbpsi_DeleteArena
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DeleteArena(dvbpsi_arena_t *p_arena)
+ * \brief Destruction of an arena together with all the blocks allocated
+ * from it.
+ * \param p_arena pointer to the arena, can be NULL
+ * \return nothing.
+ */
+void dvbpsi_DeleteArena(dvbpsi_arena_t *p_arena);
+
+/*****************************************************************************
+ * dvbpsi_NewArenaDescriptor
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_descriptor_t *dvbpsi_NewArenaDescriptor(dvbpsi_arena_t *p_arena,
+                                                      uint8_t i_tag,
+                                                      uint8_t i_length,
+                                                      uint8_t *p_data)
+ * \brief Creation of a new dvbpsi_descriptor_t structure in an arena.
+ * \param p_arena pointer to the arena, can be NULL
+ * \param i_tag descriptor's tag
+ * \param i_length descriptor's length
+ * \param p_data descriptor's data
+ * \return a pointer to the descriptor.
+ *
+ * The structure and its payload are carved from 'p_arena' in one block.
+ * Without an arena this is the same as dvbpsi_NewDescriptor().
+ */
+dvbpsi_descriptor_t *dvbpsi_NewArenaDescriptor(dvbpsi_arena_t *p_arena,
+                                               uint8_t i_tag, uint8_t i_length,
+                                               uint8_t *p_data);
+
+/*****************************************************************************
+ * dvbpsi_DeleteArenaDescriptors
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DeleteArenaDescriptors(dvbpsi_arena_t *p_arena,
+                                          dvbpsi_descriptor_t *p_descriptor)
+ * \brief Destruction of a list of descriptors created with
+ * dvbpsi_NewArenaDescriptor().
+ * \param p_arena pointer to the arena the descriptors come from, can be NULL
+ * \param p_descriptor pointer to the first descriptor structure
+ * \return nothing.
+ *
+ * Only the decoded descriptors, which the dvbpsi_DecodeXXXXDr functions
+ * allocate on their own, are freed. The descriptors themselves go away with
+ * the arena. Without an arena this is the same as dvbpsi_DeleteDescriptors().
+ */
+void dvbpsi_DeleteArenaDescriptors(dvbpsi_arena_t *p_arena,
+                                   dvbpsi_descriptor_t *p_descriptor);
+
+/*****************************************************************************
+ * dvbpsi_AppendDescriptorViews
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_AppendDescriptorViews(dvbpsi_arena_t *p_arena,
+                                         dvbpsi_descriptor_t **pp_first,
+                                         dvbpsi_descriptor_t **pp_last,
+                                         uint8_t *p_data, int i_length)
+ * \brief Add all the descriptors of a descriptor loop to the end of a
+ * descriptor list without copying their payload.
+ * \param p_arena pointer to the arena the descriptors are carved from
+ * \param pp_first pointer to the first descriptor of the list.
+ * \param pp_last pointer to the last descriptor of the list, which is updated.
+ * \param p_data first byte of the descriptor loop
+ * \param i_length length of the descriptor loop in bytes
+ * \return true on success, false without an arena or when out of memory, in
+ * which case the list is left untouched.
+ *
+ * The descriptors of the loop are stored in one array, linked in order
+ * through p_next, and their p_data points into 'p_data'. The loop must stay
+ * valid as long as the descriptors are used. A truncated descriptor ends the
+ * loop. Use dvbpsi_DeleteArenaDescriptors() to free them.
+ */
+bool dvbpsi_AppendDescriptorViews(dvbpsi_arena_t *p_arena,
+                                  dvbpsi_descriptor_t **pp_first,
+                                  dvbpsi_descriptor_t **pp_last,
+                                  uint8_t *p_data, int i_length);
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_descriptor_cursor_s
+ * \brief Cursor over the descriptor loops of a section.
+ *
+ * This structure is used to iterate over the descriptors of a section
+ * without decoding the section into a table and without allocating memory.
+ */
+/*!
+ * \typedef struct dvbpsi_descriptor_cursor_s dvbpsi_descriptor_cursor_t
+ * \brief dvbpsi_descriptor_cursor_t type definition.
+ *
+ * Its members are private, except dvbpsi_descriptor_cursor_s::p_entry which
+ * points to the header of the entry (elementary stream, service, event or
+ * transport stream) whose descriptor loop holds the current descriptor, or
+ * is NULL for the descriptors of the table itself.
+ */
+typedef struct dvbpsi_descriptor_cursor_s
+{
+  uint8_t *                     p_entry;        /*!< header of the entry
+                                                     owning the loop */
+
+  uint8_t *                     p_next;         /*!< next descriptor */
+  uint8_t *                     p_loop_end;     /*!< end of the loop */
+  uint8_t *                     p_next_entry;   /*!< header of the next entry */
+  uint8_t *                     p_entries_end;  /*!< end of the entries */
+  uint8_t                       i_entry_size;   /*!< size of an entry header */
+  uint8_t                       i_table_id;     /*!< table_id of the section */
+
+  dvbpsi_descriptor_t           descriptor;     /*!< current descriptor */
+
+} dvbpsi_descriptor_cursor_t;
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_init
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_descriptor_cursor_init(dvbpsi_descriptor_cursor_t *p_cursor,
+                                          dvbpsi_psi_section_t *p_section)
+ * \brief Set a cursor on the first descriptor loop of a section.
+ * \param p_cursor pointer to the cursor
+ * \param p_section section to iterate over, it must have been checked and
+ * must stay valid as long as the cursor is used
+ * \return true on success, false if the table_id of the section is not
+ * supported.
+ *
+ * The supported tables are the PMT, the CAT, the NIT and BAT, whose own
+ * descriptors come first, then those of their elementary streams or
+ * transport streams, and the SDT and EIT, whose descriptors all belong to
+ * a service or an event.
+ */
+bool dvbpsi_descriptor_cursor_init(dvbpsi_descriptor_cursor_t *p_cursor,
+                                   dvbpsi_psi_section_t *p_section);
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_init_loop
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_descriptor_cursor_init_loop(dvbpsi_descriptor_cursor_t *p_cursor,
+                                               uint8_t *p_data, int i_length)
+ * \brief Set a cursor on a single descriptor loop.
+ * \param p_cursor pointer to the cursor
+ * \param p_data first byte of the descriptor loop
+ * \param i_length length of the descriptor loop in bytes
+ * \return nothing.
+ */
+void dvbpsi_descriptor_cursor_init_loop(dvbpsi_descriptor_cursor_t *p_cursor,
+                                        uint8_t *p_data, int i_length);
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_next
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_descriptor_t *dvbpsi_descriptor_cursor_next(dvbpsi_descriptor_cursor_t *p_cursor)
+ * \brief Move a cursor to the next descriptor.
+ * \param p_cursor pointer to the cursor
+ * \return a view on the descriptor or NULL after the last one.
+ *
+ * The view is a dvbpsi_descriptor_t embedded in the cursor whose p_data
+ * points into the section and which is overwritten by the next call. It can
+ * be given to any dvbpsi_DecodeXXXXDr function. The decoded descriptor then
+ * belongs to the caller who must free() it: the cursor forgets it when it
+ * moves. A truncated descriptor ends its loop.
+ */
+dvbpsi_descriptor_t *dvbpsi_descriptor_cursor_next(dvbpsi_descriptor_cursor_t *p_cursor);
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_next_entry
+ *****************************************************************************/
+/*!
+ * \fn uint8_t *dvbpsi_descriptor_cursor_next_entry(dvbpsi_descriptor_cursor_t *p_cursor)
+ * \brief Move a cursor to the descriptor loop of the next entry, skipping
+ * the rest of the current loop.
+ * \param p_cursor pointer to the cursor
+ * \return the header of the entry, followed by its descriptor loop, or NULL
+ * after the last entry.
+ *
+ * The next dvbpsi_descriptor_cursor_next() returns the first descriptor of
+ * the entry, if it has any.
+ */
+uint8_t *dvbpsi_descriptor_cursor_next_entry(dvbpsi_descriptor_cursor_t *p_cursor);
+
+/*****************************************************************************
+ * dvbpsi_descriptor_cursor_entry_id
+ *****************************************************************************/
+/*!
+ * \fn int dvbpsi_descriptor_cursor_entry_id(const dvbpsi_descriptor_cursor_t *p_cursor)
+ * \brief Identifier of the entry owning the current descriptor.
+ * \param p_cursor pointer to the cursor
+ * \return the elementary_PID (PMT), service_id (SDT), event_id (EIT) or
+ * transport_stream_id (NIT, BAT) of the entry, -1 for the descriptors of the
+ * table itself.
+ */
+int dvbpsi_descriptor_cursor_entry_id(const dvbpsi_descriptor_cursor_t *p_cursor);
+
 #ifdef __cplusplus
 };
 #endif
@@ -44,6 +44,7 @@
 #include "dvbpsi.h"
 #include "dvbpsi_private.h"
 #include "psi.h"
+#include "descriptor.h"
 
 /*****************************************************************************
  * dvbpsi_new
@@ -72,6 +73,52 @@ void dvbpsi_delete(dvbpsi_t *p_dvbpsi)
     free(p_dvbpsi);
 }
 
+/*****************************************************************************
+ * dvbpsi_section_cache_s
+ *****************************************************************************
+ * Last section handed to a decoder for each table_id, table_id_extension and
+ * section_number, so that a decoder receiving several subtables (a family of
+ * the demux) keeps the sections of each of them apart. The
+ * version_number/current_next_indicator byte, section_length and CRC_32
+ * identify its content. The records are hashed on their key with linear
+ * probing and are only invalidated, never removed, until the cache is
+ * cleared.
+ *****************************************************************************/
+typedef struct dvbpsi_section_record_s
+{
+    uint32_t i_key;         /* table_id, table_id_extension, section_number */
+    bool     b_used;
+    bool     b_valid;
+    uint8_t  i_version;     /* byte 5 of the section */
+    uint16_t i_length;
+    uint32_t i_crc;
+} dvbpsi_section_record_t;
+
+struct dvbpsi_section_cache_s
+{
+    dvbpsi_section_record_t *p_records;
+    unsigned int i_size;    /* power of 2 */
+    unsigned int i_used;
+};
+
+#define DVBPSI_SECTION_KEY(table_id, extension, number) \
+    ((uint32_t)(table_id) << 24 | (uint32_t)(extension) << 8 | (uint32_t)(number))
+
+/*****************************************************************************
+ * dvbpsi_section_filter_s
+ *****************************************************************************
+ * Value/mask filter on the first bytes of the sections, without the
+ * section_length.
+ *****************************************************************************/
+struct dvbpsi_section_filter_s
+{
+    uint8_t  i_value[DVBPSI_SECTION_FILTER_SIZE]; /* already masked */
+    uint8_t  i_mask[DVBPSI_SECTION_FILTER_SIZE];
+    int      i_depth;   /* number of bytes up to the last masked one */
+
+    struct dvbpsi_section_filter_s *p_next;
+};
+
 /*****************************************************************************
  * dvbpsi_decoder_new
  *****************************************************************************/
@@ -96,8 +143,29 @@ void *dvbpsi_decoder_new(dvbpsi_callback_gather_t pf_gather,
 
     p_decoder->i_last_section_number = 0;
     p_decoder->p_sections = NULL;
+    p_decoder->pp_section_slots = NULL;
+    p_decoder->i_section_slots = 0;
+    memset(p_decoder->i_sections_received, 0, sizeof(p_decoder->i_sections_received));
     p_decoder->b_complete_header = false;
 
+    p_decoder->b_zero_copy = false;
+    p_decoder->p_gather_buffer = NULL;
+
+    /* Only decoders gathering TS packets allocate sections, without a pool
+       sections are simply allocated one by one */
+    p_decoder->p_pool = pf_gather ? dvbpsi_NewPSISectionPool() : NULL;
+
+    p_decoder->b_section_cache = false;
+    p_decoder->p_cache = NULL;
+    p_decoder->pf_route = NULL;
+    p_decoder->pf_changed = NULL;
+    p_decoder->pf_discard = NULL;
+    p_decoder->pf_peek = NULL;
+    p_decoder->p_filters = NULL;
+    p_decoder->b_retain_sections = false;
+    p_decoder->b_delta = false;
+    p_decoder->p_snapshot = NULL;
+
     return p_decoder;
 }
 
@@ -115,6 +183,16 @@ void dvbpsi_decoder_reset(dvbpsi_decoder_t* p_decoder, const bool b_force)
     /* Clear the section array */
     dvbpsi_DeletePSISections(p_decoder->p_sections);
     p_decoder->p_sections = NULL;
+    memset(p_decoder->i_sections_received, 0, sizeof(p_decoder->i_sections_received));
+
+    /* Repeats of the sections are needed again */
+    if (p_decoder->p_cache)
+    {
+        dvbpsi_section_cache_t *p_cache = p_decoder->p_cache;
+        if (p_cache->p_records)
+            memset(p_cache->p_records, 0, p_cache->i_size * sizeof(dvbpsi_section_record_t));
+        p_cache->i_used = 0;
+    }
 }
 
 /*****************************************************************************
@@ -124,22 +202,46 @@ bool dvbpsi_decoder_psi_sections_completed(dvbpsi_decoder_t* p_decoder)
 {
     assert(p_decoder);
 
-    bool b_complete = false;
+    /* All the sections from 0 to last_section_number are received */
+    const uint32_t *p_received = p_decoder->i_sections_received;
+    const int i_last = p_decoder->i_last_section_number;
 
-    dvbpsi_psi_section_t *p = p_decoder->p_sections;
-    unsigned int prev_nr = 0;
-    while (p)
+    for (int i = 0; i < i_last >> 5; i++)
     {
-        assert(prev_nr < 256);
-        if (prev_nr != p->i_number)
-            break;
-        if (p_decoder->i_last_section_number == p->i_number)
-            b_complete = true;
-        p = p->p_next;
-        prev_nr++;
+        if (p_received[i] != 0xffffffff)
+            return false;
+    }
+
+    uint32_t i_mask = (i_last & 31) == 31 ? 0xffffffff
+                                          : ((uint32_t)1 << ((i_last & 31) + 1)) - 1;
+    return (p_received[i_last >> 5] & i_mask) == i_mask;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_section_prev
+ *****************************************************************************
+ * Received section with the highest section_number below 'i_number', NULL if
+ * there is none.
+ *****************************************************************************/
+static dvbpsi_psi_section_t *dvbpsi_decoder_section_prev(dvbpsi_decoder_t *p_decoder,
+                                                         const int i_number)
+{
+    const uint32_t *p_received = p_decoder->i_sections_received;
+    int i_word = i_number >> 5;
+    uint32_t i_bits = p_received[i_word] & (((uint32_t)1 << (i_number & 31)) - 1);
+
+    while (i_bits == 0)
+    {
+        if (--i_word < 0)
+            return NULL;
+        i_bits = p_received[i_word];
     }
 
-    return b_complete;
+    int i_bit = 31;
+    while (!(i_bits & ((uint32_t)1 << i_bit)))
+        i_bit--;
+
+    return p_decoder->pp_section_slots[(i_word << 5) + i_bit];
 }
 
 /*****************************************************************************
@@ -151,71 +253,52 @@ bool dvbpsi_decoder_psi_section_add(dvbpsi_decoder_t *p_decoder, dvbpsi_psi_sect
     assert(p_section);
     assert(p_section->p_next == NULL);
 
-    /* Empty list */
-    if (!p_decoder->p_sections)
+    /* Sections gathered in zero-copy mode are only valid during the gather
+     * callback, take a private copy before keeping it */
+    if (!dvbpsi_UnsharePSISection(p_section))
     {
-        p_decoder->p_sections = p_section;
-        p_section->p_next = NULL;
+        dvbpsi_DeletePSISections(p_section);
         return false;
     }
 
-    /* Insert in right place */
-    dvbpsi_psi_section_t *p = p_decoder->p_sections;
-    dvbpsi_psi_section_t *p_prev = NULL;
-    bool b_overwrite = false;
-
-    while (p)
+    /* Make room for the section in the slots, they only grow */
+    const int i_number = p_section->i_number;
+    if (i_number >= p_decoder->i_section_slots)
     {
-        if (p->i_number == p_section->i_number)
+        dvbpsi_psi_section_t **pp_slots;
+        pp_slots = realloc(p_decoder->pp_section_slots,
+                           (i_number + 1) * sizeof(dvbpsi_psi_section_t *));
+        if (pp_slots == NULL)
         {
-            /* Replace */
-            if (p_prev)
-            {
-                p_prev->p_next = p_section;
-                p_section->p_next = p->p_next;
-                p->p_next = NULL;
-                dvbpsi_DeletePSISections(p);
-                b_overwrite = true;
-            }
-            else
-            {
-                p_section->p_next = p->p_next;
-                p->p_next = NULL;
-                dvbpsi_DeletePSISections(p);
-                p = p_section;
-                p_decoder->p_sections = p;
-                b_overwrite = true;
-            }
-            goto out;
-        }
-        else if (p->i_number > p_section->i_number)
-        {
-            /* Insert before p */
-            if (p_prev)
-            {
-                p_prev->p_next = p_section;
-                p_section->p_next = p;
-            }
-            else
-            {
-                p_section->p_next = p;
-                p_decoder->p_sections = p_section;
-            }
-            goto out;
+            dvbpsi_DeletePSISections(p_section);
+            return false;
         }
-
-        p_prev = p;
-        p = p->p_next;
+        p_decoder->pp_section_slots = pp_slots;
+        p_decoder->i_section_slots = i_number + 1;
     }
 
-    /* Add to end of list */
-    if (p_prev->i_number < p_section->i_number)
+    /* Link the section in the list after the previous one received */
+    bool b_overwrite = (p_decoder->i_sections_received[i_number >> 5]
+                            >> (i_number & 31)) & 1;
+    dvbpsi_psi_section_t *p_prev = dvbpsi_decoder_section_prev(p_decoder, i_number);
+    dvbpsi_psi_section_t **pp_link = p_prev ? &p_prev->p_next : &p_decoder->p_sections;
+
+    if (b_overwrite)
     {
-        p_prev->p_next = p_section;
-        p_section->p_next = NULL;
+        /* Replace */
+        dvbpsi_psi_section_t *p_old = p_decoder->pp_section_slots[i_number];
+        assert(*pp_link == p_old);
+        p_section->p_next = p_old->p_next;
+        p_old->p_next = NULL;
+        dvbpsi_DeletePSISections(p_old);
     }
+    else
+        p_section->p_next = *pp_link;
+
+    *pp_link = p_section;
+    p_decoder->pp_section_slots[i_number] = p_section;
+    p_decoder->i_sections_received[i_number >> 5] |= (uint32_t)1 << (i_number & 31);
 
-out:
     return b_overwrite;
 }
 
@@ -232,10 +315,361 @@ void dvbpsi_decoder_delete(dvbpsi_decoder_t *p_decoder)
         p_decoder->p_sections = NULL;
     }
 
+    free(p_decoder->pp_section_slots);
     dvbpsi_DeletePSISections(p_decoder->p_current_section);
+    dvbpsi_DeletePSISectionPool(p_decoder->p_pool);
+    if (p_decoder->p_cache)
+        free(p_decoder->p_cache->p_records);
+    free(p_decoder->p_cache);
+    free(p_decoder->p_snapshot);
+    free(p_decoder->p_gather_buffer);
+    while (p_decoder->p_filters)
+    {
+        dvbpsi_section_filter_t *p_next = p_decoder->p_filters->p_next;
+        free(p_decoder->p_filters);
+        p_decoder->p_filters = p_next;
+    }
     free(p_decoder);
 }
 
+/*****************************************************************************
+ * dvbpsi_decoder_zero_copy
+ *****************************************************************************/
+bool dvbpsi_decoder_zero_copy(dvbpsi_t *p_dvbpsi, const bool b_enable)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    dvbpsi_decoder_t *p_decoder = p_dvbpsi->p_decoder;
+    if (p_decoder->b_zero_copy == b_enable)
+        return true;
+
+    /* The section being gathered uses the old mode, start over */
+    dvbpsi_DeletePSISections(p_decoder->p_current_section);
+    p_decoder->p_current_section = NULL;
+    p_decoder->b_zero_copy = b_enable;
+
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_section_cache
+ *****************************************************************************/
+bool dvbpsi_decoder_section_cache(dvbpsi_t *p_dvbpsi, const bool b_enable)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    p_dvbpsi->p_decoder->b_section_cache = b_enable;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_retain_sections
+ *****************************************************************************/
+bool dvbpsi_decoder_retain_sections(dvbpsi_t *p_dvbpsi, const bool b_enable)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    p_dvbpsi->p_decoder->b_retain_sections = b_enable;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_delta
+ *****************************************************************************/
+bool dvbpsi_decoder_delta(dvbpsi_t *p_dvbpsi, const bool b_enable)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    p_dvbpsi->p_decoder->b_delta = b_enable;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_table_snapshot_s
+ *****************************************************************************
+ * Entries of a table sorted by key. Each one refers to a copy of its header
+ * and descriptor loop in p_bytes, which starts with the fields of the table,
+ * taken from its first section, and the descriptors of the table itself,
+ * from all the sections. Everything is allocated in one block.
+ *****************************************************************************/
+typedef struct dvbpsi_snapshot_entry_s
+{
+    uint32_t i_key;
+    uint32_t i_offset;
+    uint32_t i_length;
+} dvbpsi_snapshot_entry_t;
+
+struct dvbpsi_table_snapshot_s
+{
+    uint8_t                  i_version;
+    int                      i_entries;
+    dvbpsi_snapshot_entry_t *p_entries;
+    uint32_t                 i_table_length;
+    uint8_t *                p_bytes;
+};
+
+static int dvbpsi_CompareSnapshotEntries(const void *p_a, const void *p_b)
+{
+    const dvbpsi_snapshot_entry_t *p_entry_a = p_a, *p_entry_b = p_b;
+
+    if (p_entry_a->i_key != p_entry_b->i_key)
+        return p_entry_a->i_key < p_entry_b->i_key ? -1 : 1;
+    /* Keep duplicated keys in the order of the sections */
+    return p_entry_a->i_offset < p_entry_b->i_offset ? -1 : 1;
+}
+
+/*****************************************************************************
+ * dvbpsi_SnapshotTableStart
+ *****************************************************************************
+ * Start of the part of a section kept for the table: the fields of the table
+ * are only kept from the first section, so that the number of sections does
+ * not change the table.
+ *****************************************************************************/
+static inline uint8_t *dvbpsi_SnapshotTableStart(const dvbpsi_psi_section_t *p_sections,
+                                                 dvbpsi_psi_section_t *p_section,
+                                                 const dvbpsi_descriptor_cursor_t *p_cursor)
+{
+    return p_section == p_sections ? p_section->p_payload_start : p_cursor->p_next;
+}
+
+/*****************************************************************************
+ * dvbpsi_SnapshotClearLayout
+ *****************************************************************************
+ * Clear the fields of the copied table header that depend on how the table
+ * is split into sections: the length of the table descriptor loop and the
+ * segment_last_section_number of the EIT.
+ *****************************************************************************/
+static void dvbpsi_SnapshotClearLayout(uint8_t *p_header, const uint8_t i_table_id,
+                                       const size_t i_header)
+{
+    switch (i_table_id)
+    {
+        case 0x02: /* PMT */
+        case 0x40: /* NIT */
+        case 0x41:
+        case 0x4a: /* BAT */
+            if (i_header >= 2)
+            {
+                p_header[i_header - 2] &= 0xf0;
+                p_header[i_header - 1] = 0;
+            }
+            break;
+        case 0x42: /* SDT */
+        case 0x46:
+            break;
+        default:
+            if (i_table_id >= 0x4e && i_table_id <= 0x6f && i_header > 4)
+                p_header[4] = 0;
+            break;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_NewTableSnapshot
+ *****************************************************************************
+ * Walk the entries of the sections twice, to size the snapshot then to fill
+ * it.
+ *****************************************************************************/
+static dvbpsi_table_snapshot_t *dvbpsi_NewTableSnapshot(dvbpsi_psi_section_t *p_sections)
+{
+    dvbpsi_descriptor_cursor_t cursor;
+    dvbpsi_psi_section_t *p_section;
+    uint8_t *p_entry;
+    size_t i_size = 0;
+    int i_entries = 0;
+
+    for (p_section = p_sections; p_section; p_section = p_section->p_next)
+    {
+        if (!dvbpsi_descriptor_cursor_init(&cursor, p_section))
+            return NULL;
+        i_size += cursor.p_loop_end - dvbpsi_SnapshotTableStart(p_sections, p_section,
+                                                                &cursor);
+        while ((p_entry = dvbpsi_descriptor_cursor_next_entry(&cursor)) != NULL)
+        {
+            i_size += cursor.p_loop_end - p_entry;
+            i_entries++;
+        }
+    }
+
+    dvbpsi_table_snapshot_t *p_snapshot = (dvbpsi_table_snapshot_t *)
+                malloc(sizeof(dvbpsi_table_snapshot_t)
+                       + i_entries * sizeof(dvbpsi_snapshot_entry_t) + i_size);
+    if (p_snapshot == NULL)
+        return NULL;
+
+    p_snapshot->i_version = p_sections ? p_sections->i_version : 0;
+    p_snapshot->i_entries = i_entries;
+    p_snapshot->p_entries = (dvbpsi_snapshot_entry_t *)(p_snapshot + 1);
+    p_snapshot->p_bytes = (uint8_t *)(p_snapshot->p_entries + i_entries);
+    p_snapshot->i_table_length = 0;
+
+    /* The table parts of all the sections first, then the entries */
+    uint8_t *p_table = p_snapshot->p_bytes;
+    for (p_section = p_sections; p_section; p_section = p_section->p_next)
+    {
+        dvbpsi_descriptor_cursor_init(&cursor, p_section);
+        uint8_t *p_start = dvbpsi_SnapshotTableStart(p_sections, p_section, &cursor);
+        size_t i_length = cursor.p_loop_end - p_start;
+        memcpy(p_table, p_start, i_length);
+        if (p_section == p_sections)
+            dvbpsi_SnapshotClearLayout(p_table, p_section->i_table_id,
+                                       cursor.p_next - p_start);
+        p_table += i_length;
+    }
+    p_snapshot->i_table_length = p_table - p_snapshot->p_bytes;
+
+    uint8_t *p_bytes = p_table;
+    dvbpsi_snapshot_entry_t *p_snapshot_entry = p_snapshot->p_entries;
+    for (p_section = p_sections; p_section; p_section = p_section->p_next)
+    {
+        dvbpsi_descriptor_cursor_init(&cursor, p_section);
+        while ((p_entry = dvbpsi_descriptor_cursor_next_entry(&cursor)) != NULL)
+        {
+            size_t i_length = cursor.p_loop_end - p_entry;
+            p_snapshot_entry->i_key = dvbpsi_descriptor_cursor_entry_id(&cursor);
+            if (cursor.i_entry_size == 6) /* NIT and BAT */
+                p_snapshot_entry->i_key |= ((uint32_t)p_entry[2] << 24) | ((uint32_t)p_entry[3] << 16);
+            p_snapshot_entry->i_offset = p_bytes - p_snapshot->p_bytes;
+            p_snapshot_entry->i_length = i_length;
+            memcpy(p_bytes, p_entry, i_length);
+            p_bytes += i_length;
+            p_snapshot_entry++;
+        }
+    }
+
+    qsort(p_snapshot->p_entries, i_entries, sizeof(dvbpsi_snapshot_entry_t),
+          dvbpsi_CompareSnapshotEntries);
+    return p_snapshot;
+}
+
+/*****************************************************************************
+ * dvbpsi_DiffTableSnapshots
+ *****************************************************************************
+ * Merge the sorted entries of both snapshots. The key arrays are sized for
+ * the worst case.
+ *****************************************************************************/
+static dvbpsi_delta_t *dvbpsi_DiffTableSnapshots(const dvbpsi_table_snapshot_t *p_old,
+                                                 const dvbpsi_table_snapshot_t *p_new,
+                                                 dvbpsi_arena_t *p_arena)
+{
+    const dvbpsi_snapshot_entry_t *p_old_entries = p_old->p_entries;
+    const dvbpsi_snapshot_entry_t *p_new_entries = p_new->p_entries;
+    const int i_old = p_old->i_entries, i_new = p_new->i_entries;
+
+    dvbpsi_delta_t *p_delta = (dvbpsi_delta_t *)
+                dvbpsi_ArenaAlloc(p_arena, sizeof(dvbpsi_delta_t)
+                                  + (i_old + 2 * i_new) * sizeof(uint32_t));
+    if (p_delta == NULL)
+        return NULL;
+
+    p_delta->p_added = (uint32_t *)(p_delta + 1);
+    p_delta->p_removed = p_delta->p_added + i_new;
+    p_delta->p_modified = p_delta->p_removed + i_old;
+
+    p_delta->i_previous_version = p_old->i_version;
+    p_delta->b_table_changed = p_old->i_table_length != p_new->i_table_length
+                            || memcmp(p_old->p_bytes, p_new->p_bytes, p_new->i_table_length);
+
+    int i = 0, j = 0;
+    while (i < i_old || j < i_new)
+    {
+        if (j == i_new || (i < i_old && p_old_entries[i].i_key < p_new_entries[j].i_key))
+            p_delta->p_removed[p_delta->i_removed++] = p_old_entries[i++].i_key;
+        else if (i == i_old || p_new_entries[j].i_key < p_old_entries[i].i_key)
+            p_delta->p_added[p_delta->i_added++] = p_new_entries[j++].i_key;
+        else
+        {
+            if (p_old_entries[i].i_length != p_new_entries[j].i_length
+             || memcmp(p_old->p_bytes + p_old_entries[i].i_offset,
+                       p_new->p_bytes + p_new_entries[j].i_offset,
+                       p_new_entries[j].i_length))
+                p_delta->p_modified[p_delta->i_modified++] = p_new_entries[j].i_key;
+            i++;
+            j++;
+        }
+    }
+
+    return p_delta;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_psi_sections_delta
+ *****************************************************************************/
+dvbpsi_delta_t *dvbpsi_decoder_psi_sections_delta(dvbpsi_decoder_t *p_decoder,
+                                                  dvbpsi_arena_t *p_arena,
+                                                  dvbpsi_psi_section_t *p_sections)
+{
+    assert(p_decoder);
+
+    dvbpsi_table_snapshot_t *p_snapshot = dvbpsi_NewTableSnapshot(p_sections);
+    dvbpsi_delta_t *p_delta = NULL;
+
+    if (p_snapshot && p_decoder->p_snapshot && p_arena)
+        p_delta = dvbpsi_DiffTableSnapshots(p_decoder->p_snapshot, p_snapshot, p_arena);
+
+    /* Even without the new entries, as the next delta would be against a
+       stale table */
+    free(p_decoder->p_snapshot);
+    p_decoder->p_snapshot = p_snapshot;
+    return p_delta;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_filter_add
+ *****************************************************************************/
+bool dvbpsi_decoder_filter_add(dvbpsi_t *p_dvbpsi, const uint8_t *p_value,
+                               const uint8_t *p_mask, const int i_size)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    if (i_size < 0 || i_size > DVBPSI_SECTION_FILTER_SIZE)
+    {
+        dvbpsi_error(p_dvbpsi, "PSI decoder", "invalid section filter size (%d)", i_size);
+        return false;
+    }
+
+    dvbpsi_section_filter_t *p_filter;
+    p_filter = (dvbpsi_section_filter_t *)calloc(1, sizeof(dvbpsi_section_filter_t));
+    if (p_filter == NULL)
+        return false;
+
+    for (int i = 0; i < i_size; i++)
+    {
+        p_filter->i_mask[i] = p_mask[i];
+        p_filter->i_value[i] = p_value[i] & p_mask[i];
+        if (p_mask[i])
+            p_filter->i_depth = i + 1;
+    }
+
+    p_filter->p_next = p_dvbpsi->p_decoder->p_filters;
+    p_dvbpsi->p_decoder->p_filters = p_filter;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_filter_clear
+ *****************************************************************************/
+bool dvbpsi_decoder_filter_clear(dvbpsi_t *p_dvbpsi)
+{
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return false;
+
+    dvbpsi_decoder_t *p_decoder = p_dvbpsi->p_decoder;
+    while (p_decoder->p_filters)
+    {
+        dvbpsi_section_filter_t *p_next = p_decoder->p_filters->p_next;
+        free(p_decoder->p_filters);
+        p_decoder->p_filters = p_next;
+    }
+
+    return true;
+}
+
 /*****************************************************************************
  * dvbpsi_decoder_present
  *****************************************************************************/
@@ -248,11 +682,415 @@ bool dvbpsi_decoder_present(dvbpsi_t *p_dvbpsi)
 }
 
 /*****************************************************************************
- * dvbpsi_packet_push
+ * dvbpsi_decoder_section_new
  *****************************************************************************
- * Injection of a TS packet into a PSI decoder.
+ * Start gathering a new section that begins at 'p_pos' in a TS packet ending
+ * at 'p_end'. In zero-copy mode no section data is allocated: a section
+ * that ends in this packet is a view on the packet itself and a section that
+ * spans several packets is gathered in the reusable buffer of the decoder.
+ * Otherwise the section is only allocated as big as it needs to be. When
+ * that fails the new section is counted as dropped in 'p_stats'.
  *****************************************************************************/
-bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
+static dvbpsi_psi_section_t *dvbpsi_decoder_section_new(dvbpsi_t *p_dvbpsi,
+                                                        uint8_t *p_pos, uint8_t *p_end,
+                                                        dvbpsi_push_stats_t *p_stats)
+{
+    dvbpsi_decoder_t *p_decoder = p_dvbpsi->p_decoder;
+    dvbpsi_psi_section_t *p_section;
+
+    if (!p_decoder->b_zero_copy)
+    {
+        /* Size the section after its header when it is in this packet,
+           otherwise start small, dvbpsi_decoder_section_fit() will grow it */
+        int i_size = 3;
+        if (p_end - p_pos >= 3)
+            i_size = 3 + (((uint16_t)(p_pos[1] & 0xf)) << 8 | p_pos[2]);
+        if (i_size > p_decoder->i_section_max_size)
+            i_size = 3; /* Too long, it will be dropped */
+        p_section = dvbpsi_NewPooledPSISection(p_decoder->p_pool, i_size);
+        if (p_section == NULL)
+            goto error;
+    }
+    else
+    {
+        p_section = (dvbpsi_psi_section_t *)calloc(1, sizeof(dvbpsi_psi_section_t));
+        if (p_section == NULL)
+            goto error;
+        p_section->b_view = true;
+
+        if ((p_end - p_pos >= 3) &&
+            (3 + (((uint16_t)(p_pos[1] & 0xf)) << 8 | p_pos[2]) <= p_end - p_pos))
+            p_section->p_data = p_pos;
+        else
+        {
+            if (p_decoder->p_gather_buffer == NULL)
+                p_decoder->p_gather_buffer = (uint8_t *)malloc(p_decoder->i_section_max_size);
+            if (p_decoder->p_gather_buffer == NULL)
+            {
+                free(p_section);
+                goto error;
+            }
+            p_section->p_data = p_decoder->p_gather_buffer;
+        }
+        p_section->p_payload_end = p_section->p_data;
+    }
+
+    p_decoder->p_current_section = p_section;
+    /* Just need the header to know how long is the section */
+    p_decoder->i_need = 3;
+    p_decoder->b_complete_header = false;
+
+    return p_section;
+
+error:
+    dvbpsi_error(p_dvbpsi, "PSI decoder", "out of memory");
+    p_stats->i_dropped++;
+    return NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_section_filter
+ *****************************************************************************
+ * Match a section against the filters of the decoder. 'p_header' holds the 3
+ * first bytes of a section of 'i_length' bytes after the section_length
+ * field, 'p_rest' the 'i_rest' first of them. Returns 1 if the section
+ * matches a filter, 0 if it matches none and -1 if more bytes are needed to
+ * tell.
+ *****************************************************************************/
+static int dvbpsi_section_filter(const dvbpsi_decoder_t *p_decoder,
+                                 const uint8_t *p_header, const uint8_t *p_rest,
+                                 const int i_rest, const int i_length)
+{
+    int i_ret = 0;
+
+    for (const dvbpsi_section_filter_t *p_filter = p_decoder->p_filters;
+         p_filter; p_filter = p_filter->p_next)
+    {
+        /* Filtered bytes past the end of the section never match */
+        if (p_filter->i_depth - 1 > i_length)
+            continue;
+        if (p_filter->i_depth - 1 > i_rest)
+        {
+            i_ret = -1;
+            continue;
+        }
+
+        bool b_match = p_filter->i_depth == 0
+                    || (p_header[0] & p_filter->i_mask[0]) == p_filter->i_value[0];
+        for (int i = 1; b_match && i < p_filter->i_depth; i++)
+            b_match = (p_rest[i - 1] & p_filter->i_mask[i]) == p_filter->i_value[i];
+
+        if (b_match)
+            return 1;
+    }
+
+    return i_ret;
+}
+
+/*****************************************************************************
+ * dvbpsi_section_discarded
+ *****************************************************************************
+ * Is the section of a subtable the decoder is not interested in? 'p_header'
+ * holds the 3 first bytes of the section and 'p_rest' the 'i_rest' following
+ * ones. Returns false when it can't tell yet.
+ *****************************************************************************/
+static bool dvbpsi_section_discarded(dvbpsi_decoder_t *p_decoder,
+                                     const uint8_t *p_header, const uint8_t *p_rest,
+                                     const int i_rest)
+{
+    if (!p_decoder->pf_discard)
+        return false;
+
+    if (!(p_header[1] & 0x80))
+        return p_decoder->pf_discard(p_decoder, p_header[0], 0);
+    if (i_rest >= 2)
+        return p_decoder->pf_discard(p_decoder, p_header[0],
+                                     ((uint16_t)p_rest[0] << 8) | p_rest[1]);
+
+    return false;
+}
+
+/*****************************************************************************
+ * dvbpsi_section_known
+ *****************************************************************************
+ * Ask the decoder receiving the section if the section belongs to a table it
+ * already decoded. 'p_header' holds the 3 first bytes of a section of
+ * 'i_length' bytes after the section_length field, 'p_rest' the 'i_rest'
+ * first of them. Returns false when it can't tell yet.
+ *****************************************************************************/
+static bool dvbpsi_section_known(dvbpsi_decoder_t *p_decoder,
+                                 const uint8_t *p_header, const uint8_t *p_rest,
+                                 const int i_rest, const int i_length)
+{
+    /* The section cache checks every section to notice content changes
+       without a version update */
+    if (p_decoder->b_discontinuity || p_decoder->b_section_cache)
+        return false;
+
+    /* Only sections with the long header and a CRC_32 */
+    if (!(p_header[1] & 0x80) || i_length < 9 || i_rest < 5)
+        return false;
+
+    const uint8_t p_long[8] = { p_header[0], p_header[1], p_header[2],
+                                p_rest[0], p_rest[1], p_rest[2], p_rest[3], p_rest[4] };
+
+    dvbpsi_decoder_t *p_target = p_decoder;
+    if (p_decoder->pf_route)
+        p_target = p_decoder->pf_route(p_decoder, p_long[0],
+                                       ((uint16_t)p_long[3] << 8) | p_long[4]);
+
+    return p_target && p_target->pf_peek && p_target->pf_peek(p_target, p_long);
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_target
+ *****************************************************************************
+ * Decoder receiving a section whose header has not been parsed yet, NULL if
+ * there is none. 'p_header' holds the 3 first bytes of the section and
+ * 'p_rest' at least the 2 following ones.
+ *****************************************************************************/
+static inline dvbpsi_decoder_t *dvbpsi_section_cache_target(dvbpsi_decoder_t *p_decoder,
+                                                            const uint8_t *p_header,
+                                                            const uint8_t *p_rest)
+{
+    if (!p_decoder->pf_route)
+        return p_decoder;
+
+    return p_decoder->pf_route(p_decoder, p_header[0],
+                               ((uint16_t)p_rest[0] << 8) | p_rest[1]);
+}
+
+/*****************************************************************************
+ * dvbpsi_section_crc_field
+ *****************************************************************************
+ * Value of the CRC_32 field of a complete section.
+ *****************************************************************************/
+static inline uint32_t dvbpsi_section_crc_field(const dvbpsi_psi_section_t *p_section)
+{
+    const uint8_t *p_crc = p_section->p_data + 3 + p_section->i_length - 4;
+
+    return   ((uint32_t)p_crc[0] << 24) | ((uint32_t)p_crc[1] << 16)
+           | ((uint32_t)p_crc[2] << 8) | (uint32_t)p_crc[3];
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_find
+ *****************************************************************************
+ * Record of a key, NULL if the cache has none.
+ *****************************************************************************/
+static dvbpsi_section_record_t *dvbpsi_section_cache_find(const dvbpsi_section_cache_t *p_cache,
+                                                         const uint32_t i_key)
+{
+    if (p_cache == NULL || p_cache->i_size == 0)
+        return NULL;
+
+    uint32_t i_hash = i_key * 0x9e3779b1;
+    unsigned int i_mask = p_cache->i_size - 1;
+    for (unsigned int i = (i_hash ^ (i_hash >> 15)) & i_mask;; i = (i + 1) & i_mask)
+    {
+        if (!p_cache->p_records[i].b_used)
+            return NULL;
+        if (p_cache->p_records[i].i_key == i_key)
+            return &p_cache->p_records[i];
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_insert
+ *****************************************************************************
+ * Unused record for a key, the cache must have room for it.
+ *****************************************************************************/
+static dvbpsi_section_record_t *dvbpsi_section_cache_insert(dvbpsi_section_cache_t *p_cache,
+                                                           const uint32_t i_key)
+{
+    uint32_t i_hash = i_key * 0x9e3779b1;
+    unsigned int i_mask = p_cache->i_size - 1;
+    unsigned int i = (i_hash ^ (i_hash >> 15)) & i_mask;
+    while (p_cache->p_records[i].b_used)
+        i = (i + 1) & i_mask;
+
+    p_cache->p_records[i].i_key = i_key;
+    p_cache->p_records[i].b_used = true;
+    p_cache->p_records[i].b_valid = false;
+    p_cache->i_used++;
+    return &p_cache->p_records[i];
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_record
+ *****************************************************************************
+ * Record of a key, added if it is new. The records are kept at most half
+ * full. NULL on error.
+ *****************************************************************************/
+static dvbpsi_section_record_t *dvbpsi_section_cache_record(dvbpsi_section_cache_t *p_cache,
+                                                           const uint32_t i_key)
+{
+    dvbpsi_section_record_t *p_record = dvbpsi_section_cache_find(p_cache, i_key);
+    if (p_record)
+        return p_record;
+
+    if (2 * (p_cache->i_used + 1) > p_cache->i_size)
+    {
+        unsigned int i_old_size = p_cache->i_size;
+        unsigned int i_size = i_old_size ? 2 * i_old_size : 64;
+        dvbpsi_section_record_t *p_old = p_cache->p_records;
+
+        p_cache->p_records = (dvbpsi_section_record_t *)
+                calloc(i_size, sizeof(dvbpsi_section_record_t));
+        if (p_cache->p_records == NULL)
+        {
+            p_cache->p_records = p_old;
+            return NULL;
+        }
+        p_cache->i_size = i_size;
+        p_cache->i_used = 0;
+
+        for (unsigned int i = 0; i < i_old_size; i++)
+            if (p_old[i].b_used)
+                *dvbpsi_section_cache_insert(p_cache, p_old[i].i_key) = p_old[i];
+        free(p_old);
+    }
+
+    return dvbpsi_section_cache_insert(p_cache, i_key);
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_section_cache_forget
+ *****************************************************************************/
+void dvbpsi_decoder_section_cache_forget(dvbpsi_decoder_t *p_decoder,
+                                         const uint8_t i_table_id,
+                                         const uint16_t i_extension)
+{
+    dvbpsi_section_cache_t *p_cache = p_decoder->p_cache;
+    if (p_cache == NULL)
+        return;
+
+    const uint32_t i_subtable = DVBPSI_SECTION_KEY(i_table_id, i_extension, 0) >> 8;
+    for (unsigned int i = 0; i < p_cache->i_size; i++)
+        if (p_cache->p_records[i].b_used && (p_cache->p_records[i].i_key >> 8) == i_subtable)
+            p_cache->p_records[i].b_valid = false;
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_repeat
+ *****************************************************************************
+ * Is the section identical to the last one of its subtable and number handed
+ * to the decoder? 'p_header' holds the 3 first bytes of the section and
+ * 'p_rest' the 'i_length' following ones, they need not be contiguous so that
+ * a section can be checked in the TS packet before it is gathered.
+ *****************************************************************************/
+static bool dvbpsi_section_cache_repeat(const dvbpsi_decoder_t *p_decoder,
+                                        const uint8_t *p_header, const uint8_t *p_rest,
+                                        const int i_length)
+{
+    const dvbpsi_section_record_t *p_record;
+    p_record = dvbpsi_section_cache_find(p_decoder->p_cache,
+                   DVBPSI_SECTION_KEY(p_header[0], ((uint16_t)p_rest[0] << 8) | p_rest[1],
+                                      p_rest[3]));
+    if (p_record == NULL)
+        return false;
+
+    const uint8_t *p_crc = p_rest + i_length - 4;
+
+    return p_record->b_valid
+        && p_record->i_version == p_rest[2]
+        && p_record->i_length == i_length
+        && p_record->i_crc == (  ((uint32_t)p_crc[0] << 24) | ((uint32_t)p_crc[1] << 16)
+                               | ((uint32_t)p_crc[2] << 8) | (uint32_t)p_crc[3]);
+}
+
+/*****************************************************************************
+ * dvbpsi_section_cache_store
+ *****************************************************************************
+ * Record a valid section handed to the decoder. When the content of a section
+ * changed without a version update the records of its subtable are forgotten
+ * and the decoder is told, so that all the sections of the subtable are
+ * handed to it again and the table is decoded again.
+ *****************************************************************************/
+static void dvbpsi_section_cache_store(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_decoder,
+                                       const dvbpsi_psi_section_t *p_section,
+                                       dvbpsi_push_stats_t *p_stats)
+{
+    if (p_decoder->p_cache == NULL)
+    {
+        p_decoder->p_cache = (dvbpsi_section_cache_t *)calloc(1, sizeof(dvbpsi_section_cache_t));
+        if (p_decoder->p_cache == NULL)
+            return;
+    }
+
+    dvbpsi_section_record_t *p_record;
+    p_record = dvbpsi_section_cache_record(p_decoder->p_cache,
+                   DVBPSI_SECTION_KEY(p_section->i_table_id, p_section->i_extension,
+                                      p_section->i_number));
+    if (p_record == NULL)
+        return;
+
+    uint32_t i_crc = dvbpsi_section_crc_field(p_section);
+
+    if (   p_record->b_valid
+        && p_record->i_version == p_section->p_data[5]
+        && (   p_record->i_length != p_section->i_length
+            || p_record->i_crc != i_crc))
+    {
+        dvbpsi_warning(p_dvbpsi, "PSI decoder",
+                       "section %d of table 0x%02x (extension 0x%04x) changed "
+                       "without version update", p_section->i_number,
+                       p_section->i_table_id, p_section->i_extension);
+        p_stats->i_changed++;
+
+        dvbpsi_decoder_section_cache_forget(p_decoder, p_section->i_table_id,
+                                            p_section->i_extension);
+        if (p_decoder->pf_changed)
+            p_decoder->pf_changed(p_decoder, p_section->i_table_id,
+                                  p_section->i_extension);
+        else
+            p_decoder->b_current_valid = false;
+    }
+
+    p_record->b_valid = true;
+    p_record->i_version = p_section->p_data[5];
+    p_record->i_length = p_section->i_length;
+    p_record->i_crc = i_crc;
+}
+
+/*****************************************************************************
+ * dvbpsi_decoder_section_fit
+ *****************************************************************************
+ * Once the header of the current section is complete, make sure the section
+ * can hold 'i_length' more bytes. A section that was started before its
+ * length was known is moved to a big enough one. The current section is left
+ * untouched if that fails.
+ *****************************************************************************/
+static bool dvbpsi_decoder_section_fit(dvbpsi_decoder_t *p_decoder)
+{
+    dvbpsi_psi_section_t *p_section = p_decoder->p_current_section;
+
+    if (p_section->b_view || 3 + p_section->i_length <= p_section->i_max_size)
+        return true;
+
+    dvbpsi_psi_section_t *p_new = dvbpsi_NewPooledPSISection(p_decoder->p_pool,
+                                                             3 + p_section->i_length);
+    if (p_new == NULL)
+        return false;
+
+    memcpy(p_new->p_data, p_section->p_data, 3);
+    p_new->p_payload_end = p_new->p_data + 3;
+    p_new->i_length = p_section->i_length;
+
+    dvbpsi_DeletePSISections(p_section);
+    p_decoder->p_current_section = p_new;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_packet_push_stats
+ *****************************************************************************
+ * Injection of a TS packet into a PSI decoder, accounting for what happened
+ * to the sections in 'p_stats'. This is the common worker for
+ * dvbpsi_packet_push() and dvbpsi_packets_push().
+ *****************************************************************************/
+static inline bool dvbpsi_packet_push_stats(dvbpsi_t *p_dvbpsi, uint8_t* p_data,
+                                            dvbpsi_push_stats_t *p_stats)
 {
     uint8_t i_expected_counter;           /* Expected continuity counter */
     dvbpsi_psi_section_t* p_section;      /* Current section */
@@ -270,6 +1108,7 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
     if (p_data[0] != 0x47)
     {
         dvbpsi_error(p_dvbpsi, "PSI decoder", "not a TS packet");
+        p_stats->i_ts_errors++;
         return false;
     }
 
@@ -289,6 +1128,7 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                      "TS duplicate (received %d, expected %d) for PID %d",
                      p_decoder->i_continuity_counter, i_expected_counter,
                      ((uint16_t)(p_data[1] & 0x1f) << 8) | p_data[2]);
+            p_stats->i_ts_errors++;
             return false;
         }
 
@@ -299,8 +1139,10 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                      p_decoder->i_continuity_counter, i_expected_counter,
                      ((uint16_t)(p_data[1] & 0x1f) << 8) | p_data[2]);
             p_decoder->b_discontinuity = true;
+            p_stats->i_discontinuities++;
             if (p_decoder->p_current_section)
             {
+                p_stats->i_dropped++;
                 dvbpsi_DeletePSISections(p_decoder->p_current_section);
                 p_decoder->p_current_section = NULL;
             }
@@ -333,18 +1175,14 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
         if (p_new_pos)
         {
             /* Allocation of the structure */
-            p_decoder->p_current_section
-                        = p_section
-                        = dvbpsi_NewPSISection(p_decoder->i_section_max_size);
+            p_section = dvbpsi_decoder_section_new(p_dvbpsi, p_new_pos, p_data + 188,
+                                                   p_stats);
             if (!p_section)
                 return false;
             /* Update the position in the packet */
             p_payload_pos = p_new_pos;
             /* New section is being handled */
             p_new_pos = NULL;
-            /* Just need the header to know how long is the section */
-            p_decoder->i_need = 3;
-            p_decoder->b_complete_header = false;
         }
         else
         {
@@ -362,7 +1200,9 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
         {
             /* There are enough bytes in this packet to complete the
                header/section */
-            memcpy(p_section->p_payload_end, p_payload_pos, p_decoder->i_need);
+            /* A zero-copy view on the packet is already in place */
+            if (p_section->p_payload_end != p_payload_pos)
+                memcpy(p_section->p_payload_end, p_payload_pos, p_decoder->i_need);
             p_payload_pos += p_decoder->i_need;
             p_section->p_payload_end += p_decoder->i_need;
             i_available -= p_decoder->i_need;
@@ -375,25 +1215,85 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                 p_decoder->i_need = p_section->i_length
                                   = ((uint16_t)(p_section->p_data[1] & 0xf)) << 8
                                        | p_section->p_data[2];
-                /* Check that the section isn't too long */
-                if (p_decoder->i_need > p_decoder->i_section_max_size - 3)
+                /* Check that the section isn't too long and has to be gathered,
+                   usually the bytes following the header are in this packet */
+                bool b_too_long = p_decoder->i_need > p_decoder->i_section_max_size - 3;
+                bool b_ignore = false, b_known = false, b_repeat = false;
+                if (!b_too_long)
+                {
+                    int i_rest = i_available < p_decoder->i_need ? i_available
+                                                                 : p_decoder->i_need;
+                    if (p_decoder->p_filters)
+                        b_ignore = dvbpsi_section_filter(p_decoder, p_section->p_data,
+                                       p_payload_pos, i_rest, p_decoder->i_need) == 0;
+                    if (!b_ignore)
+                        b_ignore = dvbpsi_section_discarded(p_decoder, p_section->p_data,
+                                                            p_payload_pos, i_rest);
+                    if (!b_ignore)
+                        b_known = dvbpsi_section_known(p_decoder, p_section->p_data,
+                                                       p_payload_pos, i_rest,
+                                                       p_decoder->i_need);
+                    /* A repeat ending in this packet is compared in place */
+                    p_section->i_table_id = p_section->p_data[0];
+                    p_section->b_syntax_indicator = p_section->p_data[1] & 0x80;
+                    if (!b_ignore && !b_known && i_rest == p_decoder->i_need
+                        && p_decoder->b_section_cache && !p_decoder->b_discontinuity
+                        && p_section->b_syntax_indicator && dvbpsi_has_CRC32(p_section)
+                        && p_decoder->i_need >= 9)
+                    {
+                        dvbpsi_decoder_t *p_target;
+                        p_target = dvbpsi_section_cache_target(p_decoder, p_section->p_data,
+                                                               p_payload_pos);
+                        b_repeat = p_target
+                                && dvbpsi_section_cache_repeat(p_target, p_section->p_data,
+                                                               p_payload_pos, i_rest);
+                    }
+                }
+                if (b_ignore || b_known || b_repeat)
                 {
-                    dvbpsi_error(p_dvbpsi, "PSI decoder", "PSI section too long");
+                    /* Skip the section without gathering it */
+                    if (b_ignore)
+                        p_stats->i_ignored++;
+                    else if (b_known)
+                        p_stats->i_skipped++;
+                    else
+                        p_stats->i_repeats++;
                     dvbpsi_DeletePSISections(p_section);
                     p_decoder->p_current_section = NULL;
+                    if (p_decoder->i_need <= i_available)
+                    {
+                        p_payload_pos += p_decoder->i_need;
+                        i_available -= p_decoder->i_need;
+                        if (p_new_pos == NULL && i_available && *p_payload_pos != 0xff)
+                            p_new_pos = p_payload_pos;
+                    }
+                }
+                /* Make room for the section */
+                else if (b_too_long || !dvbpsi_decoder_section_fit(p_decoder))
+                {
+                    if (b_too_long)
+                        dvbpsi_error(p_dvbpsi, "PSI decoder", "PSI section too long");
+                    else
+                        dvbpsi_error(p_dvbpsi, "PSI decoder", "out of memory");
+                    p_stats->i_dropped++;
+                    dvbpsi_DeletePSISections(p_section);
+                    p_decoder->p_current_section = NULL;
+                }
+                else
+                    p_section = p_decoder->p_current_section;
+
+                if (p_decoder->p_current_section == NULL)
+                {
                     /* If there is a new section not being handled then go forward
                        in the packet */
                     if (p_new_pos)
                     {
-                        p_decoder->p_current_section
-                                    = p_section
-                                    = dvbpsi_NewPSISection(p_decoder->i_section_max_size);
+                        p_section = dvbpsi_decoder_section_new(p_dvbpsi, p_new_pos,
+                                                               p_data + 188, p_stats);
                         if (!p_section)
                             return false;
                         p_payload_pos = p_new_pos;
                         p_new_pos = NULL;
-                        p_decoder->i_need = 3;
-                        p_decoder->b_complete_header = false;
                         i_available = 188 + p_data - p_payload_pos;
                     }
                     else
@@ -417,11 +1317,51 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                 if (p_section->b_syntax_indicator || has_crc32)
                     p_section->p_payload_end -= 4;
 
+                /* Drop the sections that could not be checked with the header
+                   only: not matching the filters, of subtables nobody is
+                   interested in or of tables already decoded */
+                bool b_ignore = false, b_known = false;
+                if (p_decoder->p_filters)
+                    b_ignore = dvbpsi_section_filter(p_decoder, p_section->p_data,
+                                   p_section->p_data + 3, p_section->i_length,
+                                   p_section->i_length) == 0;
+                if (!b_ignore)
+                    b_ignore = dvbpsi_section_discarded(p_decoder, p_section->p_data,
+                                   p_section->p_data + 3, p_section->i_length);
+                if (!b_ignore)
+                    b_known = dvbpsi_section_known(p_decoder, p_section->p_data,
+                                   p_section->p_data + 3, p_section->i_length,
+                                   p_section->i_length);
+
+                /* Look for a repeat of a section spanning several packets */
+                dvbpsi_decoder_t *p_target = NULL;
+                if (!b_ignore && !b_known
+                    && p_decoder->b_section_cache && !p_decoder->b_discontinuity
+                    && p_section->b_syntax_indicator && has_crc32
+                    && p_section->i_length >= 9)
+                    p_target = dvbpsi_section_cache_target(p_decoder, p_section->p_data,
+                                                           p_section->p_data + 3);
+                bool b_repeat = p_target
+                             && dvbpsi_section_cache_repeat(p_target, p_section->p_data,
+                                                            p_section->p_data + 3,
+                                                            p_section->i_length);
+
                 /* Check CRC32 if present */
-                if (has_crc32)
+                if (has_crc32 && !b_repeat && !b_ignore && !b_known)
                     b_valid_crc32 = dvbpsi_ValidPSISection(p_section);
 
-                if (!has_crc32 || b_valid_crc32)
+                if (b_ignore || b_known || b_repeat)
+                {
+                    if (b_ignore)
+                        p_stats->i_ignored++;
+                    else if (b_known)
+                        p_stats->i_skipped++;
+                    else
+                        p_stats->i_repeats++;
+                    dvbpsi_DeletePSISections(p_section);
+                    p_decoder->p_current_section = NULL;
+                }
+                else if (!has_crc32 || b_valid_crc32)
                 {
                     /* PSI section is valid */
                     if (p_section->b_syntax_indicator)
@@ -443,17 +1383,27 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                         p_section->i_last_number = 0;
                         p_section->p_payload_start = p_section->p_data + 3;
                     }
+                    /* Before the gather callback which may delete p_target */
+                    if (p_target)
+                        dvbpsi_section_cache_store(p_dvbpsi, p_target, p_section, p_stats);
+                    p_stats->i_sections++;
                     if (p_decoder->pf_gather)
                         p_decoder->pf_gather(p_dvbpsi, p_section);
                     p_decoder->p_current_section = NULL;
                 }
                 else
                 {
-                    if (has_crc32 && !dvbpsi_ValidPSISection(p_section))
+                    if (has_crc32 && !b_valid_crc32)
+                    {
                         dvbpsi_error(p_dvbpsi, "misc PSI", "Bad CRC_32 table 0x%x !!!",
                                                p_section->p_data[0]);
+                        p_stats->i_crc_errors++;
+                    }
                     else
+                    {
                         dvbpsi_error(p_dvbpsi, "misc PSI", "table 0x%x", p_section->p_data[0]);
+                        p_stats->i_dropped++;
+                    }
 
                     /* PSI section isn't valid => trash it */
                     dvbpsi_DeletePSISections(p_section);
@@ -470,15 +1420,12 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
                    in the packet */
                 if (p_new_pos)
                 {
-                    p_decoder->p_current_section
-                              = p_section
-                              = dvbpsi_NewPSISection(p_decoder->i_section_max_size);
+                    p_section = dvbpsi_decoder_section_new(p_dvbpsi, p_new_pos,
+                                                           p_data + 188, p_stats);
                     if (!p_section)
                         return false;
                     p_payload_pos = p_new_pos;
                     p_new_pos = NULL;
-                    p_decoder->i_need = 3;
-                    p_decoder->b_complete_header = false;
                     i_available = 188 + p_data - p_payload_pos;
                 }
                 else
@@ -499,6 +1446,46 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
     }
     return true;
 }
+
+/*****************************************************************************
+ * dvbpsi_packet_push
+ *****************************************************************************
+ * Injection of a TS packet into a PSI decoder.
+ *****************************************************************************/
+bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
+{
+    dvbpsi_push_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+    return dvbpsi_packet_push_stats(p_dvbpsi, p_data, &stats);
+}
+
+/*****************************************************************************
+ * dvbpsi_packets_push
+ *****************************************************************************
+ * Injection of a block of TS packets into a PSI decoder.
+ *****************************************************************************/
+bool dvbpsi_packets_push(dvbpsi_t *p_dvbpsi, uint8_t *p_data, size_t i_packets,
+                         size_t i_stride, dvbpsi_push_stats_t *p_stats)
+{
+    dvbpsi_push_stats_t stats;
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    if (p_stats == NULL)
+        p_stats = &stats;
+    memset(p_stats, 0, sizeof(dvbpsi_push_stats_t));
+
+    if (i_stride == 0)
+        i_stride = 188;
+    assert(i_stride >= 188);
+
+    uint8_t *p_end = p_data + i_packets * i_stride;
+    for (; p_data < p_end; p_data += i_stride)
+        dvbpsi_packet_push_stats(p_dvbpsi, p_data, p_stats);
+    p_stats->i_packets = i_packets;
+
+    return (p_stats->i_ts_errors == 0);
+}
 #undef DVBPSI_INVALID_CC
 
 /*****************************************************************************
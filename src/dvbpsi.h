@@ -147,6 +147,17 @@ struct dvbpsi_s
     dvbpsi_message_cb             pf_message;           /*!< Log message callback */
     enum dvbpsi_msg_level         i_msg_level;          /*!< Log level */
 
+    /* Sections of the dvbpsi_xxx_sections_generate() functions */
+    struct dvbpsi_psi_section_pool_s *p_pool;           /*!< pool the generated
+                                                          sections are taken
+                                                          from, NULL to allocate
+                                                          them. The pool belongs
+                                                          to the caller:
+                                                          dvbpsi_delete() does
+                                                          not delete it, call
+                                                          dvbpsi_DeletePSISectionPool()
+                                                          when done with it */
+
     /* private data pointer for use by caller, not by libdvbpsi itself ! */
     void                         *p_sys;                /*!< pointer to private data
                                                           from caller. Do not use
@@ -198,6 +209,70 @@ void dvbpsi_delete(dvbpsi_t *p_dvbpsi);
  */
 bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data);
 
+/*****************************************************************************
+ * dvbpsi_push_stats_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_push_stats_s
+ * \brief Per block accounting of dvbpsi_packets_push().
+ *
+ * This structure is filled by dvbpsi_packets_push() and tells what happened
+ * to the TS packets and PSI sections of one block.
+ */
+/*!
+ * \typedef struct dvbpsi_push_stats_s dvbpsi_push_stats_t
+ * \brief dvbpsi_push_stats_t type definition.
+ */
+typedef struct dvbpsi_push_stats_s
+{
+    unsigned int    i_packets;          /*!< TS packets pushed */
+    unsigned int    i_ts_errors;        /*!< TS packets rejected (no sync byte
+                                             or duplicate packet) */
+    unsigned int    i_discontinuities;  /*!< continuity counter errors */
+
+    unsigned int    i_sections;         /*!< sections completed and handed to
+                                             the decoder */
+    unsigned int    i_dropped;          /*!< sections dropped (discontinuity,
+                                             too long, out of memory) */
+    unsigned int    i_crc_errors;       /*!< sections dropped because of a
+                                             bad CRC_32 */
+    unsigned int    i_repeats;          /*!< repeated sections dropped by the
+                                             section cache */
+    unsigned int    i_changed;          /*!< sections whose content changed
+                                             without a version update */
+    unsigned int    i_ignored;          /*!< sections rejected by the section
+                                             filters or of subtables no
+                                             decoder is interested in */
+    unsigned int    i_skipped;          /*!< sections of tables already
+                                             decoded skipped after their
+                                             header */
+} dvbpsi_push_stats_t;
+
+/*****************************************************************************
+ * dvbpsi_packets_push
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_packets_push(dvbpsi_t *p_dvbpsi, uint8_t *p_data,
+ *                              size_t i_packets, size_t i_stride,
+ *                              dvbpsi_push_stats_t *p_stats)
+ * \brief Injection of a block of TS packets into a PSI decoder.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param p_data pointer to the first TS packet of the block
+ * \param i_packets number of TS packets in the block
+ * \param i_stride distance in bytes between the start of two consecutive
+ *        TS packets (188, 192 for M2TS, 204 for RS coded packets). When 0
+ *        then 188 is assumed.
+ * \param p_stats pointer to per block statistics, may be NULL
+ * \return true when all packets have been handled, false when at least one
+ *         packet was rejected (see dvbpsi_push_stats_t::i_ts_errors).
+ *
+ * Equivalent to calling dvbpsi_packet_push() for each packet of the block,
+ * all packets must belong to the PID the attached decoder is interested in.
+ * The counters in 'p_stats' are reset on entry.
+ */
+bool dvbpsi_packets_push(dvbpsi_t *p_dvbpsi, uint8_t *p_data, size_t i_packets,
+                         size_t i_stride, dvbpsi_push_stats_t *p_stats);
+
 /*****************************************************************************
  * dvbpsi_psi_section_t
  *****************************************************************************/
@@ -208,6 +283,52 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data);
  */
 typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t;
 
+/*****************************************************************************
+ * dvbpsi_psi_section_pool_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_psi_section_pool_s dvbpsi_psi_section_pool_t
+ * \brief Opaque pool of PSI sections.
+ *
+ * A section pool keeps the sections given back by dvbpsi_DeletePSISections()
+ * on free lists, one per size class (256, 1024 and 4096 bytes), so that
+ * they can be reused without going through the allocator. Every decoder
+ * gathering TS packets owns such a pool.
+ */
+typedef struct dvbpsi_psi_section_pool_s dvbpsi_psi_section_pool_t;
+
+/*****************************************************************************
+ * dvbpsi_psi_section_cache_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_psi_section_cache_s dvbpsi_psi_section_cache_t
+ * \brief Opaque cache of the generated sections of a table.
+ *
+ * A section cache remembers which entries of a table each generated section
+ * carries, so that a new version of the table only encodes again the
+ * sections whose entries changed.
+ */
+typedef struct dvbpsi_psi_section_cache_s dvbpsi_psi_section_cache_t;
+
+/*****************************************************************************
+ * dvbpsi_arena_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_arena_s dvbpsi_arena_t
+ * \brief Opaque memory arena of a decoded table.
+ *
+ * A table created with one of the dvbpsi_xxx_new() functions owns an arena
+ * from which its entries (events, services, ES, ...) and their descriptors
+ * are carved. They are not freed one by one, the whole arena is released
+ * by dvbpsi_xxx_empty() and dvbpsi_xxx_delete().
+ *
+ * Applications must therefore not give such entries to free() nor their
+ * descriptors to dvbpsi_DeleteDescriptors(): this corrupts the arena.
+ * Tables set up with dvbpsi_xxx_init() have no arena, their entries and
+ * descriptors are allocated one by one as before.
+ */
+typedef struct dvbpsi_arena_s dvbpsi_arena_t;
+
 /*****************************************************************************
  * dvbpsi_callback_gather_t
  *****************************************************************************/
@@ -219,6 +340,132 @@ typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t;
 typedef void (* dvbpsi_callback_gather_t)(dvbpsi_t *p_dvbpsi,  /*!< pointer to dvbpsi handle */
                             dvbpsi_psi_section_t* p_section);  /*!< pointer to psi section */
 
+/*****************************************************************************
+ * dvbpsi_callback_route_t
+ *****************************************************************************/
+/*!
+ * \typedef dvbpsi_decoder_t *(* dvbpsi_callback_route_t)(dvbpsi_decoder_t *p_decoder,
+                                                       const uint8_t i_table_id,
+                                                       const uint16_t i_extension)
+ * \brief Callback used by decoders handing sections over to other decoders
+ * (eg: the demux) to tell which decoder gets the sections of a subtable.
+ * It returns NULL if no decoder would get them.
+ */
+typedef dvbpsi_decoder_t *(* dvbpsi_callback_route_t)(dvbpsi_decoder_t *p_decoder, /*!< pointer to decoder */
+                            const uint8_t i_table_id,    /*!< table id */
+                            const uint16_t i_extension); /*!< table extension */
+
+/*****************************************************************************
+ * dvbpsi_callback_changed_t
+ *****************************************************************************/
+/*!
+ * \typedef void (* dvbpsi_callback_changed_t)(dvbpsi_decoder_t *p_decoder,
+                                              const uint8_t i_table_id,
+                                              const uint16_t i_extension)
+ * \brief Callback used by the section cache to tell a decoder receiving
+ * several subtables (eg: a demux family) that a subtable changed without a
+ * version update, so that it decodes that subtable again. Decoders without
+ * it get dvbpsi_decoder_t::b_current_valid cleared instead.
+ */
+typedef void (* dvbpsi_callback_changed_t)(dvbpsi_decoder_t *p_decoder, /*!< pointer to decoder */
+                            const uint8_t i_table_id,    /*!< table id */
+                            const uint16_t i_extension); /*!< table extension */
+
+/*****************************************************************************
+ * dvbpsi_callback_discard_t
+ *****************************************************************************/
+/*!
+ * \typedef bool (* dvbpsi_callback_discard_t)(dvbpsi_decoder_t *p_decoder,
+                                               const uint8_t i_table_id,
+                                               const uint16_t i_extension)
+ * \brief Callback used by decoders to tell that the sections of a subtable
+ * are of no interest to them. Such sections are dropped before their CRC_32
+ * is checked.
+ */
+typedef bool (* dvbpsi_callback_discard_t)(dvbpsi_decoder_t *p_decoder, /*!< pointer to decoder */
+                            const uint8_t i_table_id,    /*!< table id */
+                            const uint16_t i_extension); /*!< table extension */
+
+/*****************************************************************************
+ * dvbpsi_callback_peek_t
+ *****************************************************************************/
+/*!
+ * \typedef bool (* dvbpsi_callback_peek_t)(dvbpsi_decoder_t *p_decoder,
+                                            const uint8_t *p_header)
+ * \brief Callback used by dvbpsi_packet_push() to ask a decoder if it
+ * already decoded the table of a section, given the 8 bytes of the long
+ * header of the section (table_id up to last_section_number). When it
+ * returns true the rest of the section is skipped without being copied nor
+ * checked and the decoder never gets the section.
+ */
+typedef bool (* dvbpsi_callback_peek_t)(dvbpsi_decoder_t *p_decoder, /*!< pointer to decoder */
+                            const uint8_t *p_header);    /*!< long section header */
+
+/*****************************************************************************
+ * dvbpsi_section_cache_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_section_cache_s dvbpsi_section_cache_t
+ * \brief Opaque record of the last sections received by a decoder.
+ */
+typedef struct dvbpsi_section_cache_s dvbpsi_section_cache_t;
+
+/*****************************************************************************
+ * dvbpsi_section_filter_t
+ *****************************************************************************/
+/*!
+ * \def DVBPSI_SECTION_FILTER_SIZE
+ * \brief Maximum number of section header bytes a section filter looks at.
+ */
+#define DVBPSI_SECTION_FILTER_SIZE 16
+
+/*!
+ * \typedef struct dvbpsi_section_filter_s dvbpsi_section_filter_t
+ * \brief Opaque list of section filters of a decoder.
+ */
+typedef struct dvbpsi_section_filter_s dvbpsi_section_filter_t;
+
+/*****************************************************************************
+ * dvbpsi_table_snapshot_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_table_snapshot_s dvbpsi_table_snapshot_t
+ * \brief Opaque copy of the entries of the last table decoded by a decoder.
+ */
+typedef struct dvbpsi_table_snapshot_s dvbpsi_table_snapshot_t;
+
+/*****************************************************************************
+ * dvbpsi_delta_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_delta_s
+ * \brief Changes between two versions of a table.
+ *
+ * The entries of a table are identified by a key: the elementary_PID of the
+ * elementary streams of a PMT, the service_id of the services of a SDT, the
+ * event_id of the events of an EIT and, for the transport streams of a NIT,
+ * (original_network_id << 16) | transport_stream_id. An entry is modified
+ * when its fields or its descriptors differ. The keys are sorted in
+ * increasing order.
+ */
+/*!
+ * \typedef struct dvbpsi_delta_s dvbpsi_delta_t
+ * \brief dvbpsi_delta_t type definition.
+ */
+typedef struct dvbpsi_delta_s
+{
+    uint8_t   i_previous_version;  /*!< version_number of the previous table */
+    bool      b_table_changed;     /*!< fields or descriptors of the table
+                                        itself changed */
+
+    int       i_added;             /*!< number of added entries */
+    uint32_t *p_added;             /*!< keys of the added entries */
+    int       i_removed;           /*!< number of removed entries */
+    uint32_t *p_removed;           /*!< keys of the removed entries */
+    int       i_modified;          /*!< number of modified entries */
+    uint32_t *p_modified;          /*!< keys of the modified entries */
+} dvbpsi_delta_t;
+
 /*****************************************************************************
  * DVBPSI_DECODER_COMMON
  *****************************************************************************/
@@ -242,9 +489,25 @@ typedef void (* dvbpsi_callback_gather_t)(dvbpsi_t *p_dvbpsi,  /*!< pointer to d
     uint8_t  i_last_section_number;/*!< Last received section number */           \
     dvbpsi_psi_section_t *p_current_section; /*!< Current section */              \
     dvbpsi_psi_section_t *p_sections; /*!< List of received PSI sections */       \
+    dvbpsi_psi_section_t **pp_section_slots; /*!< Received sections by number */  \
+    int      i_section_slots;      /*!< Size of pp_section_slots */               \
+    uint32_t i_sections_received[8]; /*!< Bitmap of the received numbers */       \
     dvbpsi_callback_gather_t  pf_gather;/*!< PSI decoder's callback */            \
     int      i_section_max_size;   /*!< Max size of a section for this decoder */ \
     int      i_need;               /*!< Bytes needed */                           \
+    bool     b_zero_copy;          /*!< Zero-copy section reassembly */           \
+    uint8_t *p_gather_buffer;      /*!< Reusable buffer for zero-copy mode */     \
+    dvbpsi_psi_section_pool_t *p_pool; /*!< Pool of gathered sections */          \
+    bool     b_section_cache;      /*!< Drop repeated sections */                 \
+    dvbpsi_section_cache_t *p_cache; /*!< Last sections received */               \
+    dvbpsi_callback_route_t pf_route; /*!< Decoder receiving a subtable */        \
+    dvbpsi_callback_changed_t pf_changed; /*!< Subtable changed in place */       \
+    dvbpsi_callback_discard_t pf_discard; /*!< Subtables to drop */               \
+    dvbpsi_callback_peek_t pf_peek; /*!< Tables already decoded */                \
+    dvbpsi_section_filter_t *p_filters; /*!< Sections to gather */                \
+    bool     b_retain_sections;    /*!< Tables keep their sections */             \
+    bool     b_delta;              /*!< Tables come with a delta */               \
+    dvbpsi_table_snapshot_t *p_snapshot; /*!< Entries of the previous table */    \
 /**@}*/
 
 /*****************************************************************************
@@ -280,6 +543,8 @@ struct dvbpsi_decoder_s
  * corresponds to a dvbpsi_decoder_t.
  * Upon return the pointer should be casted to the correct type. Delete the pointer
  * with @see dvbpsi_decoder_delete() function.
+ * When 'pf_gather' is given the decoder also gets a section pool from which the
+ * sections gathered from TS packets are taken.
  */
 void *dvbpsi_decoder_new(dvbpsi_callback_gather_t pf_gather,
                          const int i_section_max_size,
@@ -313,6 +578,27 @@ void dvbpsi_decoder_delete(dvbpsi_decoder_t *p_decoder);
  */
 void dvbpsi_decoder_reset(dvbpsi_decoder_t* p_decoder, const bool b_force);
 
+/*****************************************************************************
+ * dvbpsi_decoder_section_cache_forget
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_decoder_section_cache_forget(dvbpsi_decoder_t *p_decoder,
+ *                                              const uint8_t i_table_id,
+ *                                              const uint16_t i_extension);
+ * \brief Forget the sections of a subtable recorded by the section cache of a
+ * decoder, so that their repeats are handed to the decoder again.
+ * \param p_decoder pointer to dvbpsi_decoder_t with decoder
+ * \param i_table_id table id of the subtable
+ * \param i_extension table extension of the subtable
+ * \return nothing
+ *
+ * dvbpsi_decoder_reset() forgets all of them, a decoder receiving several
+ * subtables uses this when it starts decoding one of them again.
+ */
+void dvbpsi_decoder_section_cache_forget(dvbpsi_decoder_t *p_decoder,
+                                         const uint8_t i_table_id,
+                                         const uint16_t i_extension);
+
 /*****************************************************************************
  * dvbpsi_decoder_psi_sections_completed
  *****************************************************************************/
@@ -333,9 +619,182 @@ bool dvbpsi_decoder_psi_sections_completed(dvbpsi_decoder_t* p_decoder);
  * \param p_decoder pointer to dvbpsi_decoder_t with decoder
  * \param p_section PSI section to add to dvbpsi_decoder_t::p_sections list
  * \return true if it overwrites a earlier section, false otherwise
+ *
+ * A section gathered in zero-copy mode is copied before it is added. If
+ * that fails the section is released and false is returned.
+ *
+ * The received sections are indexed by section_number, adding a section
+ * and checking for completion take constant time. The
+ * dvbpsi_decoder_t::p_sections list is kept sorted on section_number for
+ * the decoding functions, it must only be changed through this function
+ * and dvbpsi_decoder_reset().
  */
 bool dvbpsi_decoder_psi_section_add(dvbpsi_decoder_t *p_decoder, dvbpsi_psi_section_t *p_section);
 
+/*****************************************************************************
+ * dvbpsi_decoder_zero_copy
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_zero_copy(dvbpsi_t *p_dvbpsi, const bool b_enable);
+ * \brief Enable or disable zero-copy section reassembly for the decoder
+ * attached to the handle.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param b_enable true to enable zero-copy mode, false to disable it
+ * \return true on success, false if no decoder is attached.
+ *
+ * In zero-copy mode a section that is contained in one TS packet is handed
+ * to the decoder's gather callback as a view on the packet given to
+ * dvbpsi_packet_push(), without allocating or copying the section data. A
+ * section that spans several TS packets is gathered in a buffer owned by
+ * the decoder which is reused for the next section. Such sections have
+ * dvbpsi_psi_section_t::b_view set and are only valid during the gather
+ * callback: dvbpsi_decoder_psi_section_add() takes a private copy of the
+ * sections it keeps, sections which are ignored are never copied. External
+ * decoders that keep sections by other means must call
+ * dvbpsi_UnsharePSISection() themselves.
+ */
+bool dvbpsi_decoder_zero_copy(dvbpsi_t *p_dvbpsi, const bool b_enable);
+
+/*****************************************************************************
+ * dvbpsi_decoder_section_cache
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_section_cache(dvbpsi_t *p_dvbpsi, const bool b_enable);
+ * \brief Enable or disable dropping of repeated sections for the decoder
+ * attached to the handle.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param b_enable true to drop repeated sections, false to hand all of them
+ * to the decoder
+ * \return true on success, false if no decoder is attached.
+ *
+ * Tables are repeated with identical content over and over. With the section
+ * cache each decoder (each subtable decoder for the demux, or the family of
+ * a subtable that has no decoder of its own) remembers the version_number,
+ * current_next_indicator, section_length and CRC_32 of the last section it
+ * got for each table_id, table_id_extension and section_number. A section
+ * identical to it is dropped before its CRC_32 is computed and before the
+ * gather callback. A section ending in the TS packet it starts in is
+ * compared in the packet and never copied, a section spanning several
+ * packets is compared once it is reassembled. The records are forgotten
+ * every time the decoder is reset, which happens when a table is complete or
+ * has to be built again, and a family forgets those of a subtable when it
+ * starts decoding it, so sections are never withheld from a table being
+ * built. Only sections with section_syntax_indicator set and a CRC_32 are
+ * cached.
+ *
+ * A section that comes with the version of the recorded one but another
+ * length or CRC_32 has been changed without a version update, which is not
+ * compliant but happens. Its decoder, or its family, is then told that the
+ * table is no longer valid so that it is decoded again.
+ */
+bool dvbpsi_decoder_section_cache(dvbpsi_t *p_dvbpsi, const bool b_enable);
+
+/*****************************************************************************
+ * dvbpsi_decoder_retain_sections
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_retain_sections(dvbpsi_t *p_dvbpsi, const bool b_enable);
+ * \brief Let the tables decoded through the handle keep their sections.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param b_enable true to hand the sections over to the decoded tables, false
+ * to copy the descriptors out of them
+ * \return true on success, false if no decoder is attached.
+ *
+ * By default the payload of every descriptor is copied out of the sections,
+ * which are freed once the table is decoded. When the sections are retained
+ * the PMT, SDT, EIT, NIT, BAT and CAT decoders hand them over to the table
+ * they signal, in its p_sections member, and the descriptors of each
+ * descriptor loop are one array whose p_data points into the sections.
+ * They are freed together with the table. EIT decoders delivering events
+ * per section or per segment still copy them. A table with retained
+ * sections must only be given those sections to dvbpsi_XXX_sections_decode().
+ *
+ * Retained sections come from the section pool of the decoder, which is not
+ * thread-safe: a table keeping its sections has to be deleted on the thread
+ * pushing the packets, or while no packet is pushed to that decoder.
+ */
+bool dvbpsi_decoder_retain_sections(dvbpsi_t *p_dvbpsi, const bool b_enable);
+
+/*****************************************************************************
+ * dvbpsi_decoder_delta
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_delta(dvbpsi_t *p_dvbpsi, const bool b_enable);
+ * \brief Let the tables decoded through the handle come with the changes
+ * since the previous version.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param b_enable true to compute the changes, false otherwise
+ * \return true on success, false if no decoder is attached.
+ *
+ * The PMT, SDT, NIT and EIT decoders (each subtable decoder for the demux)
+ * then keep a copy of the entries of the last table they signalled. The
+ * p_delta member of the next table they signal lists the entries added,
+ * removed and modified since, see dvbpsi_delta_t. It is NULL for the first
+ * table and when the changes could not be computed. The delta is part of
+ * the table and freed with it. EIT decoders delivering events per section
+ * or per segment do not compute changes.
+ */
+bool dvbpsi_decoder_delta(dvbpsi_t *p_dvbpsi, const bool b_enable);
+
+/*****************************************************************************
+ * dvbpsi_decoder_psi_sections_delta
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_delta_t *dvbpsi_decoder_psi_sections_delta(dvbpsi_decoder_t *p_decoder,
+                                                         dvbpsi_arena_t *p_arena,
+                                                         dvbpsi_psi_section_t *p_sections);
+ * \brief Compare the entries of a new version of a table with those of the
+ * previous one and remember the new ones.
+ * \param p_decoder pointer to dvbpsi_decoder_t with decoder
+ * \param p_arena arena of the new table the delta is carved from
+ * \param p_sections sections of the new table, the table_id must be
+ * supported by dvbpsi_descriptor_cursor_init()
+ * \return the changes, NULL if the decoder has no previous table, without
+ * an arena or when out of memory.
+ */
+dvbpsi_delta_t *dvbpsi_decoder_psi_sections_delta(dvbpsi_decoder_t *p_decoder,
+                                                  dvbpsi_arena_t *p_arena,
+                                                  dvbpsi_psi_section_t *p_sections);
+
+/*****************************************************************************
+ * dvbpsi_decoder_filter_add
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_filter_add(dvbpsi_t *p_dvbpsi, const uint8_t *p_value,
+                                      const uint8_t *p_mask, const int i_size);
+ * \brief Add a section filter to the decoder attached to the handle.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param p_value values of the filtered bytes
+ * \param p_mask bits of the filtered bytes that are compared
+ * \param i_size number of filtered bytes, at most DVBPSI_SECTION_FILTER_SIZE
+ * \return true on success, false if no decoder is attached, on a bad size or
+ * when out of memory.
+ *
+ * Like the section filters of DVB demux hardware, a filter compares the first
+ * bytes of the sections with (p_value, p_mask): byte 0 of the filter is the
+ * table_id and byte i > 0 is byte i + 2 of the section, the section_length
+ * is skipped. A section matches when
+ * (byte & p_mask[i]) == (p_value[i] & p_mask[i]) for all the filtered bytes.
+ * Once a decoder has filters, dvbpsi_packet_push() only gathers the sections
+ * matching at least one of them. The other ones are dropped as soon as the
+ * filtered bytes are received, before they are copied and before their
+ * CRC_32 is checked.
+ */
+bool dvbpsi_decoder_filter_add(dvbpsi_t *p_dvbpsi, const uint8_t *p_value,
+                               const uint8_t *p_mask, const int i_size);
+
+/*****************************************************************************
+ * dvbpsi_decoder_filter_clear
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_decoder_filter_clear(dvbpsi_t *p_dvbpsi);
+ * \brief Remove all the section filters of the decoder attached to the
+ * handle, all sections are gathered again.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \return true on success, false if no decoder is attached.
+ */
+bool dvbpsi_decoder_filter_clear(dvbpsi_t *p_dvbpsi);
+
 /*****************************************************************************
  * dvbpsi_decoder_present
  *****************************************************************************/
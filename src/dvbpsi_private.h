@@ -32,6 +32,12 @@
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
+/* New section of the dvbpsi_xxx_sections_generate() functions, which accept
+ * a NULL handle. It is taken from dvbpsi_t::p_pool when there is one and its
+ * 'i_max_size' first bytes are cleared, the generators do not write them
+ * all. */
+dvbpsi_psi_section_t *dvbpsi_NewGeneratedPSISection(dvbpsi_t *p_dvbpsi, int i_max_size);
+
 /*****************************************************************************
  * Error management
  *
@@ -45,7 +51,7 @@ void dvbpsi_message(dvbpsi_t *dvbpsi, const int level, const char *fmt, ...);
 #  define dvbpsi_error(hnd, src, str, x...)                             \
         dvbpsi_message(hnd, DVBPSI_MSG_ERROR, "libdvbpsi error (%s): " str, src, ##x)
 #  define dvbpsi_warning(hnd, src, str, x...)                                \
-        dvbpsi_message(hnd, DVBPSI_MSG_WARNING, "libdvbpsi warning (%s): " str, src, ##x)
+        dvbpsi_message(hnd, DVBPSI_MSG_WARN, "libdvbpsi warning (%s): " str, src, ##x)
 #  define dvbpsi_debug(hnd, src, str, x...)                                  \
         dvbpsi_message(hnd, DVBPSI_MSG_DEBUG, "libdvbpsi debug (%s): " str, src, ##x)
 #else
@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * packetizer.c: TS packetizer
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "packetizer.h"
+
+/*****************************************************************************
+ * dvbpsi_packetizer_s
+ *****************************************************************************/
+struct dvbpsi_packetizer_s
+{
+    bool    b_pack;                     /* several sections per packet */
+    uint8_t i_continuity_counter[8192]; /* next continuity_counter per PID */
+};
+
+/*****************************************************************************
+ * dvbpsi_packetizer_new
+ *****************************************************************************/
+dvbpsi_packetizer_t *dvbpsi_packetizer_new(const bool b_pack)
+{
+    dvbpsi_packetizer_t *p_packetizer
+                = (dvbpsi_packetizer_t *)calloc(1, sizeof(dvbpsi_packetizer_t));
+    if (p_packetizer == NULL)
+        return NULL;
+
+    p_packetizer->b_pack = b_pack;
+    return p_packetizer;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_delete
+ *****************************************************************************/
+void dvbpsi_packetizer_delete(dvbpsi_packetizer_t *p_packetizer)
+{
+    free(p_packetizer);
+}
+
+/*****************************************************************************
+ * dvbpsi_SectionEnd
+ *****************************************************************************
+ * First byte after the section, including its CRC_32.
+ *****************************************************************************/
+static inline uint8_t *dvbpsi_SectionEnd(dvbpsi_psi_section_t *p_section)
+{
+    return p_section->p_payload_end + (dvbpsi_has_CRC32(p_section) ? 4 : 0);
+}
+
+/*****************************************************************************
+ * dvbpsi_Packetize
+ *****************************************************************************
+ * Lay out the sections into packets, writing them when p_buffer isn't NULL.
+ * A packet gets a pointer_field when a section starts in it: either at its
+ * beginning, or after the end of the previous section when that section
+ * leaves room for at least one byte of the next one.
+ *****************************************************************************/
+static size_t dvbpsi_Packetize(dvbpsi_packetizer_t *p_packetizer, const uint16_t i_pid,
+                               dvbpsi_psi_section_t *p_section, uint8_t *p_buffer)
+{
+    uint8_t *p_packet = NULL;
+    size_t i_packets = 0;
+    int i_pos = 188;        /* position in the current packet */
+    bool b_pointer = false; /* the current packet has a pointer_field */
+
+    for (; p_section != NULL; p_section = p_section->p_next)
+    {
+        uint8_t *p_byte = p_section->p_data;
+        uint8_t *p_end = dvbpsi_SectionEnd(p_section);
+
+        while (p_byte < p_end)
+        {
+            if (i_pos == 188)
+            {
+                size_t i_left = p_end - p_byte;
+                bool b_first = p_byte == p_section->p_data;
+                b_pointer = b_first || (p_packetizer->b_pack
+                                        && p_section->p_next != NULL && i_left < 183);
+                if (p_buffer)
+                {
+                    uint8_t *p_cc = &p_packetizer->i_continuity_counter[i_pid];
+                    p_packet = p_buffer + 188 * i_packets;
+                    p_packet[0] = 0x47;
+                    p_packet[1] = (b_pointer ? 0x40 : 0x00) | ((i_pid >> 8) & 0x1f);
+                    p_packet[2] = i_pid & 0xff;
+                    p_packet[3] = 0x10 | *p_cc;
+                    *p_cc = (*p_cc + 1) & 0x0f;
+                    if (b_pointer)
+                        p_packet[4] = b_first ? 0 : i_left;
+                }
+                i_pos = b_pointer ? 5 : 4;
+                i_packets++;
+            }
+
+            int i_copy = p_end - p_byte;
+            if (i_copy > 188 - i_pos)
+                i_copy = 188 - i_pos;
+            if (p_buffer)
+                memcpy(p_packet + i_pos, p_byte, i_copy);
+            p_byte += i_copy;
+            i_pos += i_copy;
+        }
+
+        /* Keep the packet open for the next section or stuff it */
+        if (i_pos < 188
+         && !(p_packetizer->b_pack && p_section->p_next != NULL && b_pointer))
+        {
+            if (p_buffer)
+                memset(p_packet + i_pos, 0xff, 188 - i_pos);
+            i_pos = 188;
+        }
+    }
+
+    return i_packets;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_write
+ *****************************************************************************/
+size_t dvbpsi_packetizer_write(dvbpsi_packetizer_t *p_packetizer,
+                               const uint16_t i_pid,
+                               dvbpsi_psi_section_t *p_sections,
+                               uint8_t *p_buffer, const size_t i_packets)
+{
+    assert(p_packetizer);
+    assert(i_pid < 8192);
+
+    size_t i_needed = dvbpsi_Packetize(p_packetizer, i_pid, p_sections, NULL);
+    if (p_buffer == NULL)
+        return i_needed;
+    if (i_needed > i_packets)
+        return 0;
+
+    return dvbpsi_Packetize(p_packetizer, i_pid, p_sections, p_buffer);
+}
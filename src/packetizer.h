@@ -0,0 +1,109 @@
+/*****************************************************************************
+ * packetizer.h
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <packetizer.h>
+ * \brief TS packetizer.
+ *
+ * Writing of PSI sections into MPEG2 TS packets (ISO/IEC 13818-1 section
+ * 2.4.3 and 2.4.4.2).
+ */
+
+#ifndef _DVBPSI_PACKETIZER_H_
+#define _DVBPSI_PACKETIZER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_packetizer_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_packetizer_s dvbpsi_packetizer_t
+ * \brief Opaque TS packetizer.
+ *
+ * A packetizer keeps the continuity_counter of every PID it writes packets
+ * for, so that consecutive calls to dvbpsi_packetizer_write() on a PID
+ * produce a continuous stream.
+ */
+typedef struct dvbpsi_packetizer_s dvbpsi_packetizer_t;
+
+/*****************************************************************************
+ * dvbpsi_packetizer_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_packetizer_t *dvbpsi_packetizer_new(const bool b_pack)
+ * \brief Creation of a new packetizer.
+ * \param b_pack true to start a section in the packet where the previous
+ * one ends, false to start every section in a new packet
+ * \return a pointer to the packetizer or NULL on error.
+ *
+ * Without packing the end of the last packet of each section is filled
+ * with stuffing bytes (0xFF). With packing the next section starts right
+ * after the previous one, and the pointer_field of the packet tells where.
+ * The last packet of a chain of sections is always stuffed.
+ */
+dvbpsi_packetizer_t *dvbpsi_packetizer_new(const bool b_pack);
+
+/*****************************************************************************
+ * dvbpsi_packetizer_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_packetizer_delete(dvbpsi_packetizer_t *p_packetizer)
+ * \brief Destruction of a packetizer.
+ * \param p_packetizer pointer to the packetizer
+ * \return nothing.
+ */
+void dvbpsi_packetizer_delete(dvbpsi_packetizer_t *p_packetizer);
+
+/*****************************************************************************
+ * dvbpsi_packetizer_write
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_packetizer_write(dvbpsi_packetizer_t *p_packetizer,
+                                      const uint16_t i_pid,
+                                      dvbpsi_psi_section_t *p_sections,
+                                      uint8_t *p_buffer, const size_t i_packets)
+ * \brief Write a chain of sections into TS packets.
+ * \param p_packetizer pointer to the packetizer
+ * \param i_pid PID of the packets
+ * \param p_sections first section of the chain, as returned by the
+ * dvbpsi_xxx_sections_generate() functions
+ * \param p_buffer buffer receiving the 188 byte packets, or NULL
+ * \param i_packets number of packets the buffer can hold
+ * \return the number of packets written, 0 if the buffer is too small, in
+ * which case nothing is written. When p_buffer is NULL nothing is written
+ * and the number of packets needed is returned.
+ */
+size_t dvbpsi_packetizer_write(dvbpsi_packetizer_t *p_packetizer,
+                               const uint16_t i_pid,
+                               dvbpsi_psi_section_t *p_sections,
+                               uint8_t *p_buffer, const size_t i_packets);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of packetizer.h"
+#endif
+
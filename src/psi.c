@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include <assert.h>
 
@@ -42,101 +43,6 @@
 #include "dvbpsi_private.h"
 #include "psi.h"
 
-/*****************************************************************************
- * dvbpsi_crc32_table
- *****************************************************************************
- * This table is used to compute a PSI CRC byte per byte instead of bit per
- * bit. It's been generated by 'gen_crc' in the 'misc' directory:
- *
- *   uint32_t table[256];
- *   uint32_t i, j, k;
- *
- *   for(i = 0; i < 256; i++)
- *   {
- *     k = 0;
- *     for (j = (i << 24) | 0x800000; j != 0x80000000; j <<= 1)
- *       k = (k << 1) ^ (((k ^ j) & 0x80000000) ? 0x04c11db7 : 0);
- *     table[i] = k;
- *   }
- *
- * A CRC is computed like this:
- *
- *   initialization
- *   --------------
- *   uint32_t i_crc = 0xffffffff;
- *
- *   for each data byte do
- *   ---------------------
- *   i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[(i_crc >> 24) ^ (data_byte)];
- *****************************************************************************/
-static uint32_t dvbpsi_crc32_table[256] =
-{
-  0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9,
-  0x130476dc, 0x17c56b6b, 0x1a864db2, 0x1e475005,
-  0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
-  0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd,
-  0x4c11db70, 0x48d0c6c7, 0x4593e01e, 0x4152fda9,
-  0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
-  0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011,
-  0x791d4014, 0x7ddc5da3, 0x709f7b7a, 0x745e66cd,
-  0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
-  0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5,
-  0xbe2b5b58, 0xbaea46ef, 0xb7a96036, 0xb3687d81,
-  0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
-  0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49,
-  0xc7361b4c, 0xc3f706fb, 0xceb42022, 0xca753d95,
-  0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
-  0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d,
-  0x34867077, 0x30476dc0, 0x3d044b19, 0x39c556ae,
-  0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
-  0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16,
-  0x018aeb13, 0x054bf6a4, 0x0808d07d, 0x0cc9cdca,
-  0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
-  0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02,
-  0x5e9f46bf, 0x5a5e5b08, 0x571d7dd1, 0x53dc6066,
-  0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
-  0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e,
-  0xbfa1b04b, 0xbb60adfc, 0xb6238b25, 0xb2e29692,
-  0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
-  0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a,
-  0xe0b41de7, 0xe4750050, 0xe9362689, 0xedf73b3e,
-  0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
-  0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686,
-  0xd5b88683, 0xd1799b34, 0xdc3abded, 0xd8fba05a,
-  0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
-  0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb,
-  0x4f040d56, 0x4bc510e1, 0x46863638, 0x42472b8f,
-  0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
-  0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47,
-  0x36194d42, 0x32d850f5, 0x3f9b762c, 0x3b5a6b9b,
-  0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
-  0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623,
-  0xf12f560e, 0xf5ee4bb9, 0xf8ad6d60, 0xfc6c70d7,
-  0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
-  0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f,
-  0xc423cd6a, 0xc0e2d0dd, 0xcda1f604, 0xc960ebb3,
-  0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
-  0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b,
-  0x9b3660c6, 0x9ff77d71, 0x92b45ba8, 0x9675461f,
-  0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
-  0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640,
-  0x4e8ee645, 0x4a4ffbf2, 0x470cdd2b, 0x43cdc09c,
-  0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
-  0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24,
-  0x119b4be9, 0x155a565e, 0x18197087, 0x1cd86d30,
-  0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
-  0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088,
-  0x2497d08d, 0x2056cd3a, 0x2d15ebe3, 0x29d4f654,
-  0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
-  0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c,
-  0xe3a1cbc1, 0xe760d676, 0xea23f0af, 0xeee2ed18,
-  0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
-  0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0,
-  0x9abc8bd5, 0x9e7d9662, 0x933eb0bb, 0x97ffad0c,
-  0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
-  0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
-};
-
 /*****************************************************************************
  * dvbpsi_NewPSISection
  *****************************************************************************
@@ -159,11 +65,192 @@ dvbpsi_psi_section_t *dvbpsi_NewPSISection(int i_max_size)
     }
 
     p_section->p_payload_end = p_section->p_data;
+    p_section->i_max_size = i_max_size;
     p_section->p_next = NULL;
 
     return p_section;
 }
 
+/*****************************************************************************
+ * dvbpsi_psi_section_pool_s
+ *****************************************************************************
+ * Free lists of sections, one per size class. A pooled section is allocated
+ * in one block together with its data area. The pool is referenced by its
+ * owner and by every section taken from it, so it outlives its owner while
+ * sections are still in use. Nothing is locked, the free lists and the
+ * reference count are only touched by the thread using the pool.
+ *****************************************************************************/
+#define DVBPSI_POOL_CLASSES   3
+#define DVBPSI_POOL_CACHE_MAX 16   /* sections kept per size class, at most
+                                      about 84 KiB per pool */
+
+static const int dvbpsi_pool_class_size[DVBPSI_POOL_CLASSES] = { 256, 1024, 4096 };
+
+struct dvbpsi_psi_section_pool_s
+{
+    dvbpsi_psi_section_t *p_free[DVBPSI_POOL_CLASSES]; /* free lists */
+    int           i_free[DVBPSI_POOL_CLASSES];         /* free list lengths */
+    unsigned int  i_refcount;   /* owner + sections in use */
+    bool          b_orphan;     /* the owner deleted the pool */
+};
+
+/*****************************************************************************
+ * dvbpsi_PoolClass
+ *****************************************************************************
+ * Smallest size class holding 'i_size' bytes, -1 if there is none.
+ *****************************************************************************/
+static inline int dvbpsi_PoolClass(int i_size)
+{
+    for (int i = 0; i < DVBPSI_POOL_CLASSES; i++)
+    {
+        if (i_size <= dvbpsi_pool_class_size[i])
+            return i;
+    }
+    return -1;
+}
+
+/*****************************************************************************
+ * dvbpsi_NewPSISectionPool
+ *****************************************************************************
+ * Creation of an empty section pool.
+ *****************************************************************************/
+dvbpsi_psi_section_pool_t *dvbpsi_NewPSISectionPool(void)
+{
+    dvbpsi_psi_section_pool_t *p_pool
+                  = (dvbpsi_psi_section_pool_t *)calloc(1, sizeof(dvbpsi_psi_section_pool_t));
+    if (p_pool == NULL)
+        return NULL;
+
+    p_pool->i_refcount = 1;
+    p_pool->b_orphan = false;
+    return p_pool;
+}
+
+/*****************************************************************************
+ * dvbpsi_ReleasePSISectionPool
+ *****************************************************************************
+ * Drop one reference to the pool and free it with the last one. By then the
+ * owner is gone and the free lists are empty.
+ *****************************************************************************/
+static void dvbpsi_ReleasePSISectionPool(dvbpsi_psi_section_pool_t *p_pool)
+{
+    assert(p_pool->i_refcount > 0);
+
+    if (--p_pool->i_refcount == 0)
+        free(p_pool);
+}
+
+/*****************************************************************************
+ * dvbpsi_DeletePSISectionPool
+ *****************************************************************************
+ * The owner gives up the pool, cached sections are freed right away.
+ *****************************************************************************/
+void dvbpsi_DeletePSISectionPool(dvbpsi_psi_section_pool_t *p_pool)
+{
+    if (p_pool == NULL)
+        return;
+
+    assert(!p_pool->b_orphan);
+    p_pool->b_orphan = true;
+
+    for (int i = 0; i < DVBPSI_POOL_CLASSES; i++)
+    {
+        dvbpsi_psi_section_t *p_section = p_pool->p_free[i];
+        while (p_section)
+        {
+            dvbpsi_psi_section_t *p_next = p_section->p_next;
+            free(p_section);
+            p_section = p_next;
+        }
+        p_pool->p_free[i] = NULL;
+        p_pool->i_free[i] = 0;
+    }
+
+    dvbpsi_ReleasePSISectionPool(p_pool);
+}
+
+/*****************************************************************************
+ * dvbpsi_NewPooledPSISection
+ *****************************************************************************
+ * Take a section from the free list of the right size class, allocate one
+ * if that list is empty.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_NewPooledPSISection(dvbpsi_psi_section_pool_t *p_pool,
+                                                 int i_max_size)
+{
+    int i_class = dvbpsi_PoolClass(i_max_size);
+    if (p_pool == NULL || i_class < 0)
+        return dvbpsi_NewPSISection(i_max_size);
+
+    assert(!p_pool->b_orphan);
+
+    dvbpsi_psi_section_t *p_section = p_pool->p_free[i_class];
+    if (p_section)
+    {
+        p_pool->p_free[i_class] = p_section->p_next;
+        p_pool->i_free[i_class]--;
+    }
+    else
+    {
+        p_section = (dvbpsi_psi_section_t *)malloc(sizeof(dvbpsi_psi_section_t)
+                                                   + dvbpsi_pool_class_size[i_class]);
+        if (p_section == NULL)
+            return NULL;
+    }
+
+    /* The data area is not cleared, the decoders overwrite it with the
+     * packets and dvbpsi_NewGeneratedPSISection() clears it for the
+     * generators */
+    memset(p_section, 0, sizeof(dvbpsi_psi_section_t));
+    p_section->p_data = (uint8_t *)(p_section + 1);
+    p_section->p_payload_end = p_section->p_data;
+    p_section->i_max_size = dvbpsi_pool_class_size[i_class];
+    p_section->p_pool = p_pool;
+    p_pool->i_refcount++;
+
+    return p_section;
+}
+
+/*****************************************************************************
+ * dvbpsi_NewGeneratedPSISection
+ *****************************************************************************
+ * Section for a generator. Recycled sections hold the bytes of their previous
+ * use and the generators leave some alone (reserved bits, unsupported
+ * fields), so the requested size is cleared as dvbpsi_NewPSISection() does.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_NewGeneratedPSISection(dvbpsi_t *p_dvbpsi, int i_max_size)
+{
+    dvbpsi_psi_section_t *p_section;
+    p_section = dvbpsi_NewPooledPSISection(p_dvbpsi ? p_dvbpsi->p_pool : NULL, i_max_size);
+
+    if (p_section && p_section->p_pool)
+        memset(p_section->p_data, 0, i_max_size);
+    return p_section;
+}
+
+/*****************************************************************************
+ * dvbpsi_PoolPSISection
+ *****************************************************************************
+ * Give a pooled section back to its pool.
+ *****************************************************************************/
+static void dvbpsi_PoolPSISection(dvbpsi_psi_section_t *p_section)
+{
+    dvbpsi_psi_section_pool_t *p_pool = p_section->p_pool;
+    int i_class = dvbpsi_PoolClass(p_section->i_max_size);
+    assert(i_class >= 0);
+
+    if (!p_pool->b_orphan && p_pool->i_free[i_class] < DVBPSI_POOL_CACHE_MAX)
+    {
+        p_section->p_next = p_pool->p_free[i_class];
+        p_pool->p_free[i_class] = p_section;
+        p_pool->i_free[i_class]++;
+    }
+    else
+        free(p_section);
+
+    dvbpsi_ReleasePSISectionPool(p_pool);
+}
+
 /*****************************************************************************
  * dvbpsi_DeletePSISections
  *****************************************************************************
@@ -175,7 +262,14 @@ void dvbpsi_DeletePSISections(dvbpsi_psi_section_t *p_section)
     {
         dvbpsi_psi_section_t* p_next = p_section->p_next;
 
-        if (p_section->p_data != NULL)
+        if (p_section->p_pool)
+        {
+            dvbpsi_PoolPSISection(p_section);
+            p_section = p_next;
+            continue;
+        }
+
+        if (p_section->p_data != NULL && !p_section->b_view)
             free(p_section->p_data);
 
         free(p_section);
@@ -184,6 +278,35 @@ void dvbpsi_DeletePSISections(dvbpsi_psi_section_t *p_section)
     p_section = NULL;
 }
 
+/*****************************************************************************
+ * dvbpsi_UnsharePSISection
+ *****************************************************************************
+ * Copy the data of a section that is a view on somebody else's memory.
+ *****************************************************************************/
+bool dvbpsi_UnsharePSISection(dvbpsi_psi_section_t *p_section)
+{
+    assert(p_section);
+
+    if (!p_section->b_view)
+        return true;
+
+    /* The whole section including the CRC_32 if any */
+    size_t i_size = 3 + p_section->i_length;
+    uint8_t *p_data = (uint8_t *)malloc(i_size);
+    if (p_data == NULL)
+        return false;
+
+    memcpy(p_data, p_section->p_data, i_size);
+    if (p_section->p_payload_start)
+        p_section->p_payload_start = p_data + (p_section->p_payload_start - p_section->p_data);
+    p_section->p_payload_end = p_data + (p_section->p_payload_end - p_section->p_data);
+    p_section->p_data = p_data;
+    p_section->i_max_size = i_size;
+    p_section->b_view = false;
+
+    return true;
+}
+
 /*****************************************************************************
  * dvbpsi_CheckPSISection
  *****************************************************************************
@@ -230,14 +353,8 @@ bool dvbpsi_CheckPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section,
  *****************************************************************************/
 bool dvbpsi_ValidPSISection(dvbpsi_psi_section_t* p_section)
 {
-    uint32_t i_crc = 0xffffffff;
-    uint8_t* p_byte = p_section->p_data;
-
-    while(p_byte < p_section->p_payload_end + 4)
-    {
-        i_crc = (i_crc << 8) ^ dvbpsi_crc32_table[(i_crc >> 24) ^ (*p_byte)];
-        p_byte++;
-    }
+    uint32_t i_crc = dvbpsi_crc32(0xffffffff, p_section->p_data,
+                                  p_section->p_payload_end + 4 - p_section->p_data);
 
     if (i_crc == 0)
         return true;
@@ -252,15 +369,8 @@ bool dvbpsi_ValidPSISection(dvbpsi_psi_section_t* p_section)
  *****************************************************************************/
 void dvbpsi_CalculateCRC32(dvbpsi_psi_section_t *p_section)
 {
-    uint8_t* p_byte = p_section->p_data;
-    p_section->i_crc = 0xffffffff;
-
-    while (p_byte < p_section->p_payload_end)
-    {
-        p_section->i_crc =   (p_section->i_crc << 8)
-                           ^ dvbpsi_crc32_table[(p_section->i_crc >> 24) ^ (*p_byte)];
-        p_byte++;
-    }
+    p_section->i_crc = dvbpsi_crc32(0xffffffff, p_section->p_data,
+                                    p_section->p_payload_end - p_section->p_data);
 
     p_section->p_payload_end[0] = (p_section->i_crc >> 24) & 0xff;
     p_section->p_payload_end[1] = (p_section->i_crc >> 16) & 0xff;
@@ -269,11 +379,11 @@ void dvbpsi_CalculateCRC32(dvbpsi_psi_section_t *p_section)
 }
 
 /*****************************************************************************
- * dvbpsi_BuildPSISection
+ * dvbpsi_WritePSISectionHeader
  *****************************************************************************
- * Build the section based on the information in the structure.
+ * Write the header of a section from its members.
  *****************************************************************************/
-void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
+static void dvbpsi_WritePSISectionHeader(dvbpsi_psi_section_t* p_section)
 {
     /* table_id */
     p_section->p_data[0] = p_section->i_table_id;
@@ -303,11 +413,24 @@ void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
         p_section->p_data[7] = p_section->i_last_number;
 
     }
+}
+
+/*****************************************************************************
+ * dvbpsi_BuildPSISection
+ *****************************************************************************
+ * Build the section based on the information in the structure.
+ *****************************************************************************/
+void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
+{
+    dvbpsi_WritePSISectionHeader(p_section);
 
     if (dvbpsi_has_CRC32(p_section))
     {
         dvbpsi_CalculateCRC32(p_section);
 
+#ifdef DVBPSI_DEBUG
+        /* Recomputing the CRC_32 of every generated section costs as much
+         * as generating it, only debug builds check it */
         if (!dvbpsi_ValidPSISection(p_section))
         {
             dvbpsi_error(p_dvbpsi, "misc PSI", "********************************************");
@@ -316,5 +439,580 @@ void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
             dvbpsi_error(p_dvbpsi, "misc PSI", "*  ---  libdvbpsi-devel@videolan.org  ---  *");
             dvbpsi_error(p_dvbpsi, "misc PSI", "********************************************");
         }
+#else
+        (void)p_dvbpsi;
+#endif
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_WritePSISections
+ *****************************************************************************
+ * Copy a list of sections back to back into the caller's buffer.
+ *****************************************************************************/
+size_t dvbpsi_WritePSISections(dvbpsi_psi_section_t *p_sections,
+                               uint8_t *p_buffer, const size_t i_size)
+{
+    size_t i_total = 0;
+    for (dvbpsi_psi_section_t *p = p_sections; p != NULL; p = p->p_next)
+    {
+        /* Built sections end with their CRC_32 */
+        uint8_t *p_end = dvbpsi_has_CRC32(p) ? p->p_payload_end + 4
+                                             : p->p_payload_end;
+        i_total += p_end - p->p_data;
+    }
+
+    if (p_buffer == NULL)
+        return i_total;
+    if (i_total > i_size)
+        return 0;
+
+    uint8_t *p_write = p_buffer;
+    for (dvbpsi_psi_section_t *p = p_sections; p != NULL; p = p->p_next)
+    {
+        uint8_t *p_end = dvbpsi_has_CRC32(p) ? p->p_payload_end + 4
+                                             : p->p_payload_end;
+        memcpy(p_write, p->p_data, p_end - p->p_data);
+        p_write += p_end - p->p_data;
+    }
+
+    return i_total;
+}
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISection
+ *****************************************************************************
+ * Overwrite bytes of a section and fix its CRC_32 from the changed bytes.
+ *****************************************************************************/
+bool dvbpsi_PatchPSISection(dvbpsi_psi_section_t *p_section, const size_t i_offset,
+                            const uint8_t *p_bytes, const size_t i_size)
+{
+    assert(p_section);
+
+    size_t i_end = p_section->p_payload_end - p_section->p_data;
+    if (i_offset > i_end || i_size > i_end - i_offset)
+        return false;
+    if (!dvbpsi_UnsharePSISection(p_section))
+        return false;
+
+    uint8_t *p_data = p_section->p_data + i_offset;
+    if (dvbpsi_has_CRC32(p_section))
+    {
+        /* CRC_32 of the difference between the old and the new section */
+        uint32_t i_delta = 0;
+        uint8_t a_xor[64];
+        for (size_t i = 0; i < i_size; i += sizeof(a_xor))
+        {
+            size_t i_chunk = i_size - i < sizeof(a_xor) ? i_size - i : sizeof(a_xor);
+            for (size_t j = 0; j < i_chunk; j++)
+                a_xor[j] = p_data[i + j] ^ p_bytes[i + j];
+            i_delta = dvbpsi_crc32(i_delta, a_xor, i_chunk);
+        }
+        i_delta = dvbpsi_crc32_shift(i_delta, i_end - i_offset - i_size);
+
+        uint8_t *p_crc = p_section->p_payload_end;
+        p_section->i_crc = (  ((uint32_t)p_crc[0] << 24) | ((uint32_t)p_crc[1] << 16)
+                            | ((uint32_t)p_crc[2] << 8) | p_crc[3]) ^ i_delta;
+        p_crc[0] = (p_section->i_crc >> 24) & 0xff;
+        p_crc[1] = (p_section->i_crc >> 16) & 0xff;
+        p_crc[2] = (p_section->i_crc >> 8) & 0xff;
+        p_crc[3] = p_section->i_crc & 0xff;
+    }
+
+    memcpy(p_data, p_bytes, i_size);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionVersion
+ *****************************************************************************/
+bool dvbpsi_PatchPSISectionVersion(dvbpsi_psi_section_t *p_section,
+                                   const uint8_t i_version)
+{
+    assert(p_section);
+    if (!p_section->b_syntax_indicator)
+        return false;
+
+    uint8_t i_byte = (p_section->p_data[5] & 0xc1) | ((i_version & 0x1f) << 1);
+    if (!dvbpsi_PatchPSISection(p_section, 5, &i_byte, 1))
+        return false;
+
+    p_section->i_version = i_version & 0x1f;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionExtension
+ *****************************************************************************/
+bool dvbpsi_PatchPSISectionExtension(dvbpsi_psi_section_t *p_section,
+                                     const uint16_t i_extension)
+{
+    assert(p_section);
+    if (!p_section->b_syntax_indicator)
+        return false;
+
+    uint8_t a_bytes[2] = { i_extension >> 8, i_extension & 0xff };
+    if (!dvbpsi_PatchPSISection(p_section, 3, a_bytes, 2))
+        return false;
+
+    p_section->i_extension = i_extension;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionPID
+ *****************************************************************************/
+bool dvbpsi_PatchPSISectionPID(dvbpsi_psi_section_t *p_section,
+                               const size_t i_offset, const uint16_t i_pid)
+{
+    assert(p_section);
+
+    size_t i_end = p_section->p_payload_end - p_section->p_data;
+    if (i_offset + 2 > i_end)
+        return false;
+
+    uint8_t a_bytes[2] = { (p_section->p_data[i_offset] & 0xe0) | ((i_pid >> 8) & 0x1f),
+                           i_pid & 0xff };
+    return dvbpsi_PatchPSISection(p_section, i_offset, a_bytes, 2);
+}
+
+/*****************************************************************************
+ * dvbpsi_psi_section_cache_s
+ *****************************************************************************
+ * Generated sections of a table, each with the entries it carries.
+ *****************************************************************************/
+#define DVBPSI_CACHE_SECTIONS 256   /* section_number is 8 bits */
+
+typedef struct dvbpsi_cached_section_s
+{
+    dvbpsi_psi_section_t *p_section;
+    const void  **pp_entries;       /* entries carried, in table order */
+    int         i_entries;
+    int         i_max_entries;      /* size of pp_entries */
+    bool        b_dirty;            /* one of the entries was edited */
+} dvbpsi_cached_section_t;
+
+typedef struct dvbpsi_cached_entry_s
+{
+    const void *p_entry;            /* NULL for a free slot */
+    int         i_section;          /* index of the section carrying it */
+} dvbpsi_cached_entry_t;
+
+struct dvbpsi_psi_section_cache_s
+{
+    dvbpsi_cached_section_t *p_sections;
+    int         i_sections;
+    bool        b_valid;            /* the sections were generated once */
+    uint8_t     i_version;          /* version_number of the sections */
+
+    /* Entries of the sections hashed on their address, rebuilt by each
+       update. Without it the sections are searched one by one. */
+    dvbpsi_cached_entry_t *p_index;
+    unsigned int i_index_size;      /* a power of 2, 0 without index */
+};
+
+/*****************************************************************************
+ * dvbpsi_FreeCachedSections
+ *****************************************************************************/
+static void dvbpsi_FreeCachedSections(dvbpsi_cached_section_t *p_cached, int i_count)
+{
+    for (int i = 0; i < i_count; i++)
+    {
+        if (p_cached[i].p_section)
+        {
+            p_cached[i].p_section->p_next = NULL;
+            dvbpsi_DeletePSISections(p_cached[i].p_section);
+        }
+        free(p_cached[i].pp_entries);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_NewPSISectionCache
+ *****************************************************************************
+ * Creation of an empty section cache.
+ *****************************************************************************/
+dvbpsi_psi_section_cache_t *dvbpsi_NewPSISectionCache(void)
+{
+    return (dvbpsi_psi_section_cache_t *)calloc(1, sizeof(dvbpsi_psi_section_cache_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_DeletePSISectionCache
+ *****************************************************************************
+ * Destruction of a section cache and of its sections.
+ *****************************************************************************/
+void dvbpsi_DeletePSISectionCache(dvbpsi_psi_section_cache_t *p_cache)
+{
+    if (p_cache == NULL)
+        return;
+
+    dvbpsi_FreeCachedSections(p_cache->p_sections, p_cache->i_sections);
+    free(p_cache->p_sections);
+    free(p_cache->p_index);
+    free(p_cache);
+}
+
+/*****************************************************************************
+ * dvbpsi_CachedEntryHash
+ *****************************************************************************/
+static inline unsigned int dvbpsi_CachedEntryHash(const void *p_entry,
+                                                  const unsigned int i_size)
+{
+    uint64_t i_address = (uint64_t)(uintptr_t)p_entry;
+    uint32_t i_hash = (uint32_t)(i_address ^ (i_address >> 32)) * 0x9e3779b1;
+    return (i_hash ^ (i_hash >> 15)) & (i_size - 1);
+}
+
+/*****************************************************************************
+ * dvbpsi_IndexCachedEntries
+ *****************************************************************************
+ * Hash the entries of all the sections. On error the cache goes without
+ * index, which only makes the lookups slower.
+ *****************************************************************************/
+static void dvbpsi_IndexCachedEntries(dvbpsi_psi_section_cache_t *p_cache)
+{
+    unsigned int i_entries = 0, i_size = 16;
+    for (int i = 0; i < p_cache->i_sections; i++)
+        i_entries += p_cache->p_sections[i].i_entries;
+    while (i_size < 2 * i_entries)
+        i_size *= 2;
+
+    if (i_size != p_cache->i_index_size)
+    {
+        free(p_cache->p_index);
+        p_cache->p_index = (dvbpsi_cached_entry_t *)malloc(i_size * sizeof(dvbpsi_cached_entry_t));
+        p_cache->i_index_size = p_cache->p_index ? i_size : 0;
+        if (p_cache->p_index == NULL)
+            return;
+    }
+    memset(p_cache->p_index, 0, i_size * sizeof(dvbpsi_cached_entry_t));
+
+    for (int i = 0; i < p_cache->i_sections; i++)
+    {
+        const dvbpsi_cached_section_t *p_cached = &p_cache->p_sections[i];
+        for (int j = 0; j < p_cached->i_entries; j++)
+        {
+            unsigned int i_slot = dvbpsi_CachedEntryHash(p_cached->pp_entries[j], i_size);
+            while (p_cache->p_index[i_slot].p_entry != NULL)
+                i_slot = (i_slot + 1) & (i_size - 1);
+            p_cache->p_index[i_slot].p_entry = p_cached->pp_entries[j];
+            p_cache->p_index[i_slot].i_section = i;
+        }
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_CachedEntrySection
+ *****************************************************************************
+ * Index of the section carrying an entry, from i_from on, or -1. The
+ * sections before i_from may be freed during an update.
+ *****************************************************************************/
+static int dvbpsi_CachedEntrySection(const dvbpsi_psi_section_cache_t *p_cache,
+                                     const int i_from, const void *p_entry)
+{
+    if (p_cache->i_index_size == 0)
+    {
+        for (int i = i_from; i < p_cache->i_sections; i++)
+        {
+            const dvbpsi_cached_section_t *p_cached = &p_cache->p_sections[i];
+            for (int j = 0; j < p_cached->i_entries; j++)
+            {
+                if (p_cached->pp_entries[j] == p_entry)
+                    return i;
+            }
+        }
+        return -1;
+    }
+
+    unsigned int i_slot = dvbpsi_CachedEntryHash(p_entry, p_cache->i_index_size);
+    while (p_cache->p_index[i_slot].p_entry != NULL)
+    {
+        /* The index may be older than the sections during an update */
+        if (p_cache->p_index[i_slot].p_entry == p_entry)
+        {
+            const int i_section = p_cache->p_index[i_slot].i_section;
+            return i_section >= i_from && i_section < p_cache->i_sections
+                 ? i_section : -1;
+        }
+        i_slot = (i_slot + 1) & (p_cache->i_index_size - 1);
+    }
+    return -1;
+}
+
+/*****************************************************************************
+ * dvbpsi_PSISectionCacheChanged
+ *****************************************************************************
+ * Mark the section carrying an entry for encoding.
+ *****************************************************************************/
+void dvbpsi_PSISectionCacheChanged(dvbpsi_psi_section_cache_t *p_cache,
+                                   const void *p_entry)
+{
+    assert(p_cache);
+
+    int i_section = dvbpsi_CachedEntrySection(p_cache, 0, p_entry);
+    if (i_section >= 0)
+        p_cache->p_sections[i_section].b_dirty = true;
+}
+
+/*****************************************************************************
+ * dvbpsi_MatchCachedSection
+ *****************************************************************************
+ * Index of the clean cached section, from i_from on, carrying the entries
+ * starting at p_entry, or -1.
+ *****************************************************************************/
+static int dvbpsi_MatchCachedSection(dvbpsi_psi_section_cache_t *p_cache,
+                                     const dvbpsi_psi_section_layout_t *p_layout,
+                                     int i_from, const void *p_entry)
+{
+    /* An entry is carried by one section only */
+    int i = dvbpsi_CachedEntrySection(p_cache, i_from, p_entry);
+    if (i < 0)
+        return -1;
+
+    dvbpsi_cached_section_t *p_cached = &p_cache->p_sections[i];
+    if (p_cached->pp_entries[0] != p_entry || p_cached->b_dirty)
+        return -1;
+    for (int j = 1; j < p_cached->i_entries; j++)
+    {
+        p_entry = p_layout->pf_next(p_entry);
+        if (p_entry != p_cached->pp_entries[j])
+            return -1;
     }
+    return i;
+}
+
+/*****************************************************************************
+ * dvbpsi_NewCachedSection
+ *****************************************************************************
+ * Empty section of a cache, up to its header.
+ *****************************************************************************/
+static bool dvbpsi_NewCachedSection(dvbpsi_cached_section_t *p_cached,
+                                    const dvbpsi_psi_section_layout_t *p_layout)
+{
+    memset(p_cached, 0, sizeof(dvbpsi_cached_section_t));
+    p_cached->p_section = dvbpsi_NewPSISection(p_layout->i_max_end + 4);
+    if (p_cached->p_section == NULL)
+        return false;
+
+    dvbpsi_psi_section_t *p_section = p_cached->p_section;
+    p_section->b_syntax_indicator = true;
+    p_section->b_private_indicator = p_layout->b_private_indicator;
+    p_section->i_length = p_layout->i_header - 3 + 4;  /* header + CRC_32 */
+    p_section->p_payload_start = p_section->p_data + 8;
+    p_section->p_payload_end = p_section->p_data + p_layout->i_header;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_AddCachedEntry
+ *****************************************************************************/
+static bool dvbpsi_AddCachedEntry(dvbpsi_cached_section_t *p_cached,
+                                  const void *p_entry)
+{
+    if (p_cached->i_entries == p_cached->i_max_entries)
+    {
+        int i_max = p_cached->i_max_entries ? 2 * p_cached->i_max_entries : 16;
+        const void **pp_entries = (const void **)realloc(p_cached->pp_entries,
+                                                         i_max * sizeof(const void *));
+        if (pp_entries == NULL)
+            return false;
+        p_cached->pp_entries = pp_entries;
+        p_cached->i_max_entries = i_max;
+    }
+    p_cached->pp_entries[p_cached->i_entries++] = p_entry;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_CachedSectionHeader
+ *****************************************************************************
+ * Header bytes of a section as built from its members and the table.
+ *****************************************************************************/
+static void dvbpsi_CachedSectionHeader(const dvbpsi_psi_section_layout_t *p_layout,
+                                       const void *p_table,
+                                       const dvbpsi_psi_section_t *p_section,
+                                       uint8_t *p_header)
+{
+    dvbpsi_psi_section_t header = *p_section;
+
+    memcpy(p_header, p_section->p_data, p_layout->i_header);
+    header.p_data = p_header;
+    dvbpsi_WritePSISectionHeader(&header);
+    p_layout->pf_header(p_table, &header);
+}
+
+/*****************************************************************************
+ * dvbpsi_UpdatePSISectionCache
+ *****************************************************************************
+ * Lay the entries of a table out into sections, keeping the cached sections
+ * whose entries did not change.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_UpdatePSISectionCache(dvbpsi_t *p_dvbpsi,
+                            dvbpsi_psi_section_cache_t *p_cache,
+                            const dvbpsi_psi_section_layout_t *p_layout,
+                            const void *p_table, const void *p_first_entry,
+                            const uint8_t i_table_id, const uint16_t i_extension,
+                            const bool b_current_next, uint8_t *pi_version)
+{
+    dvbpsi_cached_section_t a_new[DVBPSI_CACHE_SECTIONS];
+    bool a_build[DVBPSI_CACHE_SECTIONS];
+    int i_new = 0, i_old = 0;
+    bool b_changed = !p_cache->b_valid;
+    bool b_relayout = false;
+    const void *p_entry = p_first_entry;
+
+    assert(p_cache);
+    assert(p_layout);
+    assert(p_layout->i_header >= 8 && p_layout->i_header <= 32);
+
+    while (p_entry != NULL)
+    {
+        /* Keep a cached section starting with this entry as it is */
+        int i_match = dvbpsi_MatchCachedSection(p_cache, p_layout, i_old, p_entry);
+        if (i_match >= 0 && i_new < DVBPSI_CACHE_SECTIONS)
+        {
+            dvbpsi_FreeCachedSections(&p_cache->p_sections[i_old], i_match - i_old);
+            b_changed |= i_match > i_old;
+            i_old = i_match;
+
+            a_build[i_new] = false;
+            a_new[i_new++] = p_cache->p_sections[i_old++];
+            for (int i = 0; i < a_new[i_new - 1].i_entries; i++)
+                p_entry = p_layout->pf_next(p_entry);
+            continue;
+        }
+
+        /* Encode the entry at the end of the last section or in a new one */
+        size_t i_length = p_layout->pf_encode(p_dvbpsi, p_entry, NULL, 0);
+        dvbpsi_cached_section_t *p_last = i_new > 0 ? &a_new[i_new - 1] : NULL;
+        if (p_last == NULL
+         || (p_last->i_entries > 0
+          && p_last->p_section->p_payload_end - p_last->p_section->p_data
+             + i_length > (size_t)p_layout->i_max_end))
+        {
+            if (i_new == DVBPSI_CACHE_SECTIONS)
+            {
+                if (b_relayout)
+                {
+                    dvbpsi_error(p_dvbpsi, "PSI section cache",
+                                 "too many sections, unable to carry all the entries");
+                    break;
+                }
+                /* Start again from scratch, packing the entries tightly */
+                dvbpsi_FreeCachedSections(a_new, i_new);
+                dvbpsi_FreeCachedSections(&p_cache->p_sections[i_old],
+                                          p_cache->i_sections - i_old);
+                p_cache->i_sections = 0;
+                i_new = i_old = 0;
+                b_relayout = b_changed = true;
+                p_entry = p_first_entry;
+                continue;
+            }
+            if (!dvbpsi_NewCachedSection(&a_new[i_new], p_layout))
+                goto error;
+            p_last = &a_new[i_new++];
+        }
+
+        dvbpsi_psi_section_t *p_section = p_last->p_section;
+        size_t i_room = p_layout->i_max_end - (p_section->p_payload_end - p_section->p_data);
+        if (!dvbpsi_AddCachedEntry(p_last, p_entry))
+            goto error;
+        i_length = p_layout->pf_encode(p_dvbpsi, p_entry, p_section->p_payload_end, i_room);
+        p_section->p_payload_end += i_length;
+        p_section->i_length += i_length;
+
+        a_build[i_new - 1] = true;
+        b_changed = true;
+        p_entry = p_layout->pf_next(p_entry);
+    }
+
+    /* A table without entries still has a section */
+    if (i_new == 0)
+    {
+        if (i_old < p_cache->i_sections && p_cache->p_sections[i_old].i_entries == 0)
+        {
+            a_build[0] = false;
+            a_new[0] = p_cache->p_sections[i_old++];
+        }
+        else
+        {
+            if (!dvbpsi_NewCachedSection(&a_new[0], p_layout))
+                goto error;
+            a_build[0] = b_changed = true;
+        }
+        i_new = 1;
+    }
+
+    dvbpsi_FreeCachedSections(&p_cache->p_sections[i_old], p_cache->i_sections - i_old);
+    b_changed |= i_old < p_cache->i_sections;
+    i_old = p_cache->i_sections;
+
+    /* Numbering, noting the table wide changes in the kept sections */
+    for (int i = 0; i < i_new; i++)
+    {
+        dvbpsi_psi_section_t *p_section = a_new[i].p_section;
+        uint8_t a_header[32];
+
+        p_section->i_table_id = i_table_id;
+        p_section->i_extension = i_extension;
+        p_section->i_version = p_cache->i_version;
+        p_section->b_current_next = b_current_next;
+        p_section->i_number = i;
+        p_section->i_last_number = i_new - 1;
+        if (a_build[i])
+            continue;
+
+        dvbpsi_CachedSectionHeader(p_layout, p_table, p_section, a_header);
+        if (memcmp(a_header, p_section->p_data, p_layout->i_header))
+            b_changed = true;
+    }
+
+    uint8_t i_version = *pi_version & 0x1f;
+    if (p_cache->b_valid && b_changed && i_version == p_cache->i_version)
+        i_version = (i_version + 1) & 0x1f;
+
+    /* Build the new sections, patch the header of the kept ones */
+    for (int i = 0; i < i_new; i++)
+    {
+        dvbpsi_psi_section_t *p_section = a_new[i].p_section;
+        uint8_t a_header[32];
+
+        p_section->p_next = i + 1 < i_new ? a_new[i + 1].p_section : NULL;
+        p_section->i_version = i_version;
+        if (a_build[i])
+        {
+            p_layout->pf_header(p_table, p_section);
+            dvbpsi_BuildPSISection(p_dvbpsi, p_section);
+        }
+        else
+        {
+            dvbpsi_CachedSectionHeader(p_layout, p_table, p_section, a_header);
+            if (memcmp(a_header, p_section->p_data, p_layout->i_header))
+                dvbpsi_PatchPSISection(p_section, 0, a_header, p_layout->i_header);
+        }
+        a_new[i].b_dirty = false;
+    }
+
+    dvbpsi_cached_section_t *p_sections = (dvbpsi_cached_section_t *)
+            realloc(p_cache->p_sections, i_new * sizeof(dvbpsi_cached_section_t));
+    if (p_sections == NULL)
+        goto error;
+    memcpy(p_sections, a_new, i_new * sizeof(dvbpsi_cached_section_t));
+    p_cache->p_sections = p_sections;
+    p_cache->i_sections = i_new;
+    p_cache->b_valid = true;
+    p_cache->i_version = i_version;
+    dvbpsi_IndexCachedEntries(p_cache);
+
+    *pi_version = i_version;
+    return p_sections[0].p_section;
+
+error:
+    dvbpsi_error(p_dvbpsi, "PSI section cache", "out of memory");
+    dvbpsi_FreeCachedSections(a_new, i_new);
+    dvbpsi_FreeCachedSections(&p_cache->p_sections[i_old], p_cache->i_sections - i_old);
+    p_cache->i_sections = 0;
+    p_cache->b_valid = false;
+    return NULL;
 }
@@ -64,6 +64,15 @@ extern "C" {
  * dvbpsi_psi_section_s::b_current_next, dvbpsi_psi_section_s::i_number,
  * dvbpsi_psi_section_s::i_last_number, and dvbpsi_psi_section_s::i_crc are
  * undefined.
+ *
+ * When dvbpsi_psi_section_s::b_view is true, dvbpsi_psi_section_s::p_data
+ * points into memory that is not owned by the section (eg: the TS packet
+ * given to dvbpsi_packet_push() in zero-copy mode). Such a section is only
+ * valid during the call to the decoder's gather callback, use
+ * dvbpsi_UnsharePSISection() to keep it.
+ *
+ * When dvbpsi_psi_section_s::p_pool is set the section has been taken from
+ * a section pool and dvbpsi_DeletePSISections() gives it back to that pool.
  */
 struct dvbpsi_psi_section_s
 {
@@ -91,6 +100,13 @@ struct dvbpsi_psi_section_s
   /* used if b_syntax_indicator is true */
   uint32_t      i_crc;                  /*!< CRC_32 */
 
+  /* memory handling */
+  bool          b_view;                 /*!< p_data is not owned by this
+                                             section */
+  int           i_max_size;             /*!< size of the p_data area */
+  dvbpsi_psi_section_pool_t *           p_pool;         /*!< pool owning
+                                                             the section */
+
   /* list handling */
   struct dvbpsi_psi_section_s *         p_next;         /*!< next element of
                                                              the list */
@@ -118,6 +134,72 @@ dvbpsi_psi_section_t * dvbpsi_NewPSISection(int i_max_size);
  */
 void dvbpsi_DeletePSISections(dvbpsi_psi_section_t * p_section);
 
+/*****************************************************************************
+ * dvbpsi_NewPSISectionPool
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_pool_t *dvbpsi_NewPSISectionPool(void)
+ * \brief Creation of a new, empty, PSI section pool.
+ * \return a pointer to the new pool or NULL on error.
+ *
+ * A pool is not thread-safe. Taking a section from it, deleting one of its
+ * sections and deleting the pool must all happen on one thread, or be
+ * serialized by the caller. This includes the sections a decoder gathers
+ * with its pool and hands over to the tables it signals.
+ */
+dvbpsi_psi_section_pool_t *dvbpsi_NewPSISectionPool(void);
+
+/*****************************************************************************
+ * dvbpsi_DeletePSISectionPool
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DeletePSISectionPool(dvbpsi_psi_section_pool_t *p_pool)
+ * \brief Destruction of a PSI section pool.
+ * \param p_pool pointer to the pool, can be NULL
+ * \return nothing.
+ *
+ * The cached sections are freed immediately. Sections of this pool that are
+ * still in use stay valid, the pool itself is freed when the last of them
+ * is deleted.
+ */
+void dvbpsi_DeletePSISectionPool(dvbpsi_psi_section_pool_t *p_pool);
+
+/*****************************************************************************
+ * dvbpsi_NewPooledPSISection
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_NewPooledPSISection(dvbpsi_psi_section_pool_t *p_pool,
+ *                                                     int i_max_size)
+ * \brief Creation of a new dvbpsi_psi_section_t structure taken from a pool.
+ * \param p_pool pointer to the pool, can be NULL
+ * \param i_max_size max size in bytes of the section
+ * \return a pointer to the new PSI section structure.
+ *
+ * The section is taken from the free list of the smallest size class that
+ * holds 'i_max_size' bytes. Unlike dvbpsi_NewPSISection() the data area is
+ * not cleared: a recycled section holds the bytes of its previous use. Without
+ * a pool, or when 'i_max_size' is bigger than the largest size class, this is
+ * the same as dvbpsi_NewPSISection(). The section is released with
+ * dvbpsi_DeletePSISections() as usual.
+ */
+dvbpsi_psi_section_t *dvbpsi_NewPooledPSISection(dvbpsi_psi_section_pool_t *p_pool,
+                                                 int i_max_size);
+
+/*****************************************************************************
+ * dvbpsi_UnsharePSISection
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_UnsharePSISection(dvbpsi_psi_section_t *p_section)
+ * \brief Make sure a PSI section owns its data.
+ * \param p_section pointer to the PSI section structure
+ * \return true on success, false if memory could not be allocated.
+ *
+ * When dvbpsi_psi_section_s::b_view is set the section data is copied into
+ * newly allocated memory of the exact section size and the payload pointers
+ * are updated accordingly. Otherwise nothing is done.
+ */
+bool dvbpsi_UnsharePSISection(dvbpsi_psi_section_t *p_section);
+
 /*****************************************************************************
  * dvbpsi_CheckPSISection
  *****************************************************************************/
@@ -161,6 +243,26 @@ bool dvbpsi_ValidPSISection(dvbpsi_psi_section_t* p_section);
  */
 void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section);
 
+/*****************************************************************************
+ * dvbpsi_WritePSISections
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_WritePSISections(dvbpsi_psi_section_t *p_sections,
+                                      uint8_t *p_buffer, const size_t i_size)
+ * \brief Copy built sections back to back into a caller provided buffer.
+ * \param p_sections list of built sections
+ * \param p_buffer buffer receiving the sections, NULL to get the size needed
+ * \param i_size size of the buffer in bytes
+ * \return the number of bytes written, or needed if p_buffer is NULL, 0 if
+ * the buffer is too small.
+ *
+ * Together with dvbpsi_t::p_pool, which lets the generators reuse the
+ * sections given back by dvbpsi_DeletePSISections(), a table can be
+ * regenerated into the same buffer without any allocation.
+ */
+size_t dvbpsi_WritePSISections(dvbpsi_psi_section_t *p_sections,
+                               uint8_t *p_buffer, const size_t i_size);
+
 /*****************************************************************************
  * dvbpsi_CalculateCRC32
  *****************************************************************************/
@@ -174,6 +276,279 @@ void dvbpsi_BuildPSISection(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
  */
 void dvbpsi_CalculateCRC32(dvbpsi_psi_section_t *p_section);
 
+/*****************************************************************************
+ * dvbpsi_PatchPSISection
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_PatchPSISection(dvbpsi_psi_section_t *p_section,
+ *                                 const size_t i_offset,
+ *                                 const uint8_t *p_bytes, const size_t i_size)
+ * \brief Overwrite bytes of a section, updating its CRC_32.
+ * \param p_section pointer to a valid PSI section
+ * \param i_offset offset of the first byte to overwrite from
+ * dvbpsi_psi_section_s::p_data
+ * \param p_bytes new bytes
+ * \param i_size number of bytes to overwrite
+ * \return false if the bytes are not before the CRC_32 field, or if the
+ * section is a view that could not be copied.
+ *
+ * The CRC_32 field and dvbpsi_psi_section_s::i_crc are updated from the
+ * changed bytes only, so the cost does not depend on the section length.
+ * The decoded members of the section, like dvbpsi_psi_section_s::i_version,
+ * are left alone. A section sharing its data (dvbpsi_psi_section_s::b_view)
+ * gets its own copy first.
+ */
+bool dvbpsi_PatchPSISection(dvbpsi_psi_section_t *p_section, const size_t i_offset,
+                            const uint8_t *p_bytes, const size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionVersion
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_PatchPSISectionVersion(dvbpsi_psi_section_t *p_section,
+ *                                        const uint8_t i_version)
+ * \brief Change the version_number of a section in place.
+ * \param p_section pointer to a valid PSI section with the syntax indicator
+ * \param i_version new version_number
+ * \return false on error, see dvbpsi_PatchPSISection().
+ */
+bool dvbpsi_PatchPSISectionVersion(dvbpsi_psi_section_t *p_section,
+                                   const uint8_t i_version);
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionExtension
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_PatchPSISectionExtension(dvbpsi_psi_section_t *p_section,
+ *                                          const uint16_t i_extension)
+ * \brief Change the table_id_extension of a section in place.
+ * \param p_section pointer to a valid PSI section with the syntax indicator
+ * \param i_extension new table_id_extension
+ * \return false on error, see dvbpsi_PatchPSISection().
+ */
+bool dvbpsi_PatchPSISectionExtension(dvbpsi_psi_section_t *p_section,
+                                     const uint16_t i_extension);
+
+/*****************************************************************************
+ * dvbpsi_PatchPSISectionPID
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_PatchPSISectionPID(dvbpsi_psi_section_t *p_section,
+ *                                    const size_t i_offset, const uint16_t i_pid)
+ * \brief Change a 13 bit PID field of a section in place.
+ * \param p_section pointer to a valid PSI section
+ * \param i_offset offset of the 2 bytes holding the PID from
+ * dvbpsi_psi_section_s::p_data
+ * \param i_pid new PID
+ * \return false on error, see dvbpsi_PatchPSISection().
+ *
+ * The 3 bits before the PID are kept. The PCR_PID of a PMT is at offset 8,
+ * the elementary_PID of a PMT entry 1 byte after the entry returned by
+ * dvbpsi_descriptor_cursor_next_entry(), and the PID of the n-th program of
+ * a PAT section at offset 10 + 4 * n.
+ */
+bool dvbpsi_PatchPSISectionPID(dvbpsi_psi_section_t *p_section,
+                               const size_t i_offset, const uint16_t i_pid);
+
+/*****************************************************************************
+ * dvbpsi_psi_section_layout_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_psi_section_layout_s
+ * \brief Layout of a table made of a header and a loop of entries.
+ *
+ * This structure tells dvbpsi_UpdatePSISectionCache() how to encode a table
+ * whose sections carry a fixed header followed by entries, such as the
+ * events of an EIT or the services of an SDT.
+ */
+/*!
+ * \typedef struct dvbpsi_psi_section_layout_s dvbpsi_psi_section_layout_t
+ * \brief dvbpsi_psi_section_layout_t type definition.
+ */
+typedef struct dvbpsi_psi_section_layout_s
+{
+    int         i_header;               /*!< size of the section header,
+                                             before the first entry */
+    int         i_max_end;              /*!< offset of the CRC_32 in a full
+                                             section */
+    bool        b_private_indicator;    /*!< private_indicator */
+
+    /*! next entry of the table, or NULL */
+    const void *(*pf_next)(const void *p_entry);
+    /*! encode an entry in at most i_room bytes of p_buffer and return its
+        size, or only return the size it needs when p_buffer is NULL */
+    size_t      (*pf_encode)(dvbpsi_t *p_dvbpsi, const void *p_entry,
+                             uint8_t *p_buffer, size_t i_room);
+    /*! write the header bytes following last_section_number */
+    void        (*pf_header)(const void *p_table,
+                             dvbpsi_psi_section_t *p_section);
+} dvbpsi_psi_section_layout_t;
+
+/*****************************************************************************
+ * dvbpsi_NewPSISectionCache
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_cache_t *dvbpsi_NewPSISectionCache(void)
+ * \brief Creation of a new, empty, section cache.
+ * \return a pointer to the new cache or NULL on error.
+ */
+dvbpsi_psi_section_cache_t *dvbpsi_NewPSISectionCache(void);
+
+/*****************************************************************************
+ * dvbpsi_DeletePSISectionCache
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_DeletePSISectionCache(dvbpsi_psi_section_cache_t *p_cache)
+ * \brief Destruction of a section cache and of the sections it holds.
+ * \param p_cache pointer to the cache, can be NULL
+ * \return nothing.
+ */
+void dvbpsi_DeletePSISectionCache(dvbpsi_psi_section_cache_t *p_cache);
+
+/*****************************************************************************
+ * dvbpsi_PSISectionCacheChanged
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_PSISectionCacheChanged(dvbpsi_psi_section_cache_t *p_cache,
+ *                                        const void *p_entry)
+ * \brief Tell a section cache that an entry was edited.
+ * \param p_cache pointer to the cache
+ * \param p_entry the entry (event, service...) whose fields or descriptors
+ * were modified in place
+ * \return nothing.
+ *
+ * The section carrying the entry is encoded again by the next update.
+ * Entries added to or removed from the table need not be reported, unless
+ * the memory of a removed entry is reused for a new one.
+ */
+void dvbpsi_PSISectionCacheChanged(dvbpsi_psi_section_cache_t *p_cache,
+                                   const void *p_entry);
+
+/*****************************************************************************
+ * dvbpsi_UpdatePSISectionCache
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_UpdatePSISectionCache(dvbpsi_t *p_dvbpsi,
+ *                            dvbpsi_psi_section_cache_t *p_cache,
+ *                            const dvbpsi_psi_section_layout_t *p_layout,
+ *                            const void *p_table, const void *p_first_entry,
+ *                            const uint8_t i_table_id, const uint16_t i_extension,
+ *                            const bool b_current_next, uint8_t *pi_version)
+ * \brief Bring the sections of a cache up to date with a table.
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache pointer to the cache of the table
+ * \param p_layout layout of the table
+ * \param p_table table given to dvbpsi_psi_section_layout_s::pf_header
+ * \param p_first_entry first entry of the table, or NULL
+ * \param i_table_id table_id of the sections
+ * \param i_extension table_id_extension of the sections
+ * \param b_current_next current_next_indicator of the sections
+ * \param pi_version version_number of the table, updated on return
+ * \return the sections of the table, owned by the cache, or NULL on error.
+ *
+ * A cached section whose entries are still consecutive in the table and
+ * were not reported as changed keeps its encoding. The other entries are
+ * encoded again, appended to the previous section when they fit. When
+ * anything changed and the caller kept the version_number the cache used
+ * last time, the version_number is incremented. Only the sections whose
+ * entries changed go through dvbpsi_BuildPSISection() again, the header
+ * of the others is updated with dvbpsi_PatchPSISection().
+ *
+ * The sections stay valid until the next update or the destruction of the
+ * cache and must not be deleted by the caller.
+ */
+dvbpsi_psi_section_t *dvbpsi_UpdatePSISectionCache(dvbpsi_t *p_dvbpsi,
+                            dvbpsi_psi_section_cache_t *p_cache,
+                            const dvbpsi_psi_section_layout_t *p_layout,
+                            const void *p_table, const void *p_first_entry,
+                            const uint8_t i_table_id, const uint16_t i_extension,
+                            const bool b_current_next, uint8_t *pi_version);
+
+/*****************************************************************************
+ * dvbpsi_crc32_impl_t
+ *****************************************************************************/
+/*!
+ * \enum dvbpsi_crc32_impl_e
+ * \brief Implementations of the CRC_32 computation.
+ */
+enum dvbpsi_crc32_impl_e
+{
+    DVBPSI_CRC32_AUTO = 0,  /*!< Fastest implementation for this CPU */
+    DVBPSI_CRC32_TABLE,     /*!< Byte per byte table lookup */
+    DVBPSI_CRC32_SLICE8,    /*!< Slicing-by-8 table lookup */
+    DVBPSI_CRC32_SLICE16,   /*!< Slicing-by-16 table lookup */
+    DVBPSI_CRC32_CLMUL,     /*!< Carry-less multiplication folding (x86
+                                 PCLMULQDQ or ARMv8 PMULL) */
+};
+/*!
+ * \typedef enum dvbpsi_crc32_impl_e dvbpsi_crc32_impl_t
+ * \brief dvbpsi_crc32_impl_t type definition.
+ */
+typedef enum dvbpsi_crc32_impl_e dvbpsi_crc32_impl_t;
+
+/*****************************************************************************
+ * dvbpsi_crc32
+ *****************************************************************************/
+/*!
+ * \fn uint32_t dvbpsi_crc32(uint32_t i_crc, const uint8_t *p_data, size_t i_size)
+ * \brief Update a CRC_32 (ISO/IEC 13818-1 annex A) with a buffer.
+ * \param i_crc CRC_32 so far, 0xffffffff for the first buffer
+ * \param p_data pointer to the data
+ * \param i_size number of bytes in p_data
+ * \return the updated CRC_32.
+ *
+ * The fastest implementation available on this CPU is picked on the first
+ * call. Computing the CRC_32 of a section including its CRC_32 field gives 0
+ * when the section is valid.
+ */
+uint32_t dvbpsi_crc32(uint32_t i_crc, const uint8_t *p_data, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_crc32_shift
+ *****************************************************************************/
+/*!
+ * \fn uint32_t dvbpsi_crc32_shift(uint32_t i_crc, size_t i_size)
+ * \brief Update a CRC_32 with zero bytes.
+ * \param i_crc CRC_32 so far
+ * \param i_size number of zero bytes
+ * \return the same as dvbpsi_crc32() over i_size zero bytes, computed in
+ * O(log(i_size)).
+ *
+ * As the CRC_32 is linear, changing bytes of a buffer changes its CRC_32 by
+ * the CRC_32, started at 0, of the xor of the old and new bytes followed by
+ * the zero bytes up to the end of the buffer.
+ */
+uint32_t dvbpsi_crc32_shift(uint32_t i_crc, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_crc32_impl
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_crc32_impl(const dvbpsi_crc32_impl_t i_impl, uint32_t *p_crc,
+ *                            const uint8_t *p_data, size_t i_size)
+ * \brief Update a CRC_32 with a given implementation.
+ * \param i_impl implementation to use
+ * \param p_crc pointer to the CRC_32 so far, updated on return
+ * \param p_data pointer to the data
+ * \param i_size number of bytes in p_data
+ * \return false if the implementation is not available on this CPU.
+ *
+ * All implementations give the same result, this is meant for testing and
+ * benchmarking them.
+ */
+bool dvbpsi_crc32_impl(const dvbpsi_crc32_impl_t i_impl, uint32_t *p_crc,
+                       const uint8_t *p_data, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_crc32_get_impl
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_crc32_impl_t dvbpsi_crc32_get_impl(void)
+ * \brief Implementation used by dvbpsi_crc32() on this CPU.
+ * \return the implementation, never DVBPSI_CRC32_AUTO.
+ */
+dvbpsi_crc32_impl_t dvbpsi_crc32_get_impl(void);
+
 /*****************************************************************************
  * dvbpsi_has_CRC32
  *****************************************************************************/
@@ -0,0 +1,351 @@
+/*****************************************************************************
+ * router.c: PID router
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "router.h"
+
+#define DVBPSI_ROUTER_PIDS 8192
+
+/*****************************************************************************
+ * dvbpsi_router_target_t
+ *****************************************************************************
+ * Either a dvbpsi handle or a packet callback. A target removed during a
+ * push is left empty until the push returns.
+ *****************************************************************************/
+typedef struct dvbpsi_router_target_s
+{
+    dvbpsi_t                   *p_dvbpsi;
+    dvbpsi_router_packet_cb_t   pf_callback;
+    void                       *p_cb_data;
+} dvbpsi_router_target_t;
+
+/*****************************************************************************
+ * dvbpsi_router_pid_t
+ *****************************************************************************/
+typedef struct dvbpsi_router_pid_s
+{
+    dvbpsi_router_target_t *p_targets;
+    uint16_t                i_targets;  /* including the empty ones */
+    uint16_t                i_size;     /* allocated targets */
+    bool                    b_empty;    /* some targets are empty */
+} dvbpsi_router_pid_t;
+
+/*****************************************************************************
+ * dvbpsi_router_s
+ *****************************************************************************/
+struct dvbpsi_router_s
+{
+    unsigned int        i_pushing;  /* nesting of dvbpsi_router_push() */
+    bool                b_empty;    /* some PIDs have empty targets */
+
+    dvbpsi_router_pid_t p_pids[DVBPSI_ROUTER_PIDS];
+};
+
+/*****************************************************************************
+ * dvbpsi_router_new
+ *****************************************************************************
+ * Creation of a router without any target.
+ *****************************************************************************/
+dvbpsi_router_t *dvbpsi_router_new(void)
+{
+    return (dvbpsi_router_t *)calloc(1, sizeof(dvbpsi_router_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_router_delete
+ *****************************************************************************
+ * Destruction of a router, the handles are not deleted.
+ *****************************************************************************/
+void dvbpsi_router_delete(dvbpsi_router_t *p_router)
+{
+    if (p_router == NULL)
+        return;
+
+    for (unsigned int i = 0; i < DVBPSI_ROUTER_PIDS; i++)
+        free(p_router->p_pids[i].p_targets);
+    free(p_router);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_compact
+ *****************************************************************************
+ * Drop the empty targets of a PID, keeping the order of the others.
+ *****************************************************************************/
+static void dvbpsi_router_compact(dvbpsi_router_pid_t *p_pid)
+{
+    uint16_t i_targets = 0;
+
+    for (uint16_t i = 0; i < p_pid->i_targets; i++)
+    {
+        dvbpsi_router_target_t *p_target = &p_pid->p_targets[i];
+        if (p_target->p_dvbpsi == NULL && p_target->pf_callback == NULL)
+            continue;
+        p_pid->p_targets[i_targets++] = *p_target;
+    }
+    p_pid->i_targets = i_targets;
+    p_pid->b_empty = false;
+
+    if (i_targets == 0)
+    {
+        free(p_pid->p_targets);
+        p_pid->p_targets = NULL;
+        p_pid->i_size = 0;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_router_find
+ *****************************************************************************
+ * Index of a target of a PID, or -1 if the PID does not have it.
+ *****************************************************************************/
+static int dvbpsi_router_find(const dvbpsi_router_pid_t *p_pid,
+                              const dvbpsi_router_target_t *p_target)
+{
+    for (uint16_t i = 0; i < p_pid->i_targets; i++)
+    {
+        const dvbpsi_router_target_t *p_other = &p_pid->p_targets[i];
+        if (p_other->p_dvbpsi == p_target->p_dvbpsi
+         && p_other->pf_callback == p_target->pf_callback
+         && p_other->p_cb_data == p_target->p_cb_data)
+            return i;
+    }
+    return -1;
+}
+
+/*****************************************************************************
+ * dvbpsi_router_insert
+ *****************************************************************************
+ * Append a target to a PID. The targets array may move, a push in progress
+ * indexes it again for every target.
+ *****************************************************************************/
+static bool dvbpsi_router_insert(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                                 const dvbpsi_router_target_t *p_target)
+{
+    assert(p_router);
+    if (i_pid >= DVBPSI_ROUTER_PIDS)
+        return false;
+
+    dvbpsi_router_pid_t *p_pid = &p_router->p_pids[i_pid];
+    if (dvbpsi_router_find(p_pid, p_target) >= 0)
+        return false;
+
+    if (p_pid->i_targets == p_pid->i_size)
+    {
+        if (p_pid->i_size == UINT16_MAX)
+            return false;
+        uint16_t i_size = p_pid->i_size ? p_pid->i_size * 2 : 2;
+        if (i_size < p_pid->i_size)
+            i_size = UINT16_MAX;
+        dvbpsi_router_target_t *p_targets;
+        p_targets = realloc(p_pid->p_targets,
+                            i_size * sizeof(dvbpsi_router_target_t));
+        if (p_targets == NULL)
+            return false;
+        p_pid->p_targets = p_targets;
+        p_pid->i_size = i_size;
+    }
+
+    p_pid->p_targets[p_pid->i_targets++] = *p_target;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_router_erase
+ *****************************************************************************
+ * Remove a target from a PID. During a push the target is only emptied, so
+ * that the indexes of the push in progress stay valid.
+ *****************************************************************************/
+static void dvbpsi_router_erase(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                                const dvbpsi_router_target_t *p_target)
+{
+    assert(p_router);
+    if (i_pid >= DVBPSI_ROUTER_PIDS)
+        return;
+
+    dvbpsi_router_pid_t *p_pid = &p_router->p_pids[i_pid];
+    int i_target = dvbpsi_router_find(p_pid, p_target);
+    if (i_target < 0)
+        return;
+
+    memset(&p_pid->p_targets[i_target], 0, sizeof(dvbpsi_router_target_t));
+    if (p_router->i_pushing > 0)
+    {
+        p_pid->b_empty = true;
+        p_router->b_empty = true;
+    }
+    else
+        dvbpsi_router_compact(p_pid);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_add
+ *****************************************************************************
+ * Route the packets of a PID to a dvbpsi handle.
+ *****************************************************************************/
+bool dvbpsi_router_add(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                       dvbpsi_t *p_dvbpsi)
+{
+    dvbpsi_router_target_t target = { p_dvbpsi, NULL, NULL };
+    assert(p_dvbpsi);
+    return dvbpsi_router_insert(p_router, i_pid, &target);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_remove
+ *****************************************************************************
+ * Stop routing the packets of a PID to a dvbpsi handle.
+ *****************************************************************************/
+void dvbpsi_router_remove(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                          dvbpsi_t *p_dvbpsi)
+{
+    dvbpsi_router_target_t target = { p_dvbpsi, NULL, NULL };
+    dvbpsi_router_erase(p_router, i_pid, &target);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_add_callback
+ *****************************************************************************
+ * Route the packets of a PID to a callback.
+ *****************************************************************************/
+bool dvbpsi_router_add_callback(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                                dvbpsi_router_packet_cb_t pf_callback,
+                                void *p_cb_data)
+{
+    dvbpsi_router_target_t target = { NULL, pf_callback, p_cb_data };
+    assert(pf_callback);
+    return dvbpsi_router_insert(p_router, i_pid, &target);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_remove_callback
+ *****************************************************************************
+ * Stop routing the packets of a PID to a callback.
+ *****************************************************************************/
+void dvbpsi_router_remove_callback(dvbpsi_router_t *p_router,
+                                   const uint16_t i_pid,
+                                   dvbpsi_router_packet_cb_t pf_callback,
+                                   void *p_cb_data)
+{
+    dvbpsi_router_target_t target = { NULL, pf_callback, p_cb_data };
+    dvbpsi_router_erase(p_router, i_pid, &target);
+}
+
+/*****************************************************************************
+ * dvbpsi_router_stats_add
+ *****************************************************************************
+ * Add the section counters of a handle to the counters of the block.
+ *****************************************************************************/
+static void dvbpsi_router_stats_add(dvbpsi_push_stats_t *p_stats,
+                                    const dvbpsi_push_stats_t *p_handle)
+{
+    p_stats->i_ts_errors += p_handle->i_ts_errors;
+    p_stats->i_discontinuities += p_handle->i_discontinuities;
+    p_stats->i_sections += p_handle->i_sections;
+    p_stats->i_dropped += p_handle->i_dropped;
+    p_stats->i_crc_errors += p_handle->i_crc_errors;
+    p_stats->i_repeats += p_handle->i_repeats;
+    p_stats->i_changed += p_handle->i_changed;
+    p_stats->i_ignored += p_handle->i_ignored;
+    p_stats->i_skipped += p_handle->i_skipped;
+}
+
+/*****************************************************************************
+ * dvbpsi_router_push
+ *****************************************************************************
+ * Injection of a block of TS packets of any PID. The targets of a packet
+ * are the ones its PID has when the packet starts being dispatched.
+ *****************************************************************************/
+bool dvbpsi_router_push(dvbpsi_router_t *p_router, uint8_t *p_data,
+                        size_t i_packets, size_t i_stride,
+                        dvbpsi_push_stats_t *p_stats)
+{
+    dvbpsi_push_stats_t stats, handle_stats;
+    assert(p_router);
+
+    if (p_stats == NULL)
+        p_stats = &stats;
+    memset(p_stats, 0, sizeof(dvbpsi_push_stats_t));
+
+    if (i_stride == 0)
+        i_stride = 188;
+    assert(i_stride >= 188);
+
+    p_router->i_pushing++;
+
+    uint8_t *p_end = p_data + i_packets * i_stride;
+    for (; p_data < p_end; p_data += i_stride)
+    {
+        if (p_data[0] != 0x47)
+        {
+            p_stats->i_ts_errors++;
+            continue;
+        }
+
+        uint16_t i_pid = ((uint16_t)(p_data[1] & 0x1f) << 8) | p_data[2];
+        dvbpsi_router_pid_t *p_pid = &p_router->p_pids[i_pid];
+        uint16_t i_targets = p_pid->i_targets;
+
+        for (uint16_t i = 0; i < i_targets; i++)
+        {
+            /* Index again, a callback may have moved the targets */
+            dvbpsi_router_target_t *p_target = &p_pid->p_targets[i];
+            if (p_target->p_dvbpsi)
+            {
+                dvbpsi_packets_push(p_target->p_dvbpsi, p_data, 1, 0,
+                                    &handle_stats);
+                dvbpsi_router_stats_add(p_stats, &handle_stats);
+            }
+            else if (p_target->pf_callback)
+                p_target->pf_callback(p_target->p_cb_data, p_data);
+        }
+    }
+    p_stats->i_packets = i_packets;
+
+    /* Drop the targets removed during the push */
+    if (--p_router->i_pushing == 0 && p_router->b_empty)
+    {
+        for (unsigned int i = 0; i < DVBPSI_ROUTER_PIDS; i++)
+        {
+            if (p_router->p_pids[i].b_empty)
+                dvbpsi_router_compact(&p_router->p_pids[i]);
+        }
+        p_router->b_empty = false;
+    }
+
+    return (p_stats->i_ts_errors == 0);
+}
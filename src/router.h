@@ -0,0 +1,194 @@
+/*****************************************************************************
+ * router.h
+ * Copyright (C) 2001-2011 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <router.h>
+ * \brief PID router.
+ *
+ * Dispatch of the TS packets of a whole multiplex to the PSI decoders and
+ * packet callbacks registered for their PID.
+ */
+
+#ifndef _DVBPSI_ROUTER_H_
+#define _DVBPSI_ROUTER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_router_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_router_s dvbpsi_router_t
+ * \brief Opaque PID router.
+ *
+ * A router holds a table indexed by the 8192 PIDs, each entry listing the
+ * targets of the PID: dvbpsi handles and packet callbacks. A PID may have
+ * several targets, they get its packets in the order they were added.
+ *
+ * Targets may be added and removed from the callbacks of the decoders the
+ * router feeds, for instance the PMT PIDs from a PAT callback or the EIT
+ * PIDs from an ATSC MGT callback. A target added while a packet is being
+ * dispatched starts with the next packet of its PID; a target removed
+ * does not get any packet anymore.
+ */
+typedef struct dvbpsi_router_s dvbpsi_router_t;
+
+/*****************************************************************************
+ * dvbpsi_router_packet_cb_t
+ *****************************************************************************/
+/*!
+ * \typedef void (* dvbpsi_router_packet_cb_t)(void *p_cb_data,
+                                               uint8_t *p_packet)
+ * \brief Callback receiving the TS packets of a PID.
+ */
+typedef void (* dvbpsi_router_packet_cb_t)(void *p_cb_data, uint8_t *p_packet);
+
+/*****************************************************************************
+ * dvbpsi_router_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_router_t *dvbpsi_router_new(void)
+ * \brief Creation of a new router, without any target.
+ * \return a pointer to the router or NULL on error.
+ */
+dvbpsi_router_t *dvbpsi_router_new(void);
+
+/*****************************************************************************
+ * dvbpsi_router_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_router_delete(dvbpsi_router_t *p_router)
+ * \brief Destruction of a router.
+ * \param p_router pointer to the router
+ * \return nothing.
+ *
+ * The dvbpsi handles registered in the router are left untouched.
+ */
+void dvbpsi_router_delete(dvbpsi_router_t *p_router);
+
+/*****************************************************************************
+ * dvbpsi_router_add
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_router_add(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                              dvbpsi_t *p_dvbpsi)
+ * \brief Route the packets of a PID to a dvbpsi handle.
+ * \param p_router pointer to the router
+ * \param i_pid PID of the packets
+ * \param p_dvbpsi handle with a decoder attached
+ * \return true on success, false on error or if the handle already gets the
+ * packets of the PID.
+ */
+bool dvbpsi_router_add(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                       dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_router_remove
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_router_remove(dvbpsi_router_t *p_router,
+                                 const uint16_t i_pid, dvbpsi_t *p_dvbpsi)
+ * \brief Stop routing the packets of a PID to a dvbpsi handle.
+ * \param p_router pointer to the router
+ * \param i_pid PID of the packets
+ * \param p_dvbpsi handle given to dvbpsi_router_add()
+ * \return nothing.
+ *
+ * The handle must be removed from the router before it is deleted.
+ */
+void dvbpsi_router_remove(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                          dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_router_add_callback
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_router_add_callback(dvbpsi_router_t *p_router,
+                                       const uint16_t i_pid,
+                                       dvbpsi_router_packet_cb_t pf_callback,
+                                       void *p_cb_data)
+ * \brief Route the packets of a PID to a callback.
+ * \param p_router pointer to the router
+ * \param i_pid PID of the packets
+ * \param pf_callback function called with each packet of the PID
+ * \param p_cb_data private data given to pf_callback
+ * \return true on success, false on error or if the callback already gets
+ * the packets of the PID with the same private data.
+ */
+bool dvbpsi_router_add_callback(dvbpsi_router_t *p_router, const uint16_t i_pid,
+                                dvbpsi_router_packet_cb_t pf_callback,
+                                void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_router_remove_callback
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_router_remove_callback(dvbpsi_router_t *p_router,
+                                          const uint16_t i_pid,
+                                          dvbpsi_router_packet_cb_t pf_callback,
+                                          void *p_cb_data)
+ * \brief Stop routing the packets of a PID to a callback.
+ * \param p_router pointer to the router
+ * \param i_pid PID of the packets
+ * \param pf_callback callback given to dvbpsi_router_add_callback()
+ * \param p_cb_data private data given to dvbpsi_router_add_callback()
+ * \return nothing.
+ */
+void dvbpsi_router_remove_callback(dvbpsi_router_t *p_router,
+                                   const uint16_t i_pid,
+                                   dvbpsi_router_packet_cb_t pf_callback,
+                                   void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_router_push
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_router_push(dvbpsi_router_t *p_router, uint8_t *p_data,
+                               size_t i_packets, size_t i_stride,
+                               dvbpsi_push_stats_t *p_stats)
+ * \brief Injection of a block of TS packets of any PID.
+ * \param p_router pointer to the router
+ * \param p_data pointer to the first TS packet of the block
+ * \param i_packets number of TS packets in the block
+ * \param i_stride distance in bytes between the start of two consecutive
+ *        TS packets, 188 is assumed when 0, see dvbpsi_packets_push()
+ * \param p_stats pointer to per block statistics, may be NULL
+ * \return true when all packets have been handled, false when at least one
+ *         packet was rejected.
+ *
+ * Each packet is given to the targets of its PID, packets of a PID without
+ * target are skipped. Packets without a sync byte are counted in
+ * dvbpsi_push_stats_t::i_ts_errors and given to no target. The section
+ * counters of 'p_stats' add up the work of all the dvbpsi handles.
+ */
+bool dvbpsi_router_push(dvbpsi_router_t *p_router, uint8_t *p_data,
+                        size_t i_packets, size_t i_stride,
+                        dvbpsi_push_stats_t *p_stats);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of router.h"
+#endif
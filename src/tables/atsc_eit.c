@@ -176,7 +176,9 @@ void dvbpsi_atsc_InitEIT(dvbpsi_atsc_eit_t* p_eit, uint8_t i_table_id, uint16_t
     p_eit->i_protocol = i_protocol;
     p_eit->i_source_id = i_source_id;
     p_eit->p_first_event = NULL;
+    p_eit->p_last_event = NULL;
     p_eit->p_first_descriptor = NULL;
+    p_eit->p_arena = NULL;
 }
 
 dvbpsi_atsc_eit_t *dvbpsi_atsc_NewEIT(uint8_t i_table_id, uint16_t i_extension,
@@ -186,8 +188,11 @@ dvbpsi_atsc_eit_t *dvbpsi_atsc_NewEIT(uint8_t i_table_id, uint16_t i_extension,
     dvbpsi_atsc_eit_t *p_eit;
     p_eit = (dvbpsi_atsc_eit_t*) malloc(sizeof(dvbpsi_atsc_eit_t));
     if (p_eit != NULL)
+    {
         dvbpsi_atsc_InitEIT(p_eit, i_table_id, i_extension, i_version,
                             i_protocol, i_source_id, b_current_next);
+        p_eit->p_arena = dvbpsi_NewArena();
+    }
     return p_eit;
 }
 
@@ -203,20 +208,26 @@ void dvbpsi_atsc_EmptyEIT(dvbpsi_atsc_eit_t* p_eit)
   while(p_event != NULL)
   {
     dvbpsi_atsc_eit_event_t* p_tmp = p_event->p_next;
-    dvbpsi_DeleteDescriptors(p_event->p_first_descriptor);
-    free(p_event);
+    dvbpsi_DeleteArenaDescriptors(p_eit->p_arena, p_event->p_first_descriptor);
+    if (p_eit->p_arena == NULL)
+      free(p_event);
     p_event = p_tmp;
   }
   p_eit->p_first_event = NULL;
+  p_eit->p_last_event = NULL;
 
-  dvbpsi_DeleteDescriptors(p_eit->p_first_descriptor);
+  dvbpsi_DeleteArenaDescriptors(p_eit->p_arena, p_eit->p_first_descriptor);
+  dvbpsi_ResetArena(p_eit->p_arena);
   p_eit->p_first_descriptor = NULL;
 }
 
 void dvbpsi_atsc_DeleteEIT(dvbpsi_atsc_eit_t *p_eit)
 {
     if (p_eit)
+    {
         dvbpsi_atsc_EmptyEIT(p_eit);
+        dvbpsi_DeleteArena(p_eit->p_arena);
+    }
     free(p_eit);
     p_eit = NULL;
 }
@@ -235,7 +246,8 @@ static dvbpsi_atsc_eit_event_t *dvbpsi_atsc_EITAddEvent(dvbpsi_atsc_eit_t* p_eit
                                             uint8_t *p_title)
 {
   dvbpsi_atsc_eit_event_t * p_event
-                = (dvbpsi_atsc_eit_event_t*)malloc(sizeof(dvbpsi_atsc_eit_event_t));
+                = (dvbpsi_atsc_eit_event_t*)dvbpsi_ArenaAlloc(p_eit->p_arena,
+                                                              sizeof(dvbpsi_atsc_eit_event_t));
   if(p_event)
   {
     p_event->i_event_id = i_event_id;
@@ -247,7 +259,9 @@ static dvbpsi_atsc_eit_event_t *dvbpsi_atsc_EITAddEvent(dvbpsi_atsc_eit_t* p_eit
     memcpy(p_event->i_title, p_title, i_title_length);
 
     p_event->p_first_descriptor = NULL;
+    p_event->p_last_descriptor = NULL;
     p_event->p_next = NULL;
+    p_event->p_arena = p_eit->p_arena;
 
     if(p_eit->p_first_event== NULL)
     {
@@ -255,11 +269,14 @@ static dvbpsi_atsc_eit_event_t *dvbpsi_atsc_EITAddEvent(dvbpsi_atsc_eit_t* p_eit
     }
     else
     {
-      dvbpsi_atsc_eit_event_t * p_last_event = p_eit->p_first_event;
+      dvbpsi_atsc_eit_event_t * p_last_event = p_eit->p_last_event;
+      if (p_last_event == NULL)
+        p_last_event = p_eit->p_first_event;
       while(p_last_event->p_next != NULL)
         p_last_event = p_last_event->p_next;
       p_last_event->p_next = p_event;
     }
+    p_eit->p_last_event = p_event;
   }
 
   return p_event;
@@ -276,12 +293,13 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_EITChannelAddDescriptor(
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor
-                            = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                            = dvbpsi_NewArenaDescriptor(p_event->p_arena, i_tag,
+                                                        i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_event->p_first_descriptor = dvbpsi_AddDescriptor(p_event->p_first_descriptor,
-                                                       p_descriptor);
+    dvbpsi_AppendDescriptor(&p_event->p_first_descriptor,
+                            &p_event->p_last_descriptor, p_descriptor);
     assert(p_event->p_first_descriptor);
     if (p_event->p_first_descriptor == NULL)
         return NULL;
@@ -55,6 +55,8 @@ typedef struct dvbpsi_atsc_eit_event_s
     uint8_t    i_title[256];    /*!< Title in multiple string structure format. */
 
     dvbpsi_descriptor_t *p_first_descriptor; /*!< First descriptor structure. */
+    dvbpsi_descriptor_t *p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t      *p_arena;            /*!< arena of the EIT */
 
     struct dvbpsi_atsc_eit_event_s   *p_next;/*!< Next event information structure. */
 
@@ -84,8 +86,10 @@ typedef struct dvbpsi_atsc_eit_s
     uint8_t                 i_protocol;         /*!< PSIP Protocol version */
 
     dvbpsi_atsc_eit_event_t *p_first_event;     /*!< First event information structure. */
+    dvbpsi_atsc_eit_event_t *p_last_event;      /*!< last event of the list */
 
     dvbpsi_descriptor_t     *p_first_descriptor;/*!< First descriptor structure. */
+    dvbpsi_arena_t          *p_arena;           /*!< arena of the events */
 } dvbpsi_atsc_eit_t;
 
 /*****************************************************************************
@@ -162,6 +166,9 @@ void dvbpsi_atsc_InitEIT(dvbpsi_atsc_eit_t* p_eit, uint8_t i_table_id, uint16_t
  * \param i_source_id Source id.
  * \param b_current_next current next indicator
  * \return p_eit pointer to the EIT structure or NULL on error
+ *
+ * The events and their descriptors are carved from an arena owned by the
+ * EIT.
  */
 dvbpsi_atsc_eit_t *dvbpsi_atsc_NewEIT(uint8_t i_table_id, uint16_t i_extension,
                                       uint8_t i_version, uint8_t i_protocol,
@@ -179,7 +179,10 @@ void dvbpsi_atsc_InitMGT(dvbpsi_atsc_mgt_t* p_mgt, uint8_t i_table_id, uint16_t
     p_mgt->b_current_next = b_current_next;
     p_mgt->i_protocol = i_protocol;
     p_mgt->p_first_table = NULL;
+    p_mgt->p_last_table = NULL;
     p_mgt->p_first_descriptor = NULL;
+    p_mgt->p_last_descriptor = NULL;
+    p_mgt->p_arena = NULL;
 }
 
 dvbpsi_atsc_mgt_t *dvbpsi_atsc_NewMGT(uint8_t i_table_id, uint16_t i_extension,
@@ -188,7 +191,10 @@ dvbpsi_atsc_mgt_t *dvbpsi_atsc_NewMGT(uint8_t i_table_id, uint16_t i_extension,
     dvbpsi_atsc_mgt_t* p_mgt;
     p_mgt = (dvbpsi_atsc_mgt_t*)calloc(1, sizeof(dvbpsi_atsc_mgt_t));
     if (p_mgt != NULL)
+    {
         dvbpsi_atsc_InitMGT(p_mgt, i_table_id, i_extension, i_version, i_protocol, b_current_next);
+        p_mgt->p_arena = dvbpsi_NewArena();
+    }
     return p_mgt;
 }
 
@@ -204,19 +210,26 @@ void dvbpsi_atsc_EmptyMGT(dvbpsi_atsc_mgt_t* p_mgt)
   while(p_table != NULL)
   {
     dvbpsi_atsc_mgt_table_t* p_tmp = p_table->p_next;
-    dvbpsi_DeleteDescriptors(p_table->p_first_descriptor);
-    free(p_table);
+    dvbpsi_DeleteArenaDescriptors(p_mgt->p_arena, p_table->p_first_descriptor);
+    if (p_mgt->p_arena == NULL)
+      free(p_table);
     p_table = p_tmp;
   }
-  dvbpsi_DeleteDescriptors(p_mgt->p_first_descriptor);
+  dvbpsi_DeleteArenaDescriptors(p_mgt->p_arena, p_mgt->p_first_descriptor);
+  dvbpsi_ResetArena(p_mgt->p_arena);
   p_mgt->p_first_table = NULL;
+  p_mgt->p_last_table = NULL;
   p_mgt->p_first_descriptor = NULL;
+  p_mgt->p_last_descriptor = NULL;
 }
 
 void dvbpsi_atsc_DeleteMGT(dvbpsi_atsc_mgt_t *p_mgt)
 {
     if (p_mgt)
+    {
         dvbpsi_atsc_EmptyMGT(p_mgt);
+        dvbpsi_DeleteArena(p_mgt->p_arena);
+    }
     free(p_mgt);
     p_mgt = NULL;
 }
@@ -232,12 +245,13 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_MGTAddDescriptor(
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_mgt->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_mgt->p_first_descriptor = dvbpsi_AddDescriptor(p_mgt->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_mgt->p_first_descriptor,
+                            &p_mgt->p_last_descriptor, p_descriptor);
     assert(p_mgt->p_first_descriptor);
     if (p_mgt->p_first_descriptor == NULL)
         return NULL;
@@ -257,7 +271,8 @@ static dvbpsi_atsc_mgt_table_t *dvbpsi_atsc_MGTAddTable(dvbpsi_atsc_mgt_t* p_mgt
 						 uint32_t i_number_bytes)
 {
   dvbpsi_atsc_mgt_table_t * p_table
-                = (dvbpsi_atsc_mgt_table_t*)malloc(sizeof(dvbpsi_atsc_mgt_table_t));
+                = (dvbpsi_atsc_mgt_table_t*)dvbpsi_ArenaAlloc(p_mgt->p_arena,
+                                                              sizeof(dvbpsi_atsc_mgt_table_t));
   if(p_table)
   {
     p_table->i_table_type = i_table_type;
@@ -266,7 +281,9 @@ static dvbpsi_atsc_mgt_table_t *dvbpsi_atsc_MGTAddTable(dvbpsi_atsc_mgt_t* p_mgt
     p_table->i_number_bytes = i_number_bytes;
 
     p_table->p_first_descriptor = NULL;
+    p_table->p_last_descriptor = NULL;
     p_table->p_next = NULL;
+    p_table->p_arena = p_mgt->p_arena;
 
     if(p_mgt->p_first_table== NULL)
     {
@@ -274,11 +291,14 @@ static dvbpsi_atsc_mgt_table_t *dvbpsi_atsc_MGTAddTable(dvbpsi_atsc_mgt_t* p_mgt
     }
     else
     {
-      dvbpsi_atsc_mgt_table_t * p_last_table = p_mgt->p_first_table;
+      dvbpsi_atsc_mgt_table_t * p_last_table = p_mgt->p_last_table;
+      if (p_last_table == NULL)
+        p_last_table = p_mgt->p_first_table;
       while(p_last_table->p_next != NULL)
         p_last_table = p_last_table->p_next;
       p_last_table->p_next = p_table;
     }
+    p_mgt->p_last_table = p_table;
   }
 
   return p_table;
@@ -295,7 +315,8 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_MGTTableAddDescriptor(
                                                uint8_t *p_data)
 {
   dvbpsi_descriptor_t * p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_table->p_arena, i_tag,
+                                                    i_length, p_data);
   if(p_descriptor)
   {
     if(p_table->p_first_descriptor == NULL)
@@ -304,11 +325,14 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_MGTTableAddDescriptor(
     }
     else
     {
-      dvbpsi_descriptor_t * p_last_descriptor = p_table->p_first_descriptor;
+      dvbpsi_descriptor_t * p_last_descriptor = p_table->p_last_descriptor;
+      if (p_last_descriptor == NULL)
+        p_last_descriptor = p_table->p_first_descriptor;
       while(p_last_descriptor->p_next != NULL)
         p_last_descriptor = p_last_descriptor->p_next;
       p_last_descriptor->p_next = p_descriptor;
     }
+    p_table->p_last_descriptor = p_descriptor;
   }
 
   return p_descriptor;
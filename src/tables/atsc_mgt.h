@@ -56,6 +56,8 @@ typedef struct dvbpsi_atsc_mgt_table_s
     uint32_t                    i_number_bytes;     /*!< bytes used for table */
 
     dvbpsi_descriptor_t        *p_first_descriptor; /*!< First descriptor. */
+    dvbpsi_descriptor_t        *p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t             *p_arena;            /*!< arena of the MGT */
 
     struct dvbpsi_atsc_mgt_table_s *p_next;         /*!< next element of the list */
 } dvbpsi_atsc_mgt_table_t;
@@ -84,8 +86,11 @@ typedef struct dvbpsi_atsc_mgt_s
     uint8_t                 i_protocol;         /*!< PSIP Protocol version */
 
     dvbpsi_atsc_mgt_table_t   *p_first_table;   /*!< First table information structure. */
+    dvbpsi_atsc_mgt_table_t   *p_last_table;    /*!< last table of the list */
 
     dvbpsi_descriptor_t    *p_first_descriptor; /*!< First descriptor. */
+    dvbpsi_descriptor_t    *p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t         *p_arena;            /*!< arena of the tables */
 } dvbpsi_atsc_mgt_t;
 
 /*****************************************************************************
@@ -158,6 +163,9 @@ void dvbpsi_atsc_InitMGT(dvbpsi_atsc_mgt_t* p_mgt, uint8_t i_table_id, uint16_t
  * \param i_protocol PSIP Protocol version.
  * \param b_current_next current next indicator
  * \return p_mgt pointer to the MGT structure, or NULL on failure
+ *
+ * The tables and the descriptors are carved from an arena owned by the
+ * MGT.
  */
 dvbpsi_atsc_mgt_t *dvbpsi_atsc_NewMGT(uint8_t i_table_id, uint16_t i_extension,
                         uint8_t i_version, uint8_t i_protocol, bool b_current_next);
@@ -166,6 +166,8 @@ void dvbpsi_atsc_InitSTT(dvbpsi_atsc_stt_t *p_stt, uint8_t i_table_id,
     p_stt->b_current_next = b_current_next;
 
     p_stt->p_first_descriptor = NULL;
+    p_stt->p_last_descriptor = NULL;
+    p_stt->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -179,7 +181,10 @@ dvbpsi_atsc_stt_t *dvbpsi_atsc_NewSTT(uint8_t i_table_id, uint16_t i_extension,
     dvbpsi_atsc_stt_t *p_stt;
     p_stt = (dvbpsi_atsc_stt_t*)malloc(sizeof(dvbpsi_atsc_stt_t));
     if (p_stt != NULL)
+    {
         dvbpsi_atsc_InitSTT(p_stt, i_table_id, i_extension, i_version, b_current_next);
+        p_stt->p_arena = dvbpsi_NewArena();
+    }
     return p_stt;
 }
 
@@ -190,8 +195,10 @@ dvbpsi_atsc_stt_t *dvbpsi_atsc_NewSTT(uint8_t i_table_id, uint16_t i_extension,
  *****************************************************************************/
 void dvbpsi_atsc_EmptySTT(dvbpsi_atsc_stt_t* p_stt)
 {
-  dvbpsi_DeleteDescriptors(p_stt->p_first_descriptor);
+  dvbpsi_DeleteArenaDescriptors(p_stt->p_arena, p_stt->p_first_descriptor);
+  dvbpsi_ResetArena(p_stt->p_arena);
   p_stt->p_first_descriptor = NULL;
+  p_stt->p_last_descriptor = NULL;
 }
 
 /*****************************************************************************
@@ -202,7 +209,10 @@ void dvbpsi_atsc_EmptySTT(dvbpsi_atsc_stt_t* p_stt)
 void dvbpsi_atsc_DeleteSTT(dvbpsi_atsc_stt_t *p_stt)
 {
     if (p_stt)
+    {
         dvbpsi_atsc_EmptySTT(p_stt);
+        dvbpsi_DeleteArena(p_stt->p_arena);
+    }
     free(p_stt);
     p_stt = NULL;
 }
@@ -216,12 +226,13 @@ dvbpsi_descriptor_t *dvbpsi_atsc_STTAddDescriptor( dvbpsi_atsc_stt_t *p_stt,
                                                uint8_t i_tag, uint8_t i_length,
                                                uint8_t *p_data)
 {
-    dvbpsi_descriptor_t * p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    dvbpsi_descriptor_t * p_descriptor
+            = dvbpsi_NewArenaDescriptor(p_stt->p_arena, i_tag, i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_stt->p_first_descriptor = dvbpsi_AddDescriptor(p_stt->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_stt->p_first_descriptor,
+                            &p_stt->p_last_descriptor, p_descriptor);
     assert(p_stt->p_first_descriptor);
     if (p_stt->p_first_descriptor == NULL)
         return NULL;
@@ -58,6 +58,8 @@ typedef struct dvbpsi_atsc_stt_s
     uint16_t                i_daylight_savings; /*!< Daylight savings control bytes. */
 
     dvbpsi_descriptor_t    *p_first_descriptor; /*!< First descriptor. */
+    dvbpsi_descriptor_t    *p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t         *p_arena;            /*!< arena of the descriptors */
 } dvbpsi_atsc_stt_t;
 
 /*****************************************************************************
@@ -129,6 +131,8 @@ void dvbpsi_atsc_InitSTT(dvbpsi_atsc_stt_t *p_stt, uint8_t i_table_id, uint16_t
  * \param i_version PSIP Protocol version.
  * \param b_current_next current next indicator
  * \return p_stt pointer to the STT structure
+ *
+ * The descriptors are carved from an arena owned by the STT.
  */
 dvbpsi_atsc_stt_t *dvbpsi_atsc_NewSTT(uint8_t i_table_id, uint16_t i_extension,
                                       uint8_t i_version, bool b_current_next);
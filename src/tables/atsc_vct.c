@@ -181,8 +181,11 @@ dvbpsi_atsc_vct_t *dvbpsi_atsc_NewVCT(uint8_t i_table_id, uint16_t i_extension,
 {
     dvbpsi_atsc_vct_t *p_vct = (dvbpsi_atsc_vct_t*)malloc(sizeof(dvbpsi_atsc_vct_t));
     if (p_vct != NULL)
+    {
         dvbpsi_atsc_InitVCT(p_vct, i_table_id, i_extension,  i_protocol,
                             b_cable_vct, i_version, b_current_next);
+        p_vct->p_arena = dvbpsi_NewArena();
+    }
     return p_vct;
 }
 
@@ -204,7 +207,10 @@ void dvbpsi_atsc_InitVCT(dvbpsi_atsc_vct_t* p_vct, uint8_t i_table_id,
     p_vct->i_protocol = i_protocol;
     p_vct->b_cable_vct = b_cable_vct;
     p_vct->p_first_channel = NULL;
+    p_vct->p_last_channel = NULL;
     p_vct->p_first_descriptor = NULL;
+    p_vct->p_last_descriptor = NULL;
+    p_vct->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -215,17 +221,21 @@ void dvbpsi_atsc_InitVCT(dvbpsi_atsc_vct_t* p_vct, uint8_t i_table_id,
 void dvbpsi_atsc_EmptyVCT(dvbpsi_atsc_vct_t* p_vct)
 {
     dvbpsi_atsc_vct_channel_t* p_channel = p_vct->p_first_channel;
-    dvbpsi_DeleteDescriptors(p_vct->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_vct->p_arena, p_vct->p_first_descriptor);
     p_vct->p_first_descriptor = NULL;
+    p_vct->p_last_descriptor = NULL;
 
     while(p_channel != NULL)
     {
         dvbpsi_atsc_vct_channel_t* p_tmp = p_channel->p_next;
-        dvbpsi_DeleteDescriptors(p_channel->p_first_descriptor);
-        free(p_channel);
+        dvbpsi_DeleteArenaDescriptors(p_vct->p_arena, p_channel->p_first_descriptor);
+        if (p_vct->p_arena == NULL)
+            free(p_channel);
         p_channel = p_tmp;
     }
+    dvbpsi_ResetArena(p_vct->p_arena);
     p_vct->p_first_channel = NULL;
+    p_vct->p_last_channel = NULL;
 }
 
 /*****************************************************************************
@@ -236,7 +246,10 @@ void dvbpsi_atsc_EmptyVCT(dvbpsi_atsc_vct_t* p_vct)
 void dvbpsi_atsc_DeleteVCT(dvbpsi_atsc_vct_t *p_vct)
 {
     if (p_vct)
+    {
         dvbpsi_atsc_EmptyVCT(p_vct);
+        dvbpsi_DeleteArena(p_vct->p_arena);
+    }
     free(p_vct);
 }
 
@@ -250,12 +263,13 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_VCTAddDescriptor(dvbpsi_atsc_vct_t *p_vc
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor
-            = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+            = dvbpsi_NewArenaDescriptor(p_vct->p_arena, i_tag,
+                                        i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_vct->p_first_descriptor = dvbpsi_AddDescriptor(p_vct->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_vct->p_first_descriptor,
+                            &p_vct->p_last_descriptor, p_descriptor);
     assert(p_vct->p_first_descriptor);
     if (p_vct->p_first_descriptor == NULL)
         return NULL;
@@ -286,7 +300,8 @@ static dvbpsi_atsc_vct_channel_t *dvbpsi_atsc_VCTAddChannel(dvbpsi_atsc_vct_t* p
                                             uint16_t i_source_id)
 {
     dvbpsi_atsc_vct_channel_t * p_channel
-            = (dvbpsi_atsc_vct_channel_t*)malloc(sizeof(dvbpsi_atsc_vct_channel_t));
+            = (dvbpsi_atsc_vct_channel_t*)dvbpsi_ArenaAlloc(p_vct->p_arena,
+                                                            sizeof(dvbpsi_atsc_vct_channel_t));
     if(p_channel)
     {
         memcpy(p_channel->i_short_name, p_short_name, sizeof(uint16_t) * 7);
@@ -306,7 +321,9 @@ static dvbpsi_atsc_vct_channel_t *dvbpsi_atsc_VCTAddChannel(dvbpsi_atsc_vct_t* p
         p_channel->i_source_id = i_source_id;
 
         p_channel->p_first_descriptor = NULL;
+        p_channel->p_last_descriptor = NULL;
         p_channel->p_next = NULL;
+        p_channel->p_arena = p_vct->p_arena;
 
         if(p_vct->p_first_channel== NULL)
         {
@@ -314,11 +331,14 @@ static dvbpsi_atsc_vct_channel_t *dvbpsi_atsc_VCTAddChannel(dvbpsi_atsc_vct_t* p
         }
         else
         {
-            dvbpsi_atsc_vct_channel_t * p_last_channel = p_vct->p_first_channel;
+            dvbpsi_atsc_vct_channel_t * p_last_channel = p_vct->p_last_channel;
+            if (p_last_channel == NULL)
+                p_last_channel = p_vct->p_first_channel;
             while(p_last_channel->p_next != NULL)
                 p_last_channel = p_last_channel->p_next;
             p_last_channel->p_next = p_channel;
         }
+        p_vct->p_last_channel = p_channel;
     }
 
     return p_channel;
@@ -335,7 +355,8 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_VCTChannelAddDescriptor(
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor
-            = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+            = dvbpsi_NewArenaDescriptor(p_channel->p_arena, i_tag,
+                                        i_length, p_data);
     if(p_descriptor)
     {
         if(p_channel->p_first_descriptor == NULL)
@@ -344,11 +365,14 @@ static dvbpsi_descriptor_t *dvbpsi_atsc_VCTChannelAddDescriptor(
         }
         else
         {
-            dvbpsi_descriptor_t * p_last_descriptor = p_channel->p_first_descriptor;
+            dvbpsi_descriptor_t * p_last_descriptor = p_channel->p_last_descriptor;
+            if (p_last_descriptor == NULL)
+                p_last_descriptor = p_channel->p_first_descriptor;
             while(p_last_descriptor->p_next != NULL)
                 p_last_descriptor = p_last_descriptor->p_next;
             p_last_descriptor->p_next = p_descriptor;
         }
+        p_channel->p_last_descriptor = p_descriptor;
     }
 
     return p_descriptor;
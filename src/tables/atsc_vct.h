@@ -69,6 +69,8 @@ typedef struct dvbpsi_atsc_vct_channel_s
     uint16_t  i_source_id;     /*!< Programming source associated with the channel.*/
 
     dvbpsi_descriptor_t *p_first_descriptor;  /*!< First descriptor. */
+    dvbpsi_descriptor_t *p_last_descriptor;   /*!< last descriptor of the list */
+    dvbpsi_arena_t      *p_arena;             /*!< arena of the VCT */
 
     struct dvbpsi_atsc_vct_channel_s *p_next; /*!< next element of the list */
 } dvbpsi_atsc_vct_channel_t;
@@ -97,7 +99,10 @@ typedef struct dvbpsi_atsc_vct_s
     bool     b_cable_vct;        /*!< 1 if this is a cable VCT, 0 if it is a Terrestrial VCT. */
 
     dvbpsi_descriptor_t         *p_first_descriptor; /*!< First descriptor. */
+    dvbpsi_descriptor_t         *p_last_descriptor;  /*!< last descriptor of the list */
     dvbpsi_atsc_vct_channel_t   *p_first_channel;    /*!< First channel information structure. */
+    dvbpsi_atsc_vct_channel_t   *p_last_channel;     /*!< last channel of the list */
+    dvbpsi_arena_t              *p_arena;            /*!< arena of the channels */
 
 } dvbpsi_atsc_vct_t;
 
@@ -181,6 +186,9 @@ void dvbpsi_atsc_InitVCT(dvbpsi_atsc_vct_t* p_vct, uint8_t i_table_id,
  * \param i_version VCT version
  * \param b_current_next current next indicator
  * \return p_vct pointer to the VCT structure
+ *
+ * The channels and the descriptors are carved from an arena owned by the
+ * VCT.
  */
 dvbpsi_atsc_vct_t *dvbpsi_atsc_NewVCT(uint8_t i_table_id, uint16_t i_extension,
                     uint8_t i_protocol, bool b_cable_vct, uint8_t i_version,
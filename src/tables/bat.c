@@ -50,6 +50,28 @@
 #include "bat.h"
 #include "bat_private.h"
 
+/*****************************************************************************
+ * dvbpsi_bat_decoder_new
+ *****************************************************************************
+ * Allocate a BAT decoder, of a subtable or of a family.
+ *****************************************************************************/
+static dvbpsi_bat_decoder_t *dvbpsi_bat_decoder_new(dvbpsi_bat_callback pf_callback,
+                                                  void *p_cb_data)
+{
+    dvbpsi_bat_decoder_t *p_bat_decoder;
+    p_bat_decoder = (dvbpsi_bat_decoder_t *) dvbpsi_decoder_new(NULL,
+                                             0, true, sizeof(dvbpsi_bat_decoder_t));
+    if (p_bat_decoder == NULL)
+        return NULL;
+
+    /* BAT decoder information */
+    p_bat_decoder->pf_bat_callback = pf_callback;
+    p_bat_decoder->p_cb_data = p_cb_data;
+    p_bat_decoder->p_building_bat = NULL;
+
+    return p_bat_decoder;
+}
+
 /*****************************************************************************
  * dvbpsi_bat_attach
  *****************************************************************************
@@ -71,9 +93,7 @@ bool dvbpsi_bat_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
         return false;
     }
 
-    dvbpsi_bat_decoder_t*  p_bat_decoder;
-    p_bat_decoder = (dvbpsi_bat_decoder_t*) dvbpsi_decoder_new(NULL,
-                                             0, true, sizeof(dvbpsi_bat_decoder_t));
+    dvbpsi_bat_decoder_t*  p_bat_decoder = dvbpsi_bat_decoder_new(pf_callback, p_cb_data);
     if (p_bat_decoder == NULL)
         return false;
 
@@ -90,11 +110,6 @@ bool dvbpsi_bat_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
     /* Attach the subtable decoder to the demux */
     dvbpsi_AttachDemuxSubDecoder(p_demux, p_subdec);
 
-    /* BAT decoder information */
-    p_bat_decoder->pf_bat_callback = pf_callback;
-    p_bat_decoder->p_cb_data = p_cb_data;
-    p_bat_decoder->p_building_bat = NULL;
-
     return true;
 }
 
@@ -131,6 +146,61 @@ void dvbpsi_bat_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
     dvbpsi_DeleteDemuxSubDecoder(p_subdec);
 }
 
+/*****************************************************************************
+ * dvbpsi_bat_family_new
+ *****************************************************************************
+ * Create the decoder of a subtable of a BAT family.
+ *****************************************************************************/
+static dvbpsi_decoder_t *dvbpsi_bat_family_new(dvbpsi_demux_family_t *p_family,
+                                              uint8_t i_table_id, uint16_t i_extension)
+{
+    (void)i_table_id;
+    (void)i_extension;
+
+    dvbpsi_bat_callback pf_callback = (dvbpsi_bat_callback)p_family->pf_table_callback;
+    return DVBPSI_DECODER(dvbpsi_bat_decoder_new(pf_callback, p_family->p_cb_data));
+}
+
+/*****************************************************************************
+ * dvbpsi_bat_family_delete
+ *****************************************************************************
+ * Destroy the decoder of a subtable of a BAT family.
+ *****************************************************************************/
+static void dvbpsi_bat_family_delete(dvbpsi_decoder_t *p_decoder)
+{
+    dvbpsi_bat_decoder_t *p_bat_decoder = (dvbpsi_bat_decoder_t *)p_decoder;
+    if (p_bat_decoder->p_building_bat)
+        dvbpsi_bat_delete(p_bat_decoder->p_building_bat);
+
+    dvbpsi_decoder_delete(p_decoder);
+}
+
+/*****************************************************************************
+ * dvbpsi_bat_family_attach
+ *****************************************************************************
+ * Initialize a BAT decoder of a range of table ids and any extension.
+ *****************************************************************************/
+bool dvbpsi_bat_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_bat_callback pf_callback, void* p_cb_data)
+{
+    return dvbpsi_AddDemuxFamily(p_dvbpsi, "BAT decoder", i_first_table_id,
+                                 i_last_table_id, dvbpsi_bat_sections_gather,
+                                 dvbpsi_bat_family_new, dvbpsi_bat_family_delete,
+                                 (dvbpsi_demux_family_table_cb_t)pf_callback, p_cb_data);
+}
+
+/*****************************************************************************
+ * dvbpsi_bat_family_detach
+ *****************************************************************************
+ * Close a BAT decoder of a range of table ids.
+ *****************************************************************************/
+void dvbpsi_bat_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+{
+    dvbpsi_RemoveDemuxFamily(p_dvbpsi, "BAT decoder", i_table_id,
+                             dvbpsi_bat_family_new);
+}
+
 /*****************************************************************************
  * dvbpsi_bat_init
  *****************************************************************************
@@ -146,7 +216,11 @@ void dvbpsi_bat_init(dvbpsi_bat_t* p_bat, uint8_t i_table_id, uint16_t i_extensi
     p_bat->i_version = i_version;
     p_bat->b_current_next = b_current_next;
     p_bat->p_first_ts = NULL;
+    p_bat->p_last_ts = NULL;
     p_bat->p_first_descriptor = NULL;
+    p_bat->p_last_descriptor = NULL;
+    p_bat->p_arena = NULL;
+    p_bat->p_sections = NULL;
 }
 
 /*****************************************************************************
@@ -158,8 +232,11 @@ dvbpsi_bat_t *dvbpsi_bat_new(uint8_t i_table_id, uint16_t i_extension,
                              uint8_t i_version, bool b_current_next)
 {
     dvbpsi_bat_t *p_bat = (dvbpsi_bat_t*)malloc(sizeof(dvbpsi_bat_t));
-    if(p_bat != NULL)
+    if (p_bat != NULL)
+    {
         dvbpsi_bat_init(p_bat, i_table_id, i_extension, i_version, b_current_next);
+        p_bat->p_arena = dvbpsi_NewArena();
+    }
     return p_bat;
 }
 
@@ -172,17 +249,23 @@ void dvbpsi_bat_empty(dvbpsi_bat_t* p_bat)
 {
     dvbpsi_bat_ts_t* p_ts = p_bat->p_first_ts;
 
-    dvbpsi_DeleteDescriptors(p_bat->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_bat->p_arena, p_bat->p_first_descriptor);
     p_bat->p_first_descriptor = NULL;
+    p_bat->p_last_descriptor = NULL;
 
     while (p_ts != NULL)
     {
         dvbpsi_bat_ts_t* p_tmp = p_ts->p_next;
-        dvbpsi_DeleteDescriptors(p_ts->p_first_descriptor);
-        free(p_ts);
+        dvbpsi_DeleteArenaDescriptors(p_bat->p_arena, p_ts->p_first_descriptor);
+        if (p_bat->p_arena == NULL)
+            free(p_ts);
         p_ts = p_tmp;
     }
+    dvbpsi_ResetArena(p_bat->p_arena);
+    dvbpsi_DeletePSISections(p_bat->p_sections);
+    p_bat->p_sections = NULL;
     p_bat->p_first_ts = NULL;
+    p_bat->p_last_ts = NULL;
 }
 
 /*****************************************************************************
@@ -193,7 +276,10 @@ void dvbpsi_bat_empty(dvbpsi_bat_t* p_bat)
 void dvbpsi_bat_delete(dvbpsi_bat_t *p_bat)
 {
     if (p_bat)
+    {
         dvbpsi_bat_empty(p_bat);
+        dvbpsi_DeleteArena(p_bat->p_arena);
+    }
     free(p_bat);
 }
 
@@ -207,12 +293,13 @@ dvbpsi_descriptor_t* dvbpsi_bat_bouquet_descriptor_add(dvbpsi_bat_t* p_bat,
                                                        uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_bat->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_bat->p_first_descriptor = dvbpsi_AddDescriptor(p_bat->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_bat->p_first_descriptor,
+                            &p_bat->p_last_descriptor, p_descriptor);
     assert(p_bat->p_first_descriptor);
     if (p_bat->p_first_descriptor == NULL)
         return NULL;
@@ -229,24 +316,30 @@ dvbpsi_bat_ts_t *dvbpsi_bat_ts_add(dvbpsi_bat_t* p_bat,
                                  uint16_t i_ts_id, uint16_t i_orig_network_id)
 {
     dvbpsi_bat_ts_t * p_ts
-                = (dvbpsi_bat_ts_t*)malloc(sizeof(dvbpsi_bat_ts_t));
+                = (dvbpsi_bat_ts_t*)dvbpsi_ArenaAlloc(p_bat->p_arena,
+                                                      sizeof(dvbpsi_bat_ts_t));
     if (p_ts == NULL)
         return NULL;
 
     p_ts->i_ts_id = i_ts_id;
     p_ts->i_orig_network_id = i_orig_network_id;
     p_ts->p_next = NULL;
+    p_ts->p_arena = p_bat->p_arena;
     p_ts->p_first_descriptor = NULL;
+    p_ts->p_last_descriptor = NULL;
 
     if (p_bat->p_first_ts == NULL)
         p_bat->p_first_ts = p_ts;
     else
     {
-        dvbpsi_bat_ts_t * p_last_ts = p_bat->p_first_ts;
+        dvbpsi_bat_ts_t * p_last_ts = p_bat->p_last_ts;
+        if (p_last_ts == NULL)
+            p_last_ts = p_bat->p_first_ts;
         while(p_last_ts->p_next != NULL)
             p_last_ts = p_last_ts->p_next;
         p_last_ts->p_next = p_ts;
     }
+    p_bat->p_last_ts = p_ts;
 
     return p_ts;
 }
@@ -262,7 +355,8 @@ dvbpsi_descriptor_t *dvbpsi_bat_ts_descriptor_add(dvbpsi_bat_ts_t *p_bat,
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_bat->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
@@ -270,11 +364,14 @@ dvbpsi_descriptor_t *dvbpsi_bat_ts_descriptor_add(dvbpsi_bat_ts_t *p_bat,
         p_bat->p_first_descriptor = p_descriptor;
     else
     {
-        dvbpsi_descriptor_t *p_last_descriptor = p_bat->p_first_descriptor;
+        dvbpsi_descriptor_t *p_last_descriptor = p_bat->p_last_descriptor;
+        if (p_last_descriptor == NULL)
+            p_last_descriptor = p_bat->p_first_descriptor;
         while(p_last_descriptor->p_next != NULL)
             p_last_descriptor = p_last_descriptor->p_next;
         p_last_descriptor->p_next = p_descriptor;
     }
+    p_bat->p_last_descriptor = p_descriptor;
     return p_descriptor;
 }
 
@@ -445,8 +542,14 @@ void dvbpsi_bat_sections_gather(dvbpsi_t *p_dvbpsi,
         p_bat_decoder->current_bat = *p_bat_decoder->p_building_bat;
         p_bat_decoder->b_current_valid = true;
         /* Decode the sections */
-        dvbpsi_bat_sections_decode(p_bat_decoder->p_building_bat,
-                                   p_bat_decoder->p_sections);
+        dvbpsi_psi_section_t *p_sections = p_bat_decoder->p_sections;
+        if (p_dvbpsi->p_decoder->b_retain_sections)
+        {
+            /* The table keeps its sections, its descriptors point into them */
+            p_bat_decoder->p_building_bat->p_sections = p_sections;
+            p_bat_decoder->p_sections = NULL;
+        }
+        dvbpsi_bat_sections_decode(p_bat_decoder->p_building_bat, p_sections);
         /* signal the new BAT */
         p_bat_decoder->pf_bat_callback(p_bat_decoder->p_cb_data,
                                        p_bat_decoder->p_building_bat);
@@ -478,6 +581,10 @@ void dvbpsi_bat_sections_decode(dvbpsi_bat_t* p_bat,
         if (p_end > p_section->p_payload_end)
             p_end = p_section->p_payload_end;
 
+        if (p_bat->p_sections != NULL
+         && dvbpsi_AppendDescriptorViews(p_bat->p_arena, &p_bat->p_first_descriptor,
+                                         &p_bat->p_last_descriptor, p_byte, p_end - p_byte))
+            p_byte = p_end;
         while(p_byte + 2 <= p_end)
         {
             uint8_t i_tag = p_byte[0];
@@ -510,6 +617,10 @@ void dvbpsi_bat_sections_decode(dvbpsi_bat_t* p_bat,
             if (p_end2 > p_section->p_payload_end)
                 p_end2 = p_section->p_payload_end;
 
+            if (p_bat->p_sections != NULL
+             && dvbpsi_AppendDescriptorViews(p_bat->p_arena, &p_ts->p_first_descriptor,
+                                             &p_ts->p_last_descriptor, p_byte, p_end2 - p_byte))
+                p_byte = p_end2;
             while (p_byte + 2 <= p_end2)
             {
                 uint8_t i_tag = p_byte[0];
@@ -532,7 +643,7 @@ void dvbpsi_bat_sections_decode(dvbpsi_bat_t* p_bat,
  *****************************************************************************/
 dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_bat_t* p_bat)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_descriptor_t* p_descriptor = p_bat->p_first_descriptor;
@@ -576,7 +687,7 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
             p_current->p_payload_end += 2;
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             if (p_current ==  NULL)
             {
                 dvbpsi_error(p_dvbpsi, "BAT encoder", "failed to allocate new PSI section");
@@ -652,7 +763,7 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
                         "create a new section to carry more TS descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x4a;
@@ -65,6 +65,8 @@ typedef struct dvbpsi_bat_ts_s
     uint16_t                i_orig_network_id;  /*!< original network id */
 
     dvbpsi_descriptor_t    *p_first_descriptor; /*!< descriptor list */
+    dvbpsi_descriptor_t    *p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t         *p_arena;            /*!< arena of the BAT */
 
     struct dvbpsi_bat_ts_s *p_next;             /*!< next element of
                                                              the list */
@@ -95,9 +97,13 @@ typedef struct dvbpsi_bat_s
     bool                    b_current_next;     /*!< current_next_indicator */
 
     dvbpsi_descriptor_t *   p_first_descriptor; /*!< descriptor list */
+    dvbpsi_descriptor_t *   p_last_descriptor;  /*!< last descriptor of the list */
 
     dvbpsi_bat_ts_t *       p_first_ts;         /*!< transport stream
                                                      description list */
+    dvbpsi_bat_ts_t *       p_last_ts;          /*!< last TS of the list */
+    dvbpsi_arena_t *        p_arena;            /*!< arena of the TS and descriptors */
+    dvbpsi_psi_section_t *  p_sections;         /*!< retained sections, or NULL */
 
 } dvbpsi_bat_t;
 
@@ -142,6 +148,46 @@ bool dvbpsi_bat_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
  */
 void dvbpsi_bat_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extension);
 
+/*****************************************************************************
+ * dvbpsi_bat_family_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_bat_family_attach(dvbpsi_t *p_dvbpsi,
+                                      uint8_t i_first_table_id,
+                                      uint8_t i_last_table_id,
+                                      dvbpsi_bat_callback pf_callback,
+                                      void* p_cb_data)
+ * \brief Creation and initialization of a BAT decoder of every subtable
+ * whose table_id is in a range, whatever its extension.
+ * \param p_dvbpsi pointer to dvbpsi to hold decoder/demuxer structure
+ * \param i_first_table_id first table id, 0x4a
+ * \param i_last_table_id last table id, 0x4a
+ * \param pf_callback function to call back on every new BAT
+ * \param p_cb_data private data given in argument to the callback.
+ * \return true on success, false on failure
+ *
+ * The subtables are delivered to pf_callback as with one dvbpsi_bat_attach()
+ * per subtable, but only the subtables being received have a decoder: the
+ * others take a few bytes each. Subtables with a decoder of their own keep
+ * it, and the new subtable callback of the demux is no longer called for
+ * these table ids.
+ */
+bool dvbpsi_bat_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_bat_callback pf_callback, void* p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_bat_family_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_bat_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+ * \brief Destroy a BAT decoder of a range of table ids.
+ * \param p_dvbpsi pointer holding decoder/demuxer structure
+ * \param i_table_id any table id of the range
+ * \return nothing.
+ */
+void dvbpsi_bat_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id);
+
 /*****************************************************************************
  * dvbpsi_bat_init/dvbpsi_bat_new
  *****************************************************************************/
@@ -168,6 +214,8 @@ void dvbpsi_bat_init(dvbpsi_bat_t *p_bat, uint8_t i_table_id, uint16_t i_extensi
  * \param i_version BAT version
  * \param b_current_next current next indicator
  * \return p_bat pointer to the BAT structure
+ *
+ * The TS and the descriptors are carved from an arena owned by the BAT.
  */
 dvbpsi_bat_t *dvbpsi_bat_new(uint8_t i_table_id, uint16_t i_extension,
                              uint8_t i_version, bool b_current_next);
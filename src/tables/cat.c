@@ -107,6 +107,9 @@ void dvbpsi_cat_init(dvbpsi_cat_t* p_cat, uint8_t i_version, bool b_current_next
     p_cat->i_version = i_version;
     p_cat->b_current_next = b_current_next;
     p_cat->p_first_descriptor = NULL;
+    p_cat->p_last_descriptor = NULL;
+    p_cat->p_arena = NULL;
+    p_cat->p_sections = NULL;
 }
 
 /*****************************************************************************
@@ -118,7 +121,10 @@ dvbpsi_cat_t *dvbpsi_cat_new(uint8_t i_version, bool b_current_next)
 {
     dvbpsi_cat_t *p_cat = (dvbpsi_cat_t*)malloc(sizeof(dvbpsi_cat_t));
     if (p_cat != NULL)
+    {
         dvbpsi_cat_init(p_cat, i_version, b_current_next);
+        p_cat->p_arena = dvbpsi_NewArena();
+    }
     return p_cat;
 }
 
@@ -129,8 +135,12 @@ dvbpsi_cat_t *dvbpsi_cat_new(uint8_t i_version, bool b_current_next)
  *****************************************************************************/
 void dvbpsi_cat_empty(dvbpsi_cat_t* p_cat)
 {
-    dvbpsi_DeleteDescriptors(p_cat->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_cat->p_arena, p_cat->p_first_descriptor);
+    dvbpsi_ResetArena(p_cat->p_arena);
+    dvbpsi_DeletePSISections(p_cat->p_sections);
+    p_cat->p_sections = NULL;
     p_cat->p_first_descriptor = NULL;
+    p_cat->p_last_descriptor = NULL;
 }
 
 /*****************************************************************************
@@ -141,7 +151,10 @@ void dvbpsi_cat_empty(dvbpsi_cat_t* p_cat)
 void dvbpsi_cat_delete(dvbpsi_cat_t *p_cat)
 {
     if (p_cat)
+    {
         dvbpsi_cat_empty(p_cat);
+        dvbpsi_DeleteArena(p_cat->p_arena);
+    }
     free(p_cat);
 }
 
@@ -155,12 +168,13 @@ dvbpsi_descriptor_t* dvbpsi_cat_descriptor_add(dvbpsi_cat_t* p_cat,
                                              uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_cat->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_cat->p_first_descriptor = dvbpsi_AddDescriptor(p_cat->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_cat->p_first_descriptor,
+                            &p_cat->p_last_descriptor, p_descriptor);
     assert(p_cat->p_first_descriptor);
     if (p_cat->p_first_descriptor == NULL)
         return NULL;
@@ -321,8 +335,14 @@ void dvbpsi_cat_sections_gather(dvbpsi_t *p_dvbpsi,
         p_cat_decoder->current_cat = *p_cat_decoder->p_building_cat;
         p_cat_decoder->b_current_valid = true;
         /* Decode the sections */
-        dvbpsi_cat_sections_decode(p_cat_decoder->p_building_cat,
-                                   p_cat_decoder->p_sections);
+        dvbpsi_psi_section_t *p_sections = p_cat_decoder->p_sections;
+        if (p_dvbpsi->p_decoder->b_retain_sections)
+        {
+            /* The table keeps its sections, its descriptors point into them */
+            p_cat_decoder->p_building_cat->p_sections = p_sections;
+            p_cat_decoder->p_sections = NULL;
+        }
+        dvbpsi_cat_sections_decode(p_cat_decoder->p_building_cat, p_sections);
         /* signal the new CAT */
         p_cat_decoder->pf_cat_callback(p_cat_decoder->p_cb_data,
                                        p_cat_decoder->p_building_cat);
@@ -345,6 +365,14 @@ void dvbpsi_cat_sections_decode(dvbpsi_cat_t* p_cat, dvbpsi_psi_section_t* p_sec
     {
         /* CAT descriptors */
         p_byte = p_section->p_payload_start;
+        if (p_cat->p_sections != NULL
+         && dvbpsi_AppendDescriptorViews(p_cat->p_arena, &p_cat->p_first_descriptor,
+                                         &p_cat->p_last_descriptor, p_byte,
+                                         p_section->p_payload_end - p_byte))
+        {
+            p_section = p_section->p_next;
+            continue;
+        }
         while (p_byte <= p_section->p_payload_end)
         {
             uint8_t i_tag = p_byte[0];
@@ -364,7 +392,7 @@ void dvbpsi_cat_sections_decode(dvbpsi_cat_t* p_cat, dvbpsi_psi_section_t* p_sec
  *****************************************************************************/
 dvbpsi_psi_section_t* dvbpsi_cat_sections_generate(dvbpsi_t* p_dvbpsi, dvbpsi_cat_t* p_cat)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_descriptor_t* p_descriptor = p_cat->p_first_descriptor;
@@ -389,7 +417,7 @@ dvbpsi_psi_section_t* dvbpsi_cat_sections_generate(dvbpsi_t* p_dvbpsi, dvbpsi_ca
                                 + p_descriptor->i_length > 1018)
         {
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x01;
@@ -60,6 +60,9 @@ typedef struct dvbpsi_cat_s
   bool                      b_current_next;     /*!< current_next_indicator */
 
   dvbpsi_descriptor_t *     p_first_descriptor; /*!< descriptor list */
+  dvbpsi_descriptor_t *     p_last_descriptor;  /*!< last descriptor of the list */
+  dvbpsi_arena_t *          p_arena;            /*!< arena of the descriptors */
+  dvbpsi_psi_section_t *    p_sections;         /*!< retained sections, or NULL */
 
 } dvbpsi_cat_t;
 
@@ -124,6 +127,8 @@ void dvbpsi_cat_init(dvbpsi_cat_t* p_cat,
  * \param i_version CAT version
  * \param b_current_next current next indicator
  * \return p_cat pointer to the CAT structure
+ *
+ * The descriptors are carved from an arena owned by the CAT.
  */
 dvbpsi_cat_t *dvbpsi_cat_new(uint8_t i_version, bool b_current_next);
 
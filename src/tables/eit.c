@@ -49,6 +49,46 @@
 #include "eit.h"
 #include "eit_private.h"
 
+/*****************************************************************************
+ * dvbpsi_eit_sections_peek
+ *****************************************************************************
+ * Tell if a section belongs to the EIT already decoded, given its header.
+ *****************************************************************************/
+static bool dvbpsi_eit_sections_peek(dvbpsi_decoder_t *p_decoder, const uint8_t *p_header)
+{
+    dvbpsi_eit_decoder_t *p_eit_decoder = (dvbpsi_eit_decoder_t *)p_decoder;
+
+    return (p_eit_decoder->p_building_eit == NULL)
+        && (p_eit_decoder->b_current_valid)
+        && (p_eit_decoder->current_eit.i_version == ((p_header[5] & 0x3e) >> 1))
+        && (p_eit_decoder->current_eit.b_current_next == ((p_header[5] & 0x01) != 0));
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_decoder_new
+ *****************************************************************************
+ * Allocate an EIT decoder, of a subtable or of a family.
+ *****************************************************************************/
+static dvbpsi_eit_decoder_t *dvbpsi_eit_decoder_new(dvbpsi_eit_callback pf_callback,
+                                                  void *p_cb_data)
+{
+    dvbpsi_eit_decoder_t *p_eit_decoder;
+    p_eit_decoder = (dvbpsi_eit_decoder_t *) dvbpsi_decoder_new(NULL,
+                                             0, true, sizeof(dvbpsi_eit_decoder_t));
+    if (p_eit_decoder == NULL)
+        return NULL;
+
+    /* EIT decoder information */
+    p_eit_decoder->pf_eit_callback = pf_callback;
+    p_eit_decoder->p_cb_data = p_cb_data;
+    p_eit_decoder->p_building_eit = NULL;
+    p_eit_decoder->pf_peek = dvbpsi_eit_sections_peek;
+    p_eit_decoder->i_delivery = DVBPSI_EIT_DELIVER_TABLE;
+    p_eit_decoder->pf_complete_callback = NULL;
+
+    return p_eit_decoder;
+}
+
 /*****************************************************************************
  * dvbpsi_eit_attach
  *****************************************************************************
@@ -71,9 +111,7 @@ bool dvbpsi_eit_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
         return false;
     }
 
-    dvbpsi_eit_decoder_t*  p_eit_decoder;
-    p_eit_decoder = (dvbpsi_eit_decoder_t*) dvbpsi_decoder_new(NULL,
-                                             0, true, sizeof(dvbpsi_eit_decoder_t));
+    dvbpsi_eit_decoder_t*  p_eit_decoder = dvbpsi_eit_decoder_new(pf_callback, p_cb_data);
     if (p_eit_decoder == NULL)
         return false;
 
@@ -90,11 +128,6 @@ bool dvbpsi_eit_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
     /* Attach the subtable decoder to the demux */
     dvbpsi_AttachDemuxSubDecoder(p_demux, p_subdec);
 
-    /* EIT decoder information */
-    p_eit_decoder->pf_eit_callback = pf_callback;
-    p_eit_decoder->p_cb_data = p_cb_data;
-    p_eit_decoder->p_building_eit = NULL;
-
     return true;
 }
 
@@ -132,6 +165,105 @@ void dvbpsi_eit_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
     dvbpsi_DeleteDemuxSubDecoder(p_subdec);
 }
 
+/*****************************************************************************
+ * dvbpsi_eit_family_new
+ *****************************************************************************
+ * Create the decoder of a subtable of an EIT family.
+ *****************************************************************************/
+static dvbpsi_decoder_t *dvbpsi_eit_family_new(dvbpsi_demux_family_t *p_family,
+                                              uint8_t i_table_id, uint16_t i_extension)
+{
+    (void)i_table_id;
+    (void)i_extension;
+
+    dvbpsi_eit_callback pf_callback = (dvbpsi_eit_callback)p_family->pf_table_callback;
+    return DVBPSI_DECODER(dvbpsi_eit_decoder_new(pf_callback, p_family->p_cb_data));
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_family_delete
+ *****************************************************************************
+ * Destroy the decoder of a subtable of an EIT family.
+ *****************************************************************************/
+static void dvbpsi_eit_family_delete(dvbpsi_decoder_t *p_decoder)
+{
+    dvbpsi_eit_decoder_t *p_eit_decoder = (dvbpsi_eit_decoder_t *)p_decoder;
+    if (p_eit_decoder->p_building_eit)
+        dvbpsi_eit_delete(p_eit_decoder->p_building_eit);
+
+    dvbpsi_decoder_delete(p_decoder);
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_family_attach
+ *****************************************************************************
+ * Initialize an EIT decoder of a range of table ids and any extension.
+ *****************************************************************************/
+bool dvbpsi_eit_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_eit_callback pf_callback, void* p_cb_data)
+{
+    return dvbpsi_AddDemuxFamily(p_dvbpsi, "EIT decoder", i_first_table_id,
+                                 i_last_table_id, dvbpsi_eit_sections_gather,
+                                 dvbpsi_eit_family_new, dvbpsi_eit_family_delete,
+                                 (dvbpsi_demux_family_table_cb_t)pf_callback, p_cb_data);
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_family_detach
+ *****************************************************************************
+ * Close an EIT decoder of a range of table ids.
+ *****************************************************************************/
+void dvbpsi_eit_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+{
+    dvbpsi_RemoveDemuxFamily(p_dvbpsi, "EIT decoder", i_table_id,
+                             dvbpsi_eit_family_new);
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_delivery
+ *****************************************************************************
+ * Choose when the events of an EIT subtable are delivered.
+ *****************************************************************************/
+bool dvbpsi_eit_delivery(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extension,
+                         dvbpsi_eit_delivery_t i_delivery,
+                         dvbpsi_eit_complete_callback pf_complete)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *) p_dvbpsi->p_decoder;
+
+    dvbpsi_demux_subdec_t* p_subdec;
+    p_subdec = dvbpsi_demuxGetSubDec(p_demux, i_table_id, i_extension);
+    if (p_subdec == NULL)
+    {
+        dvbpsi_error(p_dvbpsi, "EIT Decoder",
+                     "No such EIT decoder (table_id == 0x%02x,"
+                     "extension == 0x%02x)",
+                     i_table_id, i_extension);
+        return false;
+    }
+
+    dvbpsi_eit_decoder_t* p_eit_decoder;
+    p_eit_decoder = (dvbpsi_eit_decoder_t*)p_subdec->p_decoder;
+
+    /* Start over with the subtable being built */
+    if (p_eit_decoder->i_delivery != i_delivery)
+    {
+        if (p_eit_decoder->p_building_eit)
+            dvbpsi_eit_delete(p_eit_decoder->p_building_eit);
+        p_eit_decoder->p_building_eit = NULL;
+        dvbpsi_decoder_reset(DVBPSI_DECODER(p_eit_decoder), true);
+        memset(p_eit_decoder->i_delivered, 0, sizeof(p_eit_decoder->i_delivered));
+    }
+
+    p_eit_decoder->i_delivery = i_delivery;
+    p_eit_decoder->pf_complete_callback = pf_complete;
+
+    return true;
+}
+
 /*****************************************************************************
  * dvbpsi_eit_init
  *****************************************************************************
@@ -152,6 +284,10 @@ void dvbpsi_eit_init(dvbpsi_eit_t* p_eit, uint8_t i_table_id, uint16_t i_extensi
     p_eit->i_segment_last_section_number = i_segment_last_section_number;
     p_eit->i_last_table_id = i_last_table_id;
     p_eit->p_first_event = NULL;
+    p_eit->p_last_event = NULL;
+    p_eit->p_arena = NULL;
+    p_eit->p_sections = NULL;
+    p_eit->p_delta = NULL;
 }
 
 /*****************************************************************************
@@ -166,9 +302,12 @@ dvbpsi_eit_t* dvbpsi_eit_new(uint8_t i_table_id, uint16_t i_extension,
 {
     dvbpsi_eit_t *p_eit = (dvbpsi_eit_t*)malloc(sizeof(dvbpsi_eit_t));
     if (p_eit != NULL)
+    {
         dvbpsi_eit_init(p_eit, i_table_id, i_extension, i_version,
                         b_current_next, i_ts_id, i_network_id, i_segment_last_section_number,
                         i_last_table_id);
+        p_eit->p_arena = dvbpsi_NewArena();
+    }
     return p_eit;
 }
 
@@ -184,11 +323,17 @@ void dvbpsi_eit_empty(dvbpsi_eit_t* p_eit)
     while(p_event != NULL)
     {
         dvbpsi_eit_event_t* p_tmp = p_event->p_next;
-        dvbpsi_DeleteDescriptors(p_event->p_first_descriptor);
-        free(p_event);
+        dvbpsi_DeleteArenaDescriptors(p_eit->p_arena, p_event->p_first_descriptor);
+        if (p_eit->p_arena == NULL)
+            free(p_event);
         p_event = p_tmp;
     }
+    dvbpsi_ResetArena(p_eit->p_arena);
+    dvbpsi_DeletePSISections(p_eit->p_sections);
+    p_eit->p_sections = NULL;
+    p_eit->p_delta = NULL;
     p_eit->p_first_event = NULL;
+    p_eit->p_last_event = NULL;
 }
 
 /*****************************************************************************
@@ -199,7 +344,10 @@ void dvbpsi_eit_empty(dvbpsi_eit_t* p_eit)
 void dvbpsi_eit_delete(dvbpsi_eit_t* p_eit)
 {
     if (p_eit)
+    {
         dvbpsi_eit_empty(p_eit);
+        dvbpsi_DeleteArena(p_eit->p_arena);
+    }
     free(p_eit);
 }
 
@@ -213,7 +361,8 @@ dvbpsi_eit_event_t* dvbpsi_eit_event_add(dvbpsi_eit_t* p_eit,
     uint8_t i_running_status, bool b_free_ca, uint16_t i_event_descriptor_length)
 {
     dvbpsi_eit_event_t* p_event;
-    p_event = (dvbpsi_eit_event_t*)calloc(1,sizeof(dvbpsi_eit_event_t));
+    p_event = (dvbpsi_eit_event_t*)dvbpsi_ArenaAlloc(p_eit->p_arena,
+                                                     sizeof(dvbpsi_eit_event_t));
     if (p_event == NULL)
         return NULL;
 
@@ -227,16 +376,21 @@ dvbpsi_eit_event_t* dvbpsi_eit_event_add(dvbpsi_eit_t* p_eit,
     p_event->p_next = NULL;
     p_event->i_descriptors_length = i_event_descriptor_length;
     p_event->p_first_descriptor = NULL;
+    p_event->p_last_descriptor = NULL;
+    p_event->p_arena = p_eit->p_arena;
 
     if (p_eit->p_first_event == NULL)
         p_eit->p_first_event = p_event;
     else
     {
-        dvbpsi_eit_event_t* p_last_event = p_eit->p_first_event;
+        dvbpsi_eit_event_t* p_last_event = p_eit->p_last_event;
+        if (p_last_event == NULL)
+            p_last_event = p_eit->p_first_event;
         while(p_last_event->p_next != NULL)
             p_last_event = p_last_event->p_next;
         p_last_event->p_next = p_event;
     }
+    p_eit->p_last_event = p_event;
     return p_event;
 }
 
@@ -262,12 +416,13 @@ dvbpsi_descriptor_t* dvbpsi_eit_event_descriptor_add(dvbpsi_eit_event_t* p_event
     uint8_t i_tag, uint8_t i_length, uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor;
-    p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    p_descriptor = dvbpsi_NewArenaDescriptor(p_event->p_arena, i_tag,
+                                             i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_event->p_first_descriptor = dvbpsi_AddDescriptor(p_event->p_first_descriptor,
-                                                       p_descriptor);
+    dvbpsi_AppendDescriptor(&p_event->p_first_descriptor,
+                            &p_event->p_last_descriptor, p_descriptor);
     assert(p_event->p_first_descriptor);
     if (p_event->p_first_descriptor == NULL)
         return NULL;
@@ -281,6 +436,7 @@ static void dvbpsi_ReInitEIT(dvbpsi_eit_decoder_t* p_decoder, const bool b_force
     assert(p_decoder);
 
     dvbpsi_decoder_reset(DVBPSI_DECODER(p_decoder), b_force);
+    memset(p_decoder->i_delivered, 0, sizeof(p_decoder->i_delivered));
 
     if (b_force)
     {
@@ -291,6 +447,88 @@ static void dvbpsi_ReInitEIT(dvbpsi_eit_decoder_t* p_decoder, const bool b_force
     p_decoder->p_building_eit = NULL;
 }
 
+/*****************************************************************************
+ * dvbpsi_DeliverEIT
+ *****************************************************************************
+ * Hand the events of the section 'i_number', or of its segment, to the
+ * application as soon as they are received.
+ *****************************************************************************/
+static void dvbpsi_DeliverEIT(dvbpsi_eit_decoder_t* p_eit_decoder, const uint8_t i_number)
+{
+    uint32_t *p_delivered = p_eit_decoder->i_delivered;
+    if (p_delivered[i_number >> 5] & ((uint32_t)1 << (i_number & 31)))
+        return;
+
+    dvbpsi_psi_section_t **pp_slots = p_eit_decoder->pp_section_slots;
+    const uint32_t *p_received = p_eit_decoder->i_sections_received;
+    int i_first = i_number, i_last = i_number;
+
+    if (p_eit_decoder->i_delivery == DVBPSI_EIT_DELIVER_SEGMENT)
+    {
+        /* A segment holds up to 8 sections, up to segment_last_section_number */
+        i_first = i_number & ~7;
+        i_last = pp_slots[i_number]->p_payload_start[4];
+        if (i_last < i_number || i_last > i_first + 7)
+            i_last = i_number;
+        for (int i = i_first; i <= i_last; i++)
+        {
+            if (!(p_received[i >> 5] & ((uint32_t)1 << (i & 31))))
+                return;
+        }
+    }
+
+    const dvbpsi_eit_t *p_building = p_eit_decoder->p_building_eit;
+    dvbpsi_eit_t *p_eit = dvbpsi_eit_new(p_building->i_table_id, p_building->i_extension,
+                                         p_building->i_version, p_building->b_current_next,
+                                         p_building->i_ts_id, p_building->i_network_id,
+                                         pp_slots[i_number]->p_payload_start[4],
+                                         p_building->i_last_table_id);
+    if (p_eit == NULL)
+        return;
+
+    for (int i = i_first; i <= i_last; i++)
+    {
+        dvbpsi_psi_section_t *p_next = pp_slots[i]->p_next;
+        pp_slots[i]->p_next = NULL;
+        dvbpsi_eit_sections_decode(p_eit, pp_slots[i]);
+        pp_slots[i]->p_next = p_next;
+        p_delivered[i >> 5] |= (uint32_t)1 << (i & 31);
+    }
+
+    p_eit_decoder->pf_eit_callback(p_eit_decoder->p_cb_data, p_eit);
+}
+
+/*****************************************************************************
+ * dvbpsi_IsDeliveredEIT
+ *****************************************************************************
+ * Whether the events of all the sections received so far were handed to the
+ * application, and the segments of these sections have no missing section.
+ *****************************************************************************/
+static bool dvbpsi_IsDeliveredEIT(const dvbpsi_eit_decoder_t* p_eit_decoder)
+{
+    const uint32_t *p_received = p_eit_decoder->i_sections_received;
+    const uint32_t *p_delivered = p_eit_decoder->i_delivered;
+
+    for (int i = 0; i < 256; i++)
+    {
+        if (!(p_received[i >> 5] & ((uint32_t)1 << (i & 31))))
+            continue;
+        if (!(p_delivered[i >> 5] & ((uint32_t)1 << (i & 31))))
+            return false;
+
+        /* Same segment bounds as dvbpsi_DeliverEIT() */
+        int i_last = p_eit_decoder->pp_section_slots[i]->p_payload_start[4];
+        if (i_last < i || i_last > (i | 7))
+            i_last = i;
+        for (int j = i + 1; j <= i_last; j++)
+        {
+            if (!(p_received[j >> 5] & ((uint32_t)1 << (j & 31))))
+                return false;
+        }
+    }
+    return true;
+}
+
 static bool dvbpsi_CheckEIT(dvbpsi_t *p_dvbpsi, dvbpsi_eit_decoder_t *p_eit_decoder,
                             dvbpsi_psi_section_t *p_section)
 {
@@ -326,7 +564,7 @@ static bool dvbpsi_CheckEIT(dvbpsi_t *p_dvbpsi, dvbpsi_eit_decoder_t *p_eit_deco
     return b_reinit;
 }
 
-static bool dvbpsi_IsCompleteEIT(dvbpsi_eit_decoder_t* p_eit_decoder, dvbpsi_psi_section_t* p_section)
+static bool dvbpsi_IsCompleteEIT(dvbpsi_eit_decoder_t* p_eit_decoder, const uint8_t i_number)
 {
     assert(p_eit_decoder);
 
@@ -341,10 +579,10 @@ static bool dvbpsi_IsCompleteEIT(dvbpsi_eit_decoder_t* p_eit_decoder, dvbpsi_psi
      * this is the only way to be sure that a complete table has been
      * sent! */
     if ((p_eit_decoder->i_first_received_section_number > 0 &&
-        (p_section->i_number == p_eit_decoder->i_first_received_section_number ||
-         p_section->i_number == p_eit_decoder->i_first_received_section_number - 1)) ||
+        (i_number == p_eit_decoder->i_first_received_section_number ||
+         i_number == p_eit_decoder->i_first_received_section_number - 1)) ||
         (p_eit_decoder->i_first_received_section_number == 0 &&
-         p_section->i_number == p_eit_decoder->i_last_section_number))
+         i_number == p_eit_decoder->i_last_section_number))
     {
         dvbpsi_psi_section_t *p = p_eit_decoder->p_sections;
         while (p)
@@ -473,7 +711,8 @@ void dvbpsi_eit_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_private_
         }
     }
 
-    /* Add section to EIT */
+    /* Add section to EIT, p_section belongs to the decoder afterwards */
+    const uint8_t i_number = p_section->i_number;
     if (!dvbpsi_AddSectionEIT(p_dvbpsi, p_eit_decoder, p_section))
     {
         dvbpsi_error(p_dvbpsi, "EIT decoder", "failed decoding section %d",
@@ -483,27 +722,67 @@ void dvbpsi_eit_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_private_
     }
 
     /* Check if we have all the sections */
-    /* FIXME: p_section has just been added to the p_eit_decoder,
-     * Why do we have to explicitly check against it in dvbpsi_IsCompleteEIT() ?
-     */
-    if (dvbpsi_IsCompleteEIT(p_eit_decoder, p_section))
+    const bool b_complete = dvbpsi_IsCompleteEIT(p_eit_decoder, i_number);
+
+    switch (p_eit_decoder->i_delivery)
     {
-        assert(p_eit_decoder->pf_eit_callback);
+        case DVBPSI_EIT_DELIVER_SECTION:
+        case DVBPSI_EIT_DELIVER_SEGMENT:
+            /* Deliver the new events right away */
+            dvbpsi_DeliverEIT(p_eit_decoder, i_number);
+
+            /* A segment still missing sections keeps the version open, its
+             * events come with the next repetition */
+            if (!b_complete || !dvbpsi_IsDeliveredEIT(p_eit_decoder))
+                break;
 
-        /* Save the current information */
-        p_eit_decoder->current_eit = *p_eit_decoder->p_building_eit;
-        p_eit_decoder->b_current_valid = true;
+            /* Save the current information, the events were delivered */
+            p_eit_decoder->current_eit = *p_eit_decoder->p_building_eit;
+            p_eit_decoder->b_current_valid = true;
 
-        /* Decode the sections */
-        dvbpsi_eit_sections_decode(p_eit_decoder->p_building_eit,
-                                   p_eit_decoder->p_sections);
+            if (p_eit_decoder->pf_complete_callback)
+                p_eit_decoder->pf_complete_callback(p_eit_decoder->p_cb_data,
+                                                    p_eit_decoder->current_eit.i_table_id,
+                                                    p_eit_decoder->current_eit.i_extension,
+                                                    p_eit_decoder->current_eit.i_version);
 
-        /* signal the new EIT */
-        p_eit_decoder->pf_eit_callback(p_eit_decoder->p_cb_data, p_eit_decoder->p_building_eit);
+            /* Delete sections and Reinitialize the structures */
+            dvbpsi_eit_delete(p_eit_decoder->p_building_eit);
+            dvbpsi_ReInitEIT(p_eit_decoder, false);
+            break;
 
-        /* Delete sections and Reinitialize the structures */
-        dvbpsi_ReInitEIT(p_eit_decoder, false);
-        assert(p_eit_decoder->p_sections == NULL);
+        case DVBPSI_EIT_DELIVER_TABLE:
+        default:
+            if (!b_complete)
+                break;
+
+            assert(p_eit_decoder->pf_eit_callback);
+
+            /* Save the current information */
+            p_eit_decoder->current_eit = *p_eit_decoder->p_building_eit;
+            p_eit_decoder->b_current_valid = true;
+
+            /* Decode the sections */
+            dvbpsi_psi_section_t *p_sections = p_eit_decoder->p_sections;
+            if (p_dvbpsi->p_decoder->b_retain_sections)
+            {
+                /* The table keeps its sections, its descriptors point into them */
+                p_eit_decoder->p_building_eit->p_sections = p_sections;
+                p_eit_decoder->p_sections = NULL;
+            }
+            dvbpsi_eit_sections_decode(p_eit_decoder->p_building_eit, p_sections);
+            if (p_dvbpsi->p_decoder->b_delta)
+                p_eit_decoder->p_building_eit->p_delta =
+                    dvbpsi_decoder_psi_sections_delta(DVBPSI_DECODER(p_eit_decoder),
+                            p_eit_decoder->p_building_eit->p_arena, p_sections);
+
+            /* signal the new EIT */
+            p_eit_decoder->pf_eit_callback(p_eit_decoder->p_cb_data, p_eit_decoder->p_building_eit);
+
+            /* Delete sections and Reinitialize the structures */
+            dvbpsi_ReInitEIT(p_eit_decoder, false);
+            assert(p_eit_decoder->p_sections == NULL);
+            break;
     }
 }
 
@@ -549,6 +828,10 @@ void dvbpsi_eit_sections_decode(dvbpsi_eit_t* p_eit,
             uint8_t *p_ev_end = p_byte + i_ev_length;
             if (p_ev_end > p_section->p_payload_end)
                 p_ev_end = p_section->p_payload_end;
+            if (p_eit->p_sections != NULL
+             && dvbpsi_AppendDescriptorViews(p_eit->p_arena, &p_event->p_first_descriptor,
+                                             &p_event->p_last_descriptor, p_byte, p_ev_end - p_byte))
+                p_byte = p_ev_end;
             while (p_byte < p_ev_end)
             {
                 uint8_t i_tag = p_byte[0];
@@ -568,10 +851,10 @@ void dvbpsi_eit_sections_decode(dvbpsi_eit_t* p_eit,
  * Helper function which allocates a initializes a new PSI section suitable
  * for carrying EIT data.
  *****************************************************************************/
-static dvbpsi_psi_section_t* NewEITSection(dvbpsi_eit_t* p_eit, int i_table_id,
-                                           int i_section_number)
+static dvbpsi_psi_section_t* NewEITSection(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t* p_eit,
+                                           int i_table_id, int i_section_number)
 {
-  dvbpsi_psi_section_t *p_result = dvbpsi_NewPSISection(4094);
+  dvbpsi_psi_section_t *p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 4094);
 
   p_result->i_table_id = i_table_id;
   p_result->b_syntax_indicator = 1;
@@ -608,7 +891,7 @@ static dvbpsi_psi_section_t* NewEITSection(dvbpsi_eit_t* p_eit, int i_table_id,
  *****************************************************************************
  * Helper function which encodes an EIT event header in a byte buffer.
  *****************************************************************************/
-static inline void EncodeEventHeaders(dvbpsi_eit_event_t *p_event, uint8_t *buf)
+static inline void EncodeEventHeaders(const dvbpsi_eit_event_t *p_event, uint8_t *buf)
 {
   /* event_id */
   buf[0] = p_event->i_event_id >> 8;
@@ -641,7 +924,7 @@ static inline void EncodeEventHeaders(dvbpsi_eit_event_t *p_event, uint8_t *buf)
 dvbpsi_psi_section_t* dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t *p_eit,
                                             uint8_t i_table_id)
 {
-  dvbpsi_psi_section_t *p_result = NewEITSection (p_eit, i_table_id, 0);
+  dvbpsi_psi_section_t *p_result = NewEITSection (p_dvbpsi, p_eit, i_table_id, 0);
   dvbpsi_psi_section_t *p_current = p_result;
   uint8_t i_last_section_number = 0;
   dvbpsi_eit_event_t *p_event;
@@ -667,7 +950,7 @@ dvbpsi_psi_section_t* dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ei
       {
         dvbpsi_psi_section_t *p_prev = p_current;
 
-        p_current = NewEITSection (p_eit, i_table_id, ++i_last_section_number);
+        p_current = NewEITSection (p_dvbpsi, p_eit, i_table_id, ++i_last_section_number);
         p_event_start = p_current->p_payload_end;
         p_prev->p_next = p_current;
 
@@ -722,3 +1005,90 @@ dvbpsi_psi_section_t* dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ei
 
   return p_result;
 }
+
+/*****************************************************************************
+ * NextEITEvent
+ *****************************************************************************/
+static const void *NextEITEvent(const void *p_entry)
+{
+  return ((const dvbpsi_eit_event_t *)p_entry)->p_next;
+}
+
+/*****************************************************************************
+ * EncodeEITEvent
+ *****************************************************************************
+ * Encode an event with as many of its descriptors as fit in i_room bytes.
+ *****************************************************************************/
+static size_t EncodeEITEvent(dvbpsi_t *p_dvbpsi, const void *p_entry,
+                             uint8_t *p_buffer, size_t i_room)
+{
+  const dvbpsi_eit_event_t *p_event = (const dvbpsi_eit_event_t *)p_entry;
+  const dvbpsi_descriptor_t *p_descriptor = p_event->p_first_descriptor;
+  size_t i_length = 12;
+
+  if (p_buffer == NULL)
+  {
+    for (; p_descriptor; p_descriptor = p_descriptor->p_next)
+      i_length += p_descriptor->i_length + 2;
+    return i_length;
+  }
+
+  EncodeEventHeaders(p_event, p_buffer);
+
+  for (; p_descriptor; p_descriptor = p_descriptor->p_next)
+  {
+    if (i_length + p_descriptor->i_length + 2 > i_room)
+    {
+      dvbpsi_error(p_dvbpsi, "EIT generator", "too many descriptors in event, "
+                             "unable to carry all the descriptors");
+      break;
+    }
+
+    p_buffer[i_length] = p_descriptor->i_tag;
+    p_buffer[i_length + 1] = p_descriptor->i_length;
+    memcpy(p_buffer + i_length + 2, p_descriptor->p_data, p_descriptor->i_length);
+    i_length += p_descriptor->i_length + 2;
+  }
+
+  /* descriptors_loop_length */
+  p_buffer[10] |= ((i_length - 12) >> 8) & 0x0f;
+  p_buffer[11] = i_length - 12;
+
+  return i_length;
+}
+
+/*****************************************************************************
+ * EITSectionHeader
+ *****************************************************************************/
+static void EITSectionHeader(const void *p_table, dvbpsi_psi_section_t *p_section)
+{
+  const dvbpsi_eit_t *p_eit = (const dvbpsi_eit_t *)p_table;
+
+  p_section->p_data[8] = p_eit->i_ts_id >> 8;
+  p_section->p_data[9] = p_eit->i_ts_id;
+  p_section->p_data[10] = p_eit->i_network_id >> 8;
+  p_section->p_data[11] = p_eit->i_network_id;
+  p_section->p_data[12] = p_section->i_last_number;
+  p_section->p_data[13] = p_eit->i_last_table_id;
+}
+
+static const dvbpsi_psi_section_layout_t eit_layout =
+{
+  14, 4090, true, NextEITEvent, EncodeEITEvent, EITSectionHeader
+};
+
+/*****************************************************************************
+ * dvbpsi_eit_sections_update
+ *****************************************************************************
+ * Generate EIT sections, encoding only the events that changed since the
+ * last update of the cache.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_psi_section_cache_t *p_cache,
+                                                 dvbpsi_eit_t *p_eit, uint8_t i_table_id)
+{
+  return dvbpsi_UpdatePSISectionCache(p_dvbpsi, p_cache, &eit_layout, p_eit,
+                                      p_eit->p_first_event, i_table_id,
+                                      p_eit->i_extension, p_eit->b_current_next,
+                                      &p_eit->i_version);
+}
@@ -64,6 +64,8 @@ typedef struct dvbpsi_eit_event_s
                                                          length */
   dvbpsi_descriptor_t *     p_first_descriptor;     /*!< First of the following
                                                          DVB descriptors */
+  dvbpsi_descriptor_t *     p_last_descriptor;      /*!< last descriptor of the list */
+  dvbpsi_arena_t *          p_arena;                /*!< arena of the EIT */
 
   struct dvbpsi_eit_event_s * p_next;               /*!< next element of
                                                              the list */
@@ -97,6 +99,10 @@ typedef struct dvbpsi_eit_s
     uint8_t             i_last_table_id;    /*!< last table id */
 
     dvbpsi_eit_event_t *p_first_event;      /*!< event information list */
+    dvbpsi_eit_event_t *p_last_event;       /*!< last event of the list */
+    dvbpsi_arena_t     *p_arena;            /*!< arena of the events and descriptors */
+    dvbpsi_psi_section_t *p_sections;       /*!< retained sections, or NULL */
+    dvbpsi_delta_t       *p_delta;          /*!< changes since the previous version */
 
 } dvbpsi_eit_t;
 
@@ -109,6 +115,38 @@ typedef struct dvbpsi_eit_s
  */
 typedef void (* dvbpsi_eit_callback)(void* p_cb_data, dvbpsi_eit_t* p_new_eit);
 
+/*****************************************************************************
+ * dvbpsi_eit_delivery_t
+ *****************************************************************************/
+/*!
+ * \enum dvbpsi_eit_delivery_e
+ * \brief When the events of an EIT subtable are handed to the application.
+ */
+/*!
+ * \typedef enum dvbpsi_eit_delivery_e dvbpsi_eit_delivery_t
+ * \brief dvbpsi_eit_delivery_t type definition.
+ */
+typedef enum dvbpsi_eit_delivery_e
+{
+    DVBPSI_EIT_DELIVER_TABLE = 0, /*!< all the events once the subtable is complete */
+    DVBPSI_EIT_DELIVER_SECTION,   /*!< the events of each section */
+    DVBPSI_EIT_DELIVER_SEGMENT,   /*!< the events of each complete segment */
+} dvbpsi_eit_delivery_t;
+
+/*****************************************************************************
+ * dvbpsi_eit_complete_callback
+ *****************************************************************************/
+/*!
+ * \typedef void (* dvbpsi_eit_complete_callback)(void* p_cb_data,
+                                                  uint8_t i_table_id,
+                                                  uint16_t i_extension,
+                                                  uint8_t i_version)
+ * \brief Callback type telling that all the events of a version of an EIT
+ * subtable were delivered.
+ */
+typedef void (* dvbpsi_eit_complete_callback)(void* p_cb_data, uint8_t i_table_id,
+                                              uint16_t i_extension, uint8_t i_version);
+
 /*****************************************************************************
  * dvbpsi_AttachEIT
  *****************************************************************************/
@@ -142,6 +180,80 @@ bool dvbpsi_eit_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
  */
 void dvbpsi_eit_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extension);
 
+/*****************************************************************************
+ * dvbpsi_eit_family_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_eit_family_attach(dvbpsi_t *p_dvbpsi,
+                                      uint8_t i_first_table_id,
+                                      uint8_t i_last_table_id,
+                                      dvbpsi_eit_callback pf_callback,
+                                      void* p_cb_data)
+ * \brief Creation and initialization of an EIT decoder of every subtable
+ * whose table_id is in a range, whatever its extension.
+ * \param p_dvbpsi pointer to dvbpsi to hold decoder/demuxer structure
+ * \param i_first_table_id first table id, 0x50 to receive the whole EPG
+ * \param i_last_table_id last table id, 0x6f to receive the whole EPG
+ * \param pf_callback function to call back on every new EIT
+ * \param p_cb_data private data given in argument to the callback.
+ * \return true on success, false on failure
+ *
+ * The subtables are delivered to pf_callback as with one dvbpsi_eit_attach()
+ * per subtable, but only the subtables being received have a decoder: the
+ * others take a few bytes each. Subtables with a decoder of their own keep
+ * it, and the new subtable callback of the demux is no longer called for
+ * these table ids.
+ */
+bool dvbpsi_eit_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_eit_callback pf_callback, void* p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_eit_family_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_eit_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+ * \brief Destroy an EIT decoder of a range of table ids.
+ * \param p_dvbpsi pointer holding decoder/demuxer structure
+ * \param i_table_id any table id of the range
+ * \return nothing.
+ */
+void dvbpsi_eit_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id);
+
+/*****************************************************************************
+ * dvbpsi_eit_delivery
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_eit_delivery(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                uint16_t i_extension,
+                                dvbpsi_eit_delivery_t i_delivery,
+                                dvbpsi_eit_complete_callback pf_complete)
+ * \brief Choose when the events of an EIT subtable are delivered.
+ * \param p_dvbpsi dvbpsi handle pointing to Subtable demultiplexor to which the
+                   eit decoder is attached.
+ * \param i_table_id Table ID, 0x4E, 0x4F, or 0x50-0x6F.
+ * \param i_extension Table ID extension, here service ID.
+ * \param i_delivery DVBPSI_EIT_DELIVER_TABLE (the default),
+ * DVBPSI_EIT_DELIVER_SECTION or DVBPSI_EIT_DELIVER_SEGMENT.
+ * \param pf_complete function to call back when a subtable is complete, may be
+ * NULL. It gets the p_cb_data given to dvbpsi_eit_attach().
+ * \return true on success, false if there is no such EIT decoder.
+ *
+ * By default the callback given to dvbpsi_eit_attach() gets all the events of
+ * a subtable at once, when all its sections have been received. With
+ * DVBPSI_EIT_DELIVER_SECTION it gets a dvbpsi_eit_t holding the events of
+ * each new section as soon as the section is received, with
+ * DVBPSI_EIT_DELIVER_SEGMENT the events of each segment (ETSI EN 300 468
+ * section 5.2.4) once all the sections of the segment are received. Each
+ * section is delivered once per version. pf_complete is then called when the
+ * subtable is complete and all its segments were delivered, instead of the
+ * callback given to dvbpsi_eit_attach(); until then a segment still missing
+ * sections is completed by the next repetition of the subtable.
+ */
+bool dvbpsi_eit_delivery(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extension,
+                         dvbpsi_eit_delivery_t i_delivery,
+                         dvbpsi_eit_complete_callback pf_complete);
+
 /*****************************************************************************
  * dvbpsi_eit_init/dvbpsi_eit_new
  *****************************************************************************/
@@ -184,6 +296,9 @@ void dvbpsi_eit_init(dvbpsi_eit_t* p_eit, uint8_t i_table_id,
  * \param i_segment_last_section_number segment_last_section_number
  * \param i_last_table_id i_last_table_id
  * \return p_eit pointer to the EIT structure
+ *
+ * The events and their descriptors are carved from an arena owned by the
+ * EIT, dvbpsi_eit_delete() releases them all at once.
  */
 dvbpsi_eit_t* dvbpsi_eit_new(uint8_t i_table_id, uint16_t i_extension,
                              uint8_t i_version, bool b_current_next,
@@ -296,6 +411,30 @@ dvbpsi_descriptor_t* dvbpsi_eit_event_descriptor_add(
 dvbpsi_psi_section_t *dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t *p_eit,
                                             uint8_t i_table_id);
 
+/*****************************************************************************
+ * dvbpsi_eit_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+ *                                   dvbpsi_psi_section_cache_t *p_cache,
+ *                                   dvbpsi_eit_t *p_eit, uint8_t i_table_id)
+ * \brief Generate the EIT sections again, reusing the unchanged ones.
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache section cache of this EIT, see dvbpsi_NewPSISectionCache()
+ * \param p_eit pointer to the EIT
+ * \param i_table_id the EIT table id to use
+ * \return the sections, owned by the cache, or NULL on error.
+ *
+ * Events edited in place since the last update must be reported with
+ * dvbpsi_PSISectionCacheChanged(). Only the sections carrying changed, new
+ * or removed events are encoded again. When something changed,
+ * dvbpsi_eit_s::i_version is incremented unless the caller already changed
+ * it. See dvbpsi_UpdatePSISectionCache().
+ */
+dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_psi_section_cache_t *p_cache,
+                                                 dvbpsi_eit_t *p_eit, uint8_t i_table_id);
+
 #ifdef __cplusplus
 };
 #endif
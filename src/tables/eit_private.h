@@ -45,6 +45,11 @@ typedef struct dvbpsi_eit_decoder_s
 
     uint8_t                       i_first_received_section_number;
 
+    /* Incremental delivery */
+    dvbpsi_eit_delivery_t         i_delivery;
+    dvbpsi_eit_complete_callback  pf_complete_callback;
+    uint32_t                      i_delivered[8]; /* delivered section numbers */
+
 } dvbpsi_eit_decoder_t;
 
 /*****************************************************************************
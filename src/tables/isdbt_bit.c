@@ -433,8 +433,7 @@ static void dvbpsi_isdbt_bit_sections_gather(dvbpsi_t *p_dvbpsi,
 		/* Save the current information */
 		p_bit_decoder->current_bit = *p_bit_decoder->p_building_bit;
 		/* Delete the sections */
-		dvbpsi_DeletePSISections(p_bit_decoder->p_sections);
-		p_bit_decoder->p_sections = NULL;
+		dvbpsi_decoder_reset(DVBPSI_DECODER(p_bit_decoder), false);
 
 		/* signal the new BIT */
 		if (!tableDidntChange)
@@ -503,7 +502,7 @@ static void dvbpsi_isdbt_bit_sections_decode(dvbpsi_isdbt_bit_t* p_bit,
  *****************************************************************************/
 dvbpsi_psi_section_t* dvbpsi_isdbt_bit_sections_generate(dvbpsi_t *p_dvbpsi,
 		dvbpsi_isdbt_bit_t* p_bit, uint8_t i_table_id) {
-	dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+	dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
 	dvbpsi_psi_section_t* p_current = p_result;
 	dvbpsi_psi_section_t* p_prev;
 	dvbpsi_descriptor_t* p_descriptor = p_bit->p_first_descriptor;
@@ -534,7 +533,7 @@ dvbpsi_psi_section_t* dvbpsi_isdbt_bit_sections_generate(dvbpsi_t *p_dvbpsi,
 			p_current->p_data[9] = i_first_descriptors_length;
 
 			p_prev = p_current;
-			p_current = dvbpsi_NewPSISection(1024);
+			p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
 			p_prev->p_next = p_current;
 
 			p_current->i_table_id = i_table_id;
@@ -593,7 +592,7 @@ dvbpsi_psi_section_t* dvbpsi_isdbt_bit_sections_generate(dvbpsi_t *p_dvbpsi,
 					"create a new section to carry more BI descriptors");
 
 			p_prev = p_current;
-			p_current = dvbpsi_NewPSISection(1024);
+			p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
 			p_prev->p_next = p_current;
 
 			p_current->i_table_id = i_table_id;
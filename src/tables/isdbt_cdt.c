@@ -396,8 +396,7 @@ void dvbpsi_isdbt_cdt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_pr
         /* Save the current information */
         p_cdt_decoder->current_cdt = *p_cdt_decoder->p_building_cdt;
         /* Delete the sections */
-        dvbpsi_DeletePSISections(p_cdt_decoder->p_sections);
-        p_cdt_decoder->p_sections = NULL;
+        dvbpsi_decoder_reset(DVBPSI_DECODER(p_cdt_decoder), false);
 
         /* signal the new cdt */
         if (!cdtEquals)
@@ -447,8 +447,7 @@ void dvbpsi_isdbt_ldt_sections_gather(dvbpsi_t *p_dvbpsi,
         /* Save the current information */
         p_ldt_decoder->current_ldt = *p_ldt_decoder->p_building_ldt;
         /* Delete the sections */
-        dvbpsi_DeletePSISections(p_ldt_decoder->p_sections);
-        p_ldt_decoder->p_sections = NULL;
+        dvbpsi_decoder_reset(DVBPSI_DECODER(p_ldt_decoder), false);
 
         /* signal the new LDT */
         if(!ldtEquals)
@@ -503,7 +502,7 @@ void dvbpsi_isdbt_ldt_sections_decode(dvbpsi_isdbt_ldt_t* p_ldt,
  *****************************************************************************/
 dvbpsi_psi_section_t *dvbpsi_isdbt_ldt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_isdbt_ldt_t* p_ldt)
 {
-    dvbpsi_psi_section_t *p_result = dvbpsi_NewPSISection(4094);
+    dvbpsi_psi_section_t *p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 4094);
     dvbpsi_psi_section_t *p_current = p_result;
     dvbpsi_psi_section_t *p_prev;
 
@@ -546,7 +545,7 @@ dvbpsi_psi_section_t *dvbpsi_isdbt_ldt_sections_generate(dvbpsi_t *p_dvbpsi, dvb
             dvbpsi_debug(p_dvbpsi, "LDT generator","create a new section to carry more Service descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(4094);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 4094);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0xC7;
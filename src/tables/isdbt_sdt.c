@@ -468,8 +468,7 @@ void dvbpsi_isdbt_sdt_sections_gather(dvbpsi_t *p_dvbpsi,
         /* Save the current information */
         p_sdt_decoder->current_sdt = *p_sdt_decoder->p_building_sdt;
         /* Delete the sections */
-        dvbpsi_DeletePSISections(p_sdt_decoder->p_sections);
-        p_sdt_decoder->p_sections = NULL;
+        dvbpsi_decoder_reset(DVBPSI_DECODER(p_sdt_decoder), false);
 
         /* signal the new SDT */
         if(!sdtEquals)
@@ -530,7 +529,7 @@ void dvbpsi_isdbt_sdt_sections_decode(dvbpsi_isdbt_sdt_t* p_sdt,
  *****************************************************************************/
 dvbpsi_psi_section_t *dvbpsi_isdbt_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_isdbt_sdt_t* p_sdt)
 {
-    dvbpsi_psi_section_t *p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t *p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t *p_current = p_result;
     dvbpsi_psi_section_t *p_prev;
 
@@ -572,7 +571,7 @@ dvbpsi_psi_section_t *dvbpsi_isdbt_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvb
             dvbpsi_debug(p_dvbpsi, "SDT generator","create a new section to carry more Service descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x42;
@@ -500,8 +500,7 @@ void dvbpsi_isdbt_sdtt_sections_gather(dvbpsi_t *p_dvbpsi,
         /* Save the current information */
         p_sdtt_decoder->current_sdtt = *p_sdtt_decoder->p_building_sdtt;
         /* Delete the sections */
-        dvbpsi_DeletePSISections(p_sdtt_decoder->p_sections);
-        p_sdtt_decoder->p_sections = NULL;
+        dvbpsi_decoder_reset(DVBPSI_DECODER(p_sdtt_decoder), false);
 
         /* signal the new sdtt */
         if (!sdttEquals)
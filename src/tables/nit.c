@@ -147,7 +147,12 @@ void dvbpsi_nit_init(dvbpsi_nit_t* p_nit, uint8_t i_table_id, uint16_t i_extensi
     p_nit->i_version = i_version;
     p_nit->b_current_next = b_current_next;
     p_nit->p_first_descriptor = NULL;
+    p_nit->p_last_descriptor = NULL;
     p_nit->p_first_ts = NULL;
+    p_nit->p_last_ts = NULL;
+    p_nit->p_arena = NULL;
+    p_nit->p_sections = NULL;
+    p_nit->p_delta = NULL;
 }
 
 /****************************************************************************
@@ -161,8 +166,11 @@ dvbpsi_nit_t *dvbpsi_nit_new(uint8_t i_table_id, uint16_t i_extension,
 {
     dvbpsi_nit_t*p_nit = (dvbpsi_nit_t*)malloc(sizeof(dvbpsi_nit_t));
     if (p_nit != NULL)
+    {
        dvbpsi_nit_init(p_nit, i_table_id, i_extension, i_network_id,
                        i_version, b_current_next);
+       p_nit->p_arena = dvbpsi_NewArena();
+    }
     return p_nit;
 }
 
@@ -175,18 +183,25 @@ void dvbpsi_nit_empty(dvbpsi_nit_t* p_nit)
 {
     dvbpsi_nit_ts_t* p_ts = p_nit->p_first_ts;
 
-    dvbpsi_DeleteDescriptors(p_nit->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_nit->p_arena, p_nit->p_first_descriptor);
 
     while (p_ts != NULL)
     {
         dvbpsi_nit_ts_t* p_tmp = p_ts->p_next;
-        dvbpsi_DeleteDescriptors(p_ts->p_first_descriptor);
-        free(p_ts);
+        dvbpsi_DeleteArenaDescriptors(p_nit->p_arena, p_ts->p_first_descriptor);
+        if (p_nit->p_arena == NULL)
+            free(p_ts);
         p_ts = p_tmp;
     }
 
+    dvbpsi_ResetArena(p_nit->p_arena);
+    dvbpsi_DeletePSISections(p_nit->p_sections);
+    p_nit->p_sections = NULL;
+    p_nit->p_delta = NULL;
     p_nit->p_first_descriptor = NULL;
+    p_nit->p_last_descriptor = NULL;
     p_nit->p_first_ts = NULL;
+    p_nit->p_last_ts = NULL;
 }
 
 /****************************************************************************
@@ -197,7 +212,10 @@ void dvbpsi_nit_empty(dvbpsi_nit_t* p_nit)
 void dvbpsi_nit_delete(dvbpsi_nit_t *p_nit)
 {
     if (p_nit)
+    {
         dvbpsi_nit_empty(p_nit);
+        dvbpsi_DeleteArena(p_nit->p_arena);
+    }
     free(p_nit);
 }
 
@@ -211,7 +229,8 @@ dvbpsi_descriptor_t* dvbpsi_nit_descriptor_add(dvbpsi_nit_t* p_nit,
                                                uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_nit->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
@@ -219,11 +238,14 @@ dvbpsi_descriptor_t* dvbpsi_nit_descriptor_add(dvbpsi_nit_t* p_nit,
         p_nit->p_first_descriptor = p_descriptor;
     else
     {
-        dvbpsi_descriptor_t* p_last_descriptor = p_nit->p_first_descriptor;
+        dvbpsi_descriptor_t* p_last_descriptor = p_nit->p_last_descriptor;
+        if (p_last_descriptor == NULL)
+            p_last_descriptor = p_nit->p_first_descriptor;
         while(p_last_descriptor->p_next != NULL)
             p_last_descriptor = p_last_descriptor->p_next;
         p_last_descriptor->p_next = p_descriptor;
     }
+    p_nit->p_last_descriptor = p_descriptor;
     return p_descriptor;
 }
 
@@ -235,24 +257,30 @@ dvbpsi_descriptor_t* dvbpsi_nit_descriptor_add(dvbpsi_nit_t* p_nit,
 dvbpsi_nit_ts_t* dvbpsi_nit_ts_add(dvbpsi_nit_t* p_nit,
                                    uint16_t i_ts_id, uint16_t i_orig_network_id)
 {
-    dvbpsi_nit_ts_t* p_ts = (dvbpsi_nit_ts_t*)malloc(sizeof(dvbpsi_nit_ts_t));
+    dvbpsi_nit_ts_t* p_ts = (dvbpsi_nit_ts_t*)dvbpsi_ArenaAlloc(p_nit->p_arena,
+                                                                sizeof(dvbpsi_nit_ts_t));
     if (p_ts == NULL)
         return NULL;
 
     p_ts->i_ts_id = i_ts_id;
     p_ts->i_orig_network_id = i_orig_network_id;
     p_ts->p_first_descriptor = NULL;
+    p_ts->p_last_descriptor = NULL;
     p_ts->p_next = NULL;
+    p_ts->p_arena = p_nit->p_arena;
 
     if (p_nit->p_first_ts == NULL)
         p_nit->p_first_ts = p_ts;
     else
     {
-        dvbpsi_nit_ts_t* p_last_ts = p_nit->p_first_ts;
+        dvbpsi_nit_ts_t* p_last_ts = p_nit->p_last_ts;
+        if (p_last_ts == NULL)
+            p_last_ts = p_nit->p_first_ts;
         while(p_last_ts->p_next != NULL)
             p_last_ts = p_last_ts->p_next;
         p_last_ts->p_next = p_ts;
     }
+    p_nit->p_last_ts = p_ts;
     return p_ts;
 }
 
@@ -266,12 +294,13 @@ dvbpsi_descriptor_t* dvbpsi_nit_ts_descriptor_add(dvbpsi_nit_ts_t* p_ts,
                                                   uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_ts->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_ts->p_first_descriptor = dvbpsi_AddDescriptor(p_ts->p_first_descriptor,
-                                                    p_descriptor);
+    dvbpsi_AppendDescriptor(&p_ts->p_first_descriptor,
+                            &p_ts->p_last_descriptor, p_descriptor);
     assert(p_ts->p_first_descriptor);
     if (p_ts->p_first_descriptor == NULL)
         return NULL;
@@ -434,8 +463,18 @@ void dvbpsi_nit_sections_gather(dvbpsi_t *p_dvbpsi,
         p_nit_decoder->b_current_valid = true;
 
         /* Decode the sections */
-        dvbpsi_nit_sections_decode(p_nit_decoder->p_building_nit,
-                                   p_nit_decoder->p_sections);
+        dvbpsi_psi_section_t *p_sections = p_nit_decoder->p_sections;
+        if (p_dvbpsi->p_decoder->b_retain_sections)
+        {
+            /* The table keeps its sections, its descriptors point into them */
+            p_nit_decoder->p_building_nit->p_sections = p_sections;
+            p_nit_decoder->p_sections = NULL;
+        }
+        dvbpsi_nit_sections_decode(p_nit_decoder->p_building_nit, p_sections);
+        if (p_dvbpsi->p_decoder->b_delta)
+            p_nit_decoder->p_building_nit->p_delta =
+                dvbpsi_decoder_psi_sections_delta(DVBPSI_DECODER(p_nit_decoder),
+                        p_nit_decoder->p_building_nit->p_arena, p_sections);
         /* signal the new NIT */
         p_nit_decoder->pf_nit_callback(p_nit_decoder->p_cb_data,
                                        p_nit_decoder->p_building_nit);
@@ -462,6 +501,10 @@ void dvbpsi_nit_sections_decode(dvbpsi_nit_t* p_nit,
         p_end = p_byte + (((uint16_t)(p_section->p_payload_start[0] & 0x0f) << 8)
                           | p_section->p_payload_start[1]);
 
+        if (p_nit->p_sections != NULL
+         && dvbpsi_AppendDescriptorViews(p_nit->p_arena, &p_nit->p_first_descriptor,
+                                         &p_nit->p_last_descriptor, p_byte, p_end - p_byte))
+            p_byte = p_end;
         while (p_byte + 2 <= p_end)
         {
             uint8_t i_tag = p_byte[0];
@@ -497,6 +540,10 @@ void dvbpsi_nit_sections_decode(dvbpsi_nit_t* p_nit,
             if (p_end2 > p_section->p_payload_end)
                 p_end2 = p_section->p_payload_end;
 
+            if (p_nit->p_sections != NULL
+             && dvbpsi_AppendDescriptorViews(p_nit->p_arena, &p_ts->p_first_descriptor,
+                                             &p_ts->p_last_descriptor, p_byte, p_end2 - p_byte))
+                p_byte = p_end2;
             while (p_byte + 2 <= p_end2)
             {
                 uint8_t i_tag = p_byte[0];
@@ -518,7 +565,7 @@ void dvbpsi_nit_sections_decode(dvbpsi_nit_t* p_nit,
 dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
                                             dvbpsi_nit_t* p_nit, uint8_t i_table_id)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_descriptor_t* p_descriptor = p_nit->p_first_descriptor;
@@ -556,7 +603,7 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
             p_current->p_payload_end += 2;
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = i_table_id;
@@ -627,7 +674,7 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
                                    "create a new section to carry more TS descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = i_table_id;
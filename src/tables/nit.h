@@ -60,6 +60,8 @@ typedef struct dvbpsi_nit_ts_s
   uint16_t                      i_orig_network_id;      /*!< original network id */
 
   dvbpsi_descriptor_t *         p_first_descriptor;     /*!< descriptor list */
+  dvbpsi_descriptor_t *         p_last_descriptor;      /*!< last descriptor of the list */
+  dvbpsi_arena_t *              p_arena;                /*!< arena of the NIT */
 
   struct dvbpsi_nit_ts_s *      p_next;                 /*!< next element of
                                                              the list */
@@ -90,8 +92,13 @@ typedef struct dvbpsi_nit_s
     bool                 b_current_next;     /*!< current_next_indicator */
 
     dvbpsi_descriptor_t *p_first_descriptor; /*!< descriptor list */
+    dvbpsi_descriptor_t *p_last_descriptor;  /*!< last descriptor of the list */
 
     dvbpsi_nit_ts_t *    p_first_ts;         /*!< TS list */
+    dvbpsi_nit_ts_t *    p_last_ts;          /*!< last TS of the list */
+    dvbpsi_arena_t *     p_arena;            /*!< arena of the TS and descriptors */
+    dvbpsi_psi_section_t *p_sections;        /*!< retained sections, or NULL */
+    dvbpsi_delta_t       *p_delta;           /*!< changes since the previous version */
 
 } dvbpsi_nit_t;
 
@@ -166,6 +173,8 @@ void dvbpsi_nit_init(dvbpsi_nit_t* p_nit, uint8_t i_table_id, uint16_t i_extensi
  * \param i_version NIT version
  * \param b_current_next current next indicator
  * \return p_nit pointer to the NIT structure
+ *
+ * The TS and the descriptors are carved from an arena owned by the NIT.
  */
 dvbpsi_nit_t *dvbpsi_nit_new(uint8_t i_table_id, uint16_t i_extension,
                              uint16_t i_network_id, uint8_t i_version,
@@ -42,9 +42,26 @@
 #include "../dvbpsi.h"
 #include "../dvbpsi_private.h"
 #include "../psi.h"
+#include "../descriptor.h"
 #include "pat.h"
 #include "pat_private.h"
 
+/*****************************************************************************
+ * dvbpsi_pat_sections_peek
+ *****************************************************************************
+ * Tell if a section belongs to the PAT already decoded, given its header.
+ *****************************************************************************/
+static bool dvbpsi_pat_sections_peek(dvbpsi_decoder_t *p_decoder, const uint8_t *p_header)
+{
+    dvbpsi_pat_decoder_t *p_pat_decoder = (dvbpsi_pat_decoder_t *)p_decoder;
+
+    return (p_header[0] == 0x00)
+        && (p_pat_decoder->p_building_pat == NULL)
+        && (p_pat_decoder->b_current_valid)
+        && (p_pat_decoder->current_pat.i_version == ((p_header[5] & 0x3e) >> 1))
+        && (p_pat_decoder->current_pat.b_current_next == ((p_header[5] & 0x01) != 0));
+}
+
 /*****************************************************************************
  * dvbpsi_pat_attach
  *****************************************************************************
@@ -67,6 +84,7 @@ bool dvbpsi_pat_attach(dvbpsi_t *p_dvbpsi, dvbpsi_pat_callback pf_callback,
     p_pat_decoder->pf_pat_callback = pf_callback;
     p_pat_decoder->p_cb_data = p_cb_data;
     p_pat_decoder->p_building_pat = NULL;
+    p_pat_decoder->pf_peek = dvbpsi_pat_sections_peek;
 
     p_dvbpsi->p_decoder = DVBPSI_DECODER(p_pat_decoder);
     return true;
@@ -105,6 +123,8 @@ void dvbpsi_pat_init(dvbpsi_pat_t* p_pat, uint16_t i_ts_id, uint8_t i_version,
     p_pat->i_version = i_version;
     p_pat->b_current_next = b_current_next;
     p_pat->p_first_program = NULL;
+    p_pat->p_last_program = NULL;
+    p_pat->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -117,7 +137,10 @@ dvbpsi_pat_t *dvbpsi_pat_new(uint16_t i_ts_id, uint8_t i_version,
 {
     dvbpsi_pat_t *p_pat = (dvbpsi_pat_t*)malloc(sizeof(dvbpsi_pat_t));
     if (p_pat)
+    {
         dvbpsi_pat_init(p_pat, i_ts_id, i_version, b_current_next);
+        p_pat->p_arena = dvbpsi_NewArena();
+    }
     return p_pat;
 }
 
@@ -133,10 +156,13 @@ void dvbpsi_pat_empty(dvbpsi_pat_t* p_pat)
     while(p_program != NULL)
     {
         dvbpsi_pat_program_t* p_tmp = p_program->p_next;
-        free(p_program);
+        if (p_pat->p_arena == NULL)
+            free(p_program);
         p_program = p_tmp;
     }
+    dvbpsi_ResetArena(p_pat->p_arena);
     p_pat->p_first_program = NULL;
+    p_pat->p_last_program = NULL;
 }
 
 /*****************************************************************************
@@ -147,7 +173,10 @@ void dvbpsi_pat_empty(dvbpsi_pat_t* p_pat)
 void dvbpsi_pat_delete(dvbpsi_pat_t *p_pat)
 {
     if (p_pat)
+    {
         dvbpsi_pat_empty(p_pat);
+        dvbpsi_DeleteArena(p_pat->p_arena);
+    }
     free(p_pat);
 }
 
@@ -166,7 +195,8 @@ dvbpsi_pat_program_t* dvbpsi_pat_program_add(dvbpsi_pat_t* p_pat,
     if (i_pid == 0)
         return NULL;
 
-    p_program = (dvbpsi_pat_program_t*) malloc(sizeof(dvbpsi_pat_program_t));
+    p_program = (dvbpsi_pat_program_t*)dvbpsi_ArenaAlloc(p_pat->p_arena,
+                                                         sizeof(dvbpsi_pat_program_t));
     if (p_program == NULL)
         return NULL;
 
@@ -178,11 +208,14 @@ dvbpsi_pat_program_t* dvbpsi_pat_program_add(dvbpsi_pat_t* p_pat,
         p_pat->p_first_program = p_program;
     else
     {
-        dvbpsi_pat_program_t* p_last_program = p_pat->p_first_program;
+        dvbpsi_pat_program_t* p_last_program = p_pat->p_last_program;
+        if (p_last_program == NULL)
+            p_last_program = p_pat->p_first_program;
         while (p_last_program->p_next != NULL)
             p_last_program = p_last_program->p_next;
         p_last_program->p_next = p_program;
     }
+    p_pat->p_last_program = p_program;
 
     return p_program;
 }
@@ -386,7 +419,7 @@ bool dvbpsi_pat_sections_decode(dvbpsi_pat_t* p_pat, dvbpsi_psi_section_t* p_sec
 dvbpsi_psi_section_t* dvbpsi_pat_sections_generate(dvbpsi_t *p_dvbpsi,
                                             dvbpsi_pat_t* p_pat, int i_max_pps)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_pat_program_t* p_program = p_pat->p_first_program;
@@ -420,7 +453,7 @@ dvbpsi_psi_section_t* dvbpsi_pat_sections_generate(dvbpsi_t *p_dvbpsi,
         if (++i_count > i_max_pps)
         {
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             if (p_current ==  NULL)
             {
                 dvbpsi_error(p_dvbpsi, "PAT encoder", "failed to allocate new PSI section");
@@ -83,6 +83,8 @@ typedef struct dvbpsi_pat_s
   bool                      b_current_next;     /*!< current_next_indicator */
 
   dvbpsi_pat_program_t *    p_first_program;    /*!< program list */
+  dvbpsi_pat_program_t *    p_last_program;     /*!< last program of the list */
+  dvbpsi_arena_t *          p_arena;            /*!< arena of the programs */
 
 } dvbpsi_pat_t;
 
@@ -148,6 +150,8 @@ void dvbpsi_pat_init(dvbpsi_pat_t* p_pat, uint16_t i_ts_id, uint8_t i_version,
  * \param i_version PAT version
  * \param b_current_next current next indicator
  * \return p_pat pointer to the PAT structure
+ *
+ * The programs are carved from an arena owned by the PAT.
  */
 dvbpsi_pat_t *dvbpsi_pat_new(uint16_t i_ts_id, uint8_t i_version, bool b_current_next);
 
@@ -44,9 +44,30 @@
 #include "../dvbpsi_private.h"
 #include "../psi.h"
 #include "../descriptor.h"
+#include "../demux.h"
 #include "pmt.h"
 #include "pmt_private.h"
 
+/*****************************************************************************
+ * dvbpsi_pmt_sections_peek
+ *****************************************************************************
+ * Tell if a section belongs to the PMT already decoded, given its header.
+ * A program told of a discontinuity by dvbpsi_pmt_program_gather() decodes
+ * its next section again.
+ *****************************************************************************/
+static bool dvbpsi_pmt_sections_peek(dvbpsi_decoder_t *p_decoder, const uint8_t *p_header)
+{
+    dvbpsi_pmt_decoder_t *p_pmt_decoder = (dvbpsi_pmt_decoder_t *)p_decoder;
+
+    return (p_header[0] == 0x02)
+        && (!p_pmt_decoder->b_discontinuity)
+        && (p_pmt_decoder->i_program_number == (((uint16_t)p_header[3] << 8) | p_header[4]))
+        && (p_pmt_decoder->p_building_pmt == NULL)
+        && (p_pmt_decoder->b_current_valid)
+        && (p_pmt_decoder->current_pmt.i_version == ((p_header[5] & 0x3e) >> 1))
+        && (p_pmt_decoder->current_pmt.b_current_next == ((p_header[5] & 0x01) != 0));
+}
+
 /*****************************************************************************
  * dvbpsi_pmt_attach
  *****************************************************************************
@@ -71,6 +92,7 @@ bool dvbpsi_pmt_attach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number,
     p_pmt_decoder->pf_pmt_callback = pf_callback;
     p_pmt_decoder->p_cb_data = p_cb_data;
     p_pmt_decoder->p_building_pmt = NULL;
+    p_pmt_decoder->pf_peek = dvbpsi_pmt_sections_peek;
 
     return true;
 }
@@ -110,7 +132,12 @@ void dvbpsi_pmt_init(dvbpsi_pmt_t* p_pmt, uint16_t i_program_number,
     p_pmt->b_current_next = b_current_next;
     p_pmt->i_pcr_pid = i_pcr_pid;
     p_pmt->p_first_descriptor = NULL;
+    p_pmt->p_last_descriptor = NULL;
     p_pmt->p_first_es = NULL;
+    p_pmt->p_last_es = NULL;
+    p_pmt->p_arena = NULL;
+    p_pmt->p_sections = NULL;
+    p_pmt->p_delta = NULL;
 }
 
 /*****************************************************************************
@@ -122,9 +149,12 @@ dvbpsi_pmt_t* dvbpsi_pmt_new(uint16_t i_program_number, uint8_t i_version,
                             bool b_current_next, uint16_t i_pcr_pid)
 {
     dvbpsi_pmt_t *p_pmt = (dvbpsi_pmt_t*)malloc(sizeof(dvbpsi_pmt_t));
-    if(p_pmt != NULL)
+    if (p_pmt != NULL)
+    {
         dvbpsi_pmt_init(p_pmt, i_program_number, i_version,
                         b_current_next, i_pcr_pid);
+        p_pmt->p_arena = dvbpsi_NewArena();
+    }
     return p_pmt;
 }
 
@@ -137,18 +167,25 @@ void dvbpsi_pmt_empty(dvbpsi_pmt_t* p_pmt)
 {
     dvbpsi_pmt_es_t* p_es = p_pmt->p_first_es;
 
-    dvbpsi_DeleteDescriptors(p_pmt->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_pmt->p_arena, p_pmt->p_first_descriptor);
 
     while(p_es != NULL)
     {
         dvbpsi_pmt_es_t* p_tmp = p_es->p_next;
-        dvbpsi_DeleteDescriptors(p_es->p_first_descriptor);
-        free(p_es);
+        dvbpsi_DeleteArenaDescriptors(p_pmt->p_arena, p_es->p_first_descriptor);
+        if (p_pmt->p_arena == NULL)
+            free(p_es);
         p_es = p_tmp;
     }
 
+    dvbpsi_ResetArena(p_pmt->p_arena);
+    dvbpsi_DeletePSISections(p_pmt->p_sections);
+    p_pmt->p_sections = NULL;
+    p_pmt->p_delta = NULL;
     p_pmt->p_first_descriptor = NULL;
+    p_pmt->p_last_descriptor = NULL;
     p_pmt->p_first_es = NULL;
+    p_pmt->p_last_es = NULL;
 }
 
 /*****************************************************************************
@@ -159,7 +196,10 @@ void dvbpsi_pmt_empty(dvbpsi_pmt_t* p_pmt)
 void dvbpsi_pmt_delete(dvbpsi_pmt_t* p_pmt)
 {
     if (p_pmt)
+    {
         dvbpsi_pmt_empty(p_pmt);
+        dvbpsi_DeleteArena(p_pmt->p_arena);
+    }
     free(p_pmt);
 }
 
@@ -173,12 +213,13 @@ dvbpsi_descriptor_t* dvbpsi_pmt_descriptor_add(dvbpsi_pmt_t* p_pmt,
                                                uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor;
-    p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    p_descriptor = dvbpsi_NewArenaDescriptor(p_pmt->p_arena, i_tag,
+                                             i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_pmt->p_first_descriptor = dvbpsi_AddDescriptor(p_pmt->p_first_descriptor,
-                                                     p_descriptor);
+    dvbpsi_AppendDescriptor(&p_pmt->p_first_descriptor,
+                            &p_pmt->p_last_descriptor, p_descriptor);
     assert(p_pmt->p_first_descriptor);
     if (p_pmt->p_first_descriptor == NULL)
         return NULL;
@@ -194,24 +235,30 @@ dvbpsi_descriptor_t* dvbpsi_pmt_descriptor_add(dvbpsi_pmt_t* p_pmt,
 dvbpsi_pmt_es_t* dvbpsi_pmt_es_add(dvbpsi_pmt_t* p_pmt,
                                    uint8_t i_type, uint16_t i_pid)
 {
-    dvbpsi_pmt_es_t* p_es = (dvbpsi_pmt_es_t*)malloc(sizeof(dvbpsi_pmt_es_t));
+    dvbpsi_pmt_es_t* p_es = (dvbpsi_pmt_es_t*)dvbpsi_ArenaAlloc(p_pmt->p_arena,
+                                                                sizeof(dvbpsi_pmt_es_t));
     if (p_es == NULL)
         return NULL;
 
     p_es->i_type = i_type;
     p_es->i_pid = i_pid;
     p_es->p_first_descriptor = NULL;
+    p_es->p_last_descriptor = NULL;
     p_es->p_next = NULL;
+    p_es->p_arena = p_pmt->p_arena;
 
     if (p_pmt->p_first_es == NULL)
        p_pmt->p_first_es = p_es;
     else
     {
-        dvbpsi_pmt_es_t* p_last_es = p_pmt->p_first_es;
+        dvbpsi_pmt_es_t* p_last_es = p_pmt->p_last_es;
+        if (p_last_es == NULL)
+            p_last_es = p_pmt->p_first_es;
         while (p_last_es->p_next != NULL)
             p_last_es = p_last_es->p_next;
         p_last_es->p_next = p_es;
     }
+    p_pmt->p_last_es = p_es;
     return p_es;
 }
 
@@ -225,7 +272,8 @@ dvbpsi_descriptor_t* dvbpsi_pmt_es_descriptor_add(dvbpsi_pmt_es_t* p_es,
                                                uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor;
-    p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    p_descriptor = dvbpsi_NewArenaDescriptor(p_es->p_arena, i_tag,
+                                             i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
@@ -233,11 +281,14 @@ dvbpsi_descriptor_t* dvbpsi_pmt_es_descriptor_add(dvbpsi_pmt_es_t* p_es,
         p_es->p_first_descriptor = p_descriptor;
     else
     {
-        dvbpsi_descriptor_t* p_last_descriptor = p_es->p_first_descriptor;
+        dvbpsi_descriptor_t* p_last_descriptor = p_es->p_last_descriptor;
+        if (p_last_descriptor == NULL)
+            p_last_descriptor = p_es->p_first_descriptor;
         while(p_last_descriptor->p_next != NULL)
             p_last_descriptor = p_last_descriptor->p_next;
         p_last_descriptor->p_next = p_descriptor;
     }
+    p_es->p_last_descriptor = p_descriptor;
     return p_descriptor;
 }
 
@@ -258,13 +309,11 @@ static void dvbpsi_ReInitPMT(dvbpsi_pmt_decoder_t* p_decoder, const bool b_force
     p_decoder->p_building_pmt = NULL;
 }
 
-static bool dvbpsi_CheckPMT(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
+static bool dvbpsi_CheckPMT(dvbpsi_t *p_dvbpsi, dvbpsi_pmt_decoder_t *p_pmt_decoder,
+                            dvbpsi_psi_section_t *p_section)
 {
     bool b_reinit = false;
-    assert(p_dvbpsi->p_decoder);
-
-    dvbpsi_pmt_decoder_t* p_pmt_decoder;
-    p_pmt_decoder = (dvbpsi_pmt_decoder_t *)p_dvbpsi->p_decoder;
+    assert(p_pmt_decoder);
 
     if (p_pmt_decoder->p_building_pmt->i_version != p_section->i_version)
     {
@@ -317,12 +366,13 @@ static bool dvbpsi_AddSectionPMT(dvbpsi_t *p_dvbpsi, dvbpsi_pmt_decoder_t *p_pmt
 /*****************************************************************************
  * dvbpsi_GatherPMTSections
  *****************************************************************************
- * Callback for the PSI decoder.
+ * Add a section to the PMT of one program, signal the PMT when complete.
  *****************************************************************************/
-void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
+static void dvbpsi_GatherPMTSections(dvbpsi_t *p_dvbpsi,
+                                     dvbpsi_pmt_decoder_t *p_pmt_decoder,
+                                     dvbpsi_psi_section_t *p_section)
 {
-    assert(p_dvbpsi);
-    assert(p_dvbpsi->p_decoder);
+    assert(p_pmt_decoder);
 
     if (!dvbpsi_CheckPSISection(p_dvbpsi, p_section, 0x02, "PMT decoder"))
     {
@@ -330,10 +380,6 @@ void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_sect
         return;
     }
 
-    /* */
-    dvbpsi_pmt_decoder_t* p_pmt_decoder = (dvbpsi_pmt_decoder_t*)p_dvbpsi->p_decoder;
-    assert(p_pmt_decoder);
-
     /* We have a valid PMT section */
     if (p_pmt_decoder->i_program_number != p_section->i_extension)
     {
@@ -354,7 +400,7 @@ void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_sect
         /* Perform some few sanity checks */
         if (p_pmt_decoder->p_building_pmt)
         {
-            if (dvbpsi_CheckPMT(p_dvbpsi, p_section))
+            if (dvbpsi_CheckPMT(p_dvbpsi, p_pmt_decoder, p_section))
                 dvbpsi_ReInitPMT(p_pmt_decoder, true);
         }
         else
@@ -391,8 +437,18 @@ void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_sect
         p_pmt_decoder->current_pmt = *p_pmt_decoder->p_building_pmt;
         p_pmt_decoder->b_current_valid = true;
         /* Decode the sections */
-        dvbpsi_pmt_sections_decode(p_pmt_decoder->p_building_pmt,
-                                   p_pmt_decoder->p_sections);
+        dvbpsi_psi_section_t *p_sections = p_pmt_decoder->p_sections;
+        if (p_dvbpsi->p_decoder->b_retain_sections)
+        {
+            /* The table keeps its sections, its descriptors point into them */
+            p_pmt_decoder->p_building_pmt->p_sections = p_sections;
+            p_pmt_decoder->p_sections = NULL;
+        }
+        dvbpsi_pmt_sections_decode(p_pmt_decoder->p_building_pmt, p_sections);
+        if (p_dvbpsi->p_decoder->b_delta)
+            p_pmt_decoder->p_building_pmt->p_delta =
+                dvbpsi_decoder_psi_sections_delta(DVBPSI_DECODER(p_pmt_decoder),
+                        p_pmt_decoder->p_building_pmt->p_arena, p_sections);
         /* signal the new PMT */
         p_pmt_decoder->pf_pmt_callback(p_pmt_decoder->p_cb_data,
                                        p_pmt_decoder->p_building_pmt);
@@ -402,6 +458,242 @@ void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_sect
     }
 }
 
+/*****************************************************************************
+ * dvbpsi_pmt_sections_gather
+ *****************************************************************************
+ * Callback for the PSI decoder.
+ *****************************************************************************/
+void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_section)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_GatherPMTSections(p_dvbpsi, (dvbpsi_pmt_decoder_t *)p_dvbpsi->p_decoder,
+                             p_section);
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_gather
+ *****************************************************************************
+ * Callback for the subtable demultiplexor.
+ *****************************************************************************/
+static void dvbpsi_pmt_program_gather(dvbpsi_t *p_dvbpsi,
+                                      dvbpsi_decoder_t *p_private_decoder,
+                                      dvbpsi_psi_section_t *p_section)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    dvbpsi_pmt_decoder_t *p_pmt_decoder = (dvbpsi_pmt_decoder_t *)p_private_decoder;
+
+    /* A TS discontinuity affects every program carried on the PID */
+    if (p_demux->b_discontinuity)
+    {
+        dvbpsi_demux_subdec_t *p_subdec = p_demux->p_first_subdec;
+        for (; p_subdec != NULL; p_subdec = p_subdec->p_next)
+            if (p_subdec->pf_gather == dvbpsi_pmt_program_gather)
+                p_subdec->p_decoder->b_discontinuity = true;
+        p_demux->b_discontinuity = false;
+    }
+
+    dvbpsi_GatherPMTSections(p_dvbpsi, p_pmt_decoder, p_section);
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_detach_subdec
+ *****************************************************************************
+ * Detach callback for the subtable demultiplexor.
+ *****************************************************************************/
+static void dvbpsi_pmt_program_detach_subdec(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                             uint16_t i_extension)
+{
+    assert(i_table_id == 0x02);
+    dvbpsi_pmt_program_detach(p_dvbpsi, i_extension);
+}
+
+/*****************************************************************************
+ * dvbpsi_AttachPMTProgram
+ *****************************************************************************
+ * Add the decoder of one program to the subtable demultiplexor.
+ *****************************************************************************/
+static dvbpsi_pmt_decoder_t *dvbpsi_AttachPMTProgram(dvbpsi_t *p_dvbpsi,
+                                                     uint16_t i_program_number,
+                                                     dvbpsi_pmt_callback pf_callback,
+                                                     void *p_cb_data)
+{
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+
+    dvbpsi_pmt_decoder_t *p_pmt_decoder;
+    p_pmt_decoder = (dvbpsi_pmt_decoder_t *) dvbpsi_decoder_new(NULL,
+                                             0, true, sizeof(dvbpsi_pmt_decoder_t));
+    if (p_pmt_decoder == NULL)
+        return NULL;
+
+    dvbpsi_demux_subdec_t *p_subdec;
+    p_subdec = dvbpsi_NewDemuxSubDecoder(0x02, i_program_number,
+                                         dvbpsi_pmt_program_detach_subdec,
+                                         dvbpsi_pmt_program_gather,
+                                         DVBPSI_DECODER(p_pmt_decoder));
+    if (p_subdec == NULL)
+    {
+        dvbpsi_decoder_delete(DVBPSI_DECODER(p_pmt_decoder));
+        return NULL;
+    }
+
+    dvbpsi_AttachDemuxSubDecoder(p_demux, p_subdec);
+
+    /* PMT decoder configuration */
+    p_pmt_decoder->i_program_number = i_program_number;
+    p_pmt_decoder->pf_pmt_callback = pf_callback;
+    p_pmt_decoder->p_cb_data = p_cb_data;
+    p_pmt_decoder->p_building_pmt = NULL;
+    p_pmt_decoder->pf_peek = dvbpsi_pmt_sections_peek;
+    p_pmt_decoder->b_all_programs = false;
+
+    return p_pmt_decoder;
+}
+
+/*****************************************************************************
+ * dvbpsi_NewPMTProgram
+ *****************************************************************************
+ * New subtable callback of the subtable demultiplexor: programs without a
+ * decoder of their own go to the all programs callback, if any.
+ *****************************************************************************/
+static void dvbpsi_NewPMTProgram(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                 uint16_t i_extension, void *p_cb_data)
+{
+    dvbpsi_pmt_programs_t *p_programs = (dvbpsi_pmt_programs_t *)p_cb_data;
+
+    if (i_table_id != 0x02 || p_programs->pf_callback == NULL)
+        return;
+
+    dvbpsi_pmt_decoder_t *p_pmt_decoder;
+    p_pmt_decoder = dvbpsi_AttachPMTProgram(p_dvbpsi, i_extension,
+                                            p_programs->pf_callback,
+                                            p_programs->p_cb_data);
+    if (p_pmt_decoder)
+        p_pmt_decoder->b_all_programs = true;
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_programs_attach
+ *****************************************************************************
+ * Initialize a decoder of all the PMTs carried on a PID.
+ *****************************************************************************/
+bool dvbpsi_pmt_programs_attach(dvbpsi_t *p_dvbpsi,
+                                dvbpsi_pmt_callback pf_callback, void *p_cb_data)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder == NULL);
+
+    dvbpsi_pmt_programs_t *p_programs;
+    p_programs = (dvbpsi_pmt_programs_t *)malloc(sizeof(dvbpsi_pmt_programs_t));
+    if (p_programs == NULL)
+        return false;
+
+    p_programs->pf_callback = pf_callback;
+    p_programs->p_cb_data = p_cb_data;
+
+    if (!dvbpsi_AttachDemux(p_dvbpsi, dvbpsi_NewPMTProgram, p_programs))
+    {
+        free(p_programs);
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_programs_detach
+ *****************************************************************************
+ * Close a decoder of all the PMTs carried on a PID and its programs.
+ *****************************************************************************/
+void dvbpsi_pmt_programs_detach(dvbpsi_t *p_dvbpsi)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    assert(p_demux->pf_new_callback == dvbpsi_NewPMTProgram);
+    void *p_programs = p_demux->p_new_cb_data;
+
+    dvbpsi_DetachDemux(p_dvbpsi);
+    free(p_programs);
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_attach
+ *****************************************************************************
+ * Add the decoder of one program to a subtable demultiplexor.
+ *****************************************************************************/
+bool dvbpsi_pmt_program_attach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number,
+                               dvbpsi_pmt_callback pf_callback, void *p_cb_data)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+    dvbpsi_demux_subdec_t *p_subdec = dvbpsi_demuxGetSubDec(p_demux, 0x02,
+                                                            i_program_number);
+    if (p_subdec)
+    {
+        dvbpsi_pmt_decoder_t *p_pmt_decoder = (dvbpsi_pmt_decoder_t *)p_subdec->p_decoder;
+        if (p_subdec->pf_gather != dvbpsi_pmt_program_gather
+         || !p_pmt_decoder->b_all_programs)
+        {
+            dvbpsi_error(p_dvbpsi, "PMT decoder",
+                         "Already a decoder for (program_number == 0x%04x)",
+                         i_program_number);
+            return false;
+        }
+
+        /* Take the program over from the all programs callback, the PMT
+         * already decoded is not signaled again */
+        p_pmt_decoder->pf_pmt_callback = pf_callback;
+        p_pmt_decoder->p_cb_data = p_cb_data;
+        p_pmt_decoder->b_all_programs = false;
+        return true;
+    }
+
+    return dvbpsi_AttachPMTProgram(p_dvbpsi, i_program_number,
+                                   pf_callback, p_cb_data) != NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_detach
+ *****************************************************************************
+ * Remove the decoder of one program from a subtable demultiplexor.
+ *****************************************************************************/
+void dvbpsi_pmt_program_detach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_demux_t *p_demux = (dvbpsi_demux_t *)p_dvbpsi->p_decoder;
+
+    dvbpsi_demux_subdec_t *p_subdec;
+    p_subdec = dvbpsi_demuxGetSubDec(p_demux, 0x02, i_program_number);
+    if (p_subdec == NULL)
+    {
+        dvbpsi_error(p_dvbpsi, "PMT decoder",
+                     "No such PMT decoder (program_number == 0x%04x)",
+                     i_program_number);
+        return;
+    }
+
+    assert(p_subdec->p_decoder);
+
+    dvbpsi_pmt_decoder_t *p_pmt_decoder;
+    p_pmt_decoder = (dvbpsi_pmt_decoder_t *)p_subdec->p_decoder;
+    if (p_pmt_decoder->p_building_pmt)
+        dvbpsi_pmt_delete(p_pmt_decoder->p_building_pmt);
+    p_pmt_decoder->p_building_pmt = NULL;
+
+    /* Free sub table decoder */
+    dvbpsi_DetachDemuxSubDecoder(p_demux, p_subdec);
+    dvbpsi_DeleteDemuxSubDecoder(p_subdec);
+}
+
 /*****************************************************************************
  * dvbpsi_pmt_sections_decode
  *****************************************************************************
@@ -418,6 +710,10 @@ void dvbpsi_pmt_sections_decode(dvbpsi_pmt_t* p_pmt,
         p_byte = p_section->p_payload_start + 4;
         p_end = p_byte + (   ((uint16_t)(p_section->p_payload_start[2] & 0x0f) << 8)
                            | p_section->p_payload_start[3]);
+        if (p_pmt->p_sections != NULL
+         && dvbpsi_AppendDescriptorViews(p_pmt->p_arena, &p_pmt->p_first_descriptor,
+                                         &p_pmt->p_last_descriptor, p_byte, p_end - p_byte))
+            p_byte = p_end;
         while (p_byte + 2 <= p_end)
         {
             uint8_t i_tag = p_byte[0];
@@ -441,6 +737,10 @@ void dvbpsi_pmt_sections_decode(dvbpsi_pmt_t* p_pmt,
             {
                 p_end = p_section->p_payload_end;
             }
+            if (p_es != NULL && p_pmt->p_sections != NULL
+             && dvbpsi_AppendDescriptorViews(p_pmt->p_arena, &p_es->p_first_descriptor,
+                                             &p_es->p_last_descriptor, p_byte, p_end - p_byte))
+                p_byte = p_end;
             while (p_byte + 2 <= p_end)
             {
                 uint8_t i_tag = p_byte[0];
@@ -461,7 +761,7 @@ void dvbpsi_pmt_sections_decode(dvbpsi_pmt_t* p_pmt,
  *****************************************************************************/
 dvbpsi_psi_section_t* dvbpsi_pmt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_pmt_t* p_pmt)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_descriptor_t* p_descriptor = p_pmt->p_first_descriptor;
@@ -497,7 +797,7 @@ dvbpsi_psi_section_t* dvbpsi_pmt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_pm
             p_current->p_data[11] = i_info_length;
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x02;
@@ -562,7 +862,7 @@ dvbpsi_psi_section_t* dvbpsi_pmt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_pm
                          "create a new section to carry more ES descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x02;
@@ -58,6 +58,8 @@ typedef struct dvbpsi_pmt_es_s
   uint16_t                      i_pid;                  /*!< elementary_PID */
 
   dvbpsi_descriptor_t *         p_first_descriptor;     /*!< descriptor list */
+  dvbpsi_descriptor_t *         p_last_descriptor;      /*!< last descriptor of the list */
+  dvbpsi_arena_t *              p_arena;                /*!< arena of the PMT */
 
   struct dvbpsi_pmt_es_s *      p_next;                 /*!< next element of
                                                              the list */
@@ -87,8 +89,13 @@ typedef struct dvbpsi_pmt_s
   uint16_t                  i_pcr_pid;          /*!< PCR_PID */
 
   dvbpsi_descriptor_t *     p_first_descriptor; /*!< descriptor list */
+  dvbpsi_descriptor_t *     p_last_descriptor;  /*!< last descriptor of the list */
 
   dvbpsi_pmt_es_t *         p_first_es;         /*!< ES list */
+  dvbpsi_pmt_es_t *         p_last_es;          /*!< last ES of the list */
+  dvbpsi_arena_t *          p_arena;            /*!< arena of the ES and descriptors */
+  dvbpsi_psi_section_t *    p_sections;         /*!< retained sections, or NULL */
+  dvbpsi_delta_t *          p_delta;            /*!< changes since the previous version */
 
 } dvbpsi_pmt_t;
 
@@ -134,6 +141,79 @@ bool dvbpsi_pmt_attach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number,
  */
 void dvbpsi_pmt_detach(dvbpsi_t *p_dvbpsi);
 
+/*****************************************************************************
+ * dvbpsi_pmt_programs_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pmt_programs_attach(dvbpsi_t *p_dvbpsi,
+                                       dvbpsi_pmt_callback pf_callback,
+                                       void* p_cb_data)
+ * \brief Creation and initialization of a decoder of all the PMTs carried on
+ * one PID.
+ * \param p_dvbpsi handle
+ * \param pf_callback function to call back on the new PMT of every program
+ * that has no decoder of its own, NULL to decode only the programs added with
+ * dvbpsi_pmt_program_attach()
+ * \param p_cb_data private data given in argument to the callback
+ * \return true on success, false on failure
+ *
+ * The sections of the PID are assembled and checked once, then routed by
+ * program_number. The decoder is a subtable demultiplexor, see
+ * dvbpsi_AttachDemux(), and must be closed with dvbpsi_pmt_programs_detach().
+ */
+bool dvbpsi_pmt_programs_attach(dvbpsi_t *p_dvbpsi,
+                                dvbpsi_pmt_callback pf_callback, void* p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_pmt_programs_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_pmt_programs_detach(dvbpsi_t *p_dvbpsi)
+ * \brief Destroy a decoder of all the PMTs carried on one PID, and the
+ * decoders of its programs.
+ * \param p_dvbpsi handle
+ * \return nothing.
+ */
+void dvbpsi_pmt_programs_detach(dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pmt_program_attach(dvbpsi_t *p_dvbpsi,
+                                      uint16_t i_program_number,
+                                      dvbpsi_pmt_callback pf_callback,
+                                      void* p_cb_data)
+ * \brief Add the PMT decoder of one program to a subtable demultiplexor.
+ * \param p_dvbpsi handle to a decoder created by dvbpsi_pmt_programs_attach()
+ * or dvbpsi_AttachDemux()
+ * \param i_program_number program number
+ * \param pf_callback function to call back on new PMT
+ * \param p_cb_data private data given in argument to the callback
+ * \return true on success, false on failure
+ *
+ * A program already delivered to the all programs callback is taken over by
+ * pf_callback from its next version on.
+ */
+bool dvbpsi_pmt_program_attach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number,
+                               dvbpsi_pmt_callback pf_callback, void* p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_pmt_program_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_pmt_program_detach(dvbpsi_t *p_dvbpsi,
+                                      uint16_t i_program_number)
+ * \brief Remove the PMT decoder of one program from a subtable demultiplexor.
+ * \param p_dvbpsi handle
+ * \param i_program_number program number
+ * \return nothing.
+ *
+ * If the decoder has an all programs callback, the program is decoded again
+ * for it from its next section on.
+ */
+void dvbpsi_pmt_program_detach(dvbpsi_t *p_dvbpsi, uint16_t i_program_number);
+
 /*****************************************************************************
  * dvbpsi_pmt_init/dvbpsi_pmt_new
  *****************************************************************************/
@@ -162,6 +242,8 @@ void dvbpsi_pmt_init(dvbpsi_pmt_t* p_pmt, uint16_t i_program_number,
  * \param b_current_next current next indicator
  * \param i_pcr_pid PCR_PID
  * \return p_pmt pointer to the PMT structure
+ *
+ * The ES and the descriptors are carved from an arena owned by the PMT.
  */
 dvbpsi_pmt_t* dvbpsi_pmt_new(uint16_t i_program_number, uint8_t i_version,
                             bool b_current_next, uint16_t i_pcr_pid);
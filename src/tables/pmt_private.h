@@ -44,9 +44,23 @@ typedef struct dvbpsi_pmt_decoder_s
     dvbpsi_pmt_t *                p_building_pmt;
 
     uint16_t                      i_program_number;
+    bool                          b_all_programs; /* created for the all
+                                                     programs callback */
 
 } dvbpsi_pmt_decoder_t;
 
+/*****************************************************************************
+ * dvbpsi_pmt_programs_t
+ *****************************************************************************
+ * All programs callback of a decoder of all the PMTs carried on a PID.
+ *****************************************************************************/
+typedef struct dvbpsi_pmt_programs_s
+{
+    dvbpsi_pmt_callback           pf_callback;
+    void *                        p_cb_data;
+
+} dvbpsi_pmt_programs_t;
+
 /*****************************************************************************
  * dvbpsi_pmt_sections_gather
  *****************************************************************************
@@ -104,6 +104,8 @@ void dvbpsi_rst_init(dvbpsi_rst_t* p_rst)
     assert(p_rst);
 
     p_rst->p_first_event = NULL;
+    p_rst->p_last_event = NULL;
+    p_rst->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -115,7 +117,10 @@ dvbpsi_rst_t *dvbpsi_rst_new(void)
 {
     dvbpsi_rst_t *p_rst = (dvbpsi_rst_t*)malloc(sizeof(dvbpsi_rst_t));
     if (p_rst != NULL)
+    {
         dvbpsi_rst_init(p_rst);
+        p_rst->p_arena = dvbpsi_NewArena();
+    }
     return p_rst;
 }
 
@@ -132,12 +137,15 @@ void dvbpsi_rst_empty(dvbpsi_rst_t* p_rst)
     {
     	dvbpsi_rst_event_t* p_next = p_rst_event->p_next;
 
-        free(p_rst_event);
+        if (p_rst->p_arena == NULL)
+            free(p_rst_event);
 
         p_rst_event = p_next;
     }
 
+    dvbpsi_ResetArena(p_rst->p_arena);
     p_rst->p_first_event = NULL;
+    p_rst->p_last_event = NULL;
 }
 
 /*****************************************************************************
@@ -148,7 +156,10 @@ void dvbpsi_rst_empty(dvbpsi_rst_t* p_rst)
 void dvbpsi_rst_delete(dvbpsi_rst_t *p_rst)
 {
     if (p_rst)
+    {
         dvbpsi_rst_empty(p_rst);
+        dvbpsi_DeleteArena(p_rst->p_arena);
+    }
     free(p_rst);
 }
 
@@ -166,7 +177,8 @@ dvbpsi_rst_event_t* dvbpsi_rst_event_add(dvbpsi_rst_t* p_rst,
                                             uint8_t i_running_status)
 {
 	dvbpsi_rst_event_t* p_rst_event
-                        = (dvbpsi_rst_event_t*)malloc(sizeof(dvbpsi_rst_event_t));
+                        = (dvbpsi_rst_event_t*)dvbpsi_ArenaAlloc(p_rst->p_arena,
+                                                                 sizeof(dvbpsi_rst_event_t));
 
     if (p_rst_event == NULL)
         return NULL;
@@ -182,11 +194,14 @@ dvbpsi_rst_event_t* dvbpsi_rst_event_add(dvbpsi_rst_t* p_rst,
     	p_rst->p_first_event = p_rst_event;
     else
     {
-    	dvbpsi_rst_event_t *p_last = p_rst->p_first_event;
+    	dvbpsi_rst_event_t *p_last = p_rst->p_last_event;
+    	if (p_last == NULL)
+    		p_last = p_rst->p_first_event;
     	while (p_last->p_next != NULL)
     		p_last = p_last->p_next;
     	p_last->p_next = p_rst_event;
     }
+    p_rst->p_last_event = p_rst_event;
 
     return p_rst_event;
 }
@@ -198,7 +213,7 @@ dvbpsi_rst_event_t* dvbpsi_rst_event_add(dvbpsi_rst_t* p_rst,
  *****************************************************************************/
 dvbpsi_psi_section_t* dvbpsi_rst_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_rst_t* p_rst)
 {
-    dvbpsi_psi_section_t* p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t* p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t* p_current = p_result;
     dvbpsi_psi_section_t* p_prev;
     dvbpsi_rst_event_t* p_event = p_rst->p_first_event;
@@ -81,6 +81,8 @@ typedef struct dvbpsi_rst_event_s
 typedef struct dvbpsi_rst_s
 {
   dvbpsi_rst_event_t *      p_first_event;      /*!< event information list */
+  dvbpsi_rst_event_t *      p_last_event;       /*!< last event of the list */
+  dvbpsi_arena_t *          p_arena;            /*!< arena of the events */
 } dvbpsi_rst_t;
 
 
@@ -138,6 +140,8 @@ void dvbpsi_rst_init(dvbpsi_rst_t* p_rst);
  * \fn dvbpsi_rst_t *dvbpsi_rst_new(void)
  * \brief Allocate and initialize a new dvbpsi_rst_t structure.
  * \return p_rst pointer to the RST structure
+ *
+ * The events are carved from an arena owned by the RST.
  */
 dvbpsi_rst_t *dvbpsi_rst_new(void);
 
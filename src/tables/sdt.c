@@ -48,6 +48,44 @@
 #include "sdt.h"
 #include "sdt_private.h"
 
+/*****************************************************************************
+ * dvbpsi_sdt_sections_peek
+ *****************************************************************************
+ * Tell if a section belongs to the SDT already decoded, given its header.
+ *****************************************************************************/
+static bool dvbpsi_sdt_sections_peek(dvbpsi_decoder_t *p_decoder, const uint8_t *p_header)
+{
+    dvbpsi_sdt_decoder_t *p_sdt_decoder = (dvbpsi_sdt_decoder_t *)p_decoder;
+
+    return (p_sdt_decoder->p_building_sdt == NULL)
+        && (p_sdt_decoder->b_current_valid)
+        && (p_sdt_decoder->current_sdt.i_version == ((p_header[5] & 0x3e) >> 1))
+        && (p_sdt_decoder->current_sdt.b_current_next == ((p_header[5] & 0x01) != 0));
+}
+
+/*****************************************************************************
+ * dvbpsi_sdt_decoder_new
+ *****************************************************************************
+ * Allocate an SDT decoder, of a subtable or of a family.
+ *****************************************************************************/
+static dvbpsi_sdt_decoder_t *dvbpsi_sdt_decoder_new(dvbpsi_sdt_callback pf_callback,
+                                                  void *p_cb_data)
+{
+    dvbpsi_sdt_decoder_t *p_sdt_decoder;
+    p_sdt_decoder = (dvbpsi_sdt_decoder_t *) dvbpsi_decoder_new(NULL,
+                                             0, true, sizeof(dvbpsi_sdt_decoder_t));
+    if (p_sdt_decoder == NULL)
+        return NULL;
+
+    /* SDT decoder information */
+    p_sdt_decoder->pf_sdt_callback = pf_callback;
+    p_sdt_decoder->p_cb_data = p_cb_data;
+    p_sdt_decoder->p_building_sdt = NULL;
+    p_sdt_decoder->pf_peek = dvbpsi_sdt_sections_peek;
+
+    return p_sdt_decoder;
+}
+
 /*****************************************************************************
  * dvbpsi_sdt_attach
  *****************************************************************************
@@ -70,9 +108,7 @@ bool dvbpsi_sdt_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
         return false;
     }
 
-    dvbpsi_sdt_decoder_t*  p_sdt_decoder;
-    p_sdt_decoder = (dvbpsi_sdt_decoder_t*) dvbpsi_decoder_new(NULL,
-                                             0, true, sizeof(dvbpsi_sdt_decoder_t));
+    dvbpsi_sdt_decoder_t*  p_sdt_decoder = dvbpsi_sdt_decoder_new(pf_callback, p_cb_data);
     if (p_sdt_decoder == NULL)
         return false;
 
@@ -89,11 +125,6 @@ bool dvbpsi_sdt_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
     /* Attach the subtable decoder to the demux */
     dvbpsi_AttachDemuxSubDecoder(p_demux, p_subdec);
 
-    /* SDT decoder information */
-    p_sdt_decoder->pf_sdt_callback = pf_callback;
-    p_sdt_decoder->p_cb_data = p_cb_data;
-    p_sdt_decoder->p_building_sdt = NULL;
-
     return true;
 }
 
@@ -133,6 +164,61 @@ void dvbpsi_sdt_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
     dvbpsi_DeleteDemuxSubDecoder(p_subdec);
 }
 
+/*****************************************************************************
+ * dvbpsi_sdt_family_new
+ *****************************************************************************
+ * Create the decoder of a subtable of an SDT family.
+ *****************************************************************************/
+static dvbpsi_decoder_t *dvbpsi_sdt_family_new(dvbpsi_demux_family_t *p_family,
+                                              uint8_t i_table_id, uint16_t i_extension)
+{
+    (void)i_table_id;
+    (void)i_extension;
+
+    dvbpsi_sdt_callback pf_callback = (dvbpsi_sdt_callback)p_family->pf_table_callback;
+    return DVBPSI_DECODER(dvbpsi_sdt_decoder_new(pf_callback, p_family->p_cb_data));
+}
+
+/*****************************************************************************
+ * dvbpsi_sdt_family_delete
+ *****************************************************************************
+ * Destroy the decoder of a subtable of an SDT family.
+ *****************************************************************************/
+static void dvbpsi_sdt_family_delete(dvbpsi_decoder_t *p_decoder)
+{
+    dvbpsi_sdt_decoder_t *p_sdt_decoder = (dvbpsi_sdt_decoder_t *)p_decoder;
+    if (p_sdt_decoder->p_building_sdt)
+        dvbpsi_sdt_delete(p_sdt_decoder->p_building_sdt);
+
+    dvbpsi_decoder_delete(p_decoder);
+}
+
+/*****************************************************************************
+ * dvbpsi_sdt_family_attach
+ *****************************************************************************
+ * Initialize an SDT decoder of a range of table ids and any extension.
+ *****************************************************************************/
+bool dvbpsi_sdt_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_sdt_callback pf_callback, void* p_cb_data)
+{
+    return dvbpsi_AddDemuxFamily(p_dvbpsi, "SDT decoder", i_first_table_id,
+                                 i_last_table_id, dvbpsi_sdt_sections_gather,
+                                 dvbpsi_sdt_family_new, dvbpsi_sdt_family_delete,
+                                 (dvbpsi_demux_family_table_cb_t)pf_callback, p_cb_data);
+}
+
+/*****************************************************************************
+ * dvbpsi_sdt_family_detach
+ *****************************************************************************
+ * Close an SDT decoder of a range of table ids.
+ *****************************************************************************/
+void dvbpsi_sdt_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+{
+    dvbpsi_RemoveDemuxFamily(p_dvbpsi, "SDT decoder", i_table_id,
+                             dvbpsi_sdt_family_new);
+}
+
 /*****************************************************************************
  * dvbpsi_sdt_init
  *****************************************************************************
@@ -150,6 +236,10 @@ void dvbpsi_sdt_init(dvbpsi_sdt_t* p_sdt, uint8_t i_table_id, uint16_t i_extensi
     p_sdt->b_current_next = b_current_next;
     p_sdt->i_network_id = i_network_id;
     p_sdt->p_first_service = NULL;
+    p_sdt->p_last_service = NULL;
+    p_sdt->p_arena = NULL;
+    p_sdt->p_sections = NULL;
+    p_sdt->p_delta = NULL;
 }
 
 /*****************************************************************************
@@ -162,8 +252,11 @@ dvbpsi_sdt_t *dvbpsi_sdt_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i
 {
     dvbpsi_sdt_t *p_sdt = (dvbpsi_sdt_t*)malloc(sizeof(dvbpsi_sdt_t));
     if (p_sdt != NULL)
+    {
         dvbpsi_sdt_init(p_sdt, i_table_id, i_extension, i_version,
                         b_current_next, i_network_id);
+        p_sdt->p_arena = dvbpsi_NewArena();
+    }
     return p_sdt;
 }
 
@@ -179,11 +272,17 @@ void dvbpsi_sdt_empty(dvbpsi_sdt_t* p_sdt)
     while (p_service != NULL)
     {
         dvbpsi_sdt_service_t* p_tmp = p_service->p_next;
-        dvbpsi_DeleteDescriptors(p_service->p_first_descriptor);
-        free(p_service);
+        dvbpsi_DeleteArenaDescriptors(p_sdt->p_arena, p_service->p_first_descriptor);
+        if (p_sdt->p_arena == NULL)
+            free(p_service);
         p_service = p_tmp;
     }
+    dvbpsi_ResetArena(p_sdt->p_arena);
+    dvbpsi_DeletePSISections(p_sdt->p_sections);
+    p_sdt->p_sections = NULL;
+    p_sdt->p_delta = NULL;
     p_sdt->p_first_service = NULL;
+    p_sdt->p_last_service = NULL;
 }
 
 /*****************************************************************************
@@ -194,7 +293,10 @@ void dvbpsi_sdt_empty(dvbpsi_sdt_t* p_sdt)
 void dvbpsi_sdt_delete(dvbpsi_sdt_t *p_sdt)
 {
     if (p_sdt)
+    {
         dvbpsi_sdt_empty(p_sdt);
+        dvbpsi_DeleteArena(p_sdt->p_arena);
+    }
     free(p_sdt);
 }
 
@@ -211,7 +313,8 @@ dvbpsi_sdt_service_t *dvbpsi_sdt_service_add(dvbpsi_sdt_t* p_sdt,
                                            bool b_free_ca)
 {
     dvbpsi_sdt_service_t * p_service;
-    p_service = (dvbpsi_sdt_service_t*)calloc(1, sizeof(dvbpsi_sdt_service_t));
+    p_service = (dvbpsi_sdt_service_t*)dvbpsi_ArenaAlloc(p_sdt->p_arena,
+                                                         sizeof(dvbpsi_sdt_service_t));
     if (p_service == NULL)
         return NULL;
 
@@ -221,17 +324,22 @@ dvbpsi_sdt_service_t *dvbpsi_sdt_service_add(dvbpsi_sdt_t* p_sdt,
     p_service->i_running_status = i_running_status;
     p_service->b_free_ca = b_free_ca;
     p_service->p_next = NULL;
+    p_service->p_arena = p_sdt->p_arena;
     p_service->p_first_descriptor = NULL;
+    p_service->p_last_descriptor = NULL;
 
     if (p_sdt->p_first_service == NULL)
         p_sdt->p_first_service = p_service;
     else
     {
-        dvbpsi_sdt_service_t * p_last_service = p_sdt->p_first_service;
+        dvbpsi_sdt_service_t * p_last_service = p_sdt->p_last_service;
+        if (p_last_service == NULL)
+            p_last_service = p_sdt->p_first_service;
         while(p_last_service->p_next != NULL)
             p_last_service = p_last_service->p_next;
         p_last_service->p_next = p_service;
     }
+    p_sdt->p_last_service = p_service;
 
     return p_service;
 }
@@ -247,12 +355,13 @@ dvbpsi_descriptor_t *dvbpsi_sdt_service_descriptor_add(
                                                uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor;
-    p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    p_descriptor = dvbpsi_NewArenaDescriptor(p_service->p_arena, i_tag,
+                                             i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_service->p_first_descriptor = dvbpsi_AddDescriptor(p_service->p_first_descriptor,
-                                                         p_descriptor);
+    dvbpsi_AppendDescriptor(&p_service->p_first_descriptor,
+                            &p_service->p_last_descriptor, p_descriptor);
     assert(p_service->p_first_descriptor);
     if (p_service->p_first_descriptor == NULL)
         return NULL;
@@ -417,8 +526,18 @@ void dvbpsi_sdt_sections_gather(dvbpsi_t *p_dvbpsi,
         p_sdt_decoder->current_sdt = *p_sdt_decoder->p_building_sdt;
         p_sdt_decoder->b_current_valid = true;
         /* Decode the sections */
-        dvbpsi_sdt_sections_decode(p_sdt_decoder->p_building_sdt,
-                                   p_sdt_decoder->p_sections);
+        dvbpsi_psi_section_t *p_sections = p_sdt_decoder->p_sections;
+        if (p_dvbpsi->p_decoder->b_retain_sections)
+        {
+            /* The table keeps its sections, its descriptors point into them */
+            p_sdt_decoder->p_building_sdt->p_sections = p_sections;
+            p_sdt_decoder->p_sections = NULL;
+        }
+        dvbpsi_sdt_sections_decode(p_sdt_decoder->p_building_sdt, p_sections);
+        if (p_dvbpsi->p_decoder->b_delta)
+            p_sdt_decoder->p_building_sdt->p_delta =
+                dvbpsi_decoder_psi_sections_delta(DVBPSI_DECODER(p_sdt_decoder),
+                        p_sdt_decoder->p_building_sdt->p_arena, p_sections);
         /* signal the new SDT */
         p_sdt_decoder->pf_sdt_callback(p_sdt_decoder->p_cb_data,
                                        p_sdt_decoder->p_building_sdt);
@@ -458,6 +577,10 @@ void dvbpsi_sdt_sections_decode(dvbpsi_sdt_t* p_sdt,
             p_end = p_byte + i_srv_length;
             if( p_end > p_section->p_payload_end ) break;
 
+            if (p_service != NULL && p_sdt->p_sections != NULL
+             && dvbpsi_AppendDescriptorViews(p_sdt->p_arena, &p_service->p_first_descriptor,
+                                             &p_service->p_last_descriptor, p_byte, p_end - p_byte))
+                p_byte = p_end;
             while(p_byte + 2 <= p_end)
             {
                 uint8_t i_tag = p_byte[0];
@@ -478,7 +601,7 @@ void dvbpsi_sdt_sections_decode(dvbpsi_sdt_t* p_sdt,
  *****************************************************************************/
 dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sdt_t* p_sdt)
 {
-    dvbpsi_psi_section_t *p_result = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t *p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
     dvbpsi_psi_section_t *p_current = p_result;
     dvbpsi_psi_section_t *p_prev;
 
@@ -520,7 +643,7 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
             dvbpsi_debug(p_dvbpsi, "SDT generator","create a new section to carry more Service descriptors");
 
             p_prev = p_current;
-            p_current = dvbpsi_NewPSISection(1024);
+            p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
             p_prev->p_next = p_current;
 
             p_current->i_table_id = 0x42;
@@ -586,3 +709,90 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
     }
     return p_result;
 }
+
+/*****************************************************************************
+ * NextSDTService
+ *****************************************************************************/
+static const void *NextSDTService(const void *p_entry)
+{
+    return ((const dvbpsi_sdt_service_t *)p_entry)->p_next;
+}
+
+/*****************************************************************************
+ * EncodeSDTService
+ *****************************************************************************
+ * Encode a service with as many of its descriptors as fit in i_room bytes.
+ *****************************************************************************/
+static size_t EncodeSDTService(dvbpsi_t *p_dvbpsi, const void *p_entry,
+                               uint8_t *p_buffer, size_t i_room)
+{
+    const dvbpsi_sdt_service_t *p_service = (const dvbpsi_sdt_service_t *)p_entry;
+    const dvbpsi_descriptor_t *p_descriptor = p_service->p_first_descriptor;
+    size_t i_length = 5;
+
+    if (p_buffer == NULL)
+    {
+        for (; p_descriptor != NULL; p_descriptor = p_descriptor->p_next)
+            i_length += p_descriptor->i_length + 2;
+        return i_length;
+    }
+
+    p_buffer[0] = (p_service->i_service_id >>8);
+    p_buffer[1] = (p_service->i_service_id );
+    p_buffer[2] = 0xfc | (p_service->b_eit_schedule ? 0x2 : 0x0) | (p_service->b_eit_present ? 0x01 : 0x00);
+    p_buffer[3] = ((p_service->i_running_status & 0x07) << 5 ) | ((p_service->b_free_ca & 0x1) << 4);
+
+    for (; p_descriptor != NULL; p_descriptor = p_descriptor->p_next)
+    {
+        if (i_length + p_descriptor->i_length + 2 > i_room)
+        {
+            dvbpsi_error(p_dvbpsi, "SDT generator", "unable to carry all the descriptors");
+            break;
+        }
+
+        p_buffer[i_length] = p_descriptor->i_tag;
+        p_buffer[i_length + 1] = p_descriptor->i_length;
+        memcpy(p_buffer + i_length + 2, p_descriptor->p_data, p_descriptor->i_length);
+        i_length += p_descriptor->i_length + 2;
+    }
+
+    /* descriptors_loop_length */
+    p_buffer[3] |= ((i_length - 5) >> 8) & 0x0f;
+    p_buffer[4] = i_length - 5;
+
+    return i_length;
+}
+
+/*****************************************************************************
+ * SDTSectionHeader
+ *****************************************************************************/
+static void SDTSectionHeader(const void *p_table, dvbpsi_psi_section_t *p_section)
+{
+    const dvbpsi_sdt_t *p_sdt = (const dvbpsi_sdt_t *)p_table;
+
+    /* Original Network ID */
+    p_section->p_data[8] = (p_sdt->i_network_id >> 8) ;
+    p_section->p_data[9] = p_sdt->i_network_id;
+    p_section->p_data[10] = 0xff;
+}
+
+static const dvbpsi_psi_section_layout_t sdt_layout =
+{
+    11, 1020, true, NextSDTService, EncodeSDTService, SDTSectionHeader
+};
+
+/*****************************************************************************
+ * dvbpsi_sdt_sections_update
+ *****************************************************************************
+ * Generate SDT sections, encoding only the services that changed since the
+ * last update of the cache.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_psi_section_cache_t *p_cache,
+                                                 dvbpsi_sdt_t *p_sdt)
+{
+    return dvbpsi_UpdatePSISectionCache(p_dvbpsi, p_cache, &sdt_layout, p_sdt,
+                                        p_sdt->p_first_service, p_sdt->i_table_id,
+                                        p_sdt->i_extension, p_sdt->b_current_next,
+                                        &p_sdt->i_version);
+}
@@ -64,6 +64,8 @@ typedef struct dvbpsi_sdt_service_s
                                                          length */
   dvbpsi_descriptor_t *     p_first_descriptor;     /*!< First of the following
                                                          DVB descriptors */
+  dvbpsi_descriptor_t *     p_last_descriptor;      /*!< last descriptor of the list */
+  dvbpsi_arena_t *          p_arena;                /*!< arena of the SDT */
 
   struct dvbpsi_sdt_service_s * p_next;             /*!< next element of
                                                              the list */
@@ -97,6 +99,10 @@ typedef struct dvbpsi_sdt_s
 
     dvbpsi_sdt_service_t *    p_first_service;    /*!< service description
                                                      list */
+    dvbpsi_sdt_service_t *    p_last_service;     /*!< last service of the list */
+    dvbpsi_arena_t *          p_arena;            /*!< arena of the services */
+    dvbpsi_psi_section_t *    p_sections;         /*!< retained sections, or NULL */
+    dvbpsi_delta_t *          p_delta;            /*!< changes since the previous version */
 
 } dvbpsi_sdt_t;
 
@@ -142,6 +148,46 @@ bool dvbpsi_sdt_attach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extens
  */
 void dvbpsi_sdt_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id, uint16_t i_extension);
 
+/*****************************************************************************
+ * dvbpsi_sdt_family_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_sdt_family_attach(dvbpsi_t *p_dvbpsi,
+                                      uint8_t i_first_table_id,
+                                      uint8_t i_last_table_id,
+                                      dvbpsi_sdt_callback pf_callback,
+                                      void* p_cb_data)
+ * \brief Creation and initialization of an SDT decoder of every subtable
+ * whose table_id is in a range, whatever its extension.
+ * \param p_dvbpsi pointer to dvbpsi to hold decoder/demuxer structure
+ * \param i_first_table_id first table id, 0x42 for the SDT actual
+ * \param i_last_table_id last table id, 0x46 to also receive the SDT other
+ * \param pf_callback function to call back on every new SDT
+ * \param p_cb_data private data given in argument to the callback.
+ * \return true on success, false on failure
+ *
+ * The subtables are delivered to pf_callback as with one dvbpsi_sdt_attach()
+ * per subtable, but only the subtables being received have a decoder: the
+ * others take a few bytes each. Subtables with a decoder of their own keep
+ * it, and the new subtable callback of the demux is no longer called for
+ * these table ids.
+ */
+bool dvbpsi_sdt_family_attach(dvbpsi_t *p_dvbpsi, uint8_t i_first_table_id,
+                              uint8_t i_last_table_id,
+                              dvbpsi_sdt_callback pf_callback, void* p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_sdt_family_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_sdt_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id)
+ * \brief Destroy an SDT decoder of a range of table ids.
+ * \param p_dvbpsi pointer holding decoder/demuxer structure
+ * \param i_table_id any table id of the range
+ * \return nothing.
+ */
+void dvbpsi_sdt_family_detach(dvbpsi_t *p_dvbpsi, uint8_t i_table_id);
+
 /*****************************************************************************
  * dvbpsi_sdt_init/dvbpsi_NewSDT
  *****************************************************************************/
@@ -170,6 +216,9 @@ void dvbpsi_sdt_init(dvbpsi_sdt_t *p_sdt, uint8_t i_table_id, uint16_t i_extensi
  * \param b_current_next current next indicator
  * \param i_network_id original network id
  * \return p_sdt pointer to the SDT structure
+ *
+ * The services and their descriptors are carved from an arena owned by
+ * the SDT.
  */
 dvbpsi_sdt_t *dvbpsi_sdt_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i_version,
                              bool b_current_next, uint16_t i_network_id);
@@ -253,6 +302,27 @@ dvbpsi_descriptor_t *dvbpsi_sdt_service_descriptor_add(
  */
 dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sdt_t * p_sdt);
 
+/*****************************************************************************
+ * dvbpsi_sdt_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+ *                                   dvbpsi_psi_section_cache_t *p_cache,
+ *                                   dvbpsi_sdt_t *p_sdt)
+ * \brief Generate the SDT sections again, reusing the unchanged ones.
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache section cache of this SDT, see dvbpsi_NewPSISectionCache()
+ * \param p_sdt pointer to the SDT
+ * \return the sections, owned by the cache, or NULL on error.
+ *
+ * Services edited in place since the last update must be reported with
+ * dvbpsi_PSISectionCacheChanged(). dvbpsi_sdt_s::i_version is incremented
+ * when something changed, see dvbpsi_UpdatePSISectionCache().
+ */
+dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_psi_section_cache_t *p_cache,
+                                                 dvbpsi_sdt_t *p_sdt);
+
 #ifdef __cplusplus
 };
 #endif
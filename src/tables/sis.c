@@ -168,10 +168,12 @@ void dvbpsi_sis_init(dvbpsi_sis_t *p_sis, uint8_t i_table_id, uint16_t i_extensi
     /* descriptors */
     p_sis->i_descriptors_length = 0;
     p_sis->p_first_descriptor = NULL;
+    p_sis->p_last_descriptor = NULL;
 
     /* FIXME: alignment stuffing */
 
     p_sis->i_ecrc = 0;
+    p_sis->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -184,8 +186,11 @@ dvbpsi_sis_t* dvbpsi_sis_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i
 {
     dvbpsi_sis_t* p_sis = (dvbpsi_sis_t*)malloc(sizeof(dvbpsi_sis_t));
     if (p_sis != NULL)
+    {
         dvbpsi_sis_init(p_sis, i_table_id, i_extension, i_version,
                         b_current_next, i_protocol_version);
+        p_sis->p_arena = dvbpsi_NewArena();
+    }
     return p_sis;
 }
 
@@ -198,8 +203,10 @@ void dvbpsi_sis_empty(dvbpsi_sis_t* p_sis)
 {
     /* FIXME: free splice_command_sections */
 
-    dvbpsi_DeleteDescriptors(p_sis->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_sis->p_arena, p_sis->p_first_descriptor);
+    dvbpsi_ResetArena(p_sis->p_arena);
     p_sis->p_first_descriptor = NULL;
+    p_sis->p_last_descriptor = NULL;
 
     /* FIXME: free alignment stuffing */
 }
@@ -212,7 +219,10 @@ void dvbpsi_sis_empty(dvbpsi_sis_t* p_sis)
 void dvbpsi_sis_delete(dvbpsi_sis_t *p_sis)
 {
     if (p_sis)
+    {
         dvbpsi_sis_empty(p_sis);
+        dvbpsi_DeleteArena(p_sis->p_arena);
+    }
     free(p_sis);
 }
 
@@ -226,12 +236,17 @@ dvbpsi_descriptor_t *dvbpsi_sis_descriptor_add(dvbpsi_sis_t *p_sis,
                                              uint8_t *p_data)
 {
     dvbpsi_descriptor_t * p_descriptor;
-    p_descriptor = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+    p_descriptor = dvbpsi_NewArenaDescriptor(p_sis->p_arena, i_tag,
+                                             i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_sis->p_first_descriptor = dvbpsi_AddDescriptor(p_sis->p_first_descriptor,
-                                                     p_descriptor);
+    /* The structure is packed, don't take the address of its members */
+    dvbpsi_descriptor_t *p_first = p_sis->p_first_descriptor;
+    dvbpsi_descriptor_t *p_last = p_sis->p_last_descriptor;
+    dvbpsi_AppendDescriptor(&p_first, &p_last, p_descriptor);
+    p_sis->p_first_descriptor = p_first;
+    p_sis->p_last_descriptor = p_last;
     assert(p_sis->p_first_descriptor);
     if (p_sis->p_first_descriptor == NULL)
         return NULL;
@@ -508,7 +523,7 @@ void dvbpsi_sis_sections_decode(dvbpsi_t* p_dvbpsi, dvbpsi_sis_t* p_sis,
  *****************************************************************************/
 dvbpsi_psi_section_t *dvbpsi_sis_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sis_t* p_sis)
 {
-    dvbpsi_psi_section_t * p_current = dvbpsi_NewPSISection(1024);
+    dvbpsi_psi_section_t * p_current = dvbpsi_NewGeneratedPSISection(p_dvbpsi, 1024);
 
     p_current->i_table_id = 0xFC;
     p_current->b_syntax_indicator = false;
@@ -96,6 +96,8 @@ typedef struct dvbpsi_sis_s
                                                          length */
   dvbpsi_descriptor_t       *p_first_descriptor;     /*!< First of the following
                                                           SIS descriptors */
+  dvbpsi_descriptor_t       *p_last_descriptor;      /*!< last descriptor of the list */
+  dvbpsi_arena_t            *p_arena;                /*!< arena of the descriptors */
 
   /* FIXME: alignment stuffing */
   uint32_t i_ecrc; /*!< CRC 32 of decrypted splice_info_section */
@@ -406,6 +408,8 @@ void dvbpsi_sis_init(dvbpsi_sis_t *p_sis, uint8_t i_table_id, uint16_t i_extensi
  * \param b_current_next current next indicator
  * \param i_protocol_version SIS protocol version (currently 0)
  * \return p_sis pointer to the SIS structure
+ *
+ * The descriptors are carved from an arena owned by the SIS.
  */
 dvbpsi_sis_t* dvbpsi_sis_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i_version,
                              bool b_current_next, uint8_t i_protocol_version);
@@ -155,6 +155,8 @@ void dvbpsi_tot_init(dvbpsi_tot_t* p_tot, uint8_t i_table_id, uint16_t i_extensi
 
     p_tot->i_utc_time = i_utc_time;
     p_tot->p_first_descriptor = NULL;
+    p_tot->p_last_descriptor = NULL;
+    p_tot->p_arena = NULL;
 }
 
 /*****************************************************************************
@@ -167,8 +169,11 @@ dvbpsi_tot_t *dvbpsi_tot_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i
 {
   dvbpsi_tot_t *p_tot = (dvbpsi_tot_t*)malloc(sizeof(dvbpsi_tot_t));
   if (p_tot != NULL)
+  {
         dvbpsi_tot_init(p_tot, i_table_id, i_extension, i_version,
                         b_current_next, i_utc_time);
+        p_tot->p_arena = dvbpsi_NewArena();
+  }
   return p_tot;
 }
 
@@ -179,8 +184,10 @@ dvbpsi_tot_t *dvbpsi_tot_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i
  *****************************************************************************/
 void dvbpsi_tot_empty(dvbpsi_tot_t* p_tot)
 {
-    dvbpsi_DeleteDescriptors(p_tot->p_first_descriptor);
+    dvbpsi_DeleteArenaDescriptors(p_tot->p_arena, p_tot->p_first_descriptor);
+    dvbpsi_ResetArena(p_tot->p_arena);
     p_tot->p_first_descriptor = NULL;
+    p_tot->p_last_descriptor = NULL;
 }
 
 /*****************************************************************************
@@ -191,7 +198,10 @@ void dvbpsi_tot_empty(dvbpsi_tot_t* p_tot)
 void dvbpsi_tot_delete(dvbpsi_tot_t* p_tot)
 {
     if (p_tot)
+    {
         dvbpsi_tot_empty(p_tot);
+        dvbpsi_DeleteArena(p_tot->p_arena);
+    }
     free(p_tot);
 }
 
@@ -205,12 +215,17 @@ dvbpsi_descriptor_t* dvbpsi_tot_descriptor_add(dvbpsi_tot_t* p_tot,
                                                uint8_t* p_data)
 {
     dvbpsi_descriptor_t* p_descriptor
-                        = dvbpsi_NewDescriptor(i_tag, i_length, p_data);
+                        = dvbpsi_NewArenaDescriptor(p_tot->p_arena, i_tag,
+                                                    i_length, p_data);
     if (p_descriptor == NULL)
         return NULL;
 
-    p_tot->p_first_descriptor = dvbpsi_AddDescriptor(p_tot->p_first_descriptor,
-                                                     p_descriptor);
+    /* The structure is packed, don't take the address of its members */
+    dvbpsi_descriptor_t *p_first = p_tot->p_first_descriptor;
+    dvbpsi_descriptor_t *p_last = p_tot->p_last_descriptor;
+    dvbpsi_AppendDescriptor(&p_first, &p_last, p_descriptor);
+    p_tot->p_first_descriptor = p_first;
+    p_tot->p_last_descriptor = p_last;
     assert(p_tot->p_first_descriptor);
     if (p_tot->p_first_descriptor == NULL)
         return NULL;
@@ -477,7 +492,8 @@ dvbpsi_psi_section_t* dvbpsi_tot_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_to
     dvbpsi_descriptor_t* p_descriptor = p_tot->p_first_descriptor;
 
     /* If it has descriptors, it must be a TOT, otherwise a TDT */
-    p_result = dvbpsi_NewPSISection((p_descriptor != NULL) ? 4096 : 8);
+    p_result = dvbpsi_NewGeneratedPSISection(p_dvbpsi,
+                                             (p_descriptor != NULL) ? 4096 : 8);
 
     p_result->i_table_id = (p_descriptor != NULL) ? 0x73 : 0x70;
     p_result->b_syntax_indicator = false;
@@ -67,6 +67,8 @@ typedef struct dvbpsi_tot_s
     uint64_t                  i_utc_time;         /*!< UTC_time */
 
     dvbpsi_descriptor_t *     p_first_descriptor; /*!< descriptor list */
+    dvbpsi_descriptor_t *     p_last_descriptor;  /*!< last descriptor of the list */
+    dvbpsi_arena_t *          p_arena;            /*!< arena of the descriptors */
 
 } __attribute__((packed)) dvbpsi_tot_t;
 
@@ -139,6 +141,8 @@ void dvbpsi_tot_init(dvbpsi_tot_t* p_tot, uint8_t i_table_id, uint16_t i_extensi
  * \param b_current_next current next indicator
  * \param i_utc_time the time in UTC
  * \return p_tot pointer to the TDT/TOT structure
+ *
+ * The descriptors are carved from an arena owned by the TDT/TOT.
  */
 dvbpsi_tot_t *dvbpsi_tot_new(uint8_t i_table_id, uint16_t i_extension, uint8_t i_version,
                              bool b_current_next, uint64_t i_utc_time);